@@ -0,0 +1,434 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  AabbTree.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 24/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_AABBTREE_H
+#define GRE_AABBTREE_H
+
+#include "BoundingBox.h"
+
+#include <queue>
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A dynamic bounding volume hierarchy of axis-aligned boxes.
+///
+/// Each leaf holds a user pointer , its exact box and a fat box : the
+/// exact box grown by 'iMargin'. Internal nodes hold the union of their
+/// children's fat boxes. Moving a leaf whose new box is still inside its
+/// fat box costs nothing. Otherwise the leaf is removed and inserted again
+/// at the place growing the tree's surface the least , and ancestors are
+/// refitted and rotated to keep the tree balanced.
+///
+/// Nodes are stored in one array and designated by their index , the
+/// index of a leaf being its proxy. Queries are const and keep their
+/// traversal stack on the stack , so several threads can query the tree
+/// at the same time , as long as no thread modifies it.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC AabbTree
+{
+public:
+
+    /// @brief Invalid node index.
+    static const int Null = -1 ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    AabbTree ( float margin = 0.1f ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~AabbTree () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds a leaf and returns its proxy.
+    //////////////////////////////////////////////////////////////////////
+    int insert ( const BoundingBox & box , void * userdata ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes a leaf.
+    //////////////////////////////////////////////////////////////////////
+    void remove ( int proxy ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the box of a leaf. Returns true if the leaf had to be
+    /// inserted again , false if it stayed in its fat box.
+    //////////////////////////////////////////////////////////////////////
+    bool move ( int proxy , const BoundingBox & box ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the user pointer of a leaf.
+    //////////////////////////////////////////////////////////////////////
+    void * getUserData ( int proxy ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of leaves.
+    //////////////////////////////////////////////////////////////////////
+    size_t getCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the height of the tree. Zero when empty or with one
+    /// leaf.
+    //////////////////////////////////////////////////////////////////////
+    int getHeight () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the margin of fat boxes. Only applies to leaves
+    /// inserted or moved after.
+    //////////////////////////////////////////////////////////////////////
+    void setMargin ( float margin ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the margin of fat boxes.
+    //////////////////////////////////////////////////////////////////////
+    float getMargin () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes every leaves.
+    //////////////////////////////////////////////////////////////////////
+    void clear () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Calls 'callback ( userdata )' for each leaf whose exact box
+    /// overlaps the given box. The query stops when the callback returns
+    /// false.
+    //////////////////////////////////////////////////////////////////////
+    template < typename Callback >
+    void queryBox ( const Vector3 & min , const Vector3 & max , Callback callback ) const
+    {
+        std::vector < int > stack ;
+        stack.reserve ( 64 ) ;
+
+        if ( iRoot != Null )
+        stack.push_back ( iRoot ) ;
+
+        while ( !stack.empty () )
+        {
+            const Node & node = iNodes [stack.back ()] ;
+            stack.pop_back () ;
+
+            if ( !Overlaps ( node.min , node.max , min , max ) )
+            continue ;
+
+            if ( node.isLeaf () )
+            {
+                if ( Overlaps ( node.tightmin , node.tightmax , min , max ) && !callback ( node.userdata ) )
+                return ;
+            }
+
+            else
+            {
+                stack.push_back ( node.child1 ) ;
+                stack.push_back ( node.child2 ) ;
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Calls 'callback ( userdata )' for each leaf whose exact box
+    /// overlaps the given sphere. The query stops when the callback returns
+    /// false.
+    //////////////////////////////////////////////////////////////////////
+    template < typename Callback >
+    void querySphere ( const Vector3 & center , float radius , Callback callback ) const
+    {
+        std::vector < int > stack ;
+        stack.reserve ( 64 ) ;
+
+        if ( iRoot != Null )
+        stack.push_back ( iRoot ) ;
+
+        float radius2 = radius * radius ;
+
+        while ( !stack.empty () )
+        {
+            const Node & node = iNodes [stack.back ()] ;
+            stack.pop_back () ;
+
+            if ( SquaredDistance ( node.min , node.max , center ) > radius2 )
+            continue ;
+
+            if ( node.isLeaf () )
+            {
+                if ( SquaredDistance ( node.tightmin , node.tightmax , center ) <= radius2 && !callback ( node.userdata ) )
+                return ;
+            }
+
+            else
+            {
+                stack.push_back ( node.child1 ) ;
+                stack.push_back ( node.child2 ) ;
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Casts a ray. 'callback ( userdata , entry )' is called for each
+    /// leaf whose exact box is hit closer than the nearest hit found yet ,
+    /// 'entry' being the distance where the ray enters the box. The callback
+    /// returns the distance of the hit , or a negative value if the leaf is
+    /// not hit ( for example when testing its triangles ). Leaves are visited
+    /// near to far , and the ray is shortened to each hit. 'direction' must
+    /// be normalized.
+    //////////////////////////////////////////////////////////////////////
+    template < typename Callback >
+    void raycast ( const Vector3 & origin , const Vector3 & direction , float maxdistance , Callback callback ) const
+    {
+        if ( iRoot == Null )
+        return ;
+
+        Vector3 inverse ( 1.0f / direction.x , 1.0f / direction.y , 1.0f / direction.z ) ;
+
+        std::vector < std::pair < float , int > > stack ;
+        stack.reserve ( 64 ) ;
+
+        float entry = 0.0f ;
+
+        if ( RayBox ( iNodes [iRoot] .min , iNodes [iRoot] .max , origin , inverse , maxdistance , entry ) )
+        stack.push_back ( std::make_pair ( entry , iRoot ) ) ;
+
+        while ( !stack.empty () )
+        {
+            std::pair < float , int > top = stack.back () ;
+            stack.pop_back () ;
+
+            if ( top.first > maxdistance )
+            continue ;
+
+            const Node & node = iNodes [top.second] ;
+
+            if ( node.isLeaf () )
+            {
+                if ( !RayBox ( node.tightmin , node.tightmax , origin , inverse , maxdistance , entry ) )
+                continue ;
+
+                float hit = callback ( node.userdata , entry ) ;
+
+                if ( hit >= 0.0f && hit < maxdistance )
+                maxdistance = hit ;
+
+                continue ;
+            }
+
+            //////////////////////////////////////////////////////////////////////
+            // Pushes the farthest child first , so the nearest is visited
+            // first and may shorten the ray before the other one is tested.
+
+            float entry1 = 0.0f , entry2 = 0.0f ;
+            bool hit1 = RayBox ( iNodes [node.child1] .min , iNodes [node.child1] .max , origin , inverse , maxdistance , entry1 ) ;
+            bool hit2 = RayBox ( iNodes [node.child2] .min , iNodes [node.child2] .max , origin , inverse , maxdistance , entry2 ) ;
+
+            if ( hit1 && hit2 )
+            {
+                if ( entry1 <= entry2 )
+                {
+                    stack.push_back ( std::make_pair ( entry2 , node.child2 ) ) ;
+                    stack.push_back ( std::make_pair ( entry1 , node.child1 ) ) ;
+                }
+
+                else
+                {
+                    stack.push_back ( std::make_pair ( entry1 , node.child1 ) ) ;
+                    stack.push_back ( std::make_pair ( entry2 , node.child2 ) ) ;
+                }
+            }
+
+            else if ( hit1 )
+            stack.push_back ( std::make_pair ( entry1 , node.child1 ) ) ;
+
+            else if ( hit2 )
+            stack.push_back ( std::make_pair ( entry2 , node.child2 ) ) ;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Finds the 'count' leaves nearest to the given point , sorted
+    /// by distance , and appends them to 'result' with their distance.
+    /// 'distance ( userdata , tightmin , tightmax )' returns the distance
+    /// from the point to a leaf. It must not be less than the distance to
+    /// the leaf's exact box : returning the box distance is always correct.
+    //////////////////////////////////////////////////////////////////////
+    template < typename Distance >
+    void nearest ( const Vector3 & point , size_t count , Distance distance ,
+                   std::vector < std::pair < float , void * > > & result ) const
+    {
+        if ( iRoot == Null || !count )
+        return ;
+
+        //////////////////////////////////////////////////////////////////////
+        // Best-first search : nodes are queued by the distance to their box ,
+        // which is never more than the distance to any leaf under them , and
+        // leaves by their exact distance. A leaf at the top of the queue is
+        // so nearer than anything left.
+
+        typedef std::pair < float , int > Item ;
+        std::priority_queue < Item , std::vector < Item > , std::greater < Item > > queue ;
+
+        queue.push ( std::make_pair ( std::sqrt ( SquaredDistance ( iNodes [iRoot] .min , iNodes [iRoot] .max , point ) ) , iRoot ) ) ;
+
+        size_t found = 0 ;
+
+        while ( !queue.empty () && found < count )
+        {
+            Item top = queue.top () ;
+            queue.pop () ;
+
+            //////////////////////////////////////////////////////////////////////
+            // Leaves are queued twice : first by their fat box , then with a
+            // negative index once their exact distance is known.
+
+            if ( top.second < 0 )
+            {
+                result.push_back ( std::make_pair ( top.first , iNodes [- top.second - 1] .userdata ) ) ;
+                found ++ ;
+                continue ;
+            }
+
+            const Node & node = iNodes [top.second] ;
+
+            if ( node.isLeaf () )
+            {
+                float exact = distance ( node.userdata , node.tightmin , node.tightmax ) ;
+                queue.push ( std::make_pair ( exact , - top.second - 1 ) ) ;
+            }
+
+            else
+            {
+                queue.push ( std::make_pair ( std::sqrt ( SquaredDistance ( iNodes [node.child1] .min , iNodes [node.child1] .max , point ) ) , node.child1 ) ) ;
+                queue.push ( std::make_pair ( std::sqrt ( SquaredDistance ( iNodes [node.child2] .min , iNodes [node.child2] .max , point ) ) , node.child2 ) ) ;
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the squared distance from a point to a box. Zero if
+    /// the point is inside.
+    //////////////////////////////////////////////////////////////////////
+    static float SquaredDistance ( const Vector3 & min , const Vector3 & max , const Vector3 & point ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if two boxes overlap.
+    //////////////////////////////////////////////////////////////////////
+    static bool Overlaps ( const Vector3 & mina , const Vector3 & maxa , const Vector3 & minb , const Vector3 & maxb ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if the ray hits the box before 'maxdistance' ,
+    /// and sets the entry distance. 'inverse' holds the inverse of each
+    /// component of the ray direction.
+    //////////////////////////////////////////////////////////////////////
+    static bool RayBox ( const Vector3 & min , const Vector3 & max , const Vector3 & origin ,
+                         const Vector3 & inverse , float maxdistance , float & entry ) ;
+
+protected:
+
+    /// @brief A node of the tree.
+    struct Node
+    {
+        /// @brief Fat box for leaves , union of the children for internal nodes.
+        Vector3 min ;
+        Vector3 max ;
+
+        /// @brief Exact box of a leaf.
+        Vector3 tightmin ;
+        Vector3 tightmax ;
+
+        void * userdata ;
+
+        /// @brief Parent node , or next free node when the node is free.
+        int parent ;
+        int child1 ;
+        int child2 ;
+
+        /// @brief Zero for leaves , -1 for free nodes.
+        int height ;
+
+        bool isLeaf () const { return child1 == Null ; }
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Takes a node from the free list.
+    //////////////////////////////////////////////////////////////////////
+    int allocateNode () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Gives a node back to the free list.
+    //////////////////////////////////////////////////////////////////////
+    void freeNode ( int index ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Links a leaf in the tree.
+    //////////////////////////////////////////////////////////////////////
+    void insertLeaf ( int leaf ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Unlinks a leaf from the tree.
+    //////////////////////////////////////////////////////////////////////
+    void removeLeaf ( int leaf ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Refits and balances the given node and its ancestors.
+    //////////////////////////////////////////////////////////////////////
+    void refit ( int index ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Rotates the given node if its children heights differ by more
+    /// than one. Returns the node now at its place.
+    //////////////////////////////////////////////////////////////////////
+    int balance ( int index ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the surface of a box.
+    //////////////////////////////////////////////////////////////////////
+    static float Surface ( const Vector3 & min , const Vector3 & max ) ;
+
+protected:
+
+    /// @brief Nodes of the tree.
+    std::vector < Node > iNodes ;
+
+    /// @brief Root node.
+    int iRoot ;
+
+    /// @brief First free node.
+    int iFree ;
+
+    /// @brief Number of leaves.
+    size_t iCount ;
+
+    /// @brief Margin of fat boxes.
+    float iMargin ;
+};
+
+GreEndNamespace
+
+#endif // GRE_AABBTREE_H
@@ -0,0 +1,154 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  AnimationClip.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_ANIMATIONCLIP_H
+#define GRE_ANIMATIONCLIP_H
+
+#include "Skeleton.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Keyframes of one bone. Each component has its own keys , so
+/// a bone only rotating doesn't store translations or scales. Rotations
+/// are quantized to four 16 bits integers.
+struct AnimationTrack
+{
+    std::vector < float > translationtimes ;
+    std::vector < Vector3 > translations ;
+
+    std::vector < float > rotationtimes ;
+    std::vector < int16_t > rotations ;
+
+    std::vector < float > scaletimes ;
+    std::vector < Vector3 > scales ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief An animation of a skeleton , stored as keyframes per bone.
+///
+/// Keys are added with 'addTranslationKey()' , 'addRotationKey()' and
+/// 'addScaleKey()' in increasing time order. 'compress()' then removes
+/// every key the interpolation of its neighbours already gives within a
+/// tolerance , which typically removes most keys of baked animations.
+///
+/// 'sample()' interpolates the keys at a given time and writes the local
+/// transformation of every animated bone in a pose. Bones without track
+/// keep their value in the pose , usually the bind pose.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC AnimationClip : public Resource
+{
+public:
+
+    POOLED ( Pools::Resource )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    AnimationClip ( const std::string & name = std::string () , float duration = 0.0f ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~AnimationClip () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the duration , in seconds.
+    //////////////////////////////////////////////////////////////////////
+    virtual float getDuration () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the duration , in seconds.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setDuration ( float duration ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds a translation key to the given bone.
+    //////////////////////////////////////////////////////////////////////
+    virtual void addTranslationKey ( size_t bone , float time , const Vector3 & translation ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds a rotation key to the given bone.
+    //////////////////////////////////////////////////////////////////////
+    virtual void addRotationKey ( size_t bone , float time , const Quaternion & rotation ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds a scale key to the given bone.
+    //////////////////////////////////////////////////////////////////////
+    virtual void addScaleKey ( size_t bone , float time , const Vector3 & scale ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes the keys given by the interpolation of the remaining
+    /// ones. 'tolerance' is a distance for translations and scales , and
+    /// applies to the components of normalized rotations. Returns the
+    /// number of keys removed.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t compress ( float tolerance = 0.001f ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of keys of every tracks.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getKeysCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the size of the keys , in bytes.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getKeysSize () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Writes the transformation of every animated bone at 'time'
+    /// in 'pose'. When 'loop' is true , 'time' wraps around the duration ,
+    /// else it is clamped. 'pose' must have one transformation per bone.
+    //////////////////////////////////////////////////////////////////////
+    virtual void sample ( float time , bool loop , Pose & pose ) const ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the track of a bone , creating it if needed.
+    //////////////////////////////////////////////////////////////////////
+    AnimationTrack & getTrack ( size_t bone ) ;
+
+protected:
+
+    /// @brief Tracks , one per bone.
+    std::vector < AnimationTrack > iTracks ;
+
+    /// @brief Duration , in seconds.
+    float iDuration ;
+};
+
+/// @brief Holder for AnimationClip.
+typedef Holder < AnimationClip > AnimationClipHolder ;
+
+GreEndNamespace
+
+#endif // GRE_ANIMATIONCLIP_H
@@ -0,0 +1,270 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  Broadphase.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 25/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_BROADPHASE_H
+#define GRE_BROADPHASE_H
+
+#include "RenderNode.h"
+
+#include <array>
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Finds the pairs of overlapping bounding boxes , and sends
+/// 'OverlapBeginEvent' and 'OverlapEndEvent' to its listeners when the
+/// pairs change.
+///
+/// Boxes are registered as proxies , either with an explicit box moved
+/// with 'move()' , or with a RenderNode whose bounding box is read again
+/// by each 'update()'.
+///
+/// Each update uses sweep and prune : proxies are kept in a list sorted
+/// by their minimum on one axis , the list is sorted again ( insertion sort ,
+/// as boxes move little between updates ) and swept , testing each box
+/// against the following ones until their minimum is over its maximum.
+/// The sweep axis is the one where box centers are the most spread , and
+/// changes when the boxes spread differently.
+///
+/// For large worlds , 'setRegions()' splits the world in a grid of regions
+/// ( multi-box pruning ). Each region keeps its own sorted list of the
+/// proxies touching it , and regions are sorted and swept in parallel on
+/// the JobPool. Large lists are also swept in parallel , and sorted in
+/// parallel when they must be sorted from scratch.
+///
+/// Events are sent by 'update()' and 'remove()' , from the calling thread.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC Broadphase : public Resource
+{
+public:
+
+    /// @brief Invalid proxy.
+    static const uint32_t InvalidProxy = 0xFFFFFFFF ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    Broadphase ( const std::string & name ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~Broadphase () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds a box , for given object. 'object' is the value given
+    /// by the overlap events.
+    //////////////////////////////////////////////////////////////////////
+    virtual uint32_t add ( const BoundingBox & box , const EventProceeder * object ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds a node. Its bounding box is read by each update , and
+    /// the node is given by the overlap events. Nodes without a valid
+    /// bounding box never overlap.
+    //////////////////////////////////////////////////////////////////////
+    virtual uint32_t add ( const RenderNodeHolder & node ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes a proxy. An 'OverlapEndEvent' is sent immediately
+    /// for each of its pairs.
+    //////////////////////////////////////////////////////////////////////
+    virtual void remove ( uint32_t proxy ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the box of a proxy added with a box.
+    //////////////////////////////////////////////////////////////////////
+    virtual void move ( uint32_t proxy , const BoundingBox & box ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Splits the given world box in 'x * y * z' regions. Boxes
+    /// outside the world belong to the border regions. A 1 * 1 * 1 grid
+    /// ( the default ) is a plain sweep and prune.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setRegions ( const BoundingBox & world , size_t x , size_t y , size_t z ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Finds the overlapping pairs and sends the events for the pairs
+    /// which began or ended since the last update.
+    //////////////////////////////////////////////////////////////////////
+    virtual void update () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if the two proxies overlapped at the last update.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isOverlapping ( uint32_t first , uint32_t second ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of pairs found by the last update.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getPairsCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Appends the pairs found by the last update.
+    //////////////////////////////////////////////////////////////////////
+    virtual void getPairs ( std::vector < std::pair < uint32_t , uint32_t > > & pairs ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of proxies.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getProxiesCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Calls 'update()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual void onUpdateEvent ( const UpdateEvent & e ) ;
+
+protected:
+
+    /// @brief A box.
+    struct Proxy
+    {
+        Vector3 min ;
+        Vector3 max ;
+
+        /// @brief Object given by the events.
+        const EventProceeder * object ;
+
+        /// @brief Node whose bounding box is read by 'update()' , if any.
+        RenderNodeHolder node ;
+
+        /// @brief False when the box is invalid , or the proxy removed.
+        bool active ;
+
+        /// @brief False when the proxy is removed.
+        bool alive ;
+
+        /// @brief True when the box changed since the last update.
+        bool dirty ;
+
+        /// @brief Range of regions touched at the last update : minimum x ,
+        /// y , z then maximum x , y , z. Empty ( minimum over maximum ) when
+        /// not active.
+        int cells [6] ;
+    };
+
+    /// @brief A proxy in a region's sorted list.
+    struct Entry
+    {
+        Vector3 min ;
+        Vector3 max ;
+        uint32_t proxy ;
+    };
+
+    /// @brief A region of the world.
+    struct Region
+    {
+        /// @brief Coordinates in the regions grid.
+        int coords [3] ;
+
+        /// @brief Proxies touching the region , sorted by their minimum on
+        /// 'axis'.
+        std::vector < Entry > entries ;
+
+        /// @brief Proxies which entered the region since the last update.
+        std::vector < uint32_t > added ;
+
+        /// @brief Sweep axis.
+        int axis ;
+
+        /// @brief Minimum of each entry on the sweep axis , in the entries'
+        /// order. The sweep scans this compact array first.
+        std::vector < float > keys ;
+
+        /// @brief Maximum on the sweep axis , then extents on the two other
+        /// axes , of each entry.
+        std::vector < std::array < float , 5 > > extents ;
+
+        /// @brief Pairs found by the last sweep , sorted.
+        std::vector < uint64_t > pairs ;
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Computes the range of regions touched by a proxy.
+    //////////////////////////////////////////////////////////////////////
+    void computeCells ( const Proxy & proxy , int cells [6] ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Updates the range of regions touched by a proxy , and adds it
+    /// to the regions it entered.
+    //////////////////////////////////////////////////////////////////////
+    void updateCells ( uint32_t index ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Updates the entries of a region , sorts and sweeps them.
+    //////////////////////////////////////////////////////////////////////
+    void updateRegion ( Region & region ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Sends an overlap event for given pair.
+    //////////////////////////////////////////////////////////////////////
+    void sendOverlap ( bool begin , uint64_t pair ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the key of a pair. The lowest proxy is in the high
+    /// bits , so keys sort by first proxy.
+    //////////////////////////////////////////////////////////////////////
+    static uint64_t PairKey ( uint32_t first , uint32_t second ) ;
+
+protected:
+
+    /// @brief Proxies , by index.
+    std::vector < Proxy > iProxies ;
+
+    /// @brief Removed proxies , reused once the next update has dropped
+    /// them from the regions.
+    std::vector < uint32_t > iFree ;
+
+    /// @brief Removed since the last update.
+    std::vector < uint32_t > iRemoved ;
+
+    /// @brief Regions.
+    std::vector < Region > iRegions ;
+
+    /// @brief Number of regions on each axis.
+    int iGrid [3] ;
+
+    /// @brief World split in regions.
+    Vector3 iWorldMin ;
+    Vector3 iWorldMax ;
+
+    /// @brief Overlapping pairs found by the last update , sorted.
+    std::vector < uint64_t > iPairs ;
+
+    /// @brief Number of active proxies.
+    size_t iCount ;
+};
+
+/// @brief Holder for Broadphase.
+typedef Holder < Broadphase > BroadphaseHolder ;
+
+GreEndNamespace
+
+#endif // GRE_BROADPHASE_H
@@ -0,0 +1,260 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  CommandBuffer.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_COMMANDBUFFER_H
+#define GRE_COMMANDBUFFER_H
+
+#include "UniformBlock.h"
+
+GreBeginNamespace
+
+class Technique ;
+class Material ;
+class Mesh ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Actions recorded in a CommandBuffer.
+enum class CommandType : int
+{
+    /// @brief Makes 'technique' the target of the next commands , without
+    /// binding it.
+    SetTechnique ,
+
+    /// @brief Binds 'technique' and makes it the target of the next commands.
+    BindTechnique ,
+
+    /// @brief Unbinds the current technique.
+    UnbindTechnique ,
+
+    /// @brief Sets the value at 'offset' to the aliased parameter 'param'.
+    SetParameter ,
+
+    /// @brief Sets the value at 'offset' to the member 'param' of the
+    /// technique's current light.
+    SetLightParameter ,
+
+    /// @brief Copies 'size' bytes at 'offset' to the technique's block
+    /// 'param' and binds it.
+    SetUniformBlock ,
+
+    /// @brief Uses 'material' with the current technique.
+    UseMaterial ,
+
+    /// @brief Resets the current technique's lights.
+    ResetLights ,
+
+    /// @brief Resets the current technique's parameters.
+    ResetTechnique ,
+
+    /// @brief Draws every submeshes of 'mesh' at level 'offset'. When
+    /// 'param' is zero , submeshes use their default material.
+    DrawMesh ,
+
+    /// @brief Draws the current technique by itself.
+    Draw
+};
+
+/// @brief Number of CommandType values.
+static const size_t CommandTypeCount = (size_t) CommandType::Draw + 1 ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A recorded command. Commands only hold raw pointers : the
+/// recorded objects must be alive until the buffer is executed.
+struct DLL_PUBLIC Command
+{
+    /// @brief What the command does.
+    CommandType type ;
+
+    /// @brief Type of the value for parameters commands.
+    HdwProgVarType vartype ;
+
+    /// @brief Parameter , block binding or material flag , depending on the type.
+    int param ;
+
+    /// @brief Offset of the value in the payload , or level of detail.
+    size_t offset ;
+
+    /// @brief Size of the value in the payload.
+    size_t size ;
+
+    /// @brief Object used by the command.
+    union
+    {
+        const Technique * technique ;
+        const Material * material ;
+        const Mesh * mesh ;
+    };
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A list of commands recorded without any renderer , and executed
+/// later by 'Renderer::execute()'.
+///
+/// Recording a buffer only reads the objects it is given , so several
+/// buffers can be recorded at the same time by different jobs , one per
+/// pass or per chunk of items. Buffers are then executed in order by the
+/// thread owning the render context. Parameters values and blocks are
+/// copied in the buffer's payload.
+///
+/// 'clear()' keeps the memory used , so a buffer recorded every frame
+/// does not allocate once its size is reached.
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC CommandBuffer
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    CommandBuffer () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records a CommandType::SetTechnique command.
+    //////////////////////////////////////////////////////////////////////
+    void setTechnique ( const Technique * technique ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records a CommandType::BindTechnique command.
+    //////////////////////////////////////////////////////////////////////
+    void bindTechnique ( const Technique * technique ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records a CommandType::UnbindTechnique command.
+    //////////////////////////////////////////////////////////////////////
+    void unbindTechnique () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records a CommandType::SetParameter command.
+    //////////////////////////////////////////////////////////////////////
+    void setParameter ( const TechniqueParam & param , const HdwProgVarType & type , const RealProgramVariable & value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records a CommandType::SetLightParameter command.
+    //////////////////////////////////////////////////////////////////////
+    void setLightParameter ( const TechniqueParam & member , const HdwProgVarType & type , const RealProgramVariable & value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records a CommandType::SetUniformBlock command. The block
+    /// must have the layout of the technique's one.
+    //////////////////////////////////////////////////////////////////////
+    void setUniformBlock ( const UniformBlockBinding & binding , const UniformBlock & block ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records a CommandType::UseMaterial command.
+    //////////////////////////////////////////////////////////////////////
+    void useMaterial ( const Material * material ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records a CommandType::ResetLights command.
+    //////////////////////////////////////////////////////////////////////
+    void resetLights () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records a CommandType::ResetTechnique command.
+    //////////////////////////////////////////////////////////////////////
+    void resetTechnique () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records a CommandType::DrawMesh command.
+    //////////////////////////////////////////////////////////////////////
+    void drawMesh ( const Mesh * mesh , bool hasmaterial , size_t lod ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records a CommandType::Draw command.
+    //////////////////////////////////////////////////////////////////////
+    void draw () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes every commands , keeping the memory used.
+    //////////////////////////////////////////////////////////////////////
+    void clear () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the recorded commands.
+    //////////////////////////////////////////////////////////////////////
+    const std::vector < Command > & getCommands () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the payload's bytes at given offset.
+    //////////////////////////////////////////////////////////////////////
+    const char* getPayload ( size_t offset ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the value of a parameter command.
+    //////////////////////////////////////////////////////////////////////
+    RealProgramVariable getValue ( const Command & command ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the size of the payload , in bytes.
+    //////////////////////////////////////////////////////////////////////
+    size_t getPayloadSize () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of draw commands ( DrawMesh and Draw ).
+    //////////////////////////////////////////////////////////////////////
+    size_t getDrawsCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if no command is recorded.
+    //////////////////////////////////////////////////////////////////////
+    bool isEmpty () const ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Appends a command of given type , and returns it.
+    //////////////////////////////////////////////////////////////////////
+    Command & iAppend ( const CommandType & type ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Copies bytes at the end of the payload , aligned on 16 bytes ,
+    /// and returns their offset.
+    //////////////////////////////////////////////////////////////////////
+    size_t iPush ( const void * data , size_t size ) ;
+
+protected:
+
+    /// @brief Recorded commands.
+    std::vector < Command > iCommands ;
+
+    /// @brief Values and blocks copied by the commands.
+    std::vector < char > iPayload ;
+
+    /// @brief Number of draw commands.
+    size_t iDraws ;
+};
+
+/// @brief A list of command buffers , executed in order.
+typedef std::vector < CommandBuffer > CommandBufferList ;
+
+GreEndNamespace
+
+#endif // GRE_COMMANDBUFFER_H
@@ -85,6 +85,8 @@ enum class EventType
 
     PositionChanged , DirectionChanged ,
 
+    OverlapBegin , OverlapEnd ,
+
     Custom
 };
 
@@ -824,6 +826,61 @@ public:
     Vector3 Direction ;
 };
 
+//////////////////////////////////////////////////////////////////////
+/// @brief OverlapBegin Event .
+/// Sent by a Broadphase when the bounding boxes of two objects start
+/// overlapping. The objects are only guaranteed to be valid while the
+/// event is processed.
+//////////////////////////////////////////////////////////////////////
+class OverlapBeginEvent : public Event
+{
+public:
+
+    POOLED(Pools::Event)
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    OverlapBeginEvent ( const EventProceeder* emitter , const EventProceeder* first , const EventProceeder* second ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Clones the Event .
+    //////////////////////////////////////////////////////////////////////
+    Event* clone () const ;
+
+    /// @brief First object of the pair.
+    const EventProceeder* First ;
+
+    /// @brief Second object of the pair.
+    const EventProceeder* Second ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief OverlapEnd Event .
+/// Sent by a Broadphase when the bounding boxes of two objects stop
+/// overlapping , or when one of them is removed.
+//////////////////////////////////////////////////////////////////////
+class OverlapEndEvent : public Event
+{
+public:
+
+    POOLED(Pools::Event)
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    OverlapEndEvent ( const EventProceeder* emitter , const EventProceeder* first , const EventProceeder* second ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Clones the Event .
+    //////////////////////////////////////////////////////////////////////
+    Event* clone () const ;
+
+    /// @brief First object of the pair.
+    const EventProceeder* First ;
+
+    /// @brief Second object of the pair.
+    const EventProceeder* Second ;
+};
+
 //////////////////////////////////////////////////////////////////////
 /// @brief A Custom Event .
 //////////////////////////////////////////////////////////////////////
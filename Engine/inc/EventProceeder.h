@@ -296,6 +296,14 @@ protected:
     //////////////////////////////////////////////////////////////////////
     virtual void onDirectionChangedEvent ( const DirectionChangedEvent& e ) ;
 
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void onOverlapBeginEvent ( const OverlapBeginEvent& e ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void onOverlapEndEvent ( const OverlapEndEvent& e ) ;
+
     //////////////////////////////////////////////////////////////////////
     //////////////////////////////////////////////////////////////////////
     virtual void onCustomEvent ( const CustomEvent & e ) ;
@@ -238,6 +238,14 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual const Projection & getProjection () const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Copies given attachment of the source framebuffer to the same
+    /// attachment of this framebuffer. Both attachments must have the same
+    /// size and format. The default implementation does nothing.
+    /// @return True on success , otherwise false.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool copy ( const RenderFramebuffer & source , const RenderFramebufferAttachement & attachment ) const ;
+
 protected:
 
     //////////////////////////////////////////////////////////////////////
@@ -0,0 +1,213 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  FrameGraph.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_FRAMEGRAPH_H
+#define GRE_FRAMEGRAPH_H
+
+#include "RenderPass.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Describes a transient target of a FrameGraph.
+//////////////////////////////////////////////////////////////////////
+struct FrameGraphTarget
+{
+    /// @brief Size of the texture , in pixels.
+    int width ;
+    int height ;
+
+    /// @brief Formats of the texture.
+    PixelFormat format ;
+    InternalPixelFormat internalformat ;
+    PixelType type ;
+
+    FrameGraphTarget () ;
+
+    FrameGraphTarget (int w , int h ,
+                      const PixelFormat & pf ,
+                      const InternalPixelFormat & ipf ,
+                      const PixelType & pt ) ;
+
+    /// @brief Returns the size of a texture made from this target , in bytes.
+    size_t getBytes () const ;
+
+    /// @brief True if textures made from both targets are interchangeable.
+    bool operator == ( const FrameGraphTarget & rhs ) const ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Counters of the last frame compiled by a FrameGraph.
+//////////////////////////////////////////////////////////////////////
+struct FrameGraphStats
+{
+    /// @brief Passes executed.
+    size_t passes ;
+
+    /// @brief Passes culled because nothing used their outputs.
+    size_t culled ;
+
+    /// @brief Transient targets used by the executed passes.
+    size_t targets ;
+
+    /// @brief Textures allocated to hold those targets.
+    size_t textures ;
+
+    /// @brief Size of the transient targets if none were aliased , in bytes.
+    size_t transientBytes ;
+
+    /// @brief Highest size of the transient targets alive at the same time ,
+    /// in bytes. This is the render-target memory used by the frame.
+    size_t peakBytes ;
+
+    FrameGraphStats () : passes ( 0 ) , culled ( 0 ) , targets ( 0 ) , textures ( 0 ) , transientBytes ( 0 ) , peakBytes ( 0 ) { }
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Orders the passes of a frame from the targets they read and
+/// write , and allocates the transient targets.
+///
+/// A pass reading a target is executed after every other pass writing
+/// it , and passes writing the same target keep their given order. The
+/// passes ready at the same time also keep their given order , so a
+/// pipeline without any target is executed as before.
+///
+/// Only passes needed to draw the frame are executed : those writing no
+/// target ( they draw to their technique's framebuffer ) , those writing
+/// an imported target , and the passes writing a target they read.
+///
+/// Transient targets live from the first to the last executed pass using
+/// them. Their textures come from a pool kept between frames : a texture
+/// is given to another target with the same description once the
+/// lifetime of its target is over. Textures not used by a frame are
+/// released.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC FrameGraph
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Creates the graph. Textures are named after 'name'.
+    //////////////////////////////////////////////////////////////////////
+    FrameGraph ( const std::string & name ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~FrameGraph () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Declares a transient target , allocated by the graph.
+    //////////////////////////////////////////////////////////////////////
+    void addTarget ( const std::string & name , const FrameGraphTarget & target ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Declares a target held by the user. Passes writing it are
+    /// always executed.
+    //////////////////////////////////////////////////////////////////////
+    void importTarget ( const std::string & name , const TextureHolder & texture ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes a target.
+    //////////////////////////////////////////////////////////////////////
+    void removeTarget ( const std::string & name ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes every targets and releases the textures.
+    //////////////////////////////////////////////////////////////////////
+    void clear () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if no target is declared.
+    //////////////////////////////////////////////////////////////////////
+    bool empty () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Orders and culls given passes , and gives the textures of
+    /// their targets. Returns the passes to execute , in order. If the
+    /// passes depend on each others , they are all returned in the given
+    /// order.
+    //////////////////////////////////////////////////////////////////////
+    std::vector < const RenderPass * > compile ( const std::vector < const RenderPass * > & passes ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the counters of the last 'compile()'.
+    //////////////////////////////////////////////////////////////////////
+    const FrameGraphStats & getStats () const ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the index of the passes in execution order , or an
+    /// empty list if they depend on each others.
+    //////////////////////////////////////////////////////////////////////
+    std::vector < size_t > sort ( const std::vector < const RenderPass * > & passes ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns a free texture of the pool matching given target ,
+    /// or creates one.
+    //////////////////////////////////////////////////////////////////////
+    size_t acquire ( const FrameGraphTarget & target ) ;
+
+protected:
+
+    /// @brief A texture of the pool.
+    struct PoolEntry
+    {
+        FrameGraphTarget target ;
+        TextureHolder texture ;
+        bool used ;
+        bool free ;
+    };
+
+    /// @brief Name of the graph.
+    std::string iName ;
+
+    /// @brief Transient targets.
+    std::map < std::string , FrameGraphTarget > iTargets ;
+
+    /// @brief Imported targets.
+    std::map < std::string , TextureHolder > iImported ;
+
+    /// @brief Textures of the transient targets.
+    std::vector < PoolEntry > iPool ;
+
+    /// @brief Number of textures created , to name them.
+    size_t iCreated ;
+
+    /// @brief Counters of the last frame.
+    FrameGraphStats iStats ;
+};
+
+GreEndNamespace
+
+#endif // GRE_FRAMEGRAPH_H
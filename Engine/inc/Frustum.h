@@ -0,0 +1,107 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  Frustum.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 14/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_FRUSTUM_H
+#define GRE_FRUSTUM_H
+
+#include "BoundingBox.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Six planes volume extracted from a projection-view matrix.
+///
+/// Planes are stored in the order left , right , bottom , top , near
+/// and far. Each plane is normalized and its normal points inside the
+/// volume , so a point is inside the frustum when its signed distance
+/// to every plane is positive.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC Frustum
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Constructs a frustum which contains everything.
+    //////////////////////////////////////////////////////////////////////
+    Frustum () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Constructs the frustum from given projection-view matrix.
+    //////////////////////////////////////////////////////////////////////
+    Frustum ( const Matrix4 & projectionview ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Extracts the planes from given projection-view matrix.
+    //////////////////////////////////////////////////////////////////////
+    void set ( const Matrix4 & projectionview ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the plane at given index ( between 0 and 5 ).
+    //////////////////////////////////////////////////////////////////////
+    const Plane & getPlane ( int index ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes the plane at given index : the frustum is unbounded
+    /// in its direction. Removing the near plane of a light's frustum keeps
+    /// the objects between the light and the near plane , which cast shadows
+    /// in the frustum.
+    //////////////////////////////////////////////////////////////////////
+    void disablePlane ( int index ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if given point is inside the frustum.
+    //////////////////////////////////////////////////////////////////////
+    bool contains ( const Vector3 & point ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the intersection between the frustum and given
+    /// bounding box. 'Inside' means the box is fully in the frustum. An
+    /// invalid bounding box is always 'Outside'.
+    //////////////////////////////////////////////////////////////////////
+    IntersectionResult intersect ( const BoundingBox & bbox ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the intersection between the frustum and given
+    /// sphere.
+    //////////////////////////////////////////////////////////////////////
+    IntersectionResult intersect ( const Vector3 & center , float radius ) const ;
+
+protected:
+
+    /// @brief Planes of the frustum , as ( normal , distance ).
+    Plane iPlanes [6] ;
+};
+
+GreEndNamespace
+
+#endif // GRE_FRUSTUM_H
@@ -0,0 +1,96 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  GlslReflection.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_GLSLREFLECTION_H
+#define GRE_GLSLREFLECTION_H
+
+#include "HardwareProgramVariable.h"
+#include "HardwareShader.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Returns the HdwProgVarType for a GLSL type name , as 'vec3' or
+/// 'sampler2DShadow'. Unknown types return HdwProgVarType::None.
+//////////////////////////////////////////////////////////////////////
+DLL_PUBLIC HdwProgVarType HdwProgVarTypeFromGlsl ( const std::string & type ) ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Returns the source with its '#include path' directives replaced
+/// by the content of the files.
+//////////////////////////////////////////////////////////////////////
+DLL_PUBLIC std::string GlslExpandIncludes ( const std::string & source ) ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Uniforms , uniform blocks and vertex attributes declared by
+/// GLSL sources , for backends without a GLSL compiler.
+///
+/// Only the global scope is read. Structures and arrays are expanded as
+/// a driver names them ( 'lights[0].position' ) , simple '#define' are
+/// replaced , and 'layout ( location = N )' is honoured for attributes.
+/// Other locations are given in declaration order. Unlike a driver , unused
+/// uniforms are also listed.
+//////////////////////////////////////////////////////////////////////
+struct DLL_PUBLIC GlslReflection
+{
+    /// @brief Uniforms found , by name.
+    std::map < std::string , HardwareProgramVariable > uniforms ;
+
+    /// @brief Uniform blocks found , with their index.
+    std::map < std::string , int > blocks ;
+
+    /// @brief Vertex attributes found , with their location.
+    std::map < std::string , int > attributes ;
+
+    /// @brief Location given to the next uniform.
+    int nextUniform ;
+
+    /// @brief Index given to the next uniform block.
+    int nextBlock ;
+
+    /// @brief Location given to the next attribute without layout.
+    int nextAttribute ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    GlslReflection () : nextUniform ( 0 ) , nextBlock ( 0 ) , nextAttribute ( 0 ) { }
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Reads the declarations of a shader's source. Attributes are
+    /// only read from vertex shaders.
+    //////////////////////////////////////////////////////////////////////
+    void reflect ( const ShaderType & type , const std::string & source ) ;
+};
+
+GreEndNamespace
+
+#endif // GRE_GLSLREFLECTION_H
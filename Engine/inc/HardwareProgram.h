@@ -38,6 +38,7 @@
 #include "HardwareShader.h"
 #include "HardwareProgramVariables.h"
 #include "VertexDescriptor.h"
+#include "UniformBlock.h"
 
 GreBeginNamespace
 
@@ -170,6 +171,23 @@ public:
                                   size_t stride ,
                                   void * pointer) const = 0 ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Binds the attribute at given location , returned by
+    /// 'getAttribLocation()'. The default implementation looks for the
+    /// attribute's name and calls the function above.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setVertexAttrib (int location ,
+                                  size_t elements ,
+                                  VertexAttribType type ,
+                                  bool normalize ,
+                                  size_t stride ,
+                                  void * pointer) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the location of given attribute , or -1.
+    //////////////////////////////////////////////////////////////////////
+    virtual int getAttribLocation ( const std::string & name ) const ;
+
     //////////////////////////////////////////////////////////////////////
     /// @brief Disables every vertex attributes present in the program .
     //////////////////////////////////////////////////////////////////////
@@ -204,11 +222,50 @@ public:
 	//////////////////////////////////////////////////////////////////////
 	virtual bool setUniform ( const HardwareProgramVariable & variable ) const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Sets a uniform from a location returned by 'findUniform()' ,
+    /// without looking for its name. '_setUniform()' is only called when the
+    /// value differs from the last one set at this location.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool setUniform ( int location , const HdwProgVarType & type , const RealProgramVariable & value ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Finds the location and the type of a uniform. Returns false
+    /// if the program has no uniform with this name.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool findUniform ( const std::string & name , int & location , HdwProgVarType & type ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns a number changed every time the program is linked or
+    /// reset. Locations found before a change are not valid anymore.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getLinkVersion () const ;
+
 	//////////////////////////////////////////////////////////////////////
 	/// @brief Internally sets the uniform to the program object.
 	//////////////////////////////////////////////////////////////////////
 	virtual bool _setUniform ( int location , const HdwProgVarType & type , const RealProgramVariable & value ) const = 0 ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if the program declares the uniform block for
+    /// given binding.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool hasUniformBlock ( const UniformBlockBinding & binding ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Binds the block staged at given offset in the arena. Binding
+    /// points are shared by every programs : '_setUniformBlock()' is only
+    /// called when another range was bound at this binding.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool setUniformBlock ( const UniformBlockBinding & binding , const UniformArena & arena , size_t offset , size_t size ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Internally uploads the bytes staged in the arena and binds the
+    /// given range to the binding. The default implementation returns false ,
+    /// and the engine sets the uniforms one by one.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool _setUniformBlock ( int index , const UniformBlockBinding & binding , const UniformArena & arena , size_t offset , size_t size ) const ;
+
     // ---------------------------------------------------------------------------------------------------
     // Utilities
 
@@ -218,6 +275,29 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual unsigned int getMaximumLights () const = 0 ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of uniforms set by every programs since
+    /// the last 'ResetUniformCalls()'.
+    //////////////////////////////////////////////////////////////////////
+    static size_t GetUniformCalls () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of uniforms not sent to the program since
+    /// the last 'ResetUniformCalls()' , because their value didn't change.
+    //////////////////////////////////////////////////////////////////////
+    static size_t GetUniformHits () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of uniforms sent to the program since the
+    /// last 'ResetUniformCalls()'.
+    //////////////////////////////////////////////////////////////////////
+    static size_t GetUniformMisses () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Resets the uniforms counters , usually once per frame.
+    //////////////////////////////////////////////////////////////////////
+    static void ResetUniformCalls () ;
+
 protected:
 
     /// @brief Shaders attached to this program. As a program can have only
@@ -242,6 +322,20 @@ protected:
     /// every uniforms are cached into this map when linking the program. Notes, their value is not
     /// cached. Only name, location (i.e. shader index) and type are stored.
     std::map < std::string , HardwareProgramVariable > iUniforms ;
+
+    /// @brief Incremented every time the program is linked or reset.
+    size_t iLinkVersion ;
+
+    /// @brief Last value sent to the program for each location. Only 'type' and 'value'
+    /// are used : a variable with type None was never sent.
+    mutable std::vector < HardwareProgramVariable > iShadowVariables ;
+
+    /// @brief Uniform blocks loaded when linking the program : name / index. Filled
+    /// by the backend in '_finalize()'.
+    std::map < std::string , int > iUniformBlocks ;
+
+    /// @brief Index of the block declared for each binding , or -1.
+    int iBlockIndexes [UniformBlockBindingCount] ;
 };
 
 /// @brief Holder for HardwareProgramPrivate.
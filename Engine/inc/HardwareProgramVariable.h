@@ -61,6 +61,10 @@ enum class HdwProgVarType
 /// @brief Returns the HdwProgVarType from string.
 HdwProgVarType HdwProgVarTypeFromString ( const std::string & type );
 
+/// @brief Returns the number of bytes used by a value of given type in a
+/// RealProgramVariable. Samplers are stored as a texture unit ( int ).
+size_t HdwProgVarTypeGetSize ( const HdwProgVarType & type );
+
 //////////////////////////////////////////////////////////////////////
 /// @brief Defines real types in a union to hold every variable types
 /// possibles.
@@ -0,0 +1,128 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  JobPool.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 16/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_JOBPOOL_H
+#define GRE_JOBPOOL_H
+
+#include "Pools.h"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A fixed set of worker threads executing short jobs.
+///
+/// The pool is made for CPU work that can be split in independent
+/// chunks , as culling or geometry processing. Jobs must not block on
+/// events from other jobs , except through 'parallelFor()' which lets
+/// the calling thread execute the remaining chunks itself. This way ,
+/// 'parallelFor()' can be called from a job without dead-locking the
+/// pool.
+///
+/// A global pool is available through 'JobPool::Get()'. It uses one
+/// thread less than the hardware concurrency , as the calling thread
+/// also works during 'parallelFor()'.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC JobPool
+{
+public:
+
+    /// @brief A job executed on a range of items , from 'begin' to 'end' ( excluded ).
+    typedef std::function < void ( size_t , size_t ) > RangeJob ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the global pool.
+    //////////////////////////////////////////////////////////////////////
+    static JobPool & Get () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Creates a pool with given number of threads. Zero uses the
+    /// hardware concurrency minus one.
+    //////////////////////////////////////////////////////////////////////
+    JobPool ( size_t threads = 0 ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Waits for the queued jobs and joins every threads.
+    //////////////////////////////////////////////////////////////////////
+    ~JobPool () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Queues a job and returns a future to wait for it.
+    //////////////////////////////////////////////////////////////////////
+    std::future < void > submit ( const std::function < void () > & job ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Splits 'count' items in chunks of 'grain' items and runs
+    /// 'job' for each chunk , using the pool and the calling thread. This
+    /// function returns when every chunk has been processed. If a chunk
+    /// throws , the other chunks are still processed and the first exception
+    /// is thrown again by this function.
+    //////////////////////////////////////////////////////////////////////
+    void parallelFor ( size_t count , size_t grain , const RangeJob & job ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of worker threads.
+    //////////////////////////////////////////////////////////////////////
+    size_t getThreadsCount () const ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Main function for every worker threads.
+    //////////////////////////////////////////////////////////////////////
+    void workerMain () ;
+
+protected:
+
+    /// @brief Worker threads.
+    std::vector < std::thread > iThreads ;
+
+    /// @brief Jobs waiting for a worker.
+    std::queue < std::packaged_task < void () > > iJobs ;
+
+    /// @brief Protects 'iJobs' and 'iStopping'.
+    std::mutex iMutex ;
+
+    /// @brief Wakes workers when a job is queued or when stopping.
+    std::condition_variable iCondition ;
+
+    /// @brief True when the pool is being destroyed.
+    bool iStopping ;
+};
+
+GreEndNamespace
+
+#endif // GRE_JOBPOOL_H
@@ -0,0 +1,190 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  LightAssignment.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 14/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_LIGHTASSIGNMENT_H
+#define GRE_LIGHTASSIGNMENT_H
+
+#include "RenderNode.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Assigns a bounded list of lights to each drawn node.
+///
+/// The assignment is prepared once per pass from the lights visible by
+/// the camera ( see 'RenderScene::lights()' ). Light positions and radius
+/// are copied at this time , so assigning lights to a node does not lock
+/// any light node.
+///
+/// Unbounded lights ( with no radius ) always come first , as they reach
+/// every node. Bounded lights are then sorted by distance to the node's
+/// bounding box , and only the lights actually reaching the box are kept.
+/// The list is never longer than 'iMaxLights' , so the renderpass binds
+/// or iterates only the lights relevant to the node.
+///
+/// When there are many bounded lights , 'prepare()' also sorts them in a
+/// uniform grid , so a node only tests the lights of the cells its box
+/// overlaps instead of every light.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC LightAssignment
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    LightAssignment () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~LightAssignment () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Caches the given lights. 'maxlights' is the maximum number
+    /// of lights a node can receive.
+    //////////////////////////////////////////////////////////////////////
+    void prepare ( const RenderNodeHolderList & lights , size_t maxlights ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Caches the lights of a snapshot. Use the 'assign()' version
+    /// returning indexes with it.
+    //////////////////////////////////////////////////////////////////////
+    void prepare ( const std::vector < RenderSnapshotLight > & lights , size_t maxlights ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Fills 'result' with the lights reaching the given world-space
+    /// bounding box. An invalid bounding box receives every light , still
+    /// bounded by 'iMaxLights'.
+    //////////////////////////////////////////////////////////////////////
+    void assign ( const BoundingBox & bbox , RenderNodeHolderList & result ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Same as above , but fills 'result' with the indexes of the
+    /// lights in the list given to 'prepare()'.
+    //////////////////////////////////////////////////////////////////////
+    void assign ( const BoundingBox & bbox , std::vector < size_t > & result ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of lights cached by 'prepare()'.
+    //////////////////////////////////////////////////////////////////////
+    size_t getLightsCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns 'iMaxLights'.
+    //////////////////////////////////////////////////////////////////////
+    size_t getMaximumLights () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Releases every cached lights.
+    //////////////////////////////////////////////////////////////////////
+    void clear () ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Fills 'iSelected' with the lights reaching the bounding box.
+    //////////////////////////////////////////////////////////////////////
+    void select ( const BoundingBox & bbox ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Sorts the bounded lights in the grid. Leaves the grid empty
+    /// when there are too few lights to need one.
+    //////////////////////////////////////////////////////////////////////
+    void buildGrid () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Computes the first ( 'cells [0..2]' ) and last ( 'cells [3..5]' )
+    /// cells overlapped by the given box , clamped to the grid.
+    //////////////////////////////////////////////////////////////////////
+    void computeCells ( const Vector3 & min , const Vector3 & max , int cells [6] ) const ;
+
+protected:
+
+    /// @brief Light as cached by 'prepare()'.
+    struct Entry
+    {
+        /// @brief The light node. Invalid for snapshot lights.
+        RenderNodeHolder light ;
+
+        /// @brief Index of the light in the list given to 'prepare()'.
+        size_t index ;
+
+        /// @brief World-space position of the light.
+        Vector3 position ;
+
+        /// @brief Squared radius of the light.
+        float radius2 ;
+    };
+
+    /// @brief Lights with no radius.
+    std::vector < Entry > iUnbounded ;
+
+    /// @brief Lights with a radius.
+    std::vector < Entry > iBounded ;
+
+    /// @brief Maximum number of lights assigned to a node.
+    size_t iMaxLights ;
+
+    /// @brief Scratch buffer used to sort the bounded lights by distance. Reused by every
+    /// call to 'assign()' to avoid allocations.
+    mutable std::vector < std::pair < float , size_t > > iCandidates ;
+
+    /// @brief Entries selected by the last call to 'select()'.
+    mutable std::vector < const Entry * > iSelected ;
+
+    /// @brief Lower corner of the grid , enclosing every bounded light sphere.
+    Vector3 iGridMin ;
+
+    /// @brief Size of a grid cell.
+    float iGridCellSize ;
+
+    /// @brief Number of cells on each axis.
+    int iGrid [3] ;
+
+    /// @brief Cell 'c' holds the lights 'iGridLights [iGridStarts [c]]' to
+    /// 'iGridLights [iGridStarts [c + 1]]' ( excluded ). Empty if there is no grid.
+    std::vector < size_t > iGridStarts ;
+
+    /// @brief Indexes in 'iBounded' of the lights of every cell.
+    std::vector < size_t > iGridLights ;
+
+    /// @brief Last query which tested each bounded light , as a light overlapping
+    /// several cells is found several times.
+    mutable std::vector < uint32_t > iGridVisits ;
+
+    /// @brief Number of grid queries made since 'iGridVisits' was reset.
+    mutable uint32_t iGridQuery ;
+};
+
+GreEndNamespace
+
+#endif // GRE_LIGHTASSIGNMENT_H
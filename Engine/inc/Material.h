@@ -169,6 +169,12 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual void use ( const TechniqueHolder & technique ) const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the Material uniform block. It is packed again only
+    /// when the material was modified since the last call.
+    //////////////////////////////////////////////////////////////////////
+    virtual const UniformBlock & getUniformBlock () const ;
+
     //////////////////////////////////////////////////////////////////////
     /// @brief Sets 'iUseTextures' .
     //////////////////////////////////////////////////////////////////////
@@ -223,6 +229,12 @@ private:
     /// @brief True if this material should use lights technique parameters instead of materials parameters. This
     /// should be the case when the material is an emissive one , used mainly for lights.
     bool iEmissive ;
+
+    /// @brief Colors and shininess packed for the Material uniform block.
+    mutable UniformBlock iBlock ;
+
+    /// @brief True if a color or the shininess changed since 'iBlock' was packed.
+    mutable bool iBlockDirty ;
 };
 
 /// @brief Holder for MaterialPrivate.
@@ -0,0 +1,216 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  MatrixCache.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 27/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_MATRIXCACHE_H
+#define GRE_MATRIXCACHE_H
+
+#include "RenderNode.h"
+
+#include <unordered_map>
+#include <atomic>
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Matrices of a node seen from a camera.
+//////////////////////////////////////////////////////////////////////
+struct NodeMatrices
+{
+    /// @brief Model matrix of the node.
+    Matrix4 model ;
+
+    /// @brief View matrix times model matrix.
+    Matrix4 modelview ;
+
+    /// @brief Projection , view and model matrices product.
+    Matrix4 projectionviewmodel ;
+
+    /// @brief Inverse-transpose of the 3x3 part of 'model * view' , as the
+    /// passes always bound it.
+    Matrix3 normal ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Counters of a MatrixCache.
+//////////////////////////////////////////////////////////////////////
+struct MatrixCacheStats
+{
+    /// @brief Nodes whose matrices were computed.
+    size_t computed ;
+
+    /// @brief Nodes whose matrices were reused.
+    size_t reused ;
+
+    /// @brief Normal matrices computed without inverting , as the node's
+    /// scale was uniform.
+    size_t uniform ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Remembers the matrices of nodes for the last cameras.
+///
+/// 'begin()' selects the camera , given by its view and projection
+/// matrices. 'prepare()' computes the matrices of every given node
+/// which changed since the last time this camera saw it , splitting the
+/// work among the JobPool for long lists. 'get()' then returns them ,
+/// computing the missing ones.
+///
+/// A node's matrices stay valid while its visibility version and the
+/// camera do not change. Nodes not seen by a camera during a frame are
+/// forgotten by its next 'begin()'. When every camera slot is used ,
+/// the least recently used one is replaced.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC MatrixCache
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    MatrixCache ( size_t cameras = 4 ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~MatrixCache () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Selects the slot of given camera , or a new one.
+    //////////////////////////////////////////////////////////////////////
+    void begin ( const Matrix4 & view , const Matrix4 & projection ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Computes the matrices of the nodes which are not up to date
+    /// in the current slot.
+    //////////////////////////////////////////////////////////////////////
+    void prepare ( const RenderNodeHolderList & nodes ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Same as above.
+    //////////////////////////////////////////////////////////////////////
+    void prepare ( const std::vector < const RenderNode * > & nodes ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the matrices of given node in the current slot.
+    //////////////////////////////////////////////////////////////////////
+    const NodeMatrices & get ( const RenderNode * node ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the projection matrix of the current slot.
+    //////////////////////////////////////////////////////////////////////
+    const Matrix4 & getProjection () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Forgets every slots.
+    //////////////////////////////////////////////////////////////////////
+    void clear () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the counters.
+    //////////////////////////////////////////////////////////////////////
+    const MatrixCacheStats & getStats () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Resets the counters.
+    //////////////////////////////////////////////////////////////////////
+    void resetStats () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Computes the matrices of a node from its model matrix.
+    /// Returns true if the normal matrix was computed without inverting.
+    //////////////////////////////////////////////////////////////////////
+    static bool Compute ( const Matrix4 & model , const Matrix4 & view ,
+                          const Matrix4 & projectionview , NodeMatrices & result ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the inverse-transpose of given matrix. When its
+    /// columns are orthogonal and have the same length , as for rotations
+    /// with an uniform scale , this is the matrix divided by the squared
+    /// length and no inverse is computed.
+    //////////////////////////////////////////////////////////////////////
+    static Matrix3 NormalMatrix ( const Matrix3 & matrix , bool * uniform = nullptr ) ;
+
+protected:
+
+    /// @brief Matrices of one node.
+    struct Entry
+    {
+        NodeMatrices matrices ;
+        uint64_t version ;
+        uint64_t frame ;
+    };
+
+    /// @brief Matrices for one camera.
+    struct Slot
+    {
+        Matrix4 view ;
+        Matrix4 projection ;
+        Matrix4 projectionview ;
+        uint64_t lastuse ;
+        uint64_t frame ;
+        std::unordered_map < const RenderNode * , Entry > entries ;
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds the node to 'iPending' if its entry is not up to date ,
+    /// and marks the entry as used.
+    //////////////////////////////////////////////////////////////////////
+    void schedule ( const RenderNode * node ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Computes the pending entries.
+    //////////////////////////////////////////////////////////////////////
+    void computePending () ;
+
+protected:
+
+    /// @brief Camera slots.
+    std::vector < Slot > iSlots ;
+
+    /// @brief Slot selected by 'begin()' , or -1.
+    int iCurrent ;
+
+    /// @brief Maximum number of slots.
+    size_t iCapacity ;
+
+    /// @brief Incremented by each 'begin()'.
+    uint64_t iUses ;
+
+    /// @brief Entries to compute , with the model matrix read from their node.
+    std::vector < std::pair < Entry * , Matrix4 > > iPending ;
+
+    /// @brief Counters.
+    MatrixCacheStats iStats ;
+};
+
+GreEndNamespace
+
+#endif // GRE_MATRIXCACHE_H
@@ -89,6 +89,36 @@ public:
     //////////////////////////////////////////////////////////////////////
     const HardwareIndexBufferHolder & getIndexBuffer () const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds an index buffer for the next level of detail. Every
+    /// level uses the same vertex buffers as the submesh.
+    //////////////////////////////////////////////////////////////////////
+    void addLodIndexBuffer ( const HardwareIndexBufferHolder & buffer ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the index buffer for given level. Level zero is the
+    /// full detail index buffer.
+    //////////////////////////////////////////////////////////////////////
+    const HardwareIndexBufferHolder & getLodIndexBuffer ( size_t level ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of levels of detail , including the full
+    /// detail one.
+    //////////////////////////////////////////////////////////////////////
+    size_t getLodCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes every level of detail but the full detail one.
+    //////////////////////////////////////////////////////////////////////
+    void clearLodIndexBuffers () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Selects the level returned by 'getIndexBuffer()'. Used by
+    /// the mesh while it is bound , levels out of range use the coarsest
+    /// level available.
+    //////////////////////////////////////////////////////////////////////
+    void selectLod ( size_t level ) const ;
+
     //////////////////////////////////////////////////////////////////////
     //////////////////////////////////////////////////////////////////////
     void addVertexBuffer ( const HardwareVertexBufferHolder & buffer ) ;
@@ -132,6 +162,14 @@ protected:
     /// @brief Holds the index buffer to render the sub-mesh.
     HardwareIndexBufferHolder iIndexBuffer ;
 
+    /// @brief Index buffers for the coarser levels of detail , from the most detailed
+    /// to the least detailed.
+    std::vector < HardwareIndexBufferHolder > iLodIndexBuffers ;
+
+    /// @brief Level currently returned by 'getIndexBuffer()'. Zero when the mesh is not
+    /// being drawn.
+    mutable size_t iCurrentLod ;
+
     /// @brief Holds local vertex buffers.
     HardwareVertexBufferHolderList iVertexBuffers ;
 
@@ -293,6 +331,31 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual void setDefaultMaterial ( const MaterialHolder & material ) ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the highest number of levels of detail found in the
+    /// submeshes.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getLodCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the projected size under which given level is used.
+    /// The size is the bounding sphere radius divided by the half height
+    /// of the view at the sphere's distance.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setLodScreenSize ( size_t level , float size ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the projected size under which given level is used.
+    /// By default , level 'n' is used under '0.5^n'.
+    //////////////////////////////////////////////////////////////////////
+    virtual float getLodScreenSize ( size_t level ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Selects the level of detail used by 'bindNextSubMesh()'. The
+    /// level is reset to zero by 'unbind()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual void selectLod ( size_t level ) const ;
+
 protected:
 
     //////////////////////////////////////////////////////////////////////
@@ -353,6 +416,13 @@ protected:
     /// @brief Holds a copy of the submeshes list used by 'bindNextSubMesh()'. This copy is destroyed
     /// when 'unbind()' is called.
     mutable std::list < SubMeshHolder > iCurrentSubMeshList ;
+
+    /// @brief Projected sizes set by 'setLodScreenSize()' , indexed by level. Missing
+    /// or negative values use the default size.
+    std::vector < float > iLodScreenSizes ;
+
+    /// @brief Level of detail selected for the current drawing.
+    mutable size_t iCurrentLod ;
 };
 
 /// @brief Holder for Mesh .
@@ -389,6 +459,27 @@ public:
 /// @brief ResourceLoaderFactory for MeshLoader.
 typedef ResourceLoaderFactory < MeshLoader > MeshLoaderFactory ;
 
+//////////////////////////////////////////////////////////////////////
+/// @brief CPU data of a submesh given to 'MeshManager::generateLods()'.
+/// Positions must stay valid until the function returns.
+struct MeshLodSource
+{
+    /// @brief Submesh receiving the levels of detail.
+    SubMeshHolder submesh ;
+
+    /// @brief First position , made of three floats.
+    const void * positions ;
+
+    /// @brief Bytes between two positions.
+    size_t stride ;
+
+    /// @brief Number of positions.
+    size_t vertices ;
+
+    /// @brief Triangle list of the full detail level.
+    std::vector < unsigned int > indices ;
+};
+
 //////////////////////////////////////////////////////////////////////
 /// @brief Manages the Mesh loaded.
 //////////////////////////////////////////////////////////////////////
@@ -429,6 +520,19 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual HardwareIndexBufferHolder createIndexBuffer ( const void* data , size_t sz , const IndexDescriptor& desc ) const = 0 ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Generates levels of detail for the given submeshes , and adds
+    /// their index buffers to them. Simplification runs in parallel , one
+    /// submesh per job. Loaders call it at import time with their options :
+    ///   - 'mesh.lod.levels' ( int ) : maximum number of levels generated
+    ///     after the full detail one. Zero , the default , disables it.
+    ///   - 'mesh.lod.ratio' ( float ) : triangles kept from a level to the
+    ///     next one. Default is 0.5.
+    ///   - 'mesh.lod.error' ( float ) : maximum error , relative to the
+    ///     submesh's extent. Default is 0.05.
+    //////////////////////////////////////////////////////////////////////
+    virtual void generateLods ( const std::vector < MeshLodSource > & sources , const ResourceLoaderOptions & ops ) const ;
+
     //////////////////////////////////////////////////////////////////////
     /// @brief Loads a Bundled File. The subdirectory is computed from the
     /// object file extension. For example , an '.obj' file will be in subdir
@@ -0,0 +1,103 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  MeshSimplifier.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 16/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_MESHSIMPLIFIER_H
+#define GRE_MESHSIMPLIFIER_H
+
+#include "Pools.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Reduces the triangles of an indexed mesh using quadric error
+/// edge collapses.
+///
+/// The simplifier works on a CPU copy of the positions and only produces
+/// new index lists : every collapse moves a vertex onto one of its
+/// neighbours , so the vertex buffers are shared by every level of detail.
+/// Vertices sharing the same position ( as with split normals or texture
+/// seams ) are welded while simplifying , so seams do not open.
+///
+/// A simplifier is immutable once created and can be used from several
+/// threads at the same time.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC MeshSimplifier
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Creates a simplifier from 'count' positions of three floats ,
+    /// spaced by 'stride' bytes.
+    //////////////////////////////////////////////////////////////////////
+    MeshSimplifier ( const void * positions , size_t stride , size_t count ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~MeshSimplifier () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Simplifies the given triangle list until it has at most
+    /// 'target' indices , or until the next collapse would move the surface
+    /// further than 'maxerror' ( relative to the mesh's extent ).
+    //////////////////////////////////////////////////////////////////////
+    std::vector < unsigned int > simplify ( const std::vector < unsigned int > & indices ,
+                                            size_t target , float maxerror ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Builds up to 'levels' levels of detail , each one having
+    /// 'ratio' times the triangles of the previous one. The chain stops
+    /// early when a level can't be reduced anymore.
+    //////////////////////////////////////////////////////////////////////
+    std::vector < std::vector < unsigned int > > buildLods ( const std::vector < unsigned int > & indices ,
+                                                             size_t levels , float ratio , float maxerror ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of positions.
+    //////////////////////////////////////////////////////////////////////
+    size_t getVerticesCount () const ;
+
+protected:
+
+    /// @brief Positions copied from the source buffer.
+    std::vector < Vector3 > iPositions ;
+
+    /// @brief For each vertex , the first vertex found at the same position.
+    std::vector < unsigned int > iWelded ;
+
+    /// @brief Length of the positions bounding box diagonal.
+    float iExtent ;
+};
+
+GreEndNamespace
+
+#endif // GRE_MESHSIMPLIFIER_H
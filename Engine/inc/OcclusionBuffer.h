@@ -0,0 +1,207 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  OcclusionBuffer.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 16/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_OCCLUSIONBUFFER_H
+#define GRE_OCCLUSIONBUFFER_H
+
+#include "Mesh.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Counters reported by an occlusion culling stage.
+//////////////////////////////////////////////////////////////////////
+struct OcclusionStats
+{
+    /// @brief Number of occluders rasterized.
+    size_t occluders ;
+
+    /// @brief Number of occluder triangles rasterized , after clipping.
+    size_t triangles ;
+
+    /// @brief Number of bounding boxes tested.
+    size_t tested ;
+
+    /// @brief Number of bounding boxes found occluded.
+    size_t culled ;
+
+    OcclusionStats () : occluders ( 0 ) , triangles ( 0 ) , tested ( 0 ) , culled ( 0 ) { }
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Low-resolution depth buffer filled on the CPU with occluders.
+///
+/// Occluders triangles are transformed by the projection-view matrix
+/// given to 'clear()' , clipped against the near plane and binned into
+/// screen tiles. 'rasterize()' then fills each tile independently on the
+/// JobPool , and computes the farthest depth of every tile. This gives
+/// a two-level hierarchy : bounding boxes are first tested against the
+/// tiles , and only against the pixels of tiles that could hide them.
+///
+/// Depths are stored as normalized device z in [0 , 1] , 0 being the
+/// nearest. Pixels not covered by any occluder keep the far depth , so
+/// everything behind them stays visible.
+///
+/// Occluders should be smaller than the objects they represent : a
+/// box occluder hides everything behind the whole box.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC OcclusionBuffer
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Creates a buffer with given resolution , in pixels. The
+    /// resolution is rounded up to a multiple of the tile size.
+    //////////////////////////////////////////////////////////////////////
+    OcclusionBuffer ( int width = 256 , int height = 128 ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~OcclusionBuffer () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Clears depths and occluders , and sets the projection-view
+    /// matrix used by following calls.
+    //////////////////////////////////////////////////////////////////////
+    void clear ( const Matrix4 & projectionview ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds triangles from given model-space positions. If 'indices'
+    /// is null , positions are read three by three.
+    //////////////////////////////////////////////////////////////////////
+    void addTriangles ( const Vector3 * positions , size_t count ,
+                        const uint32_t * indices , size_t icount ,
+                        const Matrix4 & model ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds the triangles of the mesh. Only vertex buffers keeping
+    /// a CPU copy of their data ( 'getData()' not null ) with a float
+    /// position can be read.
+    /// @return false if no triangle could be read from the mesh.
+    //////////////////////////////////////////////////////////////////////
+    bool addMesh ( const MeshHolder & mesh , const Matrix4 & model ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds the twelve triangles of given world-space box.
+    //////////////////////////////////////////////////////////////////////
+    void addBox ( const BoundingBox & bbox ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Rasterizes every occluders added since 'clear()'.
+    //////////////////////////////////////////////////////////////////////
+    void rasterize () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns false if the world-space bounding box is fully
+    /// hidden by the occluders. Boxes crossing the near plane are always
+    /// visible.
+    //////////////////////////////////////////////////////////////////////
+    bool isVisible ( const BoundingBox & bbox ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of triangles binned since 'clear()'.
+    //////////////////////////////////////////////////////////////////////
+    size_t getTrianglesCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    int getWidth () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    int getHeight () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the depth at given pixel.
+    //////////////////////////////////////////////////////////////////////
+    float getDepth ( int x , int y ) const ;
+
+    /// @brief Size of a tile , in pixels.
+    static const int TileSize = 32 ;
+
+protected:
+
+    /// @brief A triangle in screen space , ready to be rasterized.
+    struct ScreenTriangle
+    {
+        /// @brief Screen positions and depth of the vertices.
+        Vector3 v [3] ;
+
+        /// @brief Clamped pixel bounds.
+        int minx , miny , maxx , maxy ;
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Clips the clip-space triangle against the near plane and
+    /// stores the resulting screen-space triangles.
+    //////////////////////////////////////////////////////////////////////
+    void addClipTriangle ( const Vector4 & a , const Vector4 & b , const Vector4 & c ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Stores a triangle whose vertices are in front of the near
+    /// plane.
+    //////////////////////////////////////////////////////////////////////
+    void addScreenTriangle ( const Vector4 & a , const Vector4 & b , const Vector4 & c ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Rasterizes every triangle binned in given tile.
+    //////////////////////////////////////////////////////////////////////
+    void rasterizeTile ( size_t tile ) ;
+
+protected:
+
+    /// @brief Resolution , in pixels.
+    int iWidth , iHeight ;
+
+    /// @brief Number of tiles on each axis.
+    int iTilesX , iTilesY ;
+
+    /// @brief Depth of every pixel , row by row.
+    std::vector < float > iDepths ;
+
+    /// @brief Farthest depth of every tile.
+    std::vector < float > iTileMaxDepths ;
+
+    /// @brief Projection-view matrix given to 'clear()'.
+    Matrix4 iProjectionView ;
+
+    /// @brief Triangles added since 'clear()'.
+    std::vector < ScreenTriangle > iTriangles ;
+
+    /// @brief For each tile , the index of the triangles overlapping it.
+    std::vector < std::vector < uint32_t > > iBins ;
+};
+
+GreEndNamespace
+
+#endif // GRE_OCCLUSIONBUFFER_H
@@ -0,0 +1,285 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  ParticleEmitter.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_PARTICLEEMITTER_H
+#define GRE_PARTICLEEMITTER_H
+
+#include "RenderNode.h"
+#include "Color.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Vertex written for each alive particle : a world position
+/// and a normalized color.
+struct ParticleVertex
+{
+    float position [3] ;
+    unsigned char color [4] ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A RenderNode simulating and drawing a particle system.
+///
+/// Particles are stored as structure of arrays : one float array per
+/// component ( position , velocity , age and lifetime ). Each kernel is
+/// a flat loop over those arrays without branches , which the compiler
+/// can vectorize , and runs on the JobPool in chunks of 'ChunkSize'
+/// particles. Alive particles are always kept at the front of the arrays.
+///
+/// Every update event , 'simulate()' integrates the particles , kills the
+/// old ones , emits the new ones and writes one vertex per particle in
+/// the next mesh of a small ring , so the buffer written is never the
+/// one the renderer may still be reading. Particles are drawn as points ,
+/// with one draw call per emitter.
+///
+/// Particles live in world space : moving the emitter only changes where
+/// new particles are born. Vertices are written relative to the node , so
+/// the model matrix used by the renderer gives back world positions.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC ParticleEmitter : public RenderNode
+{
+public:
+
+    /// @brief Number of particles processed by one job.
+    static const size_t ChunkSize = 16384 ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ParticleEmitter ( const RenderScene * creator , const std::string & name = std::string () , size_t capacity = 65536 ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~ParticleEmitter () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the maximum number of alive particles. Particles
+    /// past the new capacity are killed.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setCapacity ( size_t capacity ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the maximum number of alive particles.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getCapacity () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of alive particles.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the number of particles emitted per second.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setRate ( float rate ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of particles emitted per second.
+    //////////////////////////////////////////////////////////////////////
+    virtual float getRate () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the lifetime range of new particles , in seconds.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setLifetime ( float min , float max ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the speed range of new particles.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setSpeed ( float min , float max ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the direction of new particles. 'spread' goes from
+    /// 0 ( every particle follows the direction ) to 1 ( any direction ).
+    //////////////////////////////////////////////////////////////////////
+    virtual void setDirection ( const Vector3 & direction , float spread ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the radius of the sphere where particles are born ,
+    /// centered on the node's position.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setEmissionRadius ( float radius ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the acceleration applied to every particles.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setGravity ( const Vector3 & gravity ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the fraction of velocity lost per second.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setDamping ( float damping ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the color of particles at their birth and at their
+    /// death. Colors are interpolated over the particle's lifetime.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setColors ( const Color & begin , const Color & end ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Emits 'count' particles now , in addition to the rate. Returns
+    /// the number of particles really emitted.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t emit ( size_t count ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Advances the simulation by 'elapsed' seconds and writes the
+    /// vertices of the alive particles. Called by every update event.
+    //////////////////////////////////////////////////////////////////////
+    virtual void simulate ( float elapsed ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Kills every particles.
+    //////////////////////////////////////////////////////////////////////
+    virtual void clearParticles () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the vertices written by the last 'simulate()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual const std::vector < ParticleVertex > & getVertices () const ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Updates the node , then simulates the particles.
+    //////////////////////////////////////////////////////////////////////
+    virtual void onUpdateEvent ( const UpdateEvent & e ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Resizes the particles arrays to 'iCapacity'.
+    //////////////////////////////////////////////////////////////////////
+    void resize () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Moves and ages the particles in [begin , end).
+    //////////////////////////////////////////////////////////////////////
+    void integrate ( size_t begin , size_t end , float elapsed ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Moves the particles still alive in [begin , end) to the front
+    /// of the range , and returns their number.
+    //////////////////////////////////////////////////////////////////////
+    size_t compact ( size_t begin , size_t end ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Moves 'count' particles from 'source' to 'destination'.
+    //////////////////////////////////////////////////////////////////////
+    void move ( size_t destination , size_t source , size_t count ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Initializes new particles in [begin , end).
+    //////////////////////////////////////////////////////////////////////
+    void spawn ( size_t begin , size_t end , uint64_t seed ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Kills the dead particles , keeping alive ones contiguous.
+    //////////////////////////////////////////////////////////////////////
+    void kill () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Writes the vertices and computes the bounding box of the
+    /// alive particles.
+    //////////////////////////////////////////////////////////////////////
+    void write () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Copies the vertices to the next mesh of the ring and sets
+    /// it to this node.
+    //////////////////////////////////////////////////////////////////////
+    void upload () ;
+
+protected:
+
+    /// @brief Particles components , one array per component.
+    std::vector < float > iPositionX , iPositionY , iPositionZ ;
+    std::vector < float > iVelocityX , iVelocityY , iVelocityZ ;
+    std::vector < float > iAge , iLife ;
+
+    /// @brief Number of alive particles.
+    size_t iCount ;
+
+    /// @brief Maximum number of alive particles.
+    size_t iCapacity ;
+
+    /// @brief Particles emitted per second.
+    float iRate ;
+
+    /// @brief Fraction of particle not emitted yet.
+    float iRemainder ;
+
+    /// @brief Lifetime range , in seconds.
+    float iLifeMin , iLifeMax ;
+
+    /// @brief Speed range.
+    float iSpeedMin , iSpeedMax ;
+
+    /// @brief Direction of new particles.
+    Vector3 iDirection ;
+
+    /// @brief Spread around 'iDirection'.
+    float iSpread ;
+
+    /// @brief Radius of the birth sphere.
+    float iEmissionRadius ;
+
+    /// @brief Acceleration of every particles.
+    Vector3 iGravity ;
+
+    /// @brief Fraction of velocity lost per second.
+    float iDamping ;
+
+    /// @brief Colors at birth and at death.
+    Vector4 iColorBegin , iColorEnd ;
+
+    /// @brief Seed of the next emission.
+    uint64_t iSeed ;
+
+    /// @brief Position of the node when the new particles are emitted.
+    Vector3 iOrigin ;
+
+    /// @brief Vertices written by 'write()'.
+    std::vector < ParticleVertex > iVertices ;
+
+    /// @brief Indices of the points , 0 to 'iCapacity'.
+    std::vector < unsigned int > iIndices ;
+
+    /// @brief Ring of meshes the vertices are uploaded to.
+    std::vector < MeshHolder > iMeshes ;
+
+    /// @brief Next mesh of the ring to write.
+    size_t iNextMesh ;
+};
+
+GreEndNamespace
+
+#endif // GRE_PARTICLEEMITTER_H
@@ -0,0 +1,182 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  PipelineState.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_PIPELINESTATE_H
+#define GRE_PIPELINESTATE_H
+
+#include "Resource.h"
+#include "HardwareProgram.h"
+#include "FrameBuffer.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Faces removed before the rasterization.
+enum class CullMode : int
+{
+    None , Back , Front
+};
+
+/// @brief Translates a string to a CullMode.
+CullMode CullModeFromString ( const std::string & mode ) ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Fixed function states used when drawing with a pipeline state.
+/// The default one tests and writes depth , without culling nor blending.
+struct DLL_PUBLIC RasterState
+{
+    /// @brief True if fragments are tested against the depth buffer.
+    bool depthtest ;
+
+    /// @brief True if fragments write the depth buffer.
+    bool depthwrite ;
+
+    /// @brief Faces culled.
+    CullMode culling ;
+
+    /// @brief True if fragments are blended with their alpha.
+    bool blending ;
+
+    RasterState () : depthtest ( true ) , depthwrite ( true ) , culling ( CullMode::None ) , blending ( false ) { }
+
+    bool operator == ( const RasterState & rhs ) const ;
+    bool operator != ( const RasterState & rhs ) const ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Every state a Technique needs bound before drawing : program ,
+/// framebuffer , raster states and the attributes locations.
+///
+/// A pipeline state is immutable : a Technique creates a new one when one
+/// of those changes. The Renderer keeps the bound one , so binding an
+/// identical pipeline state does nothing. See 'Renderer::bindPipelineState()'.
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC PipelineState : public Resource
+{
+public:
+
+    POOLED ( Pools::Resource )
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Creates the state. Attributes locations are resolved from
+    /// their names in the program.
+    //////////////////////////////////////////////////////////////////////
+    PipelineState (const std::string & name ,
+                   const HardwareProgramHolder & program ,
+                   const RenderFramebufferHolder & framebuffer ,
+                   const RasterState & raster ,
+                   const std::map < VertexAttribAlias , std::string > & attribs ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~PipelineState () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the program.
+    //////////////////////////////////////////////////////////////////////
+    const HardwareProgramHolder & getProgram () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the framebuffer.
+    //////////////////////////////////////////////////////////////////////
+    const RenderFramebufferHolder & getFramebuffer () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the raster states.
+    //////////////////////////////////////////////////////////////////////
+    const RasterState & getRasterState () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the location of the attribute , or -1 if the program
+    /// doesn't use it.
+    //////////////////////////////////////////////////////////////////////
+    int getAttribLocation ( const VertexAttribAlias & alias ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the program's link version when the locations were
+    /// resolved.
+    //////////////////////////////////////////////////////////////////////
+    size_t getLinkVersion () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if binding this state or the given one does the
+    /// same thing.
+    //////////////////////////////////////////////////////////////////////
+    bool isIdentical ( const PipelineState & rhs ) const ;
+
+protected:
+
+    /// @brief Program used.
+    HardwareProgramHolder iProgram ;
+
+    /// @brief Framebuffer drawn.
+    RenderFramebufferHolder iFramebuffer ;
+
+    /// @brief Raster states.
+    RasterState iRasterState ;
+
+    /// @brief Location of each attribute alias , or -1.
+    int iAttribLocations [VertexAttribAliasCount] ;
+
+    /// @brief Program's link version when the locations were resolved.
+    size_t iLinkVersion ;
+};
+
+GRE_MAKE_HOLDER( PipelineState ) ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Pipeline states bound by a Renderer during the last frame.
+struct PipelineStats
+{
+    /// @brief Pipeline states really bound.
+    size_t binds ;
+
+    /// @brief Binds skipped because an identical state was bound. Only the
+    /// program , framebuffer and raster states are skipped : uniforms are
+    /// not part of a pipeline state.
+    size_t skipped ;
+
+    /// @brief Programs switched.
+    size_t programs ;
+
+    /// @brief Framebuffers switched.
+    size_t framebuffers ;
+
+    /// @brief Raster states applied.
+    size_t rasters ;
+
+    PipelineStats () : binds ( 0 ) , skipped ( 0 ) , programs ( 0 ) , framebuffers ( 0 ) , rasters ( 0 ) { }
+};
+
+GreEndNamespace
+
+#endif // GRE_PIPELINESTATE_H
@@ -0,0 +1,279 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  Profiler.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_PROFILER_H
+#define GRE_PROFILER_H
+
+#include "Pools.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A scope recorded by the Profiler.
+//////////////////////////////////////////////////////////////////////
+struct ProfilerEvent
+{
+    /// @brief Name given to the marker.
+    const char * name ;
+
+    /// @brief Detail given to the marker , as a pass or a file name.
+    std::string detail ;
+
+    /// @brief Beginning and end of the scope , in nanoseconds since the
+    /// Profiler creation.
+    uint64_t begin ;
+    uint64_t end ;
+
+    /// @brief Thread which recorded the scope.
+    uint32_t thread ;
+
+    /// @brief Number of scopes opened around this one on its thread.
+    uint32_t depth ;
+
+    /// @brief Frame the scope began in.
+    uint64_t frame ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Records scoped markers of every thread.
+///
+/// Markers are placed with 'GreProfile()' and 'GreProfileDetail()' ,
+/// from the engine or from plugins. They are recorded only during a
+/// capture : otherwise , a marker only tests a flag. Each thread records
+/// its scopes in its own ring buffer , so the oldest scopes are lost when
+/// more than 'RingSize' scopes are recorded by a thread.
+///
+/// 'capture()' starts a capture for a number of frames. Frames are
+/// counted by 'newFrame()' , called by 'Application' at the beginning of
+/// each loop. Scopes recorded can then be read with 'getEvents()' , or
+/// exported to the Chrome 'trace_event' format , to be opened in a
+/// tracing tool.
+///
+/// Compiling without 'GreHasProfiler' removes every marker.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC Profiler
+{
+public:
+
+    /// @brief Number of scopes kept for each thread.
+    static const size_t RingSize = 16384 ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the global profiler.
+    //////////////////////////////////////////////////////////////////////
+    static Profiler & Get () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true while a capture is running.
+    //////////////////////////////////////////////////////////////////////
+    static bool IsCapturing () { return iCapturing.load ( std::memory_order_relaxed ) ; }
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    Profiler () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~Profiler () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Forgets the recorded scopes and captures the end of the
+    /// current frame , then the given number of frames. Zero captures until
+    /// 'stop()'.
+    //////////////////////////////////////////////////////////////////////
+    void capture ( size_t frames ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Stops the capture. Recorded scopes are kept.
+    //////////////////////////////////////////////////////////////////////
+    void stop () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Begins a new frame. Stops the capture when its frames are
+    /// recorded.
+    //////////////////////////////////////////////////////////////////////
+    void newFrame () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of frames begun.
+    //////////////////////////////////////////////////////////////////////
+    uint64_t getFrame () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Opens a scope on the calling thread. 'name' must live as
+    /// long as the profiler , as a string literal.
+    //////////////////////////////////////////////////////////////////////
+    void begin ( const char * name , const std::string & detail = std::string () ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Closes the last scope opened on the calling thread , and
+    /// records it.
+    //////////////////////////////////////////////////////////////////////
+    void end () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Names the calling thread in exported traces.
+    //////////////////////////////////////////////////////////////////////
+    void setThreadName ( const std::string & name ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the recorded scopes of every thread , sorted by
+    /// beginning.
+    //////////////////////////////////////////////////////////////////////
+    std::vector < ProfilerEvent > getEvents () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Forgets the recorded scopes.
+    //////////////////////////////////////////////////////////////////////
+    void clear () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the recorded scopes in the Chrome 'trace_event' JSON
+    /// format.
+    //////////////////////////////////////////////////////////////////////
+    std::string exportChromeTrace () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Writes 'exportChromeTrace()' to given file. Returns false if
+    /// the file can't be written.
+    //////////////////////////////////////////////////////////////////////
+    bool saveChromeTrace ( const std::string & path ) const ;
+
+protected:
+
+    /// @brief A scope opened and not closed yet.
+    struct OpenScope
+    {
+        const char * name ;
+        std::string detail ;
+        uint64_t begin ;
+        uint64_t frame ;
+    };
+
+    /// @brief Scopes of one thread.
+    struct ThreadData
+    {
+        uint32_t id ;
+        std::string name ;
+        std::vector < OpenScope > stack ;
+        std::vector < ProfilerEvent > ring ;
+        size_t head ;
+        size_t count ;
+        std::mutex mutex ;
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the scopes of the calling thread , created on first
+    /// use.
+    //////////////////////////////////////////////////////////////////////
+    ThreadData & getThreadData () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the time since the profiler creation , in nanoseconds.
+    //////////////////////////////////////////////////////////////////////
+    uint64_t now () const ;
+
+protected:
+
+    /// @brief True while a capture is running.
+    static std::atomic < bool > iCapturing ;
+
+    /// @brief Creation time of the profiler.
+    std::chrono::steady_clock::time_point iEpoch ;
+
+    /// @brief Frames begun.
+    std::atomic < uint64_t > iFrame ;
+
+    /// @brief Frame ending the capture , or zero.
+    std::atomic < uint64_t > iLastFrame ;
+
+    /// @brief Scopes of every thread which opened one.
+    std::vector < std::unique_ptr < ThreadData > > iThreads ;
+
+    /// @brief Protects 'iThreads'.
+    mutable std::mutex iMutex ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Opens a Profiler scope at construction and closes it at
+/// destruction , if a capture is running.
+//////////////////////////////////////////////////////////////////////
+class ProfilerScope
+{
+public:
+
+    ProfilerScope ( const char * name ) : iActive ( Profiler::IsCapturing () )
+    {
+        if ( iActive ) Profiler::Get () .begin ( name ) ;
+    }
+
+    ProfilerScope ( const char * name , const std::string & detail ) : iActive ( Profiler::IsCapturing () )
+    {
+        if ( iActive ) Profiler::Get () .begin ( name , detail ) ;
+    }
+
+    ~ProfilerScope ()
+    {
+        if ( iActive ) Profiler::Get () .end () ;
+    }
+
+    ProfilerScope ( const ProfilerScope & ) = delete ;
+    ProfilerScope & operator = ( const ProfilerScope & ) = delete ;
+
+private:
+
+    /// @brief True if the scope was opened.
+    bool iActive ;
+};
+
+#define GreProfileConcatPrivate( a , b ) a##b
+#define GreProfileConcat( a , b ) GreProfileConcatPrivate( a , b )
+
+#   ifdef GreHasProfiler
+
+/// @brief Profiles the enclosing scope under given name.
+#define GreProfile( name ) Gre::ProfilerScope GreProfileConcat( __greprofilescope , __LINE__ ) ( name )
+
+/// @brief Profiles the enclosing scope under given name and detail.
+#define GreProfileDetail( name , detail ) Gre::ProfilerScope GreProfileConcat( __greprofilescope , __LINE__ ) ( name , detail )
+
+#   else
+
+#define GreProfile( name )
+#define GreProfileDetail( name , detail )
+
+#   endif
+
+GreEndNamespace
+
+#endif // GRE_PROFILER_H
@@ -36,6 +36,8 @@ THE SOFTWARE.
 #include "Renderable.h"
 #include "Material.h"
 #include "Mesh.h"
+#include "Frustum.h"
+#include "RenderSnapshot.h"
 
 GreBeginNamespace
 
@@ -159,6 +161,103 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual void setEmissiveMaterial ( const MaterialHolder & material ) ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the radius of the emitted light. A radius lower or
+    /// equal to zero means the light is not bounded and may illuminate
+    /// every node ( as a directionnal light ).
+    //////////////////////////////////////////////////////////////////////
+    virtual float getLightRadius () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the radius of the emitted light.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setLightRadius ( float radius ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if the light emitted by this node reaches the
+    /// given world-space bounding box.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool illuminates ( const BoundingBox & bbox ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if this node is rasterized in the occlusion
+    /// buffer to hide other nodes.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isOccluder () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Designates this node as an occluder. Only meshes whose vertex
+    /// buffers keep a CPU copy are rasterized : other occluders hide nothing.
+    /// Only set it on nodes that are mostly solid , as walls or floors.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setOccluder ( bool value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if this node is drawn by shadow passes.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isShadowCaster () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Sets whether this node is drawn by shadow passes. Nodes which
+    /// only receive shadows , as the ground , can disable it. Static nodes
+    /// merged in a batch are drawn with their batch. Default is true.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setShadowCaster ( bool value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if this node never moves.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isStatic () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Marks this node as static. Static nodes added to a scene
+    /// are merged by its StaticBatcher. Set it before adding the node.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setStatic ( bool value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if this node is drawn by a static batch , and
+    /// so is skipped by 'sort()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isBatched () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the batched flag. Only used by StaticBatcher.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setBatched ( bool value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the level of detail selected by 'updateLod()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getLodLevel () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Selects the level of detail from the projected size of the
+    /// node's bounding sphere. 'projscale' is the vertical scale of the
+    /// projection matrix ( 'projection[1][1]' ). To avoid popping when the
+    /// size stays around a threshold , a level only changes when the size
+    /// crosses the threshold by more than the hysteresis.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t updateLod ( const Vector3 & camera , float projscale ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the hysteresis used by 'updateLod()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual float getLodHysteresis () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the hysteresis , as a fraction of the thresholds.
+    /// Default is 0.1.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setLodHysteresis ( float value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the level of detail of 'mesh' for a bounding box
+    /// seen from 'camera'. See 'updateLod()'.
+    //////////////////////////////////////////////////////////////////////
+    static size_t SelectLod ( const MeshHolder & mesh , const BoundingBox & bbox , size_t current ,
+                              float hysteresis , const Vector3 & camera , float projscale ) ;
+
     //////////////////////////////////////////////////////////////////////
     /// @brief Translates the position by direction.
     //////////////////////////////////////////////////////////////////////
@@ -248,9 +347,24 @@ public:
     virtual void sort ( const Matrix4 & projectionview , RenderNodeHolderList & result ) const ;
 
     //////////////////////////////////////////////////////////////////////
-    /// @brief Returns the lights from those children.
+    /// @brief Returns true if this node , without its children , is visible
+    /// from the given projection-view matrix.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isVisible ( const Matrix4 & projectionview ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns a number changed each time the model matrix , the
+    /// bounding box or the batched flag changes. Versions are unique among
+    /// every nodes.
     //////////////////////////////////////////////////////////////////////
-    virtual void lights ( const Matrix4 & projectionview , RenderNodeHolderList & result ) const ;
+    virtual uint64_t getVisibilityVersion () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Copies this node to the given snapshot , as a drawable item ,
+    /// a light or a camera. Children are not copied : the scene copies each
+    /// node on its own , so only one node is locked at a time.
+    //////////////////////////////////////////////////////////////////////
+    virtual void snapshot ( RenderSnapshot & snapshot ) const ;
 
     //////////////////////////////////////////////////////////////////////
     /// @brief Returns the computed view matrix.
@@ -302,6 +416,19 @@ protected:
     //////////////////////////////////////////////////////////////////////
     virtual void onUpdateEvent ( const UpdateEvent & e ) ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Updates the proxy of this node in the creator scene.
+    //////////////////////////////////////////////////////////////////////
+    virtual void updateProxy () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Called when the mesh or the material changed. Changes the
+    /// visibility version , updates the proxy and , for a static node in
+    /// the scene , relocates it so the StaticBatcher merges it again in the
+    /// right chunk.
+    //////////////////////////////////////////////////////////////////////
+    virtual void updateDrawable () ;
+
 protected:
 
     /// @brief Holds a pointer to the scene that created this node. This
@@ -330,6 +457,29 @@ protected:
     /// as a light.
     MaterialHolder iEmissiveMaterial ;
 
+    /// @brief Radius of the light emitted by this node. Lower or equal to zero means the light
+    /// is not bounded. Default is zero.
+    float iLightRadius ;
+
+    /// @brief True if this node hides other nodes in the occlusion culling stage. Default
+    /// is false.
+    bool iOccluder ;
+
+    /// @brief True if this node is drawn by shadow passes. Default is true.
+    bool iShadowCaster ;
+
+    /// @brief True if this node never moves. Default is false.
+    bool iStatic ;
+
+    /// @brief True if this node is drawn by a static batch. Default is false.
+    bool iBatched ;
+
+    /// @brief Level of detail used to draw the mesh. Zero is the full detail.
+    size_t iLodLevel ;
+
+    /// @brief Fraction of the level thresholds to cross before changing level.
+    float iLodHysteresis ;
+
     /// @brief World-space position of this node.
     Vector3 iPosition ;
 
@@ -382,6 +532,9 @@ protected:
     /// @brief Updates the view matrix only if this flag is true. Default is false. It should be
     /// activated only when this node should be used as a camera.
     bool iActiveViewMatrix ;
+
+    /// @brief Visibility version , see 'getVisibilityVersion()'.
+    uint64_t iVisibilityVersion ;
 };
 
 /// @brief
@@ -39,11 +39,33 @@
 #include "RenderTarget.h"
 #include "Viewport.h"
 #include "RenderScene.h"
+#include "OcclusionBuffer.h"
+#include "MatrixCache.h"
+#include "CommandBuffer.h"
 
 GreBeginNamespace
 
 class Renderer ;
 
+//////////////////////////////////////////////////////////////////////
+/// @brief A frame graph target read or written by a RenderPass.
+//////////////////////////////////////////////////////////////////////
+struct RenderPassTarget
+{
+    /// @brief Name of the target in the RenderPipeline.
+    std::string name ;
+
+    /// @brief Texture alias used to read the target.
+    TechniqueParam alias ;
+
+    /// @brief Attachment of the technique's framebuffer used to write the
+    /// target.
+    RenderFramebufferAttachement attachment ;
+
+    /// @brief Texture given by the frame graph for the current frame.
+    mutable TextureHolder texture ;
+};
+
 //////////////////////////////////////////////////////////////////////
 /// @brief Defines a rendering pass as a rendering action constructed
 /// by the user.
@@ -79,6 +101,9 @@ public:
 
     POOLED ( Pools::Render ) ;
 
+    /// @brief Number of snapshot items recorded in one command buffer.
+    static const size_t SnapshotChunkSize = 256 ;
+
     //////////////////////////////////////////////////////////////////////
     //////////////////////////////////////////////////////////////////////
     RenderPass ( const std::string & name ) ;
@@ -111,10 +136,18 @@ public:
     virtual void use ( const TechniqueHolder & technique ) const ;
 
     //////////////////////////////////////////////////////////////////////
-    /// @brief Renders the pass using the given renderer.
+    /// @brief Renders the pass using the given renderer. When the scene
+    /// publishes snapshots , the latest one is acquired for this pass.
     //////////////////////////////////////////////////////////////////////
     virtual void render ( const Renderer * renderer ) const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Renders the pass using the given renderer and the snapshot
+    /// acquired for the frame. Every techniques of the pass draw the same
+    /// snapshot. It is not used when the scene does not publish snapshots.
+    //////////////////////////////////////////////////////////////////////
+    virtual void render ( const Renderer * renderer , const RenderSnapshot * snapshot ) const ;
+
     //////////////////////////////////////////////////////////////////////
     //////////////////////////////////////////////////////////////////////
     virtual void setCamera ( const RenderNodeHolder & camera ) ;
@@ -133,12 +166,166 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual const std::vector < RenderableHolder > & getSelfUsedRenderables () const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Enables the occlusion culling stage. When enabled , nodes
+    /// returned by 'RenderScene::sort()' and flagged as occluders are
+    /// rasterized on the CPU , and nodes they hide are not drawn.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setOcclusionCulling ( bool value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isOcclusionCulling () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the counters of the last occlusion culling stage.
+    //////////////////////////////////////////////////////////////////////
+    virtual const OcclusionStats & getOcclusionStats () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Makes this pass a shadow pass. A shadow pass draws the shadow
+    /// casters seen by its shadow light : the light's view matrix and the
+    /// technique's projection make the frustum. Nodes visible from the
+    /// camera but outside the light's frustum are not drawn , and casters
+    /// outside the camera's frustum are. Default is false.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setShadowPass ( bool value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isShadowPass () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Sets the light drawn by a shadow pass. Only one light draws
+    /// in the shadow map : other lights need their own pass. When invalid ,
+    /// the first light of the scene is used. Lights are not culled against
+    /// the camera , as a light outside the view may cast shadows in it.
+    /// Nothing is drawn when the light is not in the scene. Default is
+    /// invalid.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setShadowLight ( const RenderNodeHolder & light ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual const RenderNodeHolder & getShadowLight () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of casters drawn by the last shadow pass.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getShadowCastersCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Enables the shadow cache of a shadow pass. Static casters are
+    /// drawn once and their depth is copied to a cache framebuffer. Next
+    /// frames copy the cache back and only draw the dynamic casters , until
+    /// a light moves or a static node changes. Needs a framebuffer with a
+    /// depth texture , and a renderer able to copy framebuffers. Not used
+    /// when drawing snapshots. Default is false.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setShadowCaching ( bool value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isShadowCaching () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Forgets the cached static shadows. They are drawn again by
+    /// the next frame.
+    //////////////////////////////////////////////////////////////////////
+    virtual void invalidateShadowCache () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the cache of the nodes matrices , to read its
+    /// statistics.
+    //////////////////////////////////////////////////////////////////////
+    virtual const MatrixCache & getMatrixCache () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records the items of a snapshot seen by this pass's camera ,
+    /// as 'renderSnapshot()' draws them , without any renderer. Items are
+    /// split in chunks of 'SnapshotChunkSize' items , each recorded in its
+    /// own buffer by the JobPool. Buffers must be executed in order , with
+    /// the technique bound and the camera's values set. Returns false if
+    /// the camera is not in the snapshot.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool recordSnapshot (const TechniqueHolder & technique ,
+                                 const RenderSnapshot & snapshot ,
+                                 CommandBufferList & buffers ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Declares a target read by this pass. Its texture is set to
+    /// the given alias of every technique used by the pass.
+    //////////////////////////////////////////////////////////////////////
+    virtual void addRead ( const std::string & target , const TechniqueParam & alias ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Declares a target written by this pass. Its texture is set to
+    /// the given attachment of the technique's framebuffer before drawing.
+    //////////////////////////////////////////////////////////////////////
+    virtual void addWrite ( const std::string & target , const RenderFramebufferAttachement & attachment ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes every targets declared.
+    //////////////////////////////////////////////////////////////////////
+    virtual void clearTargets () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns 'iReads'.
+    //////////////////////////////////////////////////////////////////////
+    virtual const std::vector < RenderPassTarget > & getReads () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns 'iWrites'.
+    //////////////////////////////////////////////////////////////////////
+    virtual const std::vector < RenderPassTarget > & getWrites () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Sets the texture of every reads and writes of the given
+    /// target , for the next 'render()'. Called by the frame graph.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setTargetTexture ( const std::string & target , const TextureHolder & texture ) const ;
+
 protected:
 
     //////////////////////////////////////////////////////////////////////
-    /// @brief Renders once using the given technique.
+    /// @brief Sets the textures of the declared writes to the framebuffer
+    /// of the technique.
+    //////////////////////////////////////////////////////////////////////
+    virtual void attachTargets ( const Renderer * renderer , const TechniqueHolder & technique ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes from 'nodes' every node hidden by the occluders
+    /// present in 'nodes'. Occluders are never removed.
+    //////////////////////////////////////////////////////////////////////
+    virtual void cullOccludedNodes ( const Matrix4 & projectionview , RenderNodeHolderList & nodes ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Renders once using the given technique , and the snapshot
+    /// of the frame when the scene publishes them.
+    //////////////////////////////////////////////////////////////////////
+    virtual void renderTechnique ( const Renderer * renderer ,
+                                   const TechniqueHolder & technique ,
+                                   const RenderSnapshot * snapshot ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Draws the shadow casters seen by the shadow light.
     //////////////////////////////////////////////////////////////////////
-    virtual void renderTechnique ( const Renderer * renderer , const TechniqueHolder & technique ) const ;
+    virtual void renderShadowCasters ( const Renderer * renderer ,
+                                       const TechniqueHolder & technique ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Draws the casters selected by the filter , seen by the light.
+    //////////////////////////////////////////////////////////////////////
+    virtual void drawShadowCasters ( const Renderer * renderer ,
+                                     const TechniqueHolder & technique ,
+                                     const RenderNodeHolder & light ,
+                                     ShadowCasterFilter filter ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Creates the cache framebuffer if needed , with a depth texture
+    /// made like the one of given framebuffer. Returns false if it can't.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool prepareShadowCache ( const RenderFramebufferHolder & framebuffer ) const ;
 
     //////////////////////////////////////////////////////////////////////
     /// @brief Binds node , lights and material and render the node.
@@ -176,6 +363,74 @@ protected:
                                           const TechniqueHolder & technique ,
                                           const RenderNodeHolder & node) const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Draws every submeshes of the mesh at given level of detail.
+    /// Submeshes default materials are used when 'material' is invalid.
+    //////////////////////////////////////////////////////////////////////
+    virtual void drawMesh (const Renderer* renderer ,
+                           const TechniqueHolder & technique ,
+                           const MeshHolder & mesh ,
+                           const MaterialHolder & material ,
+                           size_t lod ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Renders the technique from a scene snapshot. Only values
+    /// copied in the snapshot are used , so no node is locked. Nodes pre
+    /// and post processing techniques are not used in this mode.
+    //////////////////////////////////////////////////////////////////////
+    virtual void renderSnapshot (const Renderer* renderer ,
+                                 const TechniqueHolder & technique ,
+                                 const RenderSnapshot & snapshot ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Sets the camera's values to the technique , with the Pass
+    /// block if the program declares it.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setCameraUniforms (const TechniqueHolder & technique ,
+                                    const Vector3 & position ,
+                                    const Vector3 & direction ,
+                                    const Matrix4 & view ,
+                                    const Matrix4 & projection ,
+                                    const Matrix4 & projectionview ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Sets the node's matrices to the technique , with the Object
+    /// block if the program declares it.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setObjectUniforms (const TechniqueHolder & technique ,
+                                    const Matrix4 & model ,
+                                    const Matrix4 & modelview ,
+                                    const Matrix3 & normal ,
+                                    const Matrix4 & projectionviewmodel ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records the object's values , the lights and the draws of one
+    /// item of a snapshot. 'objectblock' is a block with the technique's
+    /// Object layout , used to pack the matrices , or null if the program
+    /// does not declare it.
+    //////////////////////////////////////////////////////////////////////
+    virtual void recordSnapshotItem (CommandBuffer & buffer ,
+                                     const TechniqueHolder & technique ,
+                                     const RenderSnapshotItem & item ,
+                                     const Matrix4 & view ,
+                                     const Matrix4 & projection ,
+                                     const std::vector < const RenderSnapshotLight * > & lights ,
+                                     size_t lod ,
+                                     UniformBlock * objectblock ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records a snapshot light bound to the technique's current
+    /// light , as 'RenderNode::bindEmissiveMaterial()' does.
+    //////////////////////////////////////////////////////////////////////
+    virtual void recordSnapshotLight ( CommandBuffer & buffer , const Matrix4 & projection , const RenderSnapshotLight & light ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Same as 'renderShadowCasters()' , from a scene snapshot.
+    //////////////////////////////////////////////////////////////////////
+    virtual void renderSnapshotShadowCasters (const Renderer* renderer ,
+                                              const TechniqueHolder & technique ,
+                                              const RenderSnapshot & snapshot ) const ;
+
 protected:
 
     /// @brief Scene to draw.
@@ -194,6 +449,67 @@ protected:
     /// applying to its pre and post processing techniques. In order to set Self Used Params
     /// to a sub-technique only , creates a RenderSubPass.
     std::vector < RenderableHolder > iSelfUsedParams ;
+
+    /// @brief True if the occlusion culling stage is enabled. Default is false.
+    bool iOcclusionCulling ;
+
+    /// @brief Depth buffer used by the occlusion culling stage.
+    mutable OcclusionBuffer iOcclusionBuffer ;
+
+    /// @brief Counters of the last occlusion culling stage.
+    mutable OcclusionStats iOcclusionStats ;
+
+    /// @brief True if this pass draws the shadow casters seen by lights. Default
+    /// is false.
+    bool iShadowPass ;
+
+    /// @brief Casters drawn by the last shadow pass.
+    mutable size_t iShadowCasters ;
+
+    /// @brief Light drawn by the shadow pass , or invalid for the first one.
+    RenderNodeHolder iShadowLight ;
+
+    /// @brief Casters seen by the light , reused every frame.
+    mutable std::vector < const RenderNode * > iCasters ;
+
+    /// @brief True if static shadows are cached. Default is false.
+    bool iShadowCaching ;
+
+    /// @brief Framebuffer holding the depth of the static casters.
+    mutable RenderFramebufferHolder iShadowCache ;
+
+    /// @brief True when the cache holds the static casters for the key below.
+    mutable bool iShadowCacheValid ;
+
+    /// @brief Scene static version the cache was drawn with.
+    mutable uint64_t iShadowCacheVersion ;
+
+    /// @brief Projection-view matrix of the light the cache was drawn with.
+    mutable Matrix4 iShadowCacheLight ;
+
+    /// @brief Matrices of the drawn nodes , for each camera ( or light in shadow
+    /// passes ). Shared by the technique and the nodes pre and post processing
+    /// techniques.
+    mutable MatrixCache iMatrices ;
+
+    /// @brief Buffers recorded when drawing snapshots , reused every frame.
+    mutable CommandBufferList iCommandBuffers ;
+
+    /// @brief Levels of detail selected by the last 'recordSnapshot()' , for
+    /// each node. Snapshot items are copied from the nodes every update , so
+    /// the level selected for an item is kept here to be the current level
+    /// of the next selection , and the hysteresis applies.
+    mutable std::unordered_map < const RenderNode * , size_t > iSnapshotLods ;
+
+    /// @brief Levels of detail of the items of the snapshot being recorded ,
+    /// by item index.
+    mutable std::vector < size_t > iSnapshotItemLods ;
+
+    /// @brief Frame graph targets read by this pass.
+    std::vector < RenderPassTarget > iReads ;
+
+    /// @brief Frame graph targets written by this pass.
+    std::vector < RenderPassTarget > iWrites ;
 };
 
 /// @brief
@@ -35,6 +35,8 @@ THE SOFTWARE.
 
 #include "Resource.h"
 #include "RenderPass.h"
+#include "FrameGraph.h"
+#include "RenderStatistics.h"
 #include "SpecializedResourceManager.h"
 
 GreBeginNamespace
@@ -50,6 +52,12 @@ class Renderer ;
 /// exceed a too high number , the indexing is made with an uint8_t index ,
 /// so rendering pass are 0 to 511.
 ///
+/// Passes may declare the targets they read and write. 'render()' then
+/// uses a FrameGraph to execute them : a pass reading a target is drawn
+/// after the passes writing it , passes whose targets are not used are
+/// not drawn , and transient targets share their textures when their
+/// lifetimes do not overlap.
+///
 //////////////////////////////////////////////////////////////////////
 class RenderPipeline : public Resource
 {
@@ -100,20 +108,62 @@ public:
 
     //////////////////////////////////////////////////////////////////////
     /// @brief Iterates over the different activated passes and render
-    /// them with given renderer.
+    /// them with given renderer , in the order given by the frame graph.
+    /// The snapshot of each scene is acquired once for the whole frame.
     //////////////////////////////////////////////////////////////////////
     virtual void render ( const Renderer * renderer ) const ;
 
     //////////////////////////////////////////////////////////////////////
     /// @brief Reverse - iterates over the different activated passes and
-    /// render them with given renderer.
+    /// render them with given renderer. The frame graph is not used , and
+    /// passes use the targets given by the last 'render()'.
     //////////////////////////////////////////////////////////////////////
     virtual void renderReversed ( const Renderer * renderer ) const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Declares a transient target , allocated for the passes using
+    /// it.
+    //////////////////////////////////////////////////////////////////////
+    virtual void addTarget ( const std::string & name , const FrameGraphTarget & target ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Declares a target held by the user. Passes writing it are
+    /// always drawn.
+    //////////////////////////////////////////////////////////////////////
+    virtual void importTarget ( const std::string & name , const TextureHolder & texture ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes a target.
+    //////////////////////////////////////////////////////////////////////
+    virtual void removeTarget ( const std::string & name ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the passes drawn , culled , and the render-target
+    /// memory used by the last 'render()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual const FrameGraphStats & getFrameGraphStats () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the counters of the last frames , with the counters
+    /// of each pass drawn.
+    //////////////////////////////////////////////////////////////////////
+    virtual const RenderStatistics & getStatistics () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns 'iStatistics' , to change its history size.
+    //////////////////////////////////////////////////////////////////////
+    virtual RenderStatistics & getStatistics () ;
+
 protected:
 
     /// @brief Ordered map of render passes.
     std::map < uint8_t , RenderPassHolder > iPasses ;
+
+    /// @brief Orders the passes and allocates their targets.
+    mutable FrameGraph iFrameGraph ;
+
+    /// @brief Counters of the last frames rendered.
+    mutable RenderStatistics iStatistics ;
 };
 
 GRE_MAKE_HOLDER( RenderPipeline ) ;
@@ -0,0 +1,215 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  RenderProxyArray.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 26/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_RENDERPROXYARRAY_H
+#define GRE_RENDERPROXYARRAY_H
+
+#include "RenderNode.h"
+#include "VisibilityCache.h"
+
+#include <unordered_map>
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Selects the shadow casters returned by a query.
+//////////////////////////////////////////////////////////////////////
+enum class ShadowCasterFilter : int
+{
+    All , Static , Dynamic
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Copy of the node's properties needed to cull it.
+//////////////////////////////////////////////////////////////////////
+struct RenderProxy
+{
+    /// @brief Node this proxy was made from.
+    const RenderNode * node ;
+
+    /// @brief Model matrix of the node.
+    Matrix4 model ;
+
+    /// @brief Center of the bounding box.
+    Vector4 center ;
+
+    /// @brief Diameter of the bounding box.
+    float diameter ;
+
+    /// @brief Position of the node , for lights.
+    Vector3 position ;
+
+    /// @brief Light radius , or zero for unbounded lights.
+    float radius ;
+
+    /// @brief Visibility version of the node.
+    uint64_t version ;
+
+    /// @brief True if the node has a bounding box and is not batched.
+    bool drawable ;
+
+    /// @brief True if the node has an emissive material.
+    bool light ;
+
+    /// @brief True if the node is drawn by shadow passes.
+    bool caster ;
+
+    /// @brief True if the node never moves.
+    bool staticnode ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Contiguous array of the scene's nodes , culled with linear scans.
+///
+/// The scene adds a proxy when a node enters its tree , removes it when
+/// the node leaves , and updates it when the node changes. Culling and
+/// light gathering read only the proxies : they don't lock any node , and
+/// don't allocate once the result vector has grown.
+///
+/// Removing a proxy moves the last one to its place , so the order of
+/// the proxies is not the order of the tree.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC RenderProxyArray
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    RenderProxyArray () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~RenderProxyArray () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds a proxy for given node , or updates it if the node
+    /// already has one.
+    //////////////////////////////////////////////////////////////////////
+    void insert ( const RenderNode * node ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Updates the proxy of given node , if any.
+    //////////////////////////////////////////////////////////////////////
+    void update ( const RenderNode * node ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes the proxy of given node , if any.
+    //////////////////////////////////////////////////////////////////////
+    void remove ( const RenderNode * node ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if given node has a proxy.
+    //////////////////////////////////////////////////////////////////////
+    bool contains ( const RenderNode * node ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes every proxies.
+    //////////////////////////////////////////////////////////////////////
+    void clear () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of proxies.
+    //////////////////////////////////////////////////////////////////////
+    size_t getCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the proxies.
+    //////////////////////////////////////////////////////////////////////
+    const std::vector < RenderProxy > & getProxies () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Appends the nodes visible from the projection-view matrix
+    /// to 'result'.
+    //////////////////////////////////////////////////////////////////////
+    void cull ( const Matrix4 & projectionview , std::vector < const RenderNode * > & result ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Same as above , but reuses the results of the cache's current
+    /// entry for proxies whose version did not change , and records the
+    /// new ones.
+    //////////////////////////////////////////////////////////////////////
+    void cull ( const Matrix4 & projectionview , VisibilityCache & cache , std::vector < const RenderNode * > & result ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Appends the lights touching the frustum to 'result'.
+    /// Unbounded lights are always appended.
+    //////////////////////////////////////////////////////////////////////
+    void lights ( const Frustum & frustum , std::vector < const RenderNode * > & result ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Appends every lights to 'result' , without culling.
+    //////////////////////////////////////////////////////////////////////
+    void lights ( std::vector < const RenderNode * > & result ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Appends the shadow casters whose bounding sphere touches the
+    /// frustum to 'result'.
+    //////////////////////////////////////////////////////////////////////
+    void casters ( const Frustum & frustum , std::vector < const RenderNode * > & result ,
+                   ShadowCasterFilter filter = ShadowCasterFilter::All ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns a number changed each time a static node's proxy is
+    /// added , removed or changed. Static shadows stay valid while it does
+    /// not change.
+    //////////////////////////////////////////////////////////////////////
+    uint64_t getStaticVersion () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if the proxy is visible from the projection-view
+    /// matrix. Same test as 'RenderNode::isVisible()'.
+    //////////////////////////////////////////////////////////////////////
+    static bool IsVisible ( const Matrix4 & projectionview , const RenderProxy & proxy ) ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Copies the node's properties to the proxy.
+    //////////////////////////////////////////////////////////////////////
+    static void Fill ( const RenderNode * node , RenderProxy & proxy ) ;
+
+protected:
+
+    /// @brief Proxies.
+    std::vector < RenderProxy > iProxies ;
+
+    /// @brief Index of each node's proxy.
+    std::unordered_map < const RenderNode * , size_t > iIndices ;
+
+    /// @brief See 'getStaticVersion()'.
+    uint64_t iStaticVersion ;
+};
+
+GreEndNamespace
+
+#endif // GRE_RENDERPROXYARRAY_H
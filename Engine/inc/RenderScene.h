@@ -34,6 +34,10 @@ THE SOFTWARE.
 #define GRE_RENDERSCENE_H
 
 #include "RenderNode.h"
+#include "StaticBatcher.h"
+#include "VisibilityCache.h"
+#include "SpatialIndex.h"
+#include "RenderProxyArray.h"
 
 GreBeginNamespace
 
@@ -71,19 +75,85 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual bool remove ( RenderNodeHolder & node ) ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Moves a node whose bounding box changed to its new place in
+    /// the scene tree and in the spatial index. Called by 'RenderNode::update()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool relocate ( RenderNodeHolder & node ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds proxies for the node and its children , if the parent is
+    /// in the scene. Called by 'RenderNode::add()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual void attach ( const RenderNode * parent , const RenderNodeHolder & node ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes the proxies of the node and its children. Called by
+    /// 'RenderNode::remove()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual void detach ( const RenderNodeHolder & node ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Copies the node's properties to its proxy. Called by the node
+    /// when its bounding box , matrix , batched flag or light changes.
+    //////////////////////////////////////////////////////////////////////
+    virtual void updateProxy ( const RenderNode * node ) ;
+
     //////////////////////////////////////////////////////////////////////
     /// @brief Computes a sorted list of nodes , visible from the
     /// ProjecitonViewMatrix. As those nodes are sensibly not transparent ,
     /// no comparation is needed to draw them. To get a list of sorted
     /// transparent objects , see '::sortTransparent()'.
+    ///
+    /// Results are cached by projection-view matrix : calling it again with
+    /// the same matrix returns the same list without testing any node , as
+    /// long as the scene version did not change.
     //////////////////////////////////////////////////////////////////////
     virtual const RenderNodeHolderList sort ( const Matrix4 & projectionview ) const ;
 
     //////////////////////////////////////////////////////////////////////
-    /// @brief Returns the lights.
+    /// @brief Returns the lights that may illuminate something visible
+    /// from the ProjectionViewMatrix. Bounded lights are culled against the
+    /// view frustum , unbounded lights are always returned.
     //////////////////////////////////////////////////////////////////////
     virtual const RenderNodeHolderList lights ( const Matrix4 & projectionview ) const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Appends the nodes and static batches visible from the
+    /// ProjectionViewMatrix to 'result'. Unlike 'sort()' , no holder is
+    /// made and the cache is not used : reusing the same vector every frame
+    /// culls the scene without allocating.
+    //////////////////////////////////////////////////////////////////////
+    virtual void cull ( const Matrix4 & projectionview , std::vector < const RenderNode * > & result ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Appends the lights returned by 'lights()' to 'result' , without
+    /// making holders.
+    //////////////////////////////////////////////////////////////////////
+    virtual void lights ( const Matrix4 & projectionview , std::vector < const RenderNode * > & result ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Appends every lights of the scene to 'result' , without any
+    /// culling. A light outside the view frustum may still cast shadows in
+    /// it.
+    //////////////////////////////////////////////////////////////////////
+    virtual void lights ( std::vector < const RenderNode * > & result ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Appends the shadow casters and static batches seen by a light
+    /// to 'result'. Static batches are static casters. The frustum is made from the light's projection-view
+    /// matrix without its near plane , so casters between the light and the
+    /// near plane are kept.
+    //////////////////////////////////////////////////////////////////////
+    virtual void casters ( const Matrix4 & lightprojectionview , std::vector < const RenderNode * > & result ,
+                           ShadowCasterFilter filter = ShadowCasterFilter::All ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns a number changed each time a static node is added ,
+    /// removed or changed. See 'RenderProxyArray::getStaticVersion()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual uint64_t getStaticVersion () const ;
+
     //////////////////////////////////////////////////////////////////////
     //////////////////////////////////////////////////////////////////////
     virtual const RenderNodeHolder & getRoot () const ;
@@ -92,10 +162,116 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual RenderNodeHolder & getRoot () ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Merges the static nodes added or removed since the last
+    /// build. This is also done by 'sort()' when needed , but calling it
+    /// when the scene is loaded avoids a long first frame. Must be called
+    /// from a thread where buffers can be created.
+    //////////////////////////////////////////////////////////////////////
+    virtual void buildStaticBatches () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the static batcher.
+    //////////////////////////////////////////////////////////////////////
+    virtual StaticBatcher & getStaticBatcher () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns a number changed each time a node is added to or
+    /// removed from the scene , each time a node's proxy is updated , and
+    /// each time static batches are built.
+    //////////////////////////////////////////////////////////////////////
+    virtual uint64_t getVersion () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the cache used by 'sort()' , to read its statistics
+    /// or change its capacity.
+    //////////////////////////////////////////////////////////////////////
+    virtual VisibilityCache & getVisibilityCache () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the index used for spatial queries ( raycasts , overlaps
+    /// and nearest nodes ). Queries don't lock the scene , and can be run
+    /// from any thread.
+    //////////////////////////////////////////////////////////////////////
+    virtual const SpatialIndex & getSpatialIndex () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the flattened nodes used by 'sort()' , 'cull()' and
+    /// 'lights()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual const RenderProxyArray & getProxies () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Enables or disables snapshots. When enabled , a snapshot of
+    /// the scene is published at the end of every update , and renderpasses
+    /// draw the latest snapshot instead of reading the nodes. Disabled by
+    /// default.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setSnapshotEnabled ( bool value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if snapshots are enabled.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isSnapshotEnabled () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Copies the nodes to a new snapshot and publishes it. Called
+    /// at the end of every update when snapshots are enabled.
+    //////////////////////////////////////////////////////////////////////
+    virtual void publishSnapshot () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the latest published snapshot , or null. This does
+    /// not lock the scene , but must only be called from the render thread.
+    /// The snapshot stays valid until the next call.
+    //////////////////////////////////////////////////////////////////////
+    virtual const RenderSnapshot * acquireSnapshot () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Publishes a snapshot after the nodes have been updated.
+    //////////////////////////////////////////////////////////////////////
+    virtual void onUpdateEvent ( const UpdateEvent & e ) ;
+
 protected:
 
     /// @brief Root RenderNode.
     RenderNodeHolder iRoot ;
+
+    /// @brief Merges static nodes. Mutable as 'sort()' builds the dirty chunks.
+    mutable StaticBatcher iStaticBatcher ;
+
+    /// @brief Results of 'sort()'.
+    mutable VisibilityCache iVisibilityCache ;
+
+    /// @brief Nodes of the scene , for spatial queries.
+    SpatialIndex iSpatialIndex ;
+
+    /// @brief Nodes of the scene , for culling.
+    RenderProxyArray iProxies ;
+
+    /// @brief Reused by 'sort()' and 'lights()'.
+    mutable std::vector < const RenderNode * > iCulled ;
+
+    /// @brief Scene version , see 'getVersion()'. Mutable as 'sort()' may build batches.
+    mutable uint64_t iVersion ;
+
+    /// @brief Snapshots exchanged between the update and the render threads.
+    mutable RenderSnapshotBuffer iSnapshots ;
+
+    /// @brief True when snapshots are published. Read by the render thread without
+    /// locking the scene.
+    std::atomic < bool > iSnapshotEnabled ;
+
+    /// @brief Number of snapshots published.
+    uint64_t iSnapshotFrame ;
+
+    /// @brief Nodes of the scene , for 'publishSnapshot()'. Copying a shared
+    /// pointer does not lock the node , unlike copying its holder.
+    std::unordered_map < const RenderNode * , std::shared_ptr < const RenderNodeHolder > > iSnapshotNodes ;
+
+    /// @brief Serializes 'publishSnapshot()' , which fills the write snapshot
+    /// without the scene lock.
+    std::mutex iSnapshotMutex ;
 };
 
 /// @brief
@@ -135,6 +311,13 @@ public:
 ///   - 'scene.root.size' : Size of the root's bounding box. Generally
 ///     this means the total size of the scene.
 ///
+///   - 'scene.batch.chunksize' ( float ) : Size of the static batches
+///     chunks.
+///
+///   - 'scene.visibility.cachesize' ( int ) : Number of projection-view
+///     matrices whose visible nodes are cached by 'sort()'. Default is 4 ,
+///     zero disables the cache.
+///
 //////////////////////////////////////////////////////////////////////
 class DLL_PUBLIC RenderSceneManager : public SpecializedResourceManager < RenderScene , RenderSceneLoader >
 {
@@ -0,0 +1,229 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  RenderSnapshot.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 18/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_RENDERSNAPSHOT_H
+#define GRE_RENDERSNAPSHOT_H
+
+#include "Mesh.h"
+#include "Material.h"
+#include "BoundingBox.h"
+
+#include <atomic>
+
+GreBeginNamespace
+
+// Snapshot items keep the node they come from only as an identifier.
+class RenderNode ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A drawable node , as copied in a RenderSnapshot.
+struct RenderSnapshotItem
+{
+    /// @brief Node this item was made from. Only used to identify it , the
+    /// render thread must not use it.
+    const RenderNode * node ;
+
+    /// @brief Mesh drawn.
+    MeshHolder mesh ;
+
+    /// @brief Node's material , or null to use the submeshes materials.
+    MaterialHolder material ;
+
+    /// @brief World-space model matrix.
+    Matrix4 model ;
+
+    /// @brief World-space bounding box.
+    BoundingBox bbox ;
+
+    /// @brief Level of detail of the node when the snapshot was made.
+    size_t lod ;
+
+    /// @brief Hysteresis used to select the level of detail.
+    float lodhysteresis ;
+
+    /// @brief True if the item is drawn by shadow passes.
+    bool caster ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A light , as copied in a RenderSnapshot.
+struct RenderSnapshotLight
+{
+    /// @brief Node this light was made from.
+    const RenderNode * node ;
+
+    /// @brief Emissive material of the node.
+    MaterialHolder material ;
+
+    /// @brief World-space position.
+    Vector3 position ;
+
+    /// @brief World-space direction.
+    Vector3 direction ;
+
+    /// @brief View matrix of the light , used for shadows.
+    Matrix4 view ;
+
+    /// @brief Radius of the light , zero when not bounded.
+    float radius ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A camera , as copied in a RenderSnapshot.
+struct RenderSnapshotCamera
+{
+    /// @brief Node this camera was made from.
+    const RenderNode * node ;
+
+    /// @brief World-space position.
+    Vector3 position ;
+
+    /// @brief World-space direction.
+    Vector3 direction ;
+
+    /// @brief View matrix.
+    Matrix4 view ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Compact copy of a scene , as needed to render it.
+///
+/// A snapshot is filled by the update thread at the end of a scene
+/// update , then only read by the render thread. It holds plain values
+/// and holders to shared resources ( meshes and materials ) but never
+/// reads the nodes again , so rendering it does not lock any node and
+/// always sees every node at the same update.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC RenderSnapshot
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    RenderSnapshot () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~RenderSnapshot () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Clears every items , lights and cameras. Vectors keep their
+    /// memory to be refilled without allocating.
+    //////////////////////////////////////////////////////////////////////
+    void clear () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the camera made from given node , or null if this
+    /// node was not a camera when the snapshot was made.
+    //////////////////////////////////////////////////////////////////////
+    const RenderSnapshotCamera * findCamera ( const RenderNode * node ) const ;
+
+public:
+
+    /// @brief Drawable nodes.
+    std::vector < RenderSnapshotItem > items ;
+
+    /// @brief Lights.
+    std::vector < RenderSnapshotLight > lights ;
+
+    /// @brief Nodes with an active view matrix.
+    std::vector < RenderSnapshotCamera > cameras ;
+
+    /// @brief Number of the update this snapshot was made at.
+    uint64_t frame ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Triple buffer of RenderSnapshot , shared by one writer and
+/// one reader.
+///
+/// The writer fills 'getWriteSnapshot()' then calls 'publish()'. The
+/// reader calls 'acquire()' to get the latest published snapshot , which
+/// stays valid and unchanged until its next call to 'acquire()'. Buffers
+/// are exchanged with a single atomic value , so none of the threads
+/// ever waits for the other one : the writer always has a free buffer ,
+/// and a reader slower than the writer only skips snapshots.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC RenderSnapshotBuffer
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    RenderSnapshotBuffer () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~RenderSnapshotBuffer () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the snapshot owned by the writer.
+    //////////////////////////////////////////////////////////////////////
+    RenderSnapshot & getWriteSnapshot () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Publishes the writer's snapshot and gives it a free one.
+    //////////////////////////////////////////////////////////////////////
+    void publish () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the latest published snapshot , or null if nothing
+    /// was published yet.
+    //////////////////////////////////////////////////////////////////////
+    const RenderSnapshot * acquire () ;
+
+protected:
+
+    /// @brief Flag set in 'iShared' when it holds a snapshot not read yet.
+    static const unsigned int Fresh = 4 ;
+
+    /// @brief The three snapshots.
+    RenderSnapshot iSnapshots [3] ;
+
+    /// @brief Index of the snapshot owned by the writer.
+    unsigned int iWrite ;
+
+    /// @brief Index of the snapshot owned by the reader.
+    unsigned int iRead ;
+
+    /// @brief Index of the snapshot exchanged between them , with the 'Fresh' flag.
+    std::atomic < unsigned int > iShared ;
+
+    /// @brief True once the reader has a published snapshot.
+    bool iReadValid ;
+};
+
+GreEndNamespace
+
+#endif // GRE_RENDERSNAPSHOT_H
@@ -0,0 +1,287 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  RenderStatistics.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_RENDERSTATISTICS_H
+#define GRE_RENDERSTATISTICS_H
+
+#include "Pools.h"
+
+GreBeginNamespace
+
+class HardwareIndexBuffer ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Counters of the rendering work.
+//////////////////////////////////////////////////////////////////////
+struct RenderCounters
+{
+    /// @brief Nodes tested for visibility.
+    size_t nodesVisited ;
+
+    /// @brief Nodes found not visible , by the frustum or by occluders.
+    size_t nodesCulled ;
+
+    /// @brief Draw calls sent to the backend.
+    size_t drawCalls ;
+
+    /// @brief Triangles submitted by the draw calls.
+    size_t triangles ;
+
+    /// @brief Vertices submitted by the draw calls.
+    size_t vertices ;
+
+    /// @brief Techniques bound.
+    size_t techniqueBinds ;
+
+    /// @brief Framebuffers bound.
+    size_t framebufferBinds ;
+
+    /// @brief Textures bound.
+    size_t textureBinds ;
+
+    /// @brief Uniforms sent to the programs.
+    size_t uniformsIssued ;
+
+    /// @brief Uniforms not sent because their value did not change.
+    size_t uniformsFiltered ;
+
+    /// @brief Bytes uploaded to buffers and textures.
+    size_t uploadBytes ;
+
+    /// @brief Lights bound to techniques.
+    size_t lightsBound ;
+
+    RenderCounters () ;
+
+    /// @brief Adds every counters of 'rhs'.
+    RenderCounters & operator += ( const RenderCounters & rhs ) ;
+
+    /// @brief Returns the counters increased since 'rhs' was taken. A
+    /// counter reset meanwhile gives its current value.
+    RenderCounters operator - ( const RenderCounters & rhs ) const ;
+
+    /// @brief Keeps the highest value of each counter.
+    void maximize ( const RenderCounters & rhs ) ;
+
+    /// @brief Divides every counters.
+    RenderCounters operator / ( size_t value ) const ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Counters of one pass.
+//////////////////////////////////////////////////////////////////////
+struct RenderPassStatistics
+{
+    /// @brief Name of the pass.
+    std::string name ;
+
+    /// @brief Work done by the pass.
+    RenderCounters counters ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Counters of one frame.
+//////////////////////////////////////////////////////////////////////
+struct RenderFrameStatistics
+{
+    /// @brief Number of the frame , counted by its RenderStatistics.
+    uint64_t frame ;
+
+    /// @brief Work done during the whole frame.
+    RenderCounters total ;
+
+    /// @brief Work done by each pass , in execution order.
+    std::vector < RenderPassStatistics > passes ;
+
+    RenderFrameStatistics () : frame ( 0 ) { }
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Keeps the rendering counters of the last frames.
+///
+/// The engine and the backends count their work with the static 'Count'
+/// hooks , which increase global counters. A RenderStatistics object
+/// takes them at 'beginFrame()' and 'beginPass()' , and stores what was
+/// counted until 'endPass()' and 'endFrame()'. The uniforms counters are
+/// the ones of 'HardwareProgram'.
+///
+/// Counters are global : work done by other threads or renderers during
+/// a frame is also counted in it.
+///
+/// 'Renderer' and 'RenderPipeline' both own one , reachable with their
+/// 'getStatistics()' function. The last 'getHistorySize()' frames are
+/// kept , to read averages and peaks over a rolling window.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC RenderStatistics
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Creates the statistics , keeping given number of frames.
+    //////////////////////////////////////////////////////////////////////
+    RenderStatistics ( size_t history = 120 ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~RenderStatistics () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Begins a frame.
+    //////////////////////////////////////////////////////////////////////
+    void beginFrame () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Ends the frame and adds it to the history.
+    //////////////////////////////////////////////////////////////////////
+    void endFrame () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Begins a pass in the current frame.
+    //////////////////////////////////////////////////////////////////////
+    void beginPass ( const std::string & name ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Ends the pass begun.
+    //////////////////////////////////////////////////////////////////////
+    void endPass () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Replaces the passes of the current frame , to report passes
+    /// counted by another object.
+    //////////////////////////////////////////////////////////////////////
+    void setPasses ( const std::vector < RenderPassStatistics > & passes ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the last ended frame , or an empty frame.
+    //////////////////////////////////////////////////////////////////////
+    const RenderFrameStatistics & getLastFrame () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the ended frames kept , from the oldest.
+    //////////////////////////////////////////////////////////////////////
+    const std::deque < RenderFrameStatistics > & getHistory () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the average frame counters over the history.
+    //////////////////////////////////////////////////////////////////////
+    RenderCounters getAverage () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the highest frame counters over the history.
+    //////////////////////////////////////////////////////////////////////
+    RenderCounters getMaximum () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the number of frames kept.
+    //////////////////////////////////////////////////////////////////////
+    void setHistorySize ( size_t frames ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    size_t getHistorySize () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Forgets the history.
+    //////////////////////////////////////////////////////////////////////
+    void clear () ;
+
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the global counters , since the program started.
+    //////////////////////////////////////////////////////////////////////
+    static RenderCounters GetCounters () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Counts nodes tested for visibility , and those culled.
+    //////////////////////////////////////////////////////////////////////
+    static void CountNodes ( size_t visited , size_t culled ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Counts a draw call.
+    //////////////////////////////////////////////////////////////////////
+    static void CountDraw ( size_t vertices , size_t triangles ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Counts a draw call of every indices of given buffer.
+    //////////////////////////////////////////////////////////////////////
+    static void CountDraw ( const HardwareIndexBuffer & indices ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    static void CountTechniqueBind () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    static void CountFramebufferBind () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    static void CountTextureBind () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Counts bytes uploaded to a buffer or a texture.
+    //////////////////////////////////////////////////////////////////////
+    static void CountUpload ( size_t bytes ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    static void CountLights ( size_t lights ) ;
+
+protected:
+
+    /// @brief Frames kept.
+    std::deque < RenderFrameStatistics > iHistory ;
+
+    /// @brief Maximum number of frames kept.
+    size_t iHistorySize ;
+
+    /// @brief Frame being counted.
+    RenderFrameStatistics iCurrent ;
+
+    /// @brief Global counters when the frame began.
+    RenderCounters iFrameStart ;
+
+    /// @brief Global counters when the pass began.
+    RenderCounters iPassStart ;
+
+    /// @brief Name of the pass begun.
+    std::string iPassName ;
+
+    /// @brief Frames begun.
+    uint64_t iFrames ;
+};
+
+GreEndNamespace
+
+#endif // GRE_RENDERSTATISTICS_H
@@ -42,6 +42,8 @@
 #include "HardwareProgram.h"
 #include "HardwareProgramManager.h"
 #include "FrameBuffer.h"
+#include "PipelineState.h"
+#include "CommandBuffer.h"
 #include "Viewport.h"
 #include "RenderContext.h"
 #include "Variant.h"
@@ -150,6 +152,50 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual void drawSubMesh ( const SubMeshHolder & submesh ) const = 0 ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Binds the given pipeline state. Nothing is done if an identical
+    /// state is bound , and only the program , framebuffer or raster states
+    /// which differ from the bound state are changed. Uniforms are not part
+    /// of the state and are never skipped here.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool bindPipelineState ( const PipelineStateHolder & state ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Unbinds the program and the framebuffer of the bound state.
+    //////////////////////////////////////////////////////////////////////
+    virtual void unbindPipelineState () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Applies the raster states. The default implementation does
+    /// nothing.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setRasterState ( const RasterState & state ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the pipeline states counters of the current frame ,
+    /// or of the last one once 'render()' returned.
+    //////////////////////////////////////////////////////////////////////
+    virtual const PipelineStats & getPipelineStats () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the counters of the last frames rendered. Passes are
+    /// the ones of the pipeline.
+    //////////////////////////////////////////////////////////////////////
+    virtual const RenderStatistics & getStatistics () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns 'iStatistics' , to change its history size.
+    //////////////////////////////////////////////////////////////////////
+    virtual RenderStatistics & getStatistics () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Executes the recorded commands , in order , on the thread
+    /// owning the render context. The default implementation replays them
+    /// through the techniques , materials and meshes , and draws with
+    /// 'draw()' and 'drawSubMesh()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual void execute ( const CommandBuffer & buffer ) const ;
+
 public:
 
     //////////////////////////////////////////////////////////////////////
@@ -251,6 +297,15 @@ protected:
 
     /// @brief Hold the pipeline currently used by the renderer.
     RenderPipelineHolder iPipeline ;
+
+    /// @brief Pipeline state bound , or null after 'unbindPipelineState()'.
+    mutable PipelineStateHolder iPipelineState ;
+
+    /// @brief Counters of the pipeline states bound in the current frame.
+    mutable PipelineStats iPipelineStats ;
+
+    /// @brief Counters of the last frames rendered.
+    mutable RenderStatistics iStatistics ;
 };
 
 /// @brief Holder for RendererPrivate.
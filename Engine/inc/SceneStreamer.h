@@ -0,0 +1,319 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SceneStreamer.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 22/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_SCENESTREAMER_H
+#define GRE_SCENESTREAMER_H
+
+#include "RenderScene.h"
+#include "JobPool.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief States of a streamed cell.
+enum class StreamingCellState : int
+{
+    /// @brief Nothing is in memory.
+    Unloaded ,
+
+    /// @brief The cell file is being read by a background job.
+    Loading ,
+
+    /// @brief The cell file has been read , nodes are being attached.
+    Attaching ,
+
+    /// @brief Every node is in the scene.
+    Attached ,
+
+    /// @brief Nodes are being removed from the scene.
+    Detaching
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Streams parts of a scene in and out , depending on the
+/// distance to the camera.
+///
+/// The world is split in cells , each one described by a bounding box
+/// and a cell file. A cell file is a text file listing nodes :
+///
+///     node <name>
+///     mesh <path>
+///     material <name>
+///     position <x> <y> <z>
+///     target <x> <y> <z>
+///     scale <x> <y> <z>
+///     static
+///     end
+///
+/// Only 'node' and 'end' are required. Meshes are loaded from their
+/// files , and shared between cells using the same file. Materials ( and
+/// so textures ) are looked up by name in the MaterialManager.
+///
+/// When the camera comes closer than 'iLoadDistance' to a cell , the cell
+/// file is read on the JobPool. The nodes are then created and attached
+/// to the scene on the main thread , but only during 'iFrameBudget'
+/// seconds per update : remaining nodes are attached by the next updates.
+/// Cells farther than 'iUnloadDistance' are detached the same way. When
+/// the memory used by attached cells exceeds 'iMemoryBudget' , the farthest
+/// cells are detached first , and no cell is loaded until memory is back
+/// under the budget.
+///
+/// The streamer is updated by 'update()' , or by update events when added
+/// to the Application with 'addMainThread()'. It must be updated from the
+/// thread owning the render context , as meshes create buffers.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC SceneStreamer : public Resource
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SceneStreamer ( const std::string & name , const RenderSceneHolder & scene ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Waits for the running jobs.
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SceneStreamer () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds a cell with given file and bounds.
+    //////////////////////////////////////////////////////////////////////
+    virtual void addCell ( const std::string & path , const BoundingBox & bounds ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds the cells listed in an index file. Each line of the
+    /// file is 'cell <path> <minx> <miny> <minz> <maxx> <maxy> <maxz>'.
+    /// Relative cell paths are relative to the index file's directory.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool addCells ( const std::string & indexpath ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the node used as camera by 'onUpdateEvent()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setCamera ( const RenderNodeHolder & camera ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the distance under which cells are loaded. Default
+    /// is 100.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setLoadDistance ( float distance ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the distance over which cells are unloaded. Should
+    /// be greater than the load distance , to avoid cells being loaded and
+    /// unloaded continuously at the border. Default is 150.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setUnloadDistance ( float distance ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the memory , in bytes , attached cells may use.
+    /// Default is 256 MB.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setMemoryBudget ( size_t bytes ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the time , in seconds , spent attaching and detaching
+    /// nodes by each update. Default is 2 ms.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setFrameBudget ( float seconds ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Updates the cells from the camera's position.
+    //////////////////////////////////////////////////////////////////////
+    virtual void update ( const Vector3 & camera ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the memory used by the attached cells , in bytes.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getMemoryUsage () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of cells.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getCellsCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the state of given cell.
+    //////////////////////////////////////////////////////////////////////
+    virtual StreamingCellState getCellState ( size_t cell ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Updates the cells from the camera node , if there is one.
+    //////////////////////////////////////////////////////////////////////
+    virtual void onUpdateEvent ( const UpdateEvent & e ) ;
+
+protected:
+
+    /// @brief A node , as read from a cell file.
+    struct NodeEntry
+    {
+        std::string name ;
+        std::string mesh ;
+        std::string material ;
+        Vector3 position ;
+        Vector3 target ;
+        Vector3 scale ;
+        bool hastarget ;
+        bool isstatic ;
+    };
+
+    /// @brief Result of the background job reading a cell file.
+    struct CellData
+    {
+        std::vector < NodeEntry > entries ;
+        bool success ;
+    };
+
+    /// @brief A mesh used by the cells.
+    struct MeshEntry
+    {
+        MeshHolder mesh ;
+
+        /// @brief Number of nodes using the mesh.
+        size_t users ;
+
+        /// @brief Size of the mesh's buffers.
+        size_t memory ;
+    };
+
+    /// @brief A streamed cell.
+    struct Cell
+    {
+        std::string path ;
+        BoundingBox bounds ;
+        StreamingCellState state ;
+
+        /// @brief Distance to the camera at the last update.
+        float distance ;
+
+        /// @brief Memory used by the meshes of this cell. A mesh used by many
+        /// nodes of the cell is counted once. Meshes shared with other cells
+        /// are counted by each cell.
+        size_t memory ;
+
+        /// @brief Number of attached nodes using each mesh file.
+        std::map < std::string , size_t > meshusers ;
+
+        /// @brief Background job reading the cell file , and its result.
+        std::future < void > job ;
+        std::shared_ptr < CellData > data ;
+
+        /// @brief Number of entries already attached.
+        size_t attached ;
+
+        /// @brief Nodes attached to the scene , and their mesh files.
+        std::vector < RenderNodeHolder > nodes ;
+        std::vector < std::string > meshes ;
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Reads a cell file. Runs on the JobPool.
+    //////////////////////////////////////////////////////////////////////
+    static void ReadCell ( const std::string & path , CellData & data ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Creates the node for next entry of the cell and attaches it.
+    //////////////////////////////////////////////////////////////////////
+    void attachNext ( Cell & cell ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Detaches the last node of the cell.
+    //////////////////////////////////////////////////////////////////////
+    void detachNext ( Cell & cell ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Releases the mesh of a node detached from the cell. The mesh's
+    /// memory is removed from the cell with its last node.
+    //////////////////////////////////////////////////////////////////////
+    void releaseCellMesh ( Cell & cell , const std::string & path ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the mesh from given file , loading it if needed.
+    //////////////////////////////////////////////////////////////////////
+    MeshHolder acquireMesh ( const std::string & path , size_t & memory ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the size of the buffers of given mesh.
+    //////////////////////////////////////////////////////////////////////
+    static size_t MeshMemory ( const MeshHolder & mesh ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the distance from given point to given box.
+    //////////////////////////////////////////////////////////////////////
+    static float Distance ( const BoundingBox & box , const Vector3 & point ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Releases a mesh acquired by 'acquireMesh()'. The mesh is
+    /// unloaded when no cell uses it anymore.
+    //////////////////////////////////////////////////////////////////////
+    void releaseMesh ( const std::string & path ) ;
+
+protected:
+
+    /// @brief Scene receiving the nodes.
+    RenderSceneHolder iScene ;
+
+    /// @brief Node used as camera by 'onUpdateEvent()'.
+    RenderNodeHolder iCamera ;
+
+    /// @brief Every cells.
+    std::vector < Cell > iCells ;
+
+    /// @brief Meshes used by the cells , by file.
+    std::map < std::string , MeshEntry > iMeshes ;
+
+    /// @brief Distance under which cells are loaded.
+    float iLoadDistance ;
+
+    /// @brief Distance over which cells are unloaded.
+    float iUnloadDistance ;
+
+    /// @brief Memory attached cells may use.
+    size_t iMemoryBudget ;
+
+    /// @brief Memory used by the attached cells.
+    size_t iMemoryUsage ;
+
+    /// @brief Time spent attaching and detaching nodes per update.
+    float iFrameBudget ;
+
+    /// @brief Maximum number of cell files read at the same time.
+    size_t iMaxJobs ;
+};
+
+/// @brief Holder for SceneStreamer.
+typedef Holder < SceneStreamer > SceneStreamerHolder ;
+
+GreEndNamespace
+
+#endif // GRE_SCENESTREAMER_H
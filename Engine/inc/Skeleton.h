@@ -0,0 +1,164 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  Skeleton.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_SKELETON_H
+#define GRE_SKELETON_H
+
+#include "Resource.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Local transformation of a bone , relative to its parent.
+struct BoneTransform
+{
+    Vector3 translation ;
+    Quaternion rotation ;
+    Vector3 scale ;
+
+    BoneTransform () : translation ( 0.0f , 0.0f , 0.0f ) , rotation () , scale ( 1.0f , 1.0f , 1.0f ) { }
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the matrix of this transformation.
+    //////////////////////////////////////////////////////////////////////
+    Matrix4 toMatrix () const ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Local transformations of every bones of a skeleton.
+typedef std::vector < BoneTransform > Pose ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A bone of a skeleton.
+struct Bone
+{
+    /// @brief Name of the bone , used to find it from animation files.
+    std::string name ;
+
+    /// @brief Index of the parent bone , or -1 for a root.
+    int parent ;
+
+    /// @brief Local transformation in the bind pose.
+    BoneTransform bind ;
+
+    /// @brief Inverse of the bone's transformation in model space in the
+    /// bind pose. Moves a vertex from model space to bone space.
+    Matrix4 inversebind ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A hierarchy of bones used to deform a skinned mesh.
+///
+/// Bones are stored in an array where a parent always comes before its
+/// children , so poses are converted to model space in one pass. A pose
+/// is a local transformation for each bone , sampled from an AnimationClip
+/// or blended from other poses , and 'computePalette()' converts it to the
+/// matrices used by the skinning.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC Skeleton : public Resource
+{
+public:
+
+    POOLED ( Pools::Resource )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    Skeleton ( const std::string & name = std::string () ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~Skeleton () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds a bone and returns its index , or -1 if 'parent' is not
+    /// a bone already added.
+    //////////////////////////////////////////////////////////////////////
+    virtual int addBone ( const std::string & name , int parent , const BoneTransform & bind ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the index of the bone with given name , or -1.
+    //////////////////////////////////////////////////////////////////////
+    virtual int findBone ( const std::string & name ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the bones.
+    //////////////////////////////////////////////////////////////////////
+    virtual const std::vector < Bone > & getBones () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of bones.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getBonesCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the bind pose.
+    //////////////////////////////////////////////////////////////////////
+    virtual const Pose & getBindPose () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Converts 'pose' to the skinning matrices : the model space
+    /// transformation of each bone multiplied by its inverse bind matrix.
+    //////////////////////////////////////////////////////////////////////
+    virtual void computePalette ( const Pose & pose , std::vector < Matrix4 > & palette ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Blends two poses with the same number of bones. A weight of
+    /// zero gives 'from' and a weight of one gives 'to'. 'result' may be one
+    /// of the two poses.
+    //////////////////////////////////////////////////////////////////////
+    static void Blend ( const Pose & from , const Pose & to , float weight , Pose & result ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Interpolates two rotations along the shortest path and
+    /// normalizes the result.
+    //////////////////////////////////////////////////////////////////////
+    static Quaternion Nlerp ( const Quaternion & from , const Quaternion & to , float weight ) ;
+
+protected:
+
+    /// @brief Bones , parents first.
+    std::vector < Bone > iBones ;
+
+    /// @brief Local transformation of each bone in the bind pose.
+    Pose iBindPose ;
+
+    /// @brief Model space transformation of each bone in the bind pose.
+    std::vector < Matrix4 > iBindMatrices ;
+};
+
+/// @brief Holder for Skeleton.
+typedef Holder < Skeleton > SkeletonHolder ;
+
+GreEndNamespace
+
+#endif // GRE_SKELETON_H
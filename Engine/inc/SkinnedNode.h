@@ -0,0 +1,249 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SkinnedNode.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_SKINNEDNODE_H
+#define GRE_SKINNEDNODE_H
+
+#include "RenderNode.h"
+#include "AnimationClip.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Vertices of one submesh of a skinned mesh.
+struct SkinnedPart
+{
+    /// @brief Submesh in the bind pose. Its index buffer and material are
+    /// used by the skinned submesh.
+    SubMeshHolder submesh ;
+
+    /// @brief Copy of the vertices in the bind pose.
+    std::vector < char > source ;
+
+    /// @brief Skinned vertices , with the same layout.
+    std::vector < char > output ;
+
+    /// @brief Size of one vertex , and number of vertices.
+    size_t stride , count ;
+
+    /// @brief Offsets of the components in a vertex. 'normal' is -1 when
+    /// the submesh has no normals.
+    size_t position , indices , weights ;
+    int normal ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A RenderNode deforming a mesh with a skeleton.
+///
+/// The mesh given to 'setSkinnedMesh()' is in the bind pose. Each submesh
+/// must keep a CPU copy of its vertex buffer , with a 3 floats position ,
+/// 4 unsigned bytes 'BoneIndices' and 4 floats 'BoneWeights' , and
+/// optionally a 3 floats normal. Other components are copied unchanged.
+///
+/// 'animate()' advances the clip played , samples it ( blending with the
+/// previous clip during a cross fade ) , computes the bones matrices and
+/// skins every vertex on the CPU. 'upload()' then copies the vertices to
+/// the next mesh of a ring of two , whose index buffers are the ones of
+/// the bind mesh. Update events do both , but many characters are better
+/// animated with 'Animate()' , which skins them in parallel on the JobPool.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC SkinnedNode : public RenderNode
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SkinnedNode ( const RenderScene * creator , const std::string & name = std::string () ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SkinnedNode () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the skeleton. The pose is reset to the bind pose.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setSkeleton ( const SkeletonHolder & skeleton ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the skeleton.
+    //////////////////////////////////////////////////////////////////////
+    virtual const SkeletonHolder & getSkeleton () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Reads the vertices of a mesh in the bind pose. Returns false
+    /// if one of its submeshes can't be skinned.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool setSkinnedMesh ( const MeshHolder & mesh ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Plays a clip from its beginning. If 'fade' is positive , the
+    /// clip played before is blended out during 'fade' seconds.
+    //////////////////////////////////////////////////////////////////////
+    virtual void play ( const AnimationClipHolder & clip , bool loop = true , float fade = 0.0f ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the clip played.
+    //////////////////////////////////////////////////////////////////////
+    virtual const AnimationClipHolder & getClip () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the time in the clip played , in seconds.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setTime ( float time ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the time in the clip played , in seconds.
+    //////////////////////////////////////////////////////////////////////
+    virtual float getTime () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the playback speed. Default is 1.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setSpeed ( float speed ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the playback speed.
+    //////////////////////////////////////////////////////////////////////
+    virtual float getSpeed () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief If false , update events don't animate the node anymore and
+    /// 'animate()' and 'upload()' ( or 'Animate()' ) must be called by the
+    /// user. Default is true.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setAutoAnimate ( bool value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if update events animate the node.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isAutoAnimate () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Advances the animation by 'elapsed' seconds and skins the
+    /// vertices. Doesn't touch any hardware buffer , so different nodes can
+    /// be animated on different threads.
+    //////////////////////////////////////////////////////////////////////
+    virtual void animate ( float elapsed ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Copies the skinned vertices to the next mesh of the ring and
+    /// sets it to this node. Must be called from a thread where buffers can
+    /// be created.
+    //////////////////////////////////////////////////////////////////////
+    virtual void upload () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the pose computed by the last 'animate()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual const Pose & getPose () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the bones matrices computed by the last 'animate()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual const std::vector < Matrix4 > & getPalette () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the submeshes vertices.
+    //////////////////////////////////////////////////////////////////////
+    virtual const std::vector < SkinnedPart > & getParts () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Animates every node on the JobPool , one node per job , then
+    /// uploads them on this thread.
+    //////////////////////////////////////////////////////////////////////
+    static void Animate ( const std::vector < SkinnedNode * > & nodes , float elapsed ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Skins the vertices of a part with linear blending of up to
+    /// four bones per vertex , and adds the skinned positions to 'bbox'.
+    //////////////////////////////////////////////////////////////////////
+    static void Skin ( SkinnedPart & part , const std::vector < Matrix4 > & palette , BoundingBox & bbox ) ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Updates the node , then animates it if 'iAutoAnimate' is true.
+    //////////////////////////////////////////////////////////////////////
+    virtual void onUpdateEvent ( const UpdateEvent & e ) ;
+
+protected:
+
+    /// @brief Skeleton deforming the mesh.
+    SkeletonHolder iSkeleton ;
+
+    /// @brief Submeshes vertices.
+    std::vector < SkinnedPart > iParts ;
+
+    /// @brief Highest bone index used by the vertices.
+    size_t iMaxBone ;
+
+    /// @brief Clip played , its time and its looping flag.
+    AnimationClipHolder iClip ;
+    float iTime ;
+    bool iLoop ;
+
+    /// @brief Clip faded out , its time and its looping flag.
+    AnimationClipHolder iPreviousClip ;
+    float iPreviousTime ;
+    bool iPreviousLoop ;
+
+    /// @brief Duration of the cross fade , and time since it started.
+    float iFadeDuration ;
+    float iFadeTime ;
+
+    /// @brief Playback speed.
+    float iSpeed ;
+
+    /// @brief True if update events animate the node.
+    bool iAutoAnimate ;
+
+    /// @brief Pose of the clip played , and pose of the clip faded out.
+    Pose iPose ;
+    Pose iPreviousPose ;
+
+    /// @brief Bones matrices.
+    std::vector < Matrix4 > iPalette ;
+
+    /// @brief Bounding box of the skinned vertices , relative to the node.
+    BoundingBox iSkinnedBox ;
+
+    /// @brief Ring of meshes the vertices are uploaded to.
+    std::vector < MeshHolder > iMeshes ;
+
+    /// @brief Next mesh of the ring to write.
+    size_t iNextMesh ;
+};
+
+GreEndNamespace
+
+#endif // GRE_SKINNEDNODE_H
@@ -0,0 +1,233 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SpatialIndex.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 24/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_SPATIALINDEX_H
+#define GRE_SPATIALINDEX_H
+
+#include "AabbTree.h"
+#include "RenderNode.h"
+
+#include <condition_variable>
+#include <memory>
+#include <unordered_map>
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Result of a raycast.
+//////////////////////////////////////////////////////////////////////
+struct RaycastHit
+{
+    /// @brief Node hit , invalid if nothing was hit.
+    RenderNodeHolder node ;
+
+    /// @brief Distance from the ray origin.
+    float distance ;
+
+    /// @brief Point hit , in world space.
+    Vector3 point ;
+
+    /// @brief True if a triangle of the node's mesh was hit , false if only
+    /// its bounding box was tested.
+    bool triangle ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Spatial queries on the nodes of a RenderScene.
+///
+/// Nodes with a valid bounding box are kept in an AabbTree , updated by
+/// the scene when nodes are added , moved or removed. Queries do not lock
+/// the scene nor walk its nodes : they only read the tree , under a shared
+/// lock , so any number of threads ( for example JobPool jobs ) can query
+/// at the same time. Updates take the lock exclusively.
+///
+/// Nodes are never locked while the index is : the scene updates the
+/// index with the node locked , so a query copies the entries it found and
+/// only reads their nodes once the shared lock is released.
+///
+/// Raycasts test node bounding boxes. When 'triangles' is true , nodes whose
+/// mesh keeps a CPU copy of its buffers ( software buffers ) are refined by
+/// testing their triangles. Other nodes are hit at their bounding box.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC SpatialIndex
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SpatialIndex ( float margin = 0.1f ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~SpatialIndex () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds a node , or moves it if already there. Nodes without a
+    /// valid bounding box are removed.
+    //////////////////////////////////////////////////////////////////////
+    void update ( const RenderNodeHolder & node ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes a node.
+    //////////////////////////////////////////////////////////////////////
+    void remove ( const RenderNodeHolder & node ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes every nodes.
+    //////////////////////////////////////////////////////////////////////
+    void clear () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the nearest node hit by the ray , closer than
+    /// 'maxdistance'. Returns false if nothing is hit.
+    //////////////////////////////////////////////////////////////////////
+    bool raycast ( const Vector3 & origin , const Vector3 & direction , float maxdistance ,
+                   RaycastHit & hit , bool triangles = false ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Appends the nodes whose bounding box overlaps the sphere.
+    //////////////////////////////////////////////////////////////////////
+    void overlapSphere ( const Vector3 & center , float radius , RenderNodeHolderList & result ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Appends the nodes whose bounding box overlaps the box.
+    //////////////////////////////////////////////////////////////////////
+    void overlapBox ( const BoundingBox & box , RenderNodeHolderList & result ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Appends the 'count' nodes nearest to the point , nearest
+    /// first. Distances are measured to the bounding boxes.
+    //////////////////////////////////////////////////////////////////////
+    void nearest ( const Vector3 & point , size_t count , RenderNodeHolderList & result ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of nodes.
+    //////////////////////////////////////////////////////////////////////
+    size_t getCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Tests the ray against the triangles of given node. Returns
+    /// the distance of the nearest triangle hit , -1 if none is hit , or -2
+    /// if the node has no triangles on the CPU.
+    //////////////////////////////////////////////////////////////////////
+    static float RaycastTriangles ( const RenderNode * node , const Vector3 & origin ,
+                                    const Vector3 & direction , float maxdistance ) ;
+
+protected:
+
+    /// @brief A node in the tree. Leaves hold 'const IndexedNode*' , and
+    /// queries share the entries they found to keep their nodes alive.
+    struct IndexedNode : public std::enable_shared_from_this < IndexedNode >
+    {
+        /// @brief Keeps the node alive while indexed.
+        RenderNodeHolder node ;
+
+        /// @brief Leaf of the node.
+        int proxy ;
+    };
+
+    typedef std::shared_ptr < const IndexedNode > IndexedNodeHolder ;
+    typedef std::vector < IndexedNodeHolder > IndexedNodeHolderList ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Holds the shared lock while alive.
+    //////////////////////////////////////////////////////////////////////
+    class SharedLock
+    {
+    public:
+
+        SharedLock ( const SpatialIndex & index ) : iIndex ( index ) { iIndex.lockShared () ; }
+        ~SharedLock () { iIndex.unlockShared () ; }
+
+    private:
+
+        const SpatialIndex & iIndex ;
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Holds the exclusive lock while alive.
+    //////////////////////////////////////////////////////////////////////
+    class ExclusiveLock
+    {
+    public:
+
+        ExclusiveLock ( const SpatialIndex & index ) : iIndex ( index ) { iIndex.lockExclusive () ; }
+        ~ExclusiveLock () { iIndex.unlockExclusive () ; }
+
+    private:
+
+        const SpatialIndex & iIndex ;
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Shared lock for queries.
+    //////////////////////////////////////////////////////////////////////
+    void lockShared () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    void unlockShared () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Exclusive lock for updates.
+    //////////////////////////////////////////////////////////////////////
+    void lockExclusive () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    void unlockExclusive () const ;
+
+protected:
+
+    /// @brief Bounding volume hierarchy. Leaves hold 'const IndexedNode*'.
+    AabbTree iTree ;
+
+    /// @brief Indexed nodes.
+    std::unordered_map < const RenderNode * , std::shared_ptr < IndexedNode > > iNodes ;
+
+    /// @brief Protects 'iReaders' and 'iWriting'.
+    mutable std::mutex iMutex ;
+
+    /// @brief Signaled when the lock is released.
+    mutable std::condition_variable iCondition ;
+
+    /// @brief Number of running queries.
+    mutable size_t iReaders ;
+
+    /// @brief True while an update runs.
+    mutable bool iWriting ;
+};
+
+GreEndNamespace
+
+#endif // GRE_SPATIALINDEX_H
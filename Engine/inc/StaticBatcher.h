@@ -0,0 +1,198 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  StaticBatcher.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 20/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_STATICBATCHER_H
+#define GRE_STATICBATCHER_H
+
+#include "RenderNode.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Merges static nodes into a few large meshes.
+///
+/// Static nodes are grouped by material and vertex layout , then split
+/// in cubic chunks of 'iChunkSize' world units from their bounding box
+/// center. Each chunk is merged in one vertex buffer and one index buffer
+/// with vertices already transformed in world space , and drawn by a
+/// single node ( the chunk's batch ) with one draw call per chunk.
+///
+/// Adding or removing a static node only marks its chunks dirty , and
+/// 'build()' merges the dirty chunks again. Merging runs on the JobPool ,
+/// one chunk per job , then buffers are created on the calling thread.
+///
+/// Only meshes keeping a CPU copy of their buffers can be merged : each
+/// submesh must use one local vertex buffer with a 3 floats position ,
+/// and triangle indices. Other nodes are refused by 'add()' and keep
+/// being drawn by themselves. A batched node must not move : remove it
+/// from the scene and add it again instead.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC StaticBatcher
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    StaticBatcher ( float chunksize = 64.0f ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~StaticBatcher () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds a static node. Returns false if its mesh can't be
+    /// merged. The node is marked as batched only by 'build()'.
+    //////////////////////////////////////////////////////////////////////
+    bool add ( const RenderNodeHolder & node ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes a node added with 'add()'. The node is drawn by itself
+    /// again immediately.
+    //////////////////////////////////////////////////////////////////////
+    void remove ( const RenderNodeHolder & node ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if some chunks must be built again.
+    //////////////////////////////////////////////////////////////////////
+    bool isDirty () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Merges every dirty chunk. Must be called from a thread where
+    /// buffers can be created. 'scene' is the creator of the batch nodes.
+    //////////////////////////////////////////////////////////////////////
+    void build ( const RenderScene * scene ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds to 'result' the batches intersecting the frustum.
+    //////////////////////////////////////////////////////////////////////
+    void visible ( const Frustum & frustum , RenderNodeHolderList & result ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Same as above , without making holders.
+    //////////////////////////////////////////////////////////////////////
+    void visible ( const Frustum & frustum , std::vector < const RenderNode * > & result ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns every batch node built.
+    //////////////////////////////////////////////////////////////////////
+    RenderNodeHolderList getBatches () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the chunk size.
+    //////////////////////////////////////////////////////////////////////
+    float getChunkSize () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the chunk size. Every nodes are distributed again
+    /// and every chunks are built again by the next 'build()'.
+    //////////////////////////////////////////////////////////////////////
+    void setChunkSize ( float size ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of chunks.
+    //////////////////////////////////////////////////////////////////////
+    size_t getChunksCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes every nodes and destroys every batches.
+    //////////////////////////////////////////////////////////////////////
+    void clear () ;
+
+protected:
+
+    /// @brief A submesh of a static node.
+    struct Part
+    {
+        /// @brief The static node.
+        RenderNodeHolder node ;
+
+        /// @brief The submesh merged.
+        SubMeshHolder submesh ;
+    };
+
+    /// @brief Material and vertex layout shared by the parts of a chunk.
+    struct Group
+    {
+        MaterialHolder material ;
+        VertexDescriptor descriptor ;
+    };
+
+    /// @brief Identifies a chunk by group and cell.
+    struct ChunkKey
+    {
+        size_t group ;
+        int x , y , z ;
+
+        bool operator < ( const ChunkKey & rhs ) const ;
+    };
+
+    /// @brief Parts merged together , and the node drawing them.
+    struct Chunk
+    {
+        std::vector < Part > parts ;
+        RenderNodeHolder batch ;
+        bool dirty ;
+    };
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the group index for given material and layout ,
+    /// creating it if needed.
+    //////////////////////////////////////////////////////////////////////
+    size_t findGroup ( const MaterialHolder & material , const VertexDescriptor & descriptor ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if the submesh can be merged.
+    //////////////////////////////////////////////////////////////////////
+    static bool IsMergeable ( const SubMeshHolder & submesh ) ;
+
+protected:
+
+    /// @brief Size of a chunk , in world units.
+    float iChunkSize ;
+
+    /// @brief Every group found.
+    std::vector < Group > iGroups ;
+
+    /// @brief Every chunks.
+    std::map < ChunkKey , Chunk > iChunks ;
+
+    /// @brief Chunks of every static node.
+    std::map < const RenderNode * , std::vector < ChunkKey > > iNodes ;
+
+    /// @brief Number of batches created , used to name them.
+    size_t iBatchesCount ;
+};
+
+GreEndNamespace
+
+#endif // GRE_STATICBATCHER_H
@@ -38,6 +38,7 @@
 #include "SpecializedResourceManager.h"
 #include "FrameBuffer.h"
 #include "HardwareProgram.h"
+#include "PipelineState.h"
 #include "ResourceBundle.h"
 
 GreBeginNamespace
@@ -68,7 +69,7 @@ enum class TechniqueParam : int
     None ,
 
     ModelMatrix , ViewMatrix , ProjectionMatrix , ProjectionViewMatrix ,
-    NormalMatrix , NormalMatrix3 ,
+    NormalMatrix , NormalMatrix3 , ModelViewMatrix , ProjectionViewModelMatrix ,
 
     CameraPosition , CameraDirection ,
 
@@ -77,7 +78,7 @@ enum class TechniqueParam : int
     ClearColor , ClearDepth ,
 
     Light0 , Light1 , Light2 , Light3 , Light4 , Light5 , Light6 , Light7 ,
-    Light8 , Light9 ,
+    Light8 , Light9 , LightCount ,
 
     LightAmbient , LightDiffuse , LightSpecular , LightPosition , LightDirection ,
     LightAttCst , LightAttLine , LightAttQuad ,
@@ -95,6 +96,23 @@ enum class TechniqueParam : int
 /// @brief Translates a string into a TechniqueParam.
 TechniqueParam TechniqueParamFromString ( const std::string & param ) ;
 
+/// @brief Number of values in TechniqueParam.
+static const size_t TechniqueParamCount = (size_t) TechniqueParam::MaterialShininess + 1 ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A program's uniform resolved for a TechniqueParam.
+struct TechniqueUniform
+{
+    /// @brief True if the technique has an alias for the parameter.
+    bool named ;
+
+    /// @brief Location of the uniform , or -1 if the program doesn't have it.
+    int location ;
+
+    /// @brief Type of the uniform.
+    HdwProgVarType type ;
+};
+
 //////////////////////////////////////////////////////////////////////
 /// @brief Represents a set of shader's parameters to draw something
 /// in the binded context by the renderer.
@@ -183,6 +201,23 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual void setFramebuffer ( const RenderFramebufferHolder & framebuffer ) ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the raster states used when drawing.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setRasterState ( const RasterState & state ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the raster states used when drawing.
+    //////////////////////////////////////////////////////////////////////
+    virtual const RasterState & getRasterState () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the pipeline state made of the program , framebuffer ,
+    /// raster states and attributes names. It is created again only after
+    /// one of them changed , or after the program was linked again.
+    //////////////////////////////////////////////////////////////////////
+    virtual const PipelineStateHolder & getPipelineState () const ;
+
     //////////////////////////////////////////////////////////////////////
     /// @brief Sets the alias for the given parameter.
     //////////////////////////////////////////////////////////////////////
@@ -217,15 +252,54 @@ public:
                                          const RealProgramVariable & value) const ;
 
     //////////////////////////////////////////////////////////////////////
-    /// @brief Binds the technique's shader program.
+    /// @brief Returns true if the program declares the uniform block for
+    /// given binding.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool hasUniformBlock ( const UniformBlockBinding & binding ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Stages the block in 'UniformArena::Get()' and binds it to the
+    /// program. Returns false if the program doesn't declare the block , or
+    /// if the backend can't bind blocks : the values must then be set one
+    /// by one.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool setUniformBlock ( const UniformBlockBinding & binding , const UniformBlock & block ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the block owned by the technique for given binding.
+    /// Pass and Object blocks have the standard layouts and are filled by
+    /// the RenderPass.
+    //////////////////////////////////////////////////////////////////////
+    virtual UniformBlock & getUniformBlock ( const UniformBlockBinding & binding ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Binds the technique's shader program. If the program declares
+    /// the Frame block , every globals are bound with it instead of the
+    /// 'GlobAlias' actions. The technique's own blocks bound before are bound
+    /// again , as another technique may have used their binding.
     //////////////////////////////////////////////////////////////////////
     virtual void bind () const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Binds the technique's pipeline state through the renderer ,
+    /// which does nothing if an identical state is bound , then binds the
+    /// blocks and globals as 'bind()'. Only the state objects are skipped :
+    /// blocks and globals are always bound again , as the globals , or a
+    /// technique using the same program , may have changed them meanwhile.
+    /// The program filters the uniforms whose value did not change.
+    //////////////////////////////////////////////////////////////////////
+    virtual void bind ( const Renderer * renderer ) const ;
+
     //////////////////////////////////////////////////////////////////////
     /// @brief Unbinds the technique's shader program.
     //////////////////////////////////////////////////////////////////////
     virtual void unbind () const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Unbinds the pipeline state bound by the renderer.
+    //////////////////////////////////////////////////////////////////////
+    virtual void unbind ( const Renderer * renderer ) const ;
+
     //////////////////////////////////////////////////////////////////////
     /// @brief Returns the next Alias a node or a render object may use to
     /// send values to the shader object lights.
@@ -243,6 +317,12 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual void resetLights () const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the maximum number of lights that can be bound at
+    /// once , limited by the program and by the number of light aliases.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getMaximumLights () const ;
+
     //////////////////////////////////////////////////////////////////////
     /// @brief Adds a texture to an object structure using two aliases.
     //////////////////////////////////////////////////////////////////////
@@ -318,6 +398,24 @@ public:
 
 protected:
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Binds the blocks and the globals once the program is bound.
+    //////////////////////////////////////////////////////////////////////
+    void bindParameters () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Resolves the uniforms of every parameters if the aliases or
+    /// the program changed since the last call.
+    //////////////////////////////////////////////////////////////////////
+    void updateUniformTable () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the slot of a structure alias in the uniforms table :
+    /// 0 for None ( the member is used alone ) , 1 to 10 for Light0 to Light9 ,
+    /// or -1 if the alias is not in the table.
+    //////////////////////////////////////////////////////////////////////
+    int getUniformSlot ( const TechniqueParam & alias ) const ;
+
     //////////////////////////////////////////////////////////////////////
     /// @brief Pushes a new texture, activating the corresponding texture
     /// unit and binding the texture. The texture unit is given by the
@@ -385,6 +483,42 @@ protected:
     /// @brief Holds a list of 'GlobAlias' actions. When the technique is bound , after binding the program ,
     /// it will automatically bind the given Global Variables to the given named program parameter.
     std::map < std::string , std::string > iGlobALiases ;
+
+    /// @brief Uniforms resolved for every parameter , 'TechniqueParamCount' entries per slot
+    /// ( see 'GetUniformSlot()' ). Slot 0 holds the parameters used alone , and the other slots
+    /// the parameters used as members of a light structure. This avoids building and looking
+    /// for the uniform's name each time a parameter is set.
+    mutable std::vector < TechniqueUniform > iUniformTable ;
+
+    /// @brief For each slot , true if the structure alias is not empty. For slot 0 , true if
+    /// None has an alias , in which case structures using it don't use the table.
+    mutable std::vector < bool > iUniformSlots ;
+
+    /// @brief For each parameter , true if a 'GlobSet' action uses it.
+    mutable std::vector < bool > iGlobSetParams ;
+
+    /// @brief True if aliases changed since 'iUniformTable' was built.
+    mutable bool iUniformTableDirty ;
+
+    /// @brief Program and link version used to build 'iUniformTable'.
+    mutable const HardwareProgram * iUniformTableProgram ;
+    mutable size_t iUniformTableVersion ;
+
+    /// @brief Raster states used when drawing.
+    RasterState iRasterState ;
+
+    /// @brief Pipeline state created from the values above.
+    mutable PipelineStateHolder iPipelineState ;
+
+    /// @brief True if a value used by the pipeline state changed.
+    mutable bool iPipelineStateDirty ;
+
+    /// @brief Pass and Object blocks , filled by the RenderPass.
+    mutable UniformBlock iBlocks [UniformBlockBindingCount] ;
+
+    /// @brief Blocks bound since the technique was bound. They are staged again
+    /// if the arena starts again at zero while drawing.
+    mutable const UniformBlock * iBoundBlocks [UniformBlockBindingCount] ;
 };
 
 GRE_MAKE_HOLDER( Technique );
@@ -443,6 +577,13 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual const HardwareProgramVariable & getGlobal ( const std::string & name ) const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the Frame block , holding every globals in the order
+    /// of their names. Globals which can't be stored in a block , as samplers ,
+    /// are skipped.
+    //////////////////////////////////////////////////////////////////////
+    virtual const UniformBlock & getGlobalsBlock () const ;
+
 protected:
 
     /// @brief Holds Globals used by other Technique's. Those globals are used
@@ -450,6 +591,15 @@ protected:
     /// a possible manual transmitting behavior. Those globals can be defined
     /// directly in the 'tech' file , and used with 'GlobSet' and 'GlobAlias'.
     std::map < std::string , HardwareProgramVariable > iGlobalsByName ;
+
+    /// @brief Globals packed for the Frame block.
+    mutable UniformBlock iGlobalsBlock ;
+
+    /// @brief True if a global was added since the block's layout was built.
+    mutable bool iGlobalsLayoutDirty ;
+
+    /// @brief True if a global changed since the block was packed.
+    mutable bool iGlobalsBlockDirty ;
 };
 
 GRE_MAKE_HOLDER( TechniqueManager );
@@ -0,0 +1,333 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  UniformBlock.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_UNIFORMBLOCK_H
+#define GRE_UNIFORMBLOCK_H
+
+#include "Pools.h"
+#include "HardwareProgramVariable.h"
+
+GreBeginNamespace
+
+enum class TechniqueParam : int ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Binding points of the uniform blocks filled by the engine.
+/// A program declares a block with the name given by 'UniformBlockName()'
+/// and the members of the matching standard layout , in the same order.
+enum class UniformBlockBinding : int
+{
+    /// @brief Technique's globals , in the order of their names.
+    Frame ,
+
+    /// @brief Camera's matrices , position and direction.
+    Pass ,
+
+    /// @brief Material's colors and shininess.
+    Material ,
+
+    /// @brief Node's matrices.
+    Object
+};
+
+/// @brief Number of values in UniformBlockBinding.
+static const size_t UniformBlockBindingCount = (size_t) UniformBlockBinding::Object + 1 ;
+
+/// @brief Returns the name of the block a program should declare for
+/// the given binding.
+const char* UniformBlockName ( const UniformBlockBinding & binding ) ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A member of a uniform block.
+struct UniformBlockMember
+{
+    /// @brief Name of the member , used to find globals.
+    std::string name ;
+
+    /// @brief Parameter set in this member , or TechniqueParam::None.
+    TechniqueParam param ;
+
+    /// @brief Type of the member.
+    HdwProgVarType type ;
+
+    /// @brief Offset of the member in the block , in bytes.
+    size_t offset ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Describes the members of a uniform block , placed with the
+/// std140 rules : vectors of three and four components , and matrices
+/// columns , are aligned on 16 bytes. Samplers are not allowed.
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC UniformBlockLayout
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Constructs an empty layout.
+    //////////////////////////////////////////////////////////////////////
+    UniformBlockLayout () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds a member after the last one. Returns false if the type
+    /// can't be stored in a block.
+    //////////////////////////////////////////////////////////////////////
+    bool addMember ( const std::string & name , const HdwProgVarType & type ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Adds a member for the given parameter.
+    //////////////////////////////////////////////////////////////////////
+    bool addMember ( const TechniqueParam & param , const HdwProgVarType & type ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the index of the member with given name , or -1.
+    //////////////////////////////////////////////////////////////////////
+    int findMember ( const std::string & name ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the index of the member for given parameter , or -1.
+    //////////////////////////////////////////////////////////////////////
+    int findMember ( const TechniqueParam & param ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the members.
+    //////////////////////////////////////////////////////////////////////
+    const std::vector < UniformBlockMember > & getMembers () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the size of the block , rounded to 16 bytes.
+    //////////////////////////////////////////////////////////////////////
+    size_t getSize () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes every members.
+    //////////////////////////////////////////////////////////////////////
+    void clear () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the std140 alignment of a type , or 0 if it can't
+    /// be stored in a block.
+    //////////////////////////////////////////////////////////////////////
+    static size_t GetAlignment ( const HdwProgVarType & type ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the std140 size of a type , or 0 if it can't be
+    /// stored in a block.
+    //////////////////////////////////////////////////////////////////////
+    static size_t GetSize ( const HdwProgVarType & type ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the layout filled by the engine for the given binding.
+    /// The Frame layout is empty , as it depends on the globals.
+    ///
+    /// Pass : ViewMatrix , ProjectionMatrix , ProjectionViewMatrix (mat4) ,
+    /// CameraPosition , CameraDirection (vec3).
+    /// Material : MaterialAmbient , MaterialDiffuse , MaterialSpecular (vec3) ,
+    /// MaterialShininess (float).
+    /// Object : ModelMatrix , ModelViewMatrix , ProjectionViewModelMatrix (mat4) ,
+    /// NormalMatrix3 (mat3).
+    //////////////////////////////////////////////////////////////////////
+    static const UniformBlockLayout & Standard ( const UniformBlockBinding & binding ) ;
+
+protected:
+
+    /// @brief Members , ordered by offset.
+    std::vector < UniformBlockMember > iMembers ;
+
+    /// @brief Size used by the members , not rounded.
+    size_t iSize ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Holds the values of a uniform block , packed as the program
+/// reads them. The version changes only when a value really changes ,
+/// so a block already staged is not staged again.
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC UniformBlock
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Constructs a block with given layout , filled with zeros.
+    //////////////////////////////////////////////////////////////////////
+    UniformBlock ( const UniformBlockLayout & layout = UniformBlockLayout () ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the layout and fills the block with zeros.
+    //////////////////////////////////////////////////////////////////////
+    void setLayout ( const UniformBlockLayout & layout ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the layout.
+    //////////////////////////////////////////////////////////////////////
+    const UniformBlockLayout & getLayout () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Packs the value of the member at given index. The value must
+    /// have the member's type.
+    //////////////////////////////////////////////////////////////////////
+    bool set ( int member , const RealProgramVariable & value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Packs the value of the member for given parameter.
+    //////////////////////////////////////////////////////////////////////
+    bool set ( const TechniqueParam & param , const RealProgramVariable & value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Copies values already packed with this block's layout , as
+    /// recorded by a CommandBuffer. 'size' must be the block's size.
+    //////////////////////////////////////////////////////////////////////
+    bool setData ( const char* data , size_t size ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the packed values.
+    //////////////////////////////////////////////////////////////////////
+    const char* getData () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the size of the packed values.
+    //////////////////////////////////////////////////////////////////////
+    size_t getSize () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns a number changed every time a value changes.
+    //////////////////////////////////////////////////////////////////////
+    size_t getVersion () const ;
+
+protected:
+
+    friend class UniformArena ;
+
+    /// @brief Layout of the block.
+    UniformBlockLayout iLayout ;
+
+    /// @brief Packed values.
+    std::vector < char > iData ;
+
+    /// @brief Incremented when a value changes.
+    size_t iVersion ;
+
+    /// @brief Generation of the arena when the block was last staged.
+    mutable size_t iStagedGeneration ;
+
+    /// @brief Version of the block when it was last staged.
+    mutable size_t iStagedVersion ;
+
+    /// @brief Offset of the block in the arena when it was last staged.
+    mutable size_t iStagedOffset ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A CPU-side buffer where uniform blocks are staged before the
+/// backend uploads them.
+///
+/// Blocks are appended at offsets aligned for the backend , and a block
+/// which did not change since it was staged keeps its offset. When the
+/// arena is full , it starts again at zero and its generation changes :
+/// the backend should then orphan its buffer. The arena is used only by
+/// the rendering thread.
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC UniformArena
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the arena used by Techniques.
+    //////////////////////////////////////////////////////////////////////
+    static UniformArena & Get () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Constructs an arena of given capacity , in bytes.
+    //////////////////////////////////////////////////////////////////////
+    UniformArena ( size_t capacity = 1024 * 1024 , size_t alignment = 256 ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Stages the block if needed , and returns its offset in the
+    /// arena.
+    //////////////////////////////////////////////////////////////////////
+    size_t push ( const UniformBlock & block ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Starts again at zero , changing the generation.
+    //////////////////////////////////////////////////////////////////////
+    void clear () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the alignment of the offsets. Backends set it to
+    /// their buffer offset alignment. Clears the arena.
+    //////////////////////////////////////////////////////////////////////
+    void setAlignment ( size_t alignment ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the alignment of the offsets.
+    //////////////////////////////////////////////////////////////////////
+    size_t getAlignment () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the staged bytes.
+    //////////////////////////////////////////////////////////////////////
+    const char* getData () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of bytes used since the last clear.
+    //////////////////////////////////////////////////////////////////////
+    size_t getSize () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the capacity of the arena.
+    //////////////////////////////////////////////////////////////////////
+    size_t getCapacity () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns a number changed every time the arena starts again
+    /// at zero. It never is zero.
+    //////////////////////////////////////////////////////////////////////
+    size_t getGeneration () const ;
+
+protected:
+
+    /// @brief Staged bytes.
+    std::vector < char > iData ;
+
+    /// @brief Bytes used since the last clear.
+    size_t iSize ;
+
+    /// @brief Alignment of the offsets.
+    size_t iAlignment ;
+
+    /// @brief Incremented at each clear.
+    size_t iGeneration ;
+};
+
+GreEndNamespace
+
+#endif // GRE_UNIFORMBLOCK_H
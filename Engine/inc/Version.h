@@ -75,6 +75,10 @@
 /// @brief Defines this to enable exception throwing.
 // #define GreHasExceptions
 
+/// @brief Defines this to compile the profiling markers ( see 'Profiler.h' ).
+/// Markers cost a flag test when no capture is running.
+#define GreHasProfiler
+
 /// @brief If enabled, use of Extra Macros to define Class attributes are
 /// allowed.
 #define GreExtraMacros
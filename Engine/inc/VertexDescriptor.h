@@ -46,9 +46,14 @@ enum class VertexAttribAlias : int
     Normal ,
     Texture ,
     Tangents ,
-    Binormals
+    Binormals ,
+    BoneIndices ,
+    BoneWeights
 };
 
+/// @brief Number of values in VertexAttribAlias.
+static const size_t VertexAttribAliasCount = (size_t) VertexAttribAlias::BoneWeights + 1 ;
+
 //////////////////////////////////////////////////////////////////////
 /// @brief Returns the VertexAttribAlias from its string.
 VertexAttribAlias VertexAttribFromString ( const std::string & attrib ) ;
@@ -148,6 +153,12 @@ public:
     //////////////////////////////////////////////////////////////////////
     const VertexAttribComponent findComponent ( const VertexAttribAlias & alias ) const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if both descriptors have the same components ,
+    /// in the same order.
+    //////////////////////////////////////////////////////////////////////
+    bool operator == ( const VertexDescriptor & rhs ) const ;
+
 private:
 
     /// @brief Arrays of Components that defines the attributes structure.
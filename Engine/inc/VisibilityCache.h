@@ -0,0 +1,192 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  VisibilityCache.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 23/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef GRE_VISIBILITYCACHE_H
+#define GRE_VISIBILITYCACHE_H
+
+#include "RenderNode.h"
+
+#include <unordered_map>
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Counters of a VisibilityCache.
+//////////////////////////////////////////////////////////////////////
+struct VisibilityCacheStats
+{
+    /// @brief Queries answered with the cached list.
+    size_t hits ;
+
+    /// @brief Queries with a known projection-view matrix but a changed
+    /// scene : only changed nodes were tested.
+    size_t partials ;
+
+    /// @brief Queries with an unknown projection-view matrix.
+    size_t misses ;
+
+    /// @brief Nodes whose previous result was reused by partial queries.
+    size_t reused ;
+
+    /// @brief Nodes tested by partial queries and misses.
+    size_t tested ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the ratio of queries answered without any test.
+    //////////////////////////////////////////////////////////////////////
+    float getHitRate () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the ratio of nodes not tested , including hits.
+    //////////////////////////////////////////////////////////////////////
+    float getNodeReuseRate () const ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Remembers visible nodes for the last projection-view matrices.
+///
+/// Each entry holds a projection-view matrix , the scene version the
+/// result was computed with , the visible nodes list and the result of
+/// each node with the node's visibility version.
+///
+/// 'find()' returns the cached list when the matrix and the scene version
+/// did not change , for example when several passes draw from the same
+/// camera during a frame. When only the scene changed , the entry is kept
+/// as current : the scene is traversed again , but nodes whose version
+/// did not change reuse their previous result through 'lookup()'. New
+/// results are given by 'record()' and the new list by 'store()'.
+///
+/// When every entry is used , the least recently used one is replaced.
+///
+//////////////////////////////////////////////////////////////////////
+class DLL_PUBLIC VisibilityCache
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    VisibilityCache ( size_t capacity = 4 ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~VisibilityCache () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Copies the cached list to 'result' and returns true if there
+    /// is one for given matrix and scene version. Else , selects the entry
+    /// filled by next calls to 'record()' and 'store()'.
+    //////////////////////////////////////////////////////////////////////
+    bool find ( const Matrix4 & projectionview , uint64_t version , RenderNodeHolderList & result ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true and sets 'visible' if the current entry has a
+    /// result for given node at given version.
+    //////////////////////////////////////////////////////////////////////
+    bool lookup ( const RenderNode * node , uint64_t version , bool & visible ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records the result for given node in the current entry.
+    //////////////////////////////////////////////////////////////////////
+    void record ( const RenderNode * node , uint64_t version , bool visible ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Stores the visible nodes list in the current entry. Results
+    /// of nodes not recorded since 'find()' are forgotten.
+    //////////////////////////////////////////////////////////////////////
+    void store ( const RenderNodeHolderList & result ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Forgets every entries.
+    //////////////////////////////////////////////////////////////////////
+    void clear () ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the number of entries. Zero disables the cache.
+    //////////////////////////////////////////////////////////////////////
+    void setCapacity ( size_t capacity ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of entries.
+    //////////////////////////////////////////////////////////////////////
+    size_t getCapacity () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the counters.
+    //////////////////////////////////////////////////////////////////////
+    const VisibilityCacheStats & getStats () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Resets the counters.
+    //////////////////////////////////////////////////////////////////////
+    void resetStats () ;
+
+protected:
+
+    /// @brief Result of one node.
+    struct NodeResult
+    {
+        uint64_t version ;
+        bool visible ;
+    };
+
+    /// @brief Results for one projection-view matrix.
+    struct Entry
+    {
+        Matrix4 projectionview ;
+        uint64_t version ;
+        bool valid ;
+        uint64_t lastuse ;
+        RenderNodeHolderList result ;
+        std::unordered_map < const RenderNode * , NodeResult > nodes ;
+        std::unordered_map < const RenderNode * , NodeResult > recorded ;
+    };
+
+    /// @brief Entries.
+    std::vector < Entry > iEntries ;
+
+    /// @brief Entry selected by 'find()' , or -1.
+    int iCurrent ;
+
+    /// @brief Number of entries.
+    size_t iCapacity ;
+
+    /// @brief Incremented by each query , to find the least recently used
+    /// entry.
+    uint64_t iQueries ;
+
+    /// @brief Counters.
+    VisibilityCacheStats iStats ;
+};
+
+GreEndNamespace
+
+#endif // GRE_VISIBILITYCACHE_H
@@ -0,0 +1,434 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  AabbTree.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 24/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "AabbTree.h"
+
+GreBeginNamespace
+
+AabbTree::AabbTree ( float margin )
+: iRoot ( Null ) , iFree ( Null ) , iCount ( 0 ) , iMargin ( margin )
+{
+
+}
+
+AabbTree::~AabbTree ()
+{
+
+}
+
+int AabbTree::insert ( const BoundingBox & box , void * userdata )
+{
+    int leaf = allocateNode () ;
+    Node & node = iNodes [leaf] ;
+
+    Vector3 margin ( iMargin , iMargin , iMargin ) ;
+
+    node.tightmin = box.getMin () ;
+    node.tightmax = box.getMax () ;
+    node.min = node.tightmin - margin ;
+    node.max = node.tightmax + margin ;
+    node.userdata = userdata ;
+    node.height = 0 ;
+
+    insertLeaf ( leaf ) ;
+    iCount ++ ;
+
+    return leaf ;
+}
+
+void AabbTree::remove ( int proxy )
+{
+    if ( proxy < 0 || proxy >= (int) iNodes.size () || !iNodes [proxy] .isLeaf () || iNodes [proxy] .height < 0 )
+    return ;
+
+    removeLeaf ( proxy ) ;
+    freeNode ( proxy ) ;
+    iCount -- ;
+}
+
+bool AabbTree::move ( int proxy , const BoundingBox & box )
+{
+    if ( proxy < 0 || proxy >= (int) iNodes.size () || !iNodes [proxy] .isLeaf () || iNodes [proxy] .height < 0 )
+    return false ;
+
+    Node & node = iNodes [proxy] ;
+    node.tightmin = box.getMin () ;
+    node.tightmax = box.getMax () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Small moves stay in the fat box : nothing else to do.
+
+    if ( node.min.x <= node.tightmin.x && node.min.y <= node.tightmin.y && node.min.z <= node.tightmin.z &&
+         node.max.x >= node.tightmax.x && node.max.y >= node.tightmax.y && node.max.z >= node.tightmax.z )
+    return false ;
+
+    removeLeaf ( proxy ) ;
+
+    Vector3 margin ( iMargin , iMargin , iMargin ) ;
+    iNodes [proxy] .min = iNodes [proxy] .tightmin - margin ;
+    iNodes [proxy] .max = iNodes [proxy] .tightmax + margin ;
+
+    insertLeaf ( proxy ) ;
+    return true ;
+}
+
+void * AabbTree::getUserData ( int proxy ) const
+{
+    if ( proxy < 0 || proxy >= (int) iNodes.size () )
+    return nullptr ;
+
+    return iNodes [proxy] .userdata ;
+}
+
+size_t AabbTree::getCount () const
+{
+    return iCount ;
+}
+
+int AabbTree::getHeight () const
+{
+    return iRoot == Null ? 0 : iNodes [iRoot] .height ;
+}
+
+void AabbTree::setMargin ( float margin )
+{
+    iMargin = margin ;
+}
+
+float AabbTree::getMargin () const
+{
+    return iMargin ;
+}
+
+void AabbTree::clear ()
+{
+    iNodes.clear () ;
+    iRoot = Null ;
+    iFree = Null ;
+    iCount = 0 ;
+}
+
+float AabbTree::SquaredDistance ( const Vector3 & min , const Vector3 & max , const Vector3 & point )
+{
+    float dx = std::max ( 0.0f , std::max ( min.x - point.x , point.x - max.x ) ) ;
+    float dy = std::max ( 0.0f , std::max ( min.y - point.y , point.y - max.y ) ) ;
+    float dz = std::max ( 0.0f , std::max ( min.z - point.z , point.z - max.z ) ) ;
+
+    return dx * dx + dy * dy + dz * dz ;
+}
+
+bool AabbTree::Overlaps ( const Vector3 & mina , const Vector3 & maxa , const Vector3 & minb , const Vector3 & maxb )
+{
+    return mina.x <= maxb.x && maxa.x >= minb.x
+        && mina.y <= maxb.y && maxa.y >= minb.y
+        && mina.z <= maxb.z && maxa.z >= minb.z ;
+}
+
+bool AabbTree::RayBox ( const Vector3 & min , const Vector3 & max , const Vector3 & origin ,
+                        const Vector3 & inverse , float maxdistance , float & entry )
+{
+    //////////////////////////////////////////////////////////////////////
+    // Slabs test. A zero direction component gives an infinite inverse ,
+    // and so an infinite interval when the origin is between the planes.
+
+    float tmin = 0.0f ;
+    float tmax = maxdistance ;
+
+    for ( int i = 0 ; i < 3 ; ++i )
+    {
+        float t1 = ( min [i] - origin [i] ) * inverse [i] ;
+        float t2 = ( max [i] - origin [i] ) * inverse [i] ;
+
+        if ( t1 > t2 )
+        std::swap ( t1 , t2 ) ;
+
+        //////////////////////////////////////////////////////////////////////
+        // NaN appears when the origin is exactly on a plane parallel to the
+        // ray : the comparisons below then keep the interval unchanged.
+
+        if ( t1 > tmin ) tmin = t1 ;
+        if ( t2 < tmax ) tmax = t2 ;
+
+        if ( tmin > tmax )
+        return false ;
+    }
+
+    entry = tmin ;
+    return true ;
+}
+
+int AabbTree::allocateNode ()
+{
+    if ( iFree == Null )
+    {
+        Node node ;
+        node.parent = Null ;
+        iNodes.push_back ( node ) ;
+        iFree = (int) iNodes.size () - 1 ;
+    }
+
+    int index = iFree ;
+    Node & node = iNodes [index] ;
+    iFree = node.parent ;
+
+    node.parent = Null ;
+    node.child1 = Null ;
+    node.child2 = Null ;
+    node.height = 0 ;
+    node.userdata = nullptr ;
+
+    return index ;
+}
+
+void AabbTree::freeNode ( int index )
+{
+    iNodes [index] .parent = iFree ;
+    iNodes [index] .child1 = Null ;
+    iNodes [index] .height = -1 ;
+    iFree = index ;
+}
+
+float AabbTree::Surface ( const Vector3 & min , const Vector3 & max )
+{
+    Vector3 d = max - min ;
+    return 2.0f * ( d.x * d.y + d.y * d.z + d.z * d.x ) ;
+}
+
+void AabbTree::insertLeaf ( int leaf )
+{
+    if ( iRoot == Null )
+    {
+        iRoot = leaf ;
+        iNodes [leaf] .parent = Null ;
+        return ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Goes down the tree , choosing at each node the child whose surface
+    // grows the least , until creating a new parent costs less than going
+    // deeper.
+
+    Vector3 leafmin = iNodes [leaf] .min ;
+    Vector3 leafmax = iNodes [leaf] .max ;
+
+    int index = iRoot ;
+
+    while ( !iNodes [index] .isLeaf () )
+    {
+        const Node & node = iNodes [index] ;
+
+        float surface = Surface ( node.min , node.max ) ;
+        float combined = Surface ( glm::min ( node.min , leafmin ) , glm::max ( node.max , leafmax ) ) ;
+
+        float cost = 2.0f * combined ;
+        float inheritance = 2.0f * ( combined - surface ) ;
+
+        float costs [2] ;
+        int children [2] = { node.child1 , node.child2 } ;
+
+        for ( int i = 0 ; i < 2 ; ++i )
+        {
+            const Node & child = iNodes [children [i]] ;
+            float grown = Surface ( glm::min ( child.min , leafmin ) , glm::max ( child.max , leafmax ) ) ;
+
+            if ( child.isLeaf () )
+            costs [i] = grown + inheritance ;
+            else
+            costs [i] = grown - Surface ( child.min , child.max ) + inheritance ;
+        }
+
+        if ( cost < costs [0] && cost < costs [1] )
+        break ;
+
+        index = costs [0] < costs [1] ? children [0] : children [1] ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Creates a new parent for the sibling and the leaf.
+
+    int sibling = index ;
+    int oldparent = iNodes [sibling] .parent ;
+    int newparent = allocateNode () ;
+
+    Node & parent = iNodes [newparent] ;
+    parent.parent = oldparent ;
+    parent.min = glm::min ( iNodes [sibling] .min , leafmin ) ;
+    parent.max = glm::max ( iNodes [sibling] .max , leafmax ) ;
+    parent.height = iNodes [sibling] .height + 1 ;
+    parent.child1 = sibling ;
+    parent.child2 = leaf ;
+
+    if ( oldparent != Null )
+    {
+        if ( iNodes [oldparent] .child1 == sibling )
+        iNodes [oldparent] .child1 = newparent ;
+        else
+        iNodes [oldparent] .child2 = newparent ;
+    }
+
+    else
+    {
+        iRoot = newparent ;
+    }
+
+    iNodes [sibling] .parent = newparent ;
+    iNodes [leaf] .parent = newparent ;
+
+    refit ( iNodes [leaf] .parent ) ;
+}
+
+void AabbTree::removeLeaf ( int leaf )
+{
+    if ( leaf == iRoot )
+    {
+        iRoot = Null ;
+        return ;
+    }
+
+    int parent = iNodes [leaf] .parent ;
+    int grandparent = iNodes [parent] .parent ;
+    int sibling = iNodes [parent] .child1 == leaf ? iNodes [parent] .child2 : iNodes [parent] .child1 ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The sibling takes the parent's place.
+
+    if ( grandparent != Null )
+    {
+        if ( iNodes [grandparent] .child1 == parent )
+        iNodes [grandparent] .child1 = sibling ;
+        else
+        iNodes [grandparent] .child2 = sibling ;
+
+        iNodes [sibling] .parent = grandparent ;
+        freeNode ( parent ) ;
+
+        refit ( grandparent ) ;
+    }
+
+    else
+    {
+        iRoot = sibling ;
+        iNodes [sibling] .parent = Null ;
+        freeNode ( parent ) ;
+    }
+}
+
+void AabbTree::refit ( int index )
+{
+    while ( index != Null )
+    {
+        index = balance ( index ) ;
+
+        Node & node = iNodes [index] ;
+        const Node & child1 = iNodes [node.child1] ;
+        const Node & child2 = iNodes [node.child2] ;
+
+        node.height = 1 + std::max ( child1.height , child2.height ) ;
+        node.min = glm::min ( child1.min , child2.min ) ;
+        node.max = glm::max ( child1.max , child2.max ) ;
+
+        index = node.parent ;
+    }
+}
+
+int AabbTree::balance ( int a )
+{
+    Node & A = iNodes [a] ;
+
+    if ( A.isLeaf () || A.height < 2 )
+    return a ;
+
+    int b = A.child1 ;
+    int c = A.child2 ;
+    int difference = iNodes [c] .height - iNodes [b] .height ;
+
+    if ( difference > 1 || difference < -1 )
+    {
+        //////////////////////////////////////////////////////////////////////
+        // The highest child ( 'up' ) takes A's place , A takes the place of
+        // the highest grandchild , and A keeps the other grandchild.
+
+        int up = difference > 0 ? c : b ;
+        int other = difference > 0 ? b : c ;
+
+        Node & U = iNodes [up] ;
+        int f = U.child1 ;
+        int g = U.child2 ;
+
+        U.child1 = a ;
+        U.parent = A.parent ;
+        A.parent = up ;
+
+        if ( U.parent != Null )
+        {
+            if ( iNodes [U.parent] .child1 == a )
+            iNodes [U.parent] .child1 = up ;
+            else
+            iNodes [U.parent] .child2 = up ;
+        }
+
+        else
+        {
+            iRoot = up ;
+        }
+
+        int keep = iNodes [f] .height > iNodes [g] .height ? f : g ;
+        int give = keep == f ? g : f ;
+
+        U.child2 = keep ;
+        iNodes [keep] .parent = up ;
+
+        if ( difference > 0 )
+        A.child2 = give ;
+        else
+        A.child1 = give ;
+
+        iNodes [give] .parent = a ;
+
+        const Node & o = iNodes [other] ;
+        const Node & k = iNodes [give] ;
+        A.min = glm::min ( o.min , k.min ) ;
+        A.max = glm::max ( o.max , k.max ) ;
+        A.height = 1 + std::max ( o.height , k.height ) ;
+
+        const Node & h = iNodes [keep] ;
+        U.min = glm::min ( A.min , h.min ) ;
+        U.max = glm::max ( A.max , h.max ) ;
+        U.height = 1 + std::max ( A.height , h.height ) ;
+
+        return up ;
+    }
+
+    return a ;
+}
+
+GreEndNamespace
@@ -0,0 +1,306 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  AnimationClip.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "AnimationClip.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+// Quantization of rotation components.
+
+static const float RotationScale = 32767.0f ;
+
+static Vector4 DecodeRotation ( const int16_t * data )
+{
+    return Vector4 ( data [0] , data [1] , data [2] , data [3] ) / RotationScale ;
+}
+
+static void EncodeRotation ( const Vector4 & rotation , int16_t * data )
+{
+    for ( int i = 0 ; i < 4 ; ++i )
+    data [i] = (int16_t) std::lround ( std::min ( std::max ( rotation [i] , -1.0f ) , 1.0f ) * RotationScale ) ;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Returns the key before 'time' and the weight of the key after it.
+
+static size_t FindKey ( const std::vector < float > & times , float time , float & weight )
+{
+    weight = 0.0f ;
+
+    if ( times.size () < 2 || time <= times.front () )
+    return 0 ;
+
+    if ( time >= times.back () )
+    return times.size () - 1 ;
+
+    size_t key = std::upper_bound ( times.begin () , times.end () , time ) - times.begin () - 1 ;
+    weight = ( time - times [key] ) / ( times [key + 1] - times [key] ) ;
+    return key ;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Removes every key the interpolation of the kept keys gives within the
+// tolerance. A key is dropped only if every key already dropped since the
+// last kept one is still given by the interpolation with the next key.
+
+template < typename Value >
+static size_t ReduceKeys ( std::vector < float > & times , std::vector < Value > & values , float tolerance , bool normalize )
+{
+    const size_t count = times.size () ;
+
+    if ( count < 2 )
+    return 0 ;
+
+    std::vector < size_t > kept ( 1 , 0 ) ;
+
+    for ( size_t i = 1 ; i + 1 < count ; ++i )
+    {
+        const size_t first = kept.back () ;
+        const size_t next = i + 1 ;
+        bool dropped = true ;
+
+        for ( size_t k = first + 1 ; k <= i && dropped ; ++k )
+        {
+            float weight = ( times [k] - times [first] ) / ( times [next] - times [first] ) ;
+            Value value = glm::mix ( values [first] , values [next] , weight ) ;
+
+            if ( normalize )
+            value = glm::normalize ( value ) ;
+
+            dropped = glm::length ( value - values [k] ) <= tolerance ;
+        }
+
+        if ( !dropped )
+        kept.push_back ( i ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // A constant track only keeps its first key.
+
+    if ( kept.size () > 1 || glm::length ( values [count - 1] - values [0] ) > tolerance )
+    kept.push_back ( count - 1 ) ;
+
+    for ( size_t i = 0 ; i < kept.size () ; ++i )
+    {
+        times [i] = times [kept [i]] ;
+        values [i] = values [kept [i]] ;
+    }
+
+    times.resize ( kept.size () ) ;
+    values.resize ( kept.size () ) ;
+
+    return count - kept.size () ;
+}
+
+// -----------------------------------------------------------------------------
+
+AnimationClip::AnimationClip ( const std::string & name , float duration )
+: Resource ( name ) , iDuration ( duration )
+{
+
+}
+
+AnimationClip::~AnimationClip () noexcept ( false )
+{
+
+}
+
+float AnimationClip::getDuration () const
+{
+    GreAutolock ; return iDuration ;
+}
+
+void AnimationClip::setDuration ( float duration )
+{
+    GreAutolock ; iDuration = std::max ( duration , 0.0f ) ;
+}
+
+void AnimationClip::addTranslationKey ( size_t bone , float time , const Vector3 & translation )
+{
+    GreAutolock ;
+
+    AnimationTrack & track = getTrack ( bone ) ;
+    track.translationtimes.push_back ( time ) ;
+    track.translations.push_back ( translation ) ;
+    iDuration = std::max ( iDuration , time ) ;
+}
+
+void AnimationClip::addRotationKey ( size_t bone , float time , const Quaternion & rotation )
+{
+    GreAutolock ;
+
+    AnimationTrack & track = getTrack ( bone ) ;
+    Quaternion normalized = glm::normalize ( rotation ) ;
+    Vector4 value ( normalized.x , normalized.y , normalized.z , normalized.w ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Keeps consecutive keys in the same hemisphere , so interpolating
+    // the components always takes the shortest path.
+
+    if ( !track.rotationtimes.empty () && glm::dot ( value , DecodeRotation ( &track.rotations [track.rotations.size () - 4] ) ) < 0.0f )
+    value = -value ;
+
+    track.rotationtimes.push_back ( time ) ;
+    track.rotations.resize ( track.rotations.size () + 4 ) ;
+    EncodeRotation ( value , &track.rotations [track.rotations.size () - 4] ) ;
+    iDuration = std::max ( iDuration , time ) ;
+}
+
+void AnimationClip::addScaleKey ( size_t bone , float time , const Vector3 & scale )
+{
+    GreAutolock ;
+
+    AnimationTrack & track = getTrack ( bone ) ;
+    track.scaletimes.push_back ( time ) ;
+    track.scales.push_back ( scale ) ;
+    iDuration = std::max ( iDuration , time ) ;
+}
+
+size_t AnimationClip::compress ( float tolerance )
+{
+    GreAutolock ;
+
+    size_t removed = 0 ;
+
+    for ( AnimationTrack & track : iTracks )
+    {
+        removed += ReduceKeys ( track.translationtimes , track.translations , tolerance , false ) ;
+        removed += ReduceKeys ( track.scaletimes , track.scales , tolerance , false ) ;
+
+        //////////////////////////////////////////////////////////////////////
+        // Rotations are reduced decoded , then quantized again.
+
+        std::vector < Vector4 > rotations ( track.rotationtimes.size () ) ;
+
+        for ( size_t i = 0 ; i < rotations.size () ; ++i )
+        rotations [i] = DecodeRotation ( &track.rotations [i * 4] ) ;
+
+        removed += ReduceKeys ( track.rotationtimes , rotations , tolerance , true ) ;
+        track.rotations.resize ( rotations.size () * 4 ) ;
+
+        for ( size_t i = 0 ; i < rotations.size () ; ++i )
+        EncodeRotation ( rotations [i] , &track.rotations [i * 4] ) ;
+    }
+
+    return removed ;
+}
+
+size_t AnimationClip::getKeysCount () const
+{
+    GreAutolock ;
+
+    size_t count = 0 ;
+
+    for ( const AnimationTrack & track : iTracks )
+    count += track.translationtimes.size () + track.rotationtimes.size () + track.scaletimes.size () ;
+
+    return count ;
+}
+
+size_t AnimationClip::getKeysSize () const
+{
+    GreAutolock ;
+
+    size_t size = 0 ;
+
+    for ( const AnimationTrack & track : iTracks )
+    {
+        size += track.translationtimes.size () * ( sizeof ( float ) + sizeof ( Vector3 ) ) ;
+        size += track.rotationtimes.size () * ( sizeof ( float ) + 4 * sizeof ( int16_t ) ) ;
+        size += track.scaletimes.size () * ( sizeof ( float ) + sizeof ( Vector3 ) ) ;
+    }
+
+    return size ;
+}
+
+void AnimationClip::sample ( float time , bool loop , Pose & pose ) const
+{
+    GreAutolock ;
+
+    if ( loop && iDuration > 0.0f )
+    {
+        time = std::fmod ( time , iDuration ) ;
+
+        if ( time < 0.0f )
+        time += iDuration ;
+    }
+
+    else
+    {
+        time = std::min ( std::max ( time , 0.0f ) , iDuration ) ;
+    }
+
+    const size_t count = std::min ( iTracks.size () , pose.size () ) ;
+
+    for ( size_t b = 0 ; b < count ; ++b )
+    {
+        const AnimationTrack & track = iTracks [b] ;
+        BoneTransform & transform = pose [b] ;
+        float weight ;
+
+        if ( !track.translationtimes.empty () )
+        {
+            size_t key = FindKey ( track.translationtimes , time , weight ) ;
+            size_t next = std::min ( key + 1 , track.translations.size () - 1 ) ;
+            transform.translation = glm::mix ( track.translations [key] , track.translations [next] , weight ) ;
+        }
+
+        if ( !track.rotationtimes.empty () )
+        {
+            size_t key = FindKey ( track.rotationtimes , time , weight ) ;
+            size_t next = std::min ( key + 1 , track.rotationtimes.size () - 1 ) ;
+
+            Vector4 value = glm::normalize ( glm::mix ( DecodeRotation ( &track.rotations [key * 4] ) ,
+                                                        DecodeRotation ( &track.rotations [next * 4] ) , weight ) ) ;
+
+            transform.rotation = Quaternion ( value.w , value.x , value.y , value.z ) ;
+        }
+
+        if ( !track.scaletimes.empty () )
+        {
+            size_t key = FindKey ( track.scaletimes , time , weight ) ;
+            size_t next = std::min ( key + 1 , track.scales.size () - 1 ) ;
+            transform.scale = glm::mix ( track.scales [key] , track.scales [next] , weight ) ;
+        }
+    }
+}
+
+AnimationTrack & AnimationClip::getTrack ( size_t bone )
+{
+    if ( bone >= iTracks.size () )
+    iTracks.resize ( bone + 1 ) ;
+
+    return iTracks [bone] ;
+}
+
+GreEndNamespace
@@ -32,6 +32,7 @@
 
 #include "Application.h"
 #include "ResourceManager.h"
+#include "Profiler.h"
 
 GreBeginNamespace
 
@@ -80,6 +81,7 @@ void Application::EscapeKeyListener::onKeyDownEvent(const Gre::KeyDownEvent &e)
 void Application::WorkerThreadMain ( Application * app )
 {
     TimePoint t = Time::now() ;
+    Profiler::Get().setThreadName( "Worker" ) ;
 
     while ( !app->shouldTerminate() )
     {
@@ -98,6 +100,7 @@ void Application::WorkerThreadMain ( Application * app )
 
         EventHolder uevent = EventHolder ( new UpdateEvent( (const EventProceeder*) app , elapsed ) ) ;
 
+        GreProfile( "Application::workers" ) ;
         app -> threadLock() ;
 
         for ( EventProceederHolder & listener : app->iWorkers )
@@ -262,6 +265,7 @@ EventHolder Application::getNextUpdateEvent()
 void Application::iMainThreadLoop()
 {
     iWorkerThread = std::thread ( Application::WorkerThreadMain , this ) ;
+    Profiler::Get().setThreadName( "Main" ) ;
 
     while ( !iShouldTerminate )
     {
@@ -279,6 +283,12 @@ void Application::iMainThreadLoop()
         EventHolder elapsed = EventHolder ( new UpdateEvent ( this , delta ) ) ;
         iMainStart = Time::now() ;
 
+        //////////////////////////////////////////////////////////////////////
+        // A profiler frame is one iteration of this loop.
+
+        Profiler::Get().newFrame() ;
+        GreProfile( "Application::frame" ) ;
+
         // We must achieve a normal update loop. This consiste in drawing everything we need
         // and then, polling for events using the window system. So , we must render the Scene using
         // the RendererManager :: render () function ( this will call the Renderer::render() one and call
@@ -288,7 +298,22 @@ void Application::iMainThreadLoop()
 
         iWindowManager -> pollEvents (delta) ;
         iRendererManager -> render () ;
-        iWindowManager -> onEvent(elapsed) ;
+
+        {
+            GreProfile( "Application::windowsUpdate" ) ;
+            iWindowManager -> onEvent(elapsed) ;
+        }
+
+        // Proceeders added with 'addMainThread()' are updated here , after the rendering , as
+        // they may need the render context ( for example to create buffers ).
+
+        GreProfile( "Application::mainProceeders" ) ;
+
+        for ( EventProceederHolder & proceeder : iMainProceeders )
+        {
+            if ( !proceeder.isInvalid() )
+            proceeder -> onEvent ( elapsed ) ;
+        }
     }
 }
 
@@ -0,0 +1,617 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  Broadphase.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 25/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "Broadphase.h"
+#include "JobPool.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Lists larger than this are swept and sorted in parallel.
+static const size_t BroadphaseParallelThreshold = 8192 ;
+
+Broadphase::Broadphase ( const std::string & name )
+: Gre::Resource ( name )
+, iWorldMin ( 0.0f , 0.0f , 0.0f ) , iWorldMax ( 0.0f , 0.0f , 0.0f )
+, iCount ( 0 )
+{
+    iGrid [0] = iGrid [1] = iGrid [2] = 1 ;
+
+    Region region ;
+    region.coords [0] = region.coords [1] = region.coords [2] = 0 ;
+    region.axis = 0 ;
+    iRegions.push_back ( region ) ;
+}
+
+Broadphase::~Broadphase () noexcept ( false )
+{
+
+}
+
+uint32_t Broadphase::add ( const BoundingBox & box , const EventProceeder * object )
+{
+    GreAutolock ;
+
+    uint32_t index ;
+
+    if ( !iFree.empty () )
+    {
+        index = iFree.back () ;
+        iFree.pop_back () ;
+    }
+
+    else
+    {
+        index = (uint32_t) iProxies.size () ;
+        iProxies.push_back ( Proxy () ) ;
+    }
+
+    Proxy & proxy = iProxies [index] ;
+    proxy.min = box.getMin () ;
+    proxy.max = box.getMax () ;
+    proxy.object = object ;
+    proxy.node.clear () ;
+    proxy.active = !box.isInvalid () ;
+    proxy.alive = true ;
+    proxy.dirty = true ;
+    proxy.cells [0] = proxy.cells [1] = proxy.cells [2] = 0 ;
+    proxy.cells [3] = proxy.cells [4] = proxy.cells [5] = -1 ;
+
+    iCount ++ ;
+    return index ;
+}
+
+uint32_t Broadphase::add ( const RenderNodeHolder & node )
+{
+    GreAutolock ;
+
+    if ( node.isInvalid() )
+    return InvalidProxy ;
+
+    uint32_t index = add ( node -> getBoundingBox () , node.getObject () ) ;
+    iProxies [index] .node = node ;
+
+    return index ;
+}
+
+void Broadphase::remove ( uint32_t proxy )
+{
+    GreAutolock ;
+
+    if ( proxy >= iProxies.size () || !iProxies [proxy] .alive )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Ends the pairs of the proxy now , while its object is still valid.
+
+    std::vector < uint64_t > ended ;
+    auto last = std::remove_if ( iPairs.begin () , iPairs.end () , [&] ( uint64_t pair ) {
+        bool involved = ( pair >> 32 ) == proxy || ( pair & 0xFFFFFFFF ) == proxy ;
+        if ( involved ) ended.push_back ( pair ) ;
+        return involved ;
+    } ) ;
+
+    iPairs.erase ( last , iPairs.end () ) ;
+
+    for ( uint64_t pair : ended )
+    sendOverlap ( false , pair ) ;
+
+    Proxy & p = iProxies [proxy] ;
+    p.alive = false ;
+    p.active = false ;
+    p.object = nullptr ;
+    p.node.clear () ;
+
+    iRemoved.push_back ( proxy ) ;
+    iCount -- ;
+}
+
+void Broadphase::move ( uint32_t proxy , const BoundingBox & box )
+{
+    GreAutolock ;
+
+    if ( proxy >= iProxies.size () || !iProxies [proxy] .alive )
+    return ;
+
+    Proxy & p = iProxies [proxy] ;
+    p.min = box.getMin () ;
+    p.max = box.getMax () ;
+    p.active = !box.isInvalid () ;
+    p.dirty = true ;
+}
+
+void Broadphase::setRegions ( const BoundingBox & world , size_t x , size_t y , size_t z )
+{
+    GreAutolock ;
+
+    iWorldMin = world.isInvalid () ? Vector3 ( 0.0f , 0.0f , 0.0f ) : world.getMin () ;
+    iWorldMax = world.isInvalid () ? Vector3 ( 0.0f , 0.0f , 0.0f ) : world.getMax () ;
+
+    iGrid [0] = (int) std::max ( x , (size_t) 1 ) ;
+    iGrid [1] = (int) std::max ( y , (size_t) 1 ) ;
+    iGrid [2] = (int) std::max ( z , (size_t) 1 ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Creates the new regions empty : every proxy enters them at the next
+    // update. Pairs are kept , so no event is sent for pairs which still
+    // overlap.
+
+    iRegions.clear () ;
+
+    for ( int k = 0 ; k < iGrid [2] ; ++k )
+    for ( int j = 0 ; j < iGrid [1] ; ++j )
+    for ( int i = 0 ; i < iGrid [0] ; ++i )
+    {
+        Region region ;
+        region.coords [0] = i ;
+        region.coords [1] = j ;
+        region.coords [2] = k ;
+        region.axis = 0 ;
+        iRegions.push_back ( region ) ;
+    }
+
+    for ( Proxy & proxy : iProxies )
+    {
+        proxy.cells [0] = proxy.cells [1] = proxy.cells [2] = 0 ;
+        proxy.cells [3] = proxy.cells [4] = proxy.cells [5] = -1 ;
+        proxy.dirty = true ;
+    }
+}
+
+void Broadphase::update ()
+{
+    GreAutolock ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Reads the nodes' bounding boxes , and adds the moved proxies to the
+    // regions they entered.
+
+    for ( uint32_t i = 0 ; i < iProxies.size () ; ++i )
+    {
+        Proxy & proxy = iProxies [i] ;
+
+        if ( !proxy.alive )
+        continue ;
+
+        if ( !proxy.node.isInvalid () )
+        {
+            const BoundingBox & box = proxy.node -> getBoundingBox () ;
+            proxy.active = !box.isInvalid () ;
+
+            if ( proxy.active )
+            {
+                proxy.min = box.getMin () ;
+                proxy.max = box.getMax () ;
+            }
+
+            proxy.dirty = true ;
+        }
+
+        if ( proxy.dirty )
+        {
+            updateCells ( i ) ;
+            proxy.dirty = false ;
+        }
+    }
+
+    for ( uint32_t removed : iRemoved )
+    {
+        int * cells = iProxies [removed] .cells ;
+        cells [0] = cells [1] = cells [2] = 0 ;
+        cells [3] = cells [4] = cells [5] = -1 ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Sorts and sweeps every regions.
+
+    if ( iRegions.size () == 1 )
+    updateRegion ( iRegions [0] ) ;
+
+    else
+    {
+        JobPool::Get () .parallelFor ( iRegions.size () , 1 , [this] ( size_t begin , size_t end ) {
+            for ( size_t i = begin ; i < end ; ++i )
+            updateRegion ( iRegions [i] ) ;
+        } ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Merges the pairs. A pair overlapping in several regions is found by
+    // each of them.
+
+    std::vector < uint64_t > pairs ;
+
+    if ( iRegions.size () == 1 )
+    pairs.swap ( iRegions [0] .pairs ) ;
+
+    else
+    {
+        size_t total = 0 ;
+
+        for ( const Region & region : iRegions )
+        total += region.pairs.size () ;
+
+        pairs.reserve ( total ) ;
+
+        for ( Region & region : iRegions )
+        {
+            pairs.insert ( pairs.end () , region.pairs.begin () , region.pairs.end () ) ;
+            region.pairs.clear () ;
+        }
+
+        std::sort ( pairs.begin () , pairs.end () ) ;
+        pairs.erase ( std::unique ( pairs.begin () , pairs.end () ) , pairs.end () ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Compares with the previous pairs. Both lists are sorted.
+
+    std::vector < uint64_t > began ;
+    std::vector < uint64_t > ended ;
+
+    std::set_difference ( pairs.begin () , pairs.end () , iPairs.begin () , iPairs.end () , std::back_inserter ( began ) ) ;
+    std::set_difference ( iPairs.begin () , iPairs.end () , pairs.begin () , pairs.end () , std::back_inserter ( ended ) ) ;
+
+    iPairs.swap ( pairs ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Removed proxies are not in any region anymore : they can be reused.
+
+    iFree.insert ( iFree.end () , iRemoved.begin () , iRemoved.end () ) ;
+    iRemoved.clear () ;
+
+    for ( uint64_t pair : ended )
+    sendOverlap ( false , pair ) ;
+
+    for ( uint64_t pair : began )
+    sendOverlap ( true , pair ) ;
+}
+
+bool Broadphase::isOverlapping ( uint32_t first , uint32_t second ) const
+{
+    GreAutolock ;
+    return std::binary_search ( iPairs.begin () , iPairs.end () , PairKey ( first , second ) ) ;
+}
+
+size_t Broadphase::getPairsCount () const
+{
+    GreAutolock ; return iPairs.size () ;
+}
+
+void Broadphase::getPairs ( std::vector < std::pair < uint32_t , uint32_t > > & pairs ) const
+{
+    GreAutolock ;
+
+    for ( uint64_t pair : iPairs )
+    pairs.push_back ( std::make_pair ( (uint32_t) ( pair >> 32 ) , (uint32_t) ( pair & 0xFFFFFFFF ) ) ) ;
+}
+
+size_t Broadphase::getProxiesCount () const
+{
+    GreAutolock ; return iCount ;
+}
+
+void Broadphase::onUpdateEvent ( const UpdateEvent & )
+{
+    update () ;
+}
+
+void Broadphase::computeCells ( const Proxy & proxy , int cells [6] ) const
+{
+    if ( !proxy.alive || !proxy.active )
+    {
+        cells [0] = cells [1] = cells [2] = 0 ;
+        cells [3] = cells [4] = cells [5] = -1 ;
+        return ;
+    }
+
+    for ( int a = 0 ; a < 3 ; ++a )
+    {
+        if ( iGrid [a] == 1 || iWorldMax [a] <= iWorldMin [a] )
+        {
+            cells [a] = cells [a + 3] = 0 ;
+            continue ;
+        }
+
+        float scale = (float) iGrid [a] / ( iWorldMax [a] - iWorldMin [a] ) ;
+        int low = (int) std::floor ( ( proxy.min [a] - iWorldMin [a] ) * scale ) ;
+        int high = (int) std::floor ( ( proxy.max [a] - iWorldMin [a] ) * scale ) ;
+
+        cells [a] = std::min ( std::max ( low , 0 ) , iGrid [a] - 1 ) ;
+        cells [a + 3] = std::min ( std::max ( high , 0 ) , iGrid [a] - 1 ) ;
+    }
+}
+
+void Broadphase::updateCells ( uint32_t index )
+{
+    Proxy & proxy = iProxies [index] ;
+
+    int cells [6] ;
+    computeCells ( proxy , cells ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Regions left are not told : their update drops the proxies out of
+    // their range.
+
+    for ( int k = cells [2] ; k <= cells [5] ; ++k )
+    for ( int j = cells [1] ; j <= cells [4] ; ++j )
+    for ( int i = cells [0] ; i <= cells [3] ; ++i )
+    {
+        bool inside = i >= proxy.cells [0] && i <= proxy.cells [3]
+                   && j >= proxy.cells [1] && j <= proxy.cells [4]
+                   && k >= proxy.cells [2] && k <= proxy.cells [5] ;
+
+        if ( !inside )
+        iRegions [ i + iGrid [0] * ( j + iGrid [1] * k ) ] .added.push_back ( index ) ;
+    }
+
+    std::copy ( cells , cells + 6 , proxy.cells ) ;
+}
+
+void Broadphase::updateRegion ( Region & region ) const
+{
+    std::vector < Entry > & entries = region.entries ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Refreshes the boxes and drops the proxies which left the region.
+
+    auto inside = [&region] ( const Proxy & proxy ) {
+        return region.coords [0] >= proxy.cells [0] && region.coords [0] <= proxy.cells [3]
+            && region.coords [1] >= proxy.cells [1] && region.coords [1] <= proxy.cells [4]
+            && region.coords [2] >= proxy.cells [2] && region.coords [2] <= proxy.cells [5] ;
+    } ;
+
+    size_t kept = 0 ;
+
+    for ( size_t i = 0 ; i < entries.size () ; ++i )
+    {
+        const Proxy & proxy = iProxies [entries [i] .proxy] ;
+
+        if ( !inside ( proxy ) )
+        continue ;
+
+        entries [kept] .min = proxy.min ;
+        entries [kept] .max = proxy.max ;
+        entries [kept] .proxy = entries [i] .proxy ;
+        kept ++ ;
+    }
+
+    entries.resize ( kept ) ;
+
+    size_t added = region.added.size () ;
+
+    for ( uint32_t index : region.added )
+    {
+        const Proxy & proxy = iProxies [index] ;
+
+        Entry entry ;
+        entry.min = proxy.min ;
+        entry.max = proxy.max ;
+        entry.proxy = index ;
+        entries.push_back ( entry ) ;
+    }
+
+    region.added.clear () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Chooses the axis where centers are the most spread. The axis only
+    // changes when another one is clearly better , as changing needs a
+    // full sort. Large lists are sampled , reading at least one entry out
+    // of sixteen.
+
+    bool fullsort = added > entries.size () / 8 ;
+
+    if ( entries.size () > 1 )
+    {
+        Vector3 sum ( 0.0f , 0.0f , 0.0f ) ;
+        Vector3 sum2 ( 0.0f , 0.0f , 0.0f ) ;
+
+        size_t step = std::max ( entries.size () / 1024 , (size_t) 1 ) ;
+        step = std::min ( step , (size_t) 16 ) ;
+        size_t samples = 0 ;
+
+        for ( size_t i = 0 ; i < entries.size () ; i += step )
+        {
+            Vector3 center = ( entries [i] .min + entries [i] .max ) * 0.5f ;
+            sum += center ;
+            sum2 += center * center ;
+            samples ++ ;
+        }
+
+        float n = (float) samples ;
+        Vector3 variance = sum2 / n - ( sum / n ) * ( sum / n ) ;
+
+        int best = 0 ;
+        if ( variance [1] > variance [best] ) best = 1 ;
+        if ( variance [2] > variance [best] ) best = 2 ;
+
+        if ( best != region.axis && variance [best] > 1.5f * variance [region.axis] )
+        {
+            region.axis = best ;
+            fullsort = true ;
+        }
+    }
+
+    const int axis = region.axis ;
+
+    auto less = [axis] ( const Entry & a , const Entry & b ) {
+        return a.min [axis] < b.min [axis] ;
+    } ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Sorts. Between two updates boxes move little , so the list is almost
+    // sorted and an insertion sort is linear. New or reordered lists are
+    // sorted from scratch , in parallel chunks merged two by two when large.
+
+    if ( fullsort && entries.size () > BroadphaseParallelThreshold && JobPool::Get () .getThreadsCount () > 1 )
+    {
+        size_t chunks = JobPool::Get () .getThreadsCount () + 1 ;
+        size_t chunksize = ( entries.size () + chunks - 1 ) / chunks ;
+
+        JobPool::Get () .parallelFor ( entries.size () , chunksize , [&] ( size_t begin , size_t end ) {
+            std::sort ( entries.begin () + begin , entries.begin () + end , less ) ;
+        } ) ;
+
+        for ( size_t width = chunksize ; width < entries.size () ; width *= 2 )
+        {
+            size_t merges = ( entries.size () + 2 * width - 1 ) / ( 2 * width ) ;
+
+            JobPool::Get () .parallelFor ( merges , 1 , [&] ( size_t begin , size_t end ) {
+                for ( size_t m = begin ; m < end ; ++m )
+                {
+                    size_t first = m * 2 * width ;
+                    size_t middle = std::min ( first + width , entries.size () ) ;
+                    size_t last = std::min ( first + 2 * width , entries.size () ) ;
+                    std::inplace_merge ( entries.begin () + first , entries.begin () + middle , entries.begin () + last , less ) ;
+                }
+            } ) ;
+        }
+    }
+
+    else if ( fullsort )
+    {
+        std::sort ( entries.begin () , entries.end () , less ) ;
+    }
+
+    else
+    {
+        for ( size_t i = 1 ; i < entries.size () ; ++i )
+        {
+            if ( !less ( entries [i] , entries [i - 1] ) )
+            continue ;
+
+            Entry entry = entries [i] ;
+            size_t j = i ;
+
+            while ( j > 0 && less ( entry , entries [j - 1] ) )
+            {
+                entries [j] = entries [j - 1] ;
+                j -- ;
+            }
+
+            entries [j] = entry ;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Sweeps : each box is tested against the following ones until their
+    // minimum on the axis is over its maximum. Minimums are copied in their
+    // own array , so the inner loop reads contiguous floats.
+
+    const int axis1 = ( axis + 1 ) % 3 ;
+    const int axis2 = ( axis + 2 ) % 3 ;
+
+    std::vector < float > & keys = region.keys ;
+    std::vector < std::array < float , 5 > > & extents = region.extents ;
+
+    keys.resize ( entries.size () ) ;
+    extents.resize ( entries.size () ) ;
+
+    for ( size_t i = 0 ; i < entries.size () ; ++i )
+    {
+        const Entry & e = entries [i] ;
+        keys [i] = e.min [axis] ;
+        extents [i] = { { e.max [axis] , e.min [axis1] , e.max [axis1] , e.min [axis2] , e.max [axis2] } } ;
+    }
+
+    const size_t count = entries.size () ;
+
+    auto sweep = [&] ( size_t begin , size_t end , std::vector < uint64_t > & pairs ) {
+        for ( size_t i = begin ; i < end ; ++i )
+        {
+            const std::array < float , 5 > & a = extents [i] ;
+            const float limit = a [0] ;
+
+            for ( size_t j = i + 1 ; j < count && keys [j] <= limit ; ++j )
+            {
+                const std::array < float , 5 > & b = extents [j] ;
+
+                //////////////////////////////////////////////////////////////////////
+                // Most tests fail on unpredictable axes : the four comparisons
+                // are combined without branches.
+
+                bool overlap = ( a [1] <= b [2] ) & ( a [2] >= b [1] ) & ( a [3] <= b [4] ) & ( a [4] >= b [3] ) ;
+
+                if ( overlap )
+                pairs.push_back ( PairKey ( entries [i] .proxy , entries [j] .proxy ) ) ;
+            }
+        }
+    } ;
+
+    region.pairs.clear () ;
+
+    if ( entries.size () > BroadphaseParallelThreshold && JobPool::Get () .getThreadsCount () > 1 )
+    {
+        size_t chunks = 4 * ( JobPool::Get () .getThreadsCount () + 1 ) ;
+        size_t chunksize = ( entries.size () + chunks - 1 ) / chunks ;
+        std::vector < std::vector < uint64_t > > chunkpairs ( chunks ) ;
+
+        JobPool::Get () .parallelFor ( entries.size () , chunksize , [&] ( size_t begin , size_t end ) {
+            sweep ( begin , end , chunkpairs [begin / chunksize] ) ;
+        } ) ;
+
+        for ( auto & pairs : chunkpairs )
+        region.pairs.insert ( region.pairs.end () , pairs.begin () , pairs.end () ) ;
+    }
+
+    else
+    {
+        sweep ( 0 , entries.size () , region.pairs ) ;
+    }
+
+    std::sort ( region.pairs.begin () , region.pairs.end () ) ;
+}
+
+void Broadphase::sendOverlap ( bool begin , uint64_t pair )
+{
+    const EventProceeder * first = iProxies [pair >> 32] .object ;
+    const EventProceeder * second = iProxies [pair & 0xFFFFFFFF] .object ;
+
+    EventHolder e ;
+
+    if ( begin )
+    e = EventHolder ( new OverlapBeginEvent ( this , first , second ) ) ;
+    else
+    e = EventHolder ( new OverlapEndEvent ( this , first , second ) ) ;
+
+    sendEvent ( e ) ;
+}
+
+uint64_t Broadphase::PairKey ( uint32_t first , uint32_t second )
+{
+    if ( first > second )
+    std::swap ( first , second ) ;
+
+    return ( (uint64_t) first << 32 ) | second ;
+}
+
+GreEndNamespace
@@ -0,0 +1,191 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  CommandBuffer.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "CommandBuffer.h"
+
+GreBeginNamespace
+
+CommandBuffer::CommandBuffer ()
+: iDraws ( 0 )
+{
+
+}
+
+void CommandBuffer::setTechnique ( const Technique * technique )
+{
+    Command & command = iAppend ( CommandType::SetTechnique ) ;
+    command.technique = technique ;
+}
+
+void CommandBuffer::bindTechnique ( const Technique * technique )
+{
+    Command & command = iAppend ( CommandType::BindTechnique ) ;
+    command.technique = technique ;
+}
+
+void CommandBuffer::unbindTechnique ()
+{
+    iAppend ( CommandType::UnbindTechnique ) ;
+}
+
+void CommandBuffer::setParameter ( const TechniqueParam & param , const HdwProgVarType & type , const RealProgramVariable & value )
+{
+    size_t offset = iPush ( &value , sizeof ( RealProgramVariable ) ) ;
+
+    Command & command = iAppend ( CommandType::SetParameter ) ;
+    command.vartype = type ;
+    command.param = (int) param ;
+    command.offset = offset ;
+    command.size = sizeof ( RealProgramVariable ) ;
+}
+
+void CommandBuffer::setLightParameter ( const TechniqueParam & member , const HdwProgVarType & type , const RealProgramVariable & value )
+{
+    size_t offset = iPush ( &value , sizeof ( RealProgramVariable ) ) ;
+
+    Command & command = iAppend ( CommandType::SetLightParameter ) ;
+    command.vartype = type ;
+    command.param = (int) member ;
+    command.offset = offset ;
+    command.size = sizeof ( RealProgramVariable ) ;
+}
+
+void CommandBuffer::setUniformBlock ( const UniformBlockBinding & binding , const UniformBlock & block )
+{
+    size_t offset = iPush ( block.getData () , block.getSize () ) ;
+
+    Command & command = iAppend ( CommandType::SetUniformBlock ) ;
+    command.param = (int) binding ;
+    command.offset = offset ;
+    command.size = block.getSize () ;
+}
+
+void CommandBuffer::useMaterial ( const Material * material )
+{
+    Command & command = iAppend ( CommandType::UseMaterial ) ;
+    command.material = material ;
+}
+
+void CommandBuffer::resetLights ()
+{
+    iAppend ( CommandType::ResetLights ) ;
+}
+
+void CommandBuffer::resetTechnique ()
+{
+    iAppend ( CommandType::ResetTechnique ) ;
+}
+
+void CommandBuffer::drawMesh ( const Mesh * mesh , bool hasmaterial , size_t lod )
+{
+    Command & command = iAppend ( CommandType::DrawMesh ) ;
+    command.param = hasmaterial ? 1 : 0 ;
+    command.offset = lod ;
+    command.mesh = mesh ;
+
+    iDraws ++ ;
+}
+
+void CommandBuffer::draw ()
+{
+    iAppend ( CommandType::Draw ) ;
+    iDraws ++ ;
+}
+
+void CommandBuffer::clear ()
+{
+    iCommands.clear () ;
+    iPayload.clear () ;
+    iDraws = 0 ;
+}
+
+const std::vector < Command > & CommandBuffer::getCommands () const
+{
+    return iCommands ;
+}
+
+const char* CommandBuffer::getPayload ( size_t offset ) const
+{
+    return offset < iPayload.size () ? &iPayload [offset] : nullptr ;
+}
+
+RealProgramVariable CommandBuffer::getValue ( const Command & command ) const
+{
+    RealProgramVariable value ;
+
+    if ( command.size == sizeof ( RealProgramVariable ) && command.offset + command.size <= iPayload.size () )
+    memcpy ( reinterpret_cast < char * > ( &value ) , &iPayload [command.offset] , sizeof ( RealProgramVariable ) ) ;
+
+    return value ;
+}
+
+size_t CommandBuffer::getPayloadSize () const
+{
+    return iPayload.size () ;
+}
+
+size_t CommandBuffer::getDrawsCount () const
+{
+    return iDraws ;
+}
+
+bool CommandBuffer::isEmpty () const
+{
+    return iCommands.empty () ;
+}
+
+Command & CommandBuffer::iAppend ( const CommandType & type )
+{
+    Command command ;
+    command.type = type ;
+    command.vartype = HdwProgVarType::None ;
+    command.param = 0 ;
+    command.offset = 0 ;
+    command.size = 0 ;
+    command.technique = nullptr ;
+
+    iCommands.push_back ( command ) ;
+    return iCommands.back () ;
+}
+
+size_t CommandBuffer::iPush ( const void * data , size_t size )
+{
+    size_t offset = ( iPayload.size () + 15 ) / 16 * 16 ;
+    iPayload.resize ( offset + size ) ;
+
+    if ( size )
+    memcpy ( &iPayload [offset] , data , size ) ;
+
+    return offset ;
+}
+
+GreEndNamespace
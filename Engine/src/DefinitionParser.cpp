@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "DefinitionParser.h"
 #include "TechniqueFilePreprocessor.h"
 #include "ResourceManager.h"
+#include "Profiler.h"
 
 GreBeginNamespace
 
@@ -294,6 +295,8 @@ DefinitionWorkerState DefinitionParser::checkCurrentWorkerStatus( const Definiti
 
 void DefinitionParser::parsing ( DefinitionContext* ctxt , const std::string & filepath )
 {
+    GreProfileDetail( "DefinitionParser::parsing" , filepath ) ;
+
     if ( !ctxt )
     return ;
 
@@ -632,6 +635,7 @@ void DefinitionParser::setLastResult ( const DefinitionContextErrors & errors )
 
 DefinitionWorkerHandlingMap DefinitionParser::checking ( DefinitionContext* ctxt , const DefinitionWorkerHandlingMap & map )
 {
+    GreProfile( "DefinitionParser::checking" ) ;
     GreAutolock ;
 
     if ( !ctxt )
@@ -739,6 +743,8 @@ dependency_stage:
 
 void DefinitionParser::working( DefinitionContext* ctxt , const DefinitionWorkerHandlingMap & map )
 {
+    GreProfile( "DefinitionParser::working" ) ;
+
     if ( !ctxt || map.empty() )
     return ;
 
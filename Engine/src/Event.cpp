@@ -489,6 +489,32 @@ Event* DirectionChangedEvent::clone() const
 
 // ---------------------------------------------------------------------------------------------------
 
+OverlapBeginEvent::OverlapBeginEvent ( const EventProceeder* emitter , const EventProceeder* first , const EventProceeder* second )
+: Gre::Event(emitter, EventType::OverlapBegin) , First(first) , Second(second)
+{
+
+}
+
+Event* OverlapBeginEvent::clone() const
+{
+    return new OverlapBeginEvent ( iEmitter->getObject() , First , Second ) ;
+}
+
+// ---------------------------------------------------------------------------------------------------
+
+OverlapEndEvent::OverlapEndEvent ( const EventProceeder* emitter , const EventProceeder* first , const EventProceeder* second )
+: Gre::Event(emitter, EventType::OverlapEnd) , First(first) , Second(second)
+{
+
+}
+
+Event* OverlapEndEvent::clone() const
+{
+    return new OverlapEndEvent ( iEmitter->getObject() , First , Second ) ;
+}
+
+// ---------------------------------------------------------------------------------------------------
+
 CustomEvent::CustomEvent ( const EventProceeder * emitter , const std::map < std::string , Variant > & properties )
 : Gre::Event( emitter , EventType::Custom )
 , Properties(properties)
@@ -238,6 +238,14 @@ void EventProceeder::onEvent(EventHolder &holder)
                 onDirectionChangedEvent(event->to<DirectionChangedEvent>());
                 break;
 
+            case EventType::OverlapBegin:
+                onOverlapBeginEvent(event->to<OverlapBeginEvent>());
+                break;
+
+            case EventType::OverlapEnd:
+                onOverlapEndEvent(event->to<OverlapEndEvent>());
+                break;
+
             case EventType::Custom:
                 onCustomEvent(event->to<CustomEvent>());
                 break;
@@ -514,6 +522,16 @@ void EventProceeder::onDirectionChangedEvent(const Gre::DirectionChangedEvent &e
 
 }
 
+void EventProceeder::onOverlapBeginEvent(const Gre::OverlapBeginEvent &)
+{
+
+}
+
+void EventProceeder::onOverlapEndEvent(const Gre::OverlapEndEvent &)
+{
+
+}
+
 void EventProceeder::onCustomEvent ( const CustomEvent & e )
 {
 
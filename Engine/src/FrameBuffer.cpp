@@ -269,6 +269,11 @@ const Projection & RenderFramebuffer::getProjection () const
     GreAutolock ; return iViewport.getProjection () ;
 }
 
+bool RenderFramebuffer::copy ( const RenderFramebuffer & , const RenderFramebufferAttachement & ) const
+{
+    return false ;
+}
+
 // ---------------------------------------------------------------------------------------------------
 
 RenderFramebufferInternalCreator::RenderFramebufferInternalCreator ()
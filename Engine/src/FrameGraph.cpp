@@ -0,0 +1,448 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  FrameGraph.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "FrameGraph.h"
+#include "ResourceManager.h"
+
+GreBeginNamespace
+
+// -----------------------------------------------------------------------------
+// FrameGraphTarget implementation.
+
+FrameGraphTarget::FrameGraphTarget ()
+: width ( 0 ) , height ( 0 )
+, format ( PixelFormat::RGBA ) , internalformat ( InternalPixelFormat::RGBA ) , type ( PixelType::UnsignedByte )
+{
+
+}
+
+FrameGraphTarget::FrameGraphTarget (int w , int h ,
+                                    const PixelFormat & pf ,
+                                    const InternalPixelFormat & ipf ,
+                                    const PixelType & pt )
+: width ( w ) , height ( h ) , format ( pf ) , internalformat ( ipf ) , type ( pt )
+{
+
+}
+
+size_t FrameGraphTarget::getBytes () const
+{
+    if ( width <= 0 || height <= 0 )
+    return 0 ;
+
+    return (size_t) width * (size_t) height * PixelFormatGetCount ( format ) * PixelTypeGetSize ( type ) ;
+}
+
+bool FrameGraphTarget::operator == ( const FrameGraphTarget & rhs ) const
+{
+    return width == rhs.width && height == rhs.height
+        && format == rhs.format && internalformat == rhs.internalformat
+        && type == rhs.type ;
+}
+
+// -----------------------------------------------------------------------------
+// FrameGraph implementation.
+
+static bool FrameGraphWrites ( const RenderPass * pass , const std::string & target )
+{
+    for ( const auto & write : pass -> getWrites () )
+    if ( write.name == target )
+    return true ;
+
+    return false ;
+}
+
+FrameGraph::FrameGraph ( const std::string & name )
+: iName ( name ) , iCreated ( 0 )
+{
+
+}
+
+FrameGraph::~FrameGraph ()
+{
+
+}
+
+void FrameGraph::addTarget ( const std::string & name , const FrameGraphTarget & target )
+{
+    iImported.erase ( name ) ;
+    iTargets[name] = target ;
+}
+
+void FrameGraph::importTarget ( const std::string & name , const TextureHolder & texture )
+{
+    iTargets.erase ( name ) ;
+    iImported[name] = texture ;
+}
+
+void FrameGraph::removeTarget ( const std::string & name )
+{
+    iTargets.erase ( name ) ;
+    iImported.erase ( name ) ;
+}
+
+void FrameGraph::clear ()
+{
+    iTargets.clear () ;
+    iImported.clear () ;
+
+    auto manager = ResourceManager::Get () ;
+    TextureManagerHolder textures = manager.isInvalid() ? TextureManagerHolder ( nullptr ) : manager -> getTextureManager () ;
+
+    if ( !textures.isInvalid() )
+    for ( const auto & entry : iPool )
+    textures -> remove ( entry.texture ) ;
+
+    iPool.clear () ;
+    iStats = FrameGraphStats () ;
+}
+
+bool FrameGraph::empty () const
+{
+    return iTargets.empty () && iImported.empty () ;
+}
+
+std::vector < const RenderPass * > FrameGraph::compile ( const std::vector < const RenderPass * > & passes )
+{
+    iStats = FrameGraphStats () ;
+
+    std::vector < const RenderPass * > result ;
+    result.reserve ( passes.size () ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Orders the passes. When they depend on each others , the given order
+    // is the only one we can trust.
+
+    std::vector < size_t > order = sort ( passes ) ;
+
+    if ( order.empty () && !passes.empty () )
+    {
+        GreDebug ( "[WARN] FrameGraph '" ) << iName << "' has a cycle , passes are not reordered." << gendl ;
+
+        for ( size_t i = 0 ; i < passes.size () ; ++i )
+        order.push_back ( i ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Culls the passes : starting from the passes drawing to the screen or
+    // to imported targets , keeps every pass writing a target read by a kept
+    // pass.
+
+    std::vector < bool > needed ( passes.size () , false ) ;
+    std::vector < size_t > stack ;
+
+    for ( size_t i = 0 ; i < passes.size () ; ++i )
+    {
+        const auto & writes = passes[i] -> getWrites () ;
+        bool root = writes.empty () ;
+
+        for ( const auto & write : writes )
+        if ( iTargets.find ( write.name ) == iTargets.end () )
+        root = true ;
+
+        if ( root )
+        {
+            needed[i] = true ;
+            stack.push_back ( i ) ;
+        }
+    }
+
+    while ( !stack.empty () )
+    {
+        size_t i = stack.back () ;
+        stack.pop_back () ;
+
+        for ( const auto & read : passes[i] -> getReads () )
+        {
+            for ( size_t j = 0 ; j < passes.size () ; ++j )
+            {
+                if ( needed[j] || !FrameGraphWrites ( passes[j] , read.name ) )
+                continue ;
+
+                needed[j] = true ;
+                stack.push_back ( j ) ;
+            }
+        }
+    }
+
+    for ( size_t i : order )
+    {
+        if ( needed[i] ) result.push_back ( passes[i] ) ;
+        else iStats.culled ++ ;
+    }
+
+    iStats.passes = result.size () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Computes the lifetime of each transient target , as the positions of
+    // the first and last executed passes using it.
+
+    std::map < std::string , std::pair < size_t , size_t > > lifetimes ;
+
+    for ( size_t p = 0 ; p < result.size () ; ++p )
+    {
+        for ( const auto * targets : { & result[p] -> getReads () , & result[p] -> getWrites () } )
+        {
+            for ( const auto & target : *targets )
+            {
+                if ( iTargets.find ( target.name ) == iTargets.end () )
+                continue ;
+
+                auto it = lifetimes.find ( target.name ) ;
+
+                if ( it == lifetimes.end () )
+                lifetimes[target.name] = std::make_pair ( p , p ) ;
+
+                else
+                it -> second.second = p ;
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Gives the textures : a target takes a free texture when its lifetime
+    // begins , and frees it after its last pass.
+
+    for ( auto & entry : iPool )
+    {
+        entry.used = false ;
+        entry.free = true ;
+    }
+
+    std::map < std::string , size_t > assigned ;
+    size_t live = 0 ;
+
+    for ( size_t p = 0 ; p < result.size () ; ++p )
+    {
+        for ( const auto & lifetime : lifetimes )
+        {
+            if ( lifetime.second.first != p )
+            continue ;
+
+            const FrameGraphTarget & target = iTargets[lifetime.first] ;
+            size_t entry = acquire ( target ) ;
+
+            if ( entry >= iPool.size () )
+            {
+                GreDebug ( "[WARN] FrameGraph '" ) << iName << "' can't allocate target '" << lifetime.first << "'." << gendl ;
+                continue ;
+            }
+
+            assigned[lifetime.first] = entry ;
+            live += target.getBytes () ;
+
+            iStats.targets ++ ;
+            iStats.transientBytes += target.getBytes () ;
+        }
+
+        iStats.peakBytes = std::max ( iStats.peakBytes , live ) ;
+
+        for ( const auto & lifetime : lifetimes )
+        {
+            if ( lifetime.second.second != p )
+            continue ;
+
+            auto it = assigned.find ( lifetime.first ) ;
+
+            if ( it == assigned.end () )
+            continue ;
+
+            iPool[it->second].free = true ;
+            live -= iPool[it->second].target.getBytes () ;
+        }
+    }
+
+    for ( const RenderPass * pass : result )
+    {
+        for ( const auto * targets : { & pass -> getReads () , & pass -> getWrites () } )
+        {
+            for ( const auto & target : *targets )
+            {
+                auto imported = iImported.find ( target.name ) ;
+                auto transient = assigned.find ( target.name ) ;
+
+                if ( imported != iImported.end () )
+                pass -> setTargetTexture ( target.name , imported -> second ) ;
+
+                else if ( transient != assigned.end () )
+                pass -> setTargetTexture ( target.name , iPool[transient->second].texture ) ;
+
+                else
+                pass -> setTargetTexture ( target.name , TextureHolder ( nullptr ) ) ;
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Releases the textures this frame did not need.
+
+    auto manager = ResourceManager::Get () ;
+    TextureManagerHolder textures = manager.isInvalid() ? TextureManagerHolder ( nullptr ) : manager -> getTextureManager () ;
+
+    for ( auto it = iPool.begin () ; it != iPool.end () ; )
+    {
+        if ( it -> used )
+        {
+            ++it ;
+            continue ;
+        }
+
+        if ( !textures.isInvalid() )
+        textures -> remove ( it -> texture ) ;
+
+        it = iPool.erase ( it ) ;
+    }
+
+    iStats.textures = iPool.size () ;
+    return result ;
+}
+
+const FrameGraphStats & FrameGraph::getStats () const
+{
+    return iStats ;
+}
+
+std::vector < size_t > FrameGraph::sort ( const std::vector < const RenderPass * > & passes ) const
+{
+    size_t count = passes.size () ;
+
+    std::vector < std::vector < size_t > > successors ( count ) ;
+    std::vector < size_t > predecessors ( count , 0 ) ;
+
+    for ( size_t i = 0 ; i < count ; ++i )
+    {
+        //////////////////////////////////////////////////////////////////////
+        // A pass reading a target comes after the other passes writing it.
+
+        for ( const auto & read : passes[i] -> getReads () )
+        {
+            for ( size_t j = 0 ; j < count ; ++j )
+            {
+                if ( j != i && FrameGraphWrites ( passes[j] , read.name ) )
+                {
+                    successors[j].push_back ( i ) ;
+                    predecessors[i] ++ ;
+                }
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        // Passes writing the same target keep their order.
+
+        for ( const auto & write : passes[i] -> getWrites () )
+        {
+            for ( size_t j = i + 1 ; j < count ; ++j )
+            {
+                if ( FrameGraphWrites ( passes[j] , write.name ) )
+                {
+                    successors[i].push_back ( j ) ;
+                    predecessors[j] ++ ;
+                }
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Takes the first ready pass in the given order , until every pass is
+    // taken.
+
+    std::vector < size_t > order ;
+    std::vector < bool > done ( count , false ) ;
+    order.reserve ( count ) ;
+
+    while ( order.size () < count )
+    {
+        size_t next = count ;
+
+        for ( size_t i = 0 ; i < count ; ++i )
+        {
+            if ( !done[i] && predecessors[i] == 0 )
+            {
+                next = i ;
+                break ;
+            }
+        }
+
+        if ( next == count )
+        return std::vector < size_t > () ;
+
+        done[next] = true ;
+        order.push_back ( next ) ;
+
+        for ( size_t successor : successors[next] )
+        predecessors[successor] -- ;
+    }
+
+    return order ;
+}
+
+size_t FrameGraph::acquire ( const FrameGraphTarget & target )
+{
+    for ( size_t i = 0 ; i < iPool.size () ; ++i )
+    {
+        PoolEntry & entry = iPool[i] ;
+
+        if ( entry.free && entry.target == target )
+        {
+            entry.free = false ;
+            entry.used = true ;
+            return i ;
+        }
+    }
+
+    auto manager = ResourceManager::Get () ;
+    TextureManagerHolder textures = manager.isInvalid() ? TextureManagerHolder ( nullptr ) : manager -> getTextureManager () ;
+
+    if ( textures.isInvalid() )
+    return iPool.size () ;
+
+    size_t psize = PixelFormatGetCount ( target.format ) * PixelTypeGetSize ( target.type ) ;
+    std::string name = iName + ".transient." + std::to_string ( iCreated ++ ) ;
+
+    TextureHolder texture = textures -> loadFromNewPixelBuffer ( name , target.width , target.height , 0 ,
+                                                                target.format , target.internalformat , target.type ,
+                                                                TextureType::Texture2D , (int) psize ) ;
+
+    if ( texture.isInvalid() )
+    return iPool.size () ;
+
+    PoolEntry entry ;
+    entry.target = target ;
+    entry.texture = texture ;
+    entry.used = true ;
+    entry.free = false ;
+
+    iPool.push_back ( entry ) ;
+    return iPool.size () - 1 ;
+}
+
+GreEndNamespace
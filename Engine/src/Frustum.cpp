@@ -0,0 +1,156 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  Frustum.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 14/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "Frustum.h"
+
+GreBeginNamespace
+
+Frustum::Frustum ()
+{
+    for ( int i = 0 ; i < 6 ; ++i )
+    iPlanes [i] = Plane ( 0.0f , 0.0f , 0.0f , 1.0f ) ;
+}
+
+Frustum::Frustum ( const Matrix4 & projectionview )
+{
+    set ( projectionview ) ;
+}
+
+void Frustum::set ( const Matrix4 & projectionview )
+{
+    //////////////////////////////////////////////////////////////////////
+    // Gribb-Hartmann extraction. glm stores matrices column-major , so the
+    // row 'i' is made of the 'i' component of every column.
+
+    const Matrix4 & m = projectionview ;
+
+    Vector4 row0 ( m[0][0] , m[1][0] , m[2][0] , m[3][0] ) ;
+    Vector4 row1 ( m[0][1] , m[1][1] , m[2][1] , m[3][1] ) ;
+    Vector4 row2 ( m[0][2] , m[1][2] , m[2][2] , m[3][2] ) ;
+    Vector4 row3 ( m[0][3] , m[1][3] , m[2][3] , m[3][3] ) ;
+
+    iPlanes [0] = row3 + row0 ;
+    iPlanes [1] = row3 - row0 ;
+    iPlanes [2] = row3 + row1 ;
+    iPlanes [3] = row3 - row1 ;
+    iPlanes [4] = row3 + row2 ;
+    iPlanes [5] = row3 - row2 ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Normalizes the planes so distances can be compared to radius.
+
+    for ( int i = 0 ; i < 6 ; ++i )
+    {
+        float len = glm::length ( Vector3 ( iPlanes[i] ) ) ;
+
+        if ( len > FloatPrecision )
+        iPlanes [i] = iPlanes [i] / len ;
+    }
+}
+
+const Plane & Frustum::getPlane ( int index ) const
+{
+    return iPlanes [index] ;
+}
+
+void Frustum::disablePlane ( int index )
+{
+    iPlanes [index] = Plane ( 0.0f , 0.0f , 0.0f , 1.0f ) ;
+}
+
+bool Frustum::contains ( const Vector3 & point ) const
+{
+    for ( int i = 0 ; i < 6 ; ++i )
+    {
+        if ( glm::dot ( Vector3 ( iPlanes[i] ) , point ) + iPlanes[i].w < 0.0f )
+        return false ;
+    }
+
+    return true ;
+}
+
+IntersectionResult Frustum::intersect ( const BoundingBox & bbox ) const
+{
+    if ( bbox.isInvalid() )
+    return IntersectionResult::Outside ;
+
+    const Vector3 & bmin = bbox.getMin () ;
+    const Vector3 & bmax = bbox.getMax () ;
+
+    IntersectionResult result = IntersectionResult::Inside ;
+
+    for ( int i = 0 ; i < 6 ; ++i )
+    {
+        const Plane & plane = iPlanes [i] ;
+
+        //////////////////////////////////////////////////////////////////////
+        // The positive vertex is the box corner the farthest along the plane's
+        // normal. If it is behind the plane , the whole box is. The negative
+        // vertex tells if the box crosses the plane.
+
+        Vector3 positive ( plane.x >= 0.0f ? bmax.x : bmin.x ,
+                           plane.y >= 0.0f ? bmax.y : bmin.y ,
+                           plane.z >= 0.0f ? bmax.z : bmin.z ) ;
+
+        Vector3 negative ( plane.x >= 0.0f ? bmin.x : bmax.x ,
+                           plane.y >= 0.0f ? bmin.y : bmax.y ,
+                           plane.z >= 0.0f ? bmin.z : bmax.z ) ;
+
+        if ( glm::dot ( Vector3 ( plane ) , positive ) + plane.w < 0.0f )
+        return IntersectionResult::Outside ;
+
+        if ( glm::dot ( Vector3 ( plane ) , negative ) + plane.w < 0.0f )
+        result = IntersectionResult::Between ;
+    }
+
+    return result ;
+}
+
+IntersectionResult Frustum::intersect ( const Vector3 & center , float radius ) const
+{
+    IntersectionResult result = IntersectionResult::Inside ;
+
+    for ( int i = 0 ; i < 6 ; ++i )
+    {
+        float distance = glm::dot ( Vector3 ( iPlanes[i] ) , center ) + iPlanes[i].w ;
+
+        if ( distance < - radius )
+        return IntersectionResult::Outside ;
+
+        if ( distance < radius )
+        result = IntersectionResult::Between ;
+    }
+
+    return result ;
+}
+
+GreEndNamespace
@@ -0,0 +1,400 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  GlslReflection.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "GlslReflection.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+GreBeginNamespace
+
+HdwProgVarType HdwProgVarTypeFromGlsl ( const std::string & type )
+{
+    if ( type == "float" ) return HdwProgVarType::Float1 ;
+    else if ( type == "vec2" ) return HdwProgVarType::Float2 ;
+    else if ( type == "vec3" ) return HdwProgVarType::Float3 ;
+    else if ( type == "vec4" ) return HdwProgVarType::Float4 ;
+
+    else if ( type == "int" ) return HdwProgVarType::Int1 ;
+    else if ( type == "ivec2" ) return HdwProgVarType::Int2 ;
+    else if ( type == "ivec3" ) return HdwProgVarType::Int3 ;
+    else if ( type == "ivec4" ) return HdwProgVarType::Int4 ;
+
+    else if ( type == "uint" ) return HdwProgVarType::UnsignedInt1 ;
+    else if ( type == "uvec2" ) return HdwProgVarType::UnsignedInt2 ;
+    else if ( type == "uvec3" ) return HdwProgVarType::UnsignedInt3 ;
+    else if ( type == "uvec4" ) return HdwProgVarType::UnsignedInt4 ;
+
+    else if ( type == "bool" ) return HdwProgVarType::Bool1 ;
+    else if ( type == "bvec2" ) return HdwProgVarType::Bool2 ;
+    else if ( type == "bvec3" ) return HdwProgVarType::Bool3 ;
+    else if ( type == "bvec4" ) return HdwProgVarType::Bool4 ;
+
+    else if ( type == "mat2" ) return HdwProgVarType::Matrix2 ;
+    else if ( type == "mat3" ) return HdwProgVarType::Matrix3 ;
+    else if ( type == "mat4" ) return HdwProgVarType::Matrix4 ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Samplers are 'sampler2D' , 'isampler2D' , 'sampler2DShadow' ...
+
+    size_t sampler = type.find ( "sampler" ) ;
+
+    if ( sampler == 0 || sampler == 1 )
+    {
+        std::string dimension = type.substr ( sampler + 7 ) ;
+
+        if ( dimension.compare ( 0 , 2 , "1D" ) == 0 ) return HdwProgVarType::Sampler1D ;
+        else if ( dimension.compare ( 0 , 2 , "2D" ) == 0 ) return HdwProgVarType::Sampler2D ;
+        else if ( dimension.compare ( 0 , 2 , "3D" ) == 0 ) return HdwProgVarType::Sampler3D ;
+        else if ( dimension.compare ( 0 , 4 , "Cube" ) == 0 ) return HdwProgVarType::SamplerCube ;
+    }
+
+    return HdwProgVarType::None ;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Splits a GLSL source in identifiers , numbers and symbols.
+/// Comments are removed , and simple '#define NAME VALUE' are replaced.
+//////////////////////////////////////////////////////////////////////
+static std::vector < std::string > GlslTokenize ( const std::string & source )
+{
+    std::vector < std::string > tokens ;
+    std::map < std::string , std::string > defines ;
+
+    size_t i = 0 ;
+    bool linestart = true ;
+
+    while ( i < source.size() )
+    {
+        char c = source [i] ;
+
+        if ( c == '\n' ) { linestart = true ; i++ ; continue ; }
+        if ( isspace ( (unsigned char) c ) ) { i++ ; continue ; }
+
+        if ( source.compare ( i , 2 , "//" ) == 0 )
+        {
+            i = source.find ( '\n' , i ) ;
+            if ( i == std::string::npos ) break ;
+            continue ;
+        }
+
+        if ( source.compare ( i , 2 , "/*" ) == 0 )
+        {
+            i = source.find ( "*/" , i + 2 ) ;
+            if ( i == std::string::npos ) break ;
+            i += 2 ; continue ;
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        // Preprocessor directives take the whole line. Only defines are kept.
+
+        if ( c == '#' && linestart )
+        {
+            size_t end = source.find ( '\n' , i ) ;
+            if ( end == std::string::npos ) end = source.size () ;
+
+            std::istringstream line ( source.substr ( i + 1 , end - i - 1 ) ) ;
+            std::string directive , name , value ;
+            line >> directive >> name >> value ;
+
+            if ( directive == "define" && !name.empty() && name.find('(') == std::string::npos )
+            defines [name] = value ;
+
+            i = end ; continue ;
+        }
+
+        linestart = false ;
+
+        if ( isalnum ( (unsigned char) c ) || c == '_' )
+        {
+            size_t start = i ;
+            while ( i < source.size() && ( isalnum ( (unsigned char) source[i] ) || source[i] == '_' || source[i] == '.' ) ) i++ ;
+
+            std::string token = source.substr ( start , i - start ) ;
+            auto define = defines.find ( token ) ;
+
+            if ( define != defines.end() && !define->second.empty() )
+            tokens.push_back ( define->second ) ;
+            else
+            tokens.push_back ( token ) ;
+
+            continue ;
+        }
+
+        tokens.push_back ( std::string ( 1 , c ) ) ;
+        i++ ;
+    }
+
+    return tokens ;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A member of a GLSL structure.
+//////////////////////////////////////////////////////////////////////
+struct GlslMember
+{
+    std::string type ;
+    std::string name ;
+    int count ;
+};
+
+typedef std::map < std::string , std::vector < GlslMember > > GlslStructs ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Reads 'type name [N] , name2 ;' from 'i' , and returns the
+/// declared members. 'i' is set after the ';'.
+//////////////////////////////////////////////////////////////////////
+static std::vector < GlslMember > GlslReadDeclaration ( const std::vector < std::string > & tokens , size_t & i )
+{
+    static const std::vector < std::string > qualifiers = {
+        "const" , "highp" , "mediump" , "lowp" , "flat" , "smooth" , "noperspective" ,
+        "centroid" , "invariant" , "in" , "out" , "uniform" , "attribute" , "varying"
+    };
+
+    std::vector < GlslMember > result ;
+
+    while ( i < tokens.size() && std::find ( qualifiers.begin() , qualifiers.end() , tokens[i] ) != qualifiers.end() )
+    i++ ;
+
+    if ( i >= tokens.size() )
+    return result ;
+
+    std::string type = tokens [i++] ;
+
+    while ( i < tokens.size() && tokens[i] != ";" )
+    {
+        if ( tokens[i] == "," ) { i++ ; continue ; }
+
+        GlslMember member = { type , tokens[i++] , 0 } ;
+
+        if ( i + 2 < tokens.size() && tokens[i] == "[" )
+        {
+            member.count = atoi ( tokens[i+1].c_str() ) ;
+            while ( i < tokens.size() && tokens[i] != "]" ) i++ ;
+            i++ ;
+        }
+
+        result.push_back ( member ) ;
+    }
+
+    i++ ;
+    return result ;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Skips a '{ ... }' bloc starting at 'i'. 'i' is set after the
+/// closing brace.
+//////////////////////////////////////////////////////////////////////
+static void GlslSkipBlock ( const std::vector < std::string > & tokens , size_t & i )
+{
+    int depth = 0 ;
+
+    for ( ; i < tokens.size() ; ++i )
+    {
+        if ( tokens[i] == "{" ) depth++ ;
+        else if ( tokens[i] == "}" && --depth == 0 ) { i++ ; return ; }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Registers a uniform , expanding arrays and structures as a
+/// driver names them.
+//////////////////////////////////////////////////////////////////////
+static void GlslAddUniform (const std::string & name , const std::string & type , int count ,
+                            const GlslStructs & structs , int & location ,
+                            std::map < std::string , HardwareProgramVariable > & uniforms)
+{
+    if ( count > 0 )
+    {
+        for ( int i = 0 ; i < count ; ++i )
+        GlslAddUniform ( name + "[" + std::to_string(i) + "]" , type , 0 , structs , location , uniforms ) ;
+
+        return ;
+    }
+
+    auto it = structs.find ( type ) ;
+
+    if ( it != structs.end() )
+    {
+        for ( const GlslMember & member : it->second )
+        GlslAddUniform ( name + "." + member.name , member.type , member.count , structs , location , uniforms ) ;
+
+        return ;
+    }
+
+    if ( uniforms.count ( name ) )
+    return ;
+
+    HardwareProgramVariable var ;
+    var.name = name ;
+    var.location = location++ ;
+    var.type = HdwProgVarTypeFromGlsl ( type ) ;
+    uniforms.insert ( std::make_pair ( name , var ) ) ;
+}
+
+static std::string GlslGetFileContent ( const std::string & path )
+{
+    std::ifstream srcstream ( path );
+
+    if ( !srcstream )
+    {
+#ifdef GreIsDebugMode
+        GreDebugPretty() << "Can't open file '" << path << "'." << Gre::gendl;
+#endif
+        return std::string () ;
+    }
+
+    return std::string ( (std::istreambuf_iterator<char>(srcstream)), std::istreambuf_iterator<char>() ) ;
+}
+
+std::string GlslExpandIncludes ( const std::string & source )
+{
+    std::string value ;
+
+    char c = 0 ;
+    std::stringstream stream ( source ) ;
+    while ( stream >> std::noskipws >> c )
+    {
+        if ( c == '#' )
+        {
+            std::string word ; stream >> word ;
+            if ( word == "include" ) {
+                stream >> std::skipws >> word ;
+                value . append( GlslExpandIncludes(GlslGetFileContent(word)) ) ;
+            } else {
+                value . push_back(c) ;
+                value . append(word) ;
+            }
+        }
+
+        else
+        {
+            value . push_back(c) ;
+        }
+    }
+
+    return value ;
+}
+
+// ---------------------------------------------------------------------------
+
+void GlslReflection::reflect ( const ShaderType & type , const std::string & source )
+{
+    std::vector < std::string > tokens = GlslTokenize ( source ) ;
+    GlslStructs structs ;
+
+    size_t i = 0 ;
+
+    while ( i < tokens.size() )
+    {
+        const std::string & token = tokens [i] ;
+        int layoutlocation = -1 ;
+
+        //////////////////////////////////////////////////////////////////////
+        // 'layout ( location = N , ... )' prefixes the declaration.
+
+        if ( token == "layout" )
+        {
+            for ( ++i ; i < tokens.size() && tokens[i] != ")" ; ++i )
+            {
+                if ( tokens[i] == "location" && i + 2 < tokens.size() && tokens[i+1] == "=" )
+                layoutlocation = atoi ( tokens[i+2].c_str() ) ;
+            }
+
+            i++ ;
+            if ( i >= tokens.size() ) break ;
+        }
+
+        const std::string & keyword = tokens [i] ;
+
+        if ( keyword == "struct" && i + 2 < tokens.size() && tokens[i+2] == "{" )
+        {
+            std::string name = tokens [i+1] ;
+            std::vector < GlslMember > & members = structs [name] ;
+
+            for ( i += 3 ; i < tokens.size() && tokens[i] != "}" ; )
+            {
+                std::vector < GlslMember > declared = GlslReadDeclaration ( tokens , i ) ;
+                members.insert ( members.end() , declared.begin() , declared.end() ) ;
+            }
+
+            while ( i < tokens.size() && tokens[i] != ";" ) i++ ;
+            i++ ; continue ;
+        }
+
+        if ( keyword == "uniform" && i + 2 < tokens.size() && tokens[i+2] == "{" )
+        {
+            if ( !blocks.count ( tokens[i+1] ) )
+            blocks [tokens[i+1]] = nextBlock++ ;
+
+            i += 2 ;
+            GlslSkipBlock ( tokens , i ) ;
+
+            while ( i < tokens.size() && tokens[i] != ";" ) i++ ;
+            i++ ; continue ;
+        }
+
+        if ( keyword == "uniform" )
+        {
+            for ( const GlslMember & member : GlslReadDeclaration ( tokens , i ) )
+            GlslAddUniform ( member.name , member.type , member.count , structs , nextUniform , uniforms ) ;
+
+            continue ;
+        }
+
+        if ( ( keyword == "in" || keyword == "attribute" ) && type == ShaderType::Vertex )
+        {
+            for ( const GlslMember & member : GlslReadDeclaration ( tokens , i ) )
+            {
+                int location = layoutlocation >= 0 ? layoutlocation++ : nextAttribute ;
+                nextAttribute = std::max ( nextAttribute , location ) + 1 ;
+                attributes [member.name] = location ;
+            }
+
+            continue ;
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        // Any other declaration or function is skipped.
+
+        while ( i < tokens.size() && tokens[i] != ";" && tokens[i] != "{" ) i++ ;
+
+        if ( i < tokens.size() && tokens[i] == "{" )
+        GlslSkipBlock ( tokens , i ) ;
+        else
+        i++ ;
+    }
+}
+
+GreEndNamespace
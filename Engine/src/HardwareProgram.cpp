@@ -33,14 +33,33 @@
 #include "HardwareProgram.h"
 #include "Material.h"
 
+#include <atomic>
+#include <cstring>
+
 GreBeginNamespace
 
+//////////////////////////////////////////////////////////////////////
+// Number of uniforms set since the last reset , and how many of them
+// were filtered because their value didn't change.
+
+static std::atomic < size_t > UniformCalls ( 0 ) ;
+static std::atomic < size_t > UniformHits ( 0 ) ;
+
+//////////////////////////////////////////////////////////////////////
+// Arena's generation , offset and size of the range bound at each block
+// binding. Bindings are shared by every programs.
+
+static size_t BoundBlocks [UniformBlockBindingCount][3] ;
+
 HardwareProgram::HardwareProgram ( const std::string & name )
 : Gre::Resource ( name )
-, iLinked ( false ) , iBinded ( false )
+, iLinked ( false ) , iBinded ( false ) , iLinkVersion ( 0 )
 {
     iAttachedShaders[ShaderType::Vertex] = HardwareShaderHolder ( nullptr ) ;
     iAttachedShaders[ShaderType::Fragment] = HardwareShaderHolder ( nullptr ) ;
+
+    for ( size_t i = 0 ; i < UniformBlockBindingCount ; ++i )
+    iBlockIndexes [i] = -1 ;
 }
 
 HardwareProgram::~HardwareProgram() noexcept ( false )
@@ -77,6 +96,17 @@ void HardwareProgram::finalize ()
 
     if ( !iLinked ) {
         iLinked = _finalize () ;
+        iLinkVersion ++ ;
+        iShadowVariables.clear () ;
+
+        //////////////////////////////////////////////////////////////////////
+        // Resolves the blocks filled by the engine from their names.
+
+        for ( size_t i = 0 ; i < UniformBlockBindingCount ; ++i )
+        {
+            auto it = iUniformBlocks.find ( UniformBlockName ( (UniformBlockBinding) i ) ) ;
+            iBlockIndexes [i] = it == iUniformBlocks.end() ? -1 : it -> second ;
+        }
     }
 }
 
@@ -127,6 +157,12 @@ void HardwareProgram::reset()
     iCachedVariables.clear() ;
     iUniforms.clear() ;
     iAttribsLocation.clear() ;
+    iShadowVariables.clear() ;
+    iUniformBlocks.clear() ;
+    iLinkVersion ++ ;
+
+    for ( size_t i = 0 ; i < UniformBlockBindingCount ; ++i )
+    iBlockIndexes [i] = -1 ;
 }
 
 bool HardwareProgram::setUniform ( const std::string & name , const HdwProgVarType & type , const RealProgramVariable & value ) const
@@ -144,7 +180,7 @@ bool HardwareProgram::setUniform ( const std::string & name , const HdwProgVarTy
 		if ( it != iUniforms.end() )
         {
             if ( it->second.type == type )
-			return _setUniform ( it->second.location , type , value ) ;
+			return setUniform ( it->second.location , type , value ) ;
 		}
 	}
 
@@ -156,6 +192,123 @@ bool HardwareProgram::setUniform ( const HardwareProgramVariable & variable ) co
     return setUniform ( variable.name , variable.type , variable.value ) ;
 }
 
+bool HardwareProgram::setUniform ( int location , const HdwProgVarType & type , const RealProgramVariable & value ) const
+{
+    GreAutolock ; UniformCalls ++ ;
+
+    if ( location < 0 )
+    return _setUniform ( location , type , value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Compares only the bytes of the given type , as the rest of the union
+    // is not initialized.
+
+    const size_t size = HdwProgVarTypeGetSize ( type ) ;
+
+    if ( (size_t) location >= iShadowVariables.size () )
+    iShadowVariables.resize ( location + 1 ) ;
+
+    HardwareProgramVariable & shadow = iShadowVariables [location] ;
+
+    if ( size && shadow.type == type && !memcmp ( &shadow.value , &value , size ) )
+    {
+        UniformHits ++ ;
+        return true ;
+    }
+
+    if ( !_setUniform ( location , type , value ) )
+    {
+        shadow.type = HdwProgVarType::None ;
+        return false ;
+    }
+
+    shadow.type = type ;
+    shadow.value = value ;
+    return true ;
+}
+
+bool HardwareProgram::findUniform ( const std::string & name , int & location , HdwProgVarType & type ) const
+{
+    GreAutolock ; auto it = iUniforms.find ( name ) ;
+
+    if ( it == iUniforms.end() ) return false ;
+
+    location = it -> second.location ;
+    type = it -> second.type ;
+    return true ;
+}
+
+size_t HardwareProgram::getLinkVersion () const
+{
+    GreAutolock ; return iLinkVersion ;
+}
+
+void HardwareProgram::setVertexAttrib (int location ,
+                                       size_t elements ,
+                                       VertexAttribType type ,
+                                       bool normalize ,
+                                       size_t stride ,
+                                       void * pointer) const
+{
+    GreAutolock ;
+
+    for ( auto & attrib : iAttribsLocation )
+    {
+        if ( attrib.second == location )
+        {
+            setVertexAttrib ( attrib.first , elements , type , normalize , stride , pointer ) ;
+            return ;
+        }
+    }
+}
+
+int HardwareProgram::getAttribLocation ( const std::string & name ) const
+{
+    GreAutolock ; auto it = iAttribsLocation.find ( name ) ;
+
+    if ( it == iAttribsLocation.end() ) return -1 ;
+    return it -> second ;
+}
+
+bool HardwareProgram::hasUniformBlock ( const UniformBlockBinding & binding ) const
+{
+    GreAutolock ; return iLinked && iBlockIndexes [(size_t) binding] >= 0 ;
+}
+
+bool HardwareProgram::setUniformBlock ( const UniformBlockBinding & binding , const UniformArena & arena , size_t offset , size_t size ) const
+{
+    GreAutolock ;
+
+    const int index = iBlockIndexes [(size_t) binding] ;
+
+    if ( !iLinked || index < 0 )
+    return false ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The range may already be bound , by this program or another one.
+
+    size_t* bound = BoundBlocks [(size_t) binding] ;
+
+    if ( bound[0] == arena.getGeneration() && bound[1] == offset && bound[2] == size )
+    return true ;
+
+    if ( !_setUniformBlock ( index , binding , arena , offset , size ) )
+    {
+        bound[0] = 0 ;
+        return false ;
+    }
+
+    bound[0] = arena.getGeneration () ;
+    bound[1] = offset ;
+    bound[2] = size ;
+    return true ;
+}
+
+bool HardwareProgram::_setUniformBlock ( int , const UniformBlockBinding & , const UniformArena & , size_t , size_t ) const
+{
+    return false ;
+}
+
 bool HardwareProgram::isUniformValid(const std::string &name) const
 {
     GreAutolock ; return iUniforms.find(name) != iUniforms.end() ;
@@ -169,4 +322,25 @@ int HardwareProgram::getUniformLocation(const std::string &name) const
     return it -> second.location ;
 }
 
+size_t HardwareProgram::GetUniformCalls ()
+{
+    return UniformCalls.load () ;
+}
+
+size_t HardwareProgram::GetUniformHits ()
+{
+    return UniformHits.load () ;
+}
+
+size_t HardwareProgram::GetUniformMisses ()
+{
+    return UniformCalls.load () - UniformHits.load () ;
+}
+
+void HardwareProgram::ResetUniformCalls ()
+{
+    UniformCalls = 0 ;
+    UniformHits = 0 ;
+}
+
 GreEndNamespace
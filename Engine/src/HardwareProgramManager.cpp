@@ -32,6 +32,7 @@
 
 #include "HardwareProgramManager.h"
 #include "ResourceManager.h"
+#include "Profiler.h"
 
 GreBeginNamespace
 
@@ -226,6 +227,7 @@ HardwareShaderHolder HardwareProgramManager::loadShaderTable ( const ShaderPathT
 
 HardwareShaderHolder HardwareProgramManager::loadShaderFromFile ( const ShaderType & type , const std::string & path )
 {
+    GreProfileDetail( "HardwareProgramManager::loadShaderFromFile" , path ) ;
     GreAutolock ;
 
     if ( !iInternalCreator )
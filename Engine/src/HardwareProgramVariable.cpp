@@ -71,6 +71,43 @@ HdwProgVarType HdwProgVarTypeFromString( const std::string & type )
     return HdwProgVarType::None ;
 }
 
+size_t HdwProgVarTypeGetSize ( const HdwProgVarType & type )
+{
+    switch ( type )
+    {
+        case HdwProgVarType::Float1 : return sizeof ( float ) ;
+        case HdwProgVarType::Float2 : return sizeof ( Vector2 ) ;
+        case HdwProgVarType::Float3 : return sizeof ( Vector3 ) ;
+        case HdwProgVarType::Float4 : return sizeof ( Vector4 ) ;
+
+        case HdwProgVarType::Int1 : return sizeof ( int ) ;
+        case HdwProgVarType::Int2 : return sizeof ( IVector2 ) ;
+        case HdwProgVarType::Int3 : return sizeof ( IVector3 ) ;
+        case HdwProgVarType::Int4 : return sizeof ( IVector4 ) ;
+
+        case HdwProgVarType::UnsignedInt1 : return sizeof ( unsigned int ) ;
+        case HdwProgVarType::UnsignedInt2 : return sizeof ( glm::uvec2 ) ;
+        case HdwProgVarType::UnsignedInt3 : return sizeof ( glm::uvec3 ) ;
+        case HdwProgVarType::UnsignedInt4 : return sizeof ( glm::uvec4 ) ;
+
+        case HdwProgVarType::Bool1 : return sizeof ( bool ) ;
+        case HdwProgVarType::Bool2 : return sizeof ( glm::bvec2 ) ;
+        case HdwProgVarType::Bool3 : return sizeof ( glm::bvec3 ) ;
+        case HdwProgVarType::Bool4 : return sizeof ( glm::bvec4 ) ;
+
+        case HdwProgVarType::Matrix2 : return sizeof ( Matrix2 ) ;
+        case HdwProgVarType::Matrix3 : return sizeof ( Matrix3 ) ;
+        case HdwProgVarType::Matrix4 : return sizeof ( Matrix4 ) ;
+
+        case HdwProgVarType::Sampler1D :
+        case HdwProgVarType::Sampler2D :
+        case HdwProgVarType::Sampler3D :
+        case HdwProgVarType::SamplerCube : return sizeof ( int ) ;
+
+        default : return 0 ;
+    }
+}
+
 // -----------------------------------------------------------------------------
 // HardwareProgramVariable implementation.
 
@@ -0,0 +1,192 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  JobPool.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 16/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "JobPool.h"
+
+GreBeginNamespace
+
+JobPool & JobPool::Get ()
+{
+    static JobPool pool ;
+    return pool ;
+}
+
+JobPool::JobPool ( size_t threads )
+: iStopping ( false )
+{
+    if ( !threads )
+    {
+        unsigned int hardware = std::thread::hardware_concurrency () ;
+        threads = hardware > 1 ? hardware - 1 : 1 ;
+    }
+
+    for ( size_t i = 0 ; i < threads ; ++i )
+    iThreads.push_back ( std::thread ( &JobPool::workerMain , this ) ) ;
+}
+
+JobPool::~JobPool ()
+{
+    {
+        std::unique_lock < std::mutex > lock ( iMutex ) ;
+        iStopping = true ;
+    }
+
+    iCondition.notify_all () ;
+
+    for ( auto & thread : iThreads )
+    {
+        if ( thread.joinable() )
+        thread.join () ;
+    }
+}
+
+std::future < void > JobPool::submit ( const std::function < void () > & job )
+{
+    std::packaged_task < void () > task ( job ) ;
+    std::future < void > result = task.get_future () ;
+
+    {
+        std::unique_lock < std::mutex > lock ( iMutex ) ;
+        iJobs.push ( std::move ( task ) ) ;
+    }
+
+    iCondition.notify_one () ;
+    return result ;
+}
+
+void JobPool::parallelFor ( size_t count , size_t grain , const RangeJob & job )
+{
+    if ( !count )
+    return ;
+
+    if ( !grain )
+    grain = 1 ;
+
+    size_t chunks = ( count + grain - 1 ) / grain ;
+
+    if ( chunks == 1 || iThreads.empty() )
+    {
+        job ( 0 , count ) ;
+        return ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Chunks are claimed through an atomic counter by the helpers and by
+    // the calling thread. A helper may start after every chunk has been
+    // claimed , so the state is shared and outlives this call.
+
+    struct State
+    {
+        std::atomic < size_t > next ;
+        std::atomic < size_t > done ;
+        std::mutex mutex ;
+        std::condition_variable condition ;
+        std::exception_ptr error ;
+    };
+
+    std::shared_ptr < State > state = std::make_shared < State > () ;
+    state -> next = 0 ;
+    state -> done = 0 ;
+
+    auto work = [state , chunks , grain , count , job] ()
+    {
+        size_t chunk ;
+
+        while ( ( chunk = state -> next ++ ) < chunks )
+        {
+            size_t begin = chunk * grain ;
+
+            //////////////////////////////////////////////////////////////////////
+            // A failed chunk still counts as done , else the calling thread would
+            // wait forever. The first error is thrown again by the calling thread.
+
+            try
+            {
+                job ( begin , std::min ( begin + grain , count ) ) ;
+            }
+            catch ( ... )
+            {
+                std::unique_lock < std::mutex > lock ( state -> mutex ) ;
+
+                if ( !state -> error )
+                state -> error = std::current_exception () ;
+            }
+
+            if ( ++ state -> done == chunks )
+            {
+                std::unique_lock < std::mutex > lock ( state -> mutex ) ;
+                state -> condition.notify_all () ;
+            }
+        }
+    };
+
+    size_t helpers = std::min ( chunks - 1 , iThreads.size () ) ;
+
+    for ( size_t i = 0 ; i < helpers ; ++i )
+    submit ( work ) ;
+
+    work () ;
+
+    std::unique_lock < std::mutex > lock ( state -> mutex ) ;
+    state -> condition.wait ( lock , [state , chunks] () { return state -> done == chunks ; } ) ;
+
+    if ( state -> error )
+    std::rethrow_exception ( state -> error ) ;
+}
+
+size_t JobPool::getThreadsCount () const
+{
+    return iThreads.size () ;
+}
+
+void JobPool::workerMain ()
+{
+    while ( true )
+    {
+        std::packaged_task < void () > task ;
+
+        {
+            std::unique_lock < std::mutex > lock ( iMutex ) ;
+            iCondition.wait ( lock , [this] () { return iStopping || !iJobs.empty() ; } ) ;
+
+            if ( iJobs.empty() )
+            return ;
+
+            task = std::move ( iJobs.front () ) ;
+            iJobs.pop () ;
+        }
+
+        task () ;
+    }
+}
+
+GreEndNamespace
@@ -0,0 +1,350 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  LightAssignment.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 14/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "LightAssignment.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Fewer bounded lights are simply tested one by one.
+static const size_t LightGridThreshold = 32 ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Maximum number of cells on each axis of the light grid.
+static const int LightGridResolution = 32 ;
+
+LightAssignment::LightAssignment ()
+: iMaxLights ( 0 ) , iGridMin ( 0.0f , 0.0f , 0.0f ) , iGridCellSize ( 0.0f ) , iGridQuery ( 0 )
+{
+    iGrid [0] = iGrid [1] = iGrid [2] = 0 ;
+
+}
+
+LightAssignment::~LightAssignment ()
+{
+
+}
+
+void LightAssignment::prepare ( const RenderNodeHolderList & lights , size_t maxlights )
+{
+    clear () ;
+    iMaxLights = maxlights ;
+
+    size_t index = 0 ;
+
+    for ( auto & light : lights )
+    {
+        if ( light.isInvalid() )
+        {
+            index++ ;
+            continue ;
+        }
+
+        Entry entry ;
+        entry.light = light ;
+        entry.index = index++ ;
+        entry.position = light -> getPosition () ;
+
+        float radius = light -> getLightRadius () ;
+        entry.radius2 = radius * radius ;
+
+        if ( radius <= 0.0f )
+        iUnbounded.push_back ( entry ) ;
+        else
+        iBounded.push_back ( entry ) ;
+    }
+
+    buildGrid () ;
+}
+
+void LightAssignment::prepare ( const std::vector < RenderSnapshotLight > & lights , size_t maxlights )
+{
+    clear () ;
+    iMaxLights = maxlights ;
+
+    for ( size_t i = 0 ; i < lights.size () ; ++i )
+    {
+        Entry entry ;
+        entry.index = i ;
+        entry.position = lights[i].position ;
+        entry.radius2 = lights[i].radius * lights[i].radius ;
+
+        if ( lights[i].radius <= 0.0f )
+        iUnbounded.push_back ( entry ) ;
+        else
+        iBounded.push_back ( entry ) ;
+    }
+
+    buildGrid () ;
+}
+
+void LightAssignment::assign ( const BoundingBox & bbox , RenderNodeHolderList & result ) const
+{
+    select ( bbox ) ;
+
+    for ( const Entry * entry : iSelected )
+    result.push_back ( entry -> light ) ;
+}
+
+void LightAssignment::assign ( const BoundingBox & bbox , std::vector < size_t > & result ) const
+{
+    select ( bbox ) ;
+
+    for ( const Entry * entry : iSelected )
+    result.push_back ( entry -> index ) ;
+}
+
+void LightAssignment::select ( const BoundingBox & bbox ) const
+{
+    iSelected.clear () ;
+
+    if ( !iMaxLights )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Unbounded lights reach every node.
+
+    for ( const Entry & entry : iUnbounded )
+    {
+        if ( iSelected.size() == iMaxLights )
+        return ;
+
+        iSelected.push_back ( &entry ) ;
+    }
+
+    if ( iBounded.empty() )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Selects bounded lights whose sphere touches the bounding box. The
+    // squared distance to the closest point of the box is used to keep
+    // the nearest lights when there are too many.
+
+    iCandidates.clear () ;
+
+    auto test = [this , &bbox] ( size_t i )
+    {
+        const Entry & entry = iBounded [i] ;
+        float distance2 = 0.0f ;
+
+        if ( !bbox.isInvalid() )
+        {
+            Vector3 closest = glm::min ( glm::max ( entry.position , bbox.getMin() ) , bbox.getMax() ) ;
+            Vector3 delta = closest - entry.position ;
+            distance2 = glm::dot ( delta , delta ) ;
+
+            if ( distance2 > entry.radius2 )
+            return ;
+        }
+
+        iCandidates.push_back ( std::make_pair ( distance2 , i ) ) ;
+    };
+
+    int cells [6] ;
+    bool grid = !iGridStarts.empty() && !bbox.isInvalid() ;
+
+    if ( grid )
+    {
+        computeCells ( bbox.getMin () , bbox.getMax () , cells ) ;
+
+        //////////////////////////////////////////////////////////////////////
+        // A box larger than the grid cells would visit more cells than there
+        // are lights : testing every light is cheaper.
+
+        size_t count = (size_t) ( cells [3] - cells [0] + 1 ) * ( cells [4] - cells [1] + 1 ) * ( cells [5] - cells [2] + 1 ) ;
+        grid = count <= iBounded.size () ;
+    }
+
+    if ( grid )
+    {
+        if ( ++iGridQuery == 0 )
+        {
+            std::fill ( iGridVisits.begin () , iGridVisits.end () , 0 ) ;
+            iGridQuery = 1 ;
+        }
+
+        for ( int k = cells [2] ; k <= cells [5] ; ++k )
+        for ( int j = cells [1] ; j <= cells [4] ; ++j )
+        for ( int i = cells [0] ; i <= cells [3] ; ++i )
+        {
+            size_t cell = ( (size_t) k * iGrid [1] + j ) * iGrid [0] + i ;
+
+            for ( size_t l = iGridStarts [cell] ; l < iGridStarts [cell + 1] ; ++l )
+            {
+                size_t light = iGridLights [l] ;
+
+                if ( iGridVisits [light] == iGridQuery )
+                continue ;
+
+                iGridVisits [light] = iGridQuery ;
+                test ( light ) ;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        // Cells are visited in any order : lights are sorted back to the order
+        // given to 'prepare()' , as without the grid.
+
+        std::sort ( iCandidates.begin () , iCandidates.end () , [] ( const std::pair < float , size_t > & a , const std::pair < float , size_t > & b )
+        { return a.second < b.second ; } ) ;
+    }
+
+    else
+    {
+        for ( size_t i = 0 ; i < iBounded.size() ; ++i )
+        test ( i ) ;
+    }
+
+    size_t remaining = iMaxLights - iSelected.size () ;
+
+    if ( iCandidates.size() > remaining )
+    {
+        std::partial_sort ( iCandidates.begin() , iCandidates.begin() + remaining , iCandidates.end() ) ;
+        iCandidates.resize ( remaining ) ;
+    }
+
+    for ( auto & candidate : iCandidates )
+    iSelected.push_back ( &iBounded[candidate.second] ) ;
+}
+
+void LightAssignment::buildGrid ()
+{
+    iGridStarts.clear () ;
+    iGridLights.clear () ;
+    iGridVisits.clear () ;
+    iGridQuery = 0 ;
+
+    if ( iBounded.size () < LightGridThreshold )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Cells are about as large as a light sphere , so most lights overlap a
+    // few cells only. The resolution is bounded , so lights spread on a large
+    // area get larger cells instead of a huge grid.
+
+    Vector3 min = iBounded [0] .position ;
+    Vector3 max = iBounded [0] .position ;
+    float diameters = 0.0f ;
+
+    for ( const Entry & entry : iBounded )
+    {
+        float radius = std::sqrt ( entry.radius2 ) ;
+        min = glm::min ( min , entry.position - Vector3 ( radius ) ) ;
+        max = glm::max ( max , entry.position + Vector3 ( radius ) ) ;
+        diameters += 2.0f * radius ;
+    }
+
+    Vector3 extent = max - min ;
+    float largest = std::max ( extent.x , std::max ( extent.y , extent.z ) ) ;
+
+    iGridMin = min ;
+    iGridCellSize = std::max ( diameters / (float) iBounded.size () , largest / (float) LightGridResolution ) ;
+
+    for ( int a = 0 ; a < 3 ; ++a )
+    iGrid [a] = std::min ( std::max ( (int) std::ceil ( extent [a] / iGridCellSize ) , 1 ) , LightGridResolution ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Counts the lights of every cell , then fills the cells from their
+    // start offsets.
+
+    iGridStarts.assign ( (size_t) iGrid [0] * iGrid [1] * iGrid [2] + 1 , 0 ) ;
+
+    for ( int pass = 0 ; pass < 2 ; ++pass )
+    {
+        std::vector < size_t > cursor ;
+
+        if ( pass == 1 )
+        {
+            for ( size_t c = 1 ; c < iGridStarts.size () ; ++c )
+            iGridStarts [c] += iGridStarts [c - 1] ;
+
+            iGridLights.resize ( iGridStarts.back () ) ;
+            cursor.assign ( iGridStarts.begin () , iGridStarts.end () - 1 ) ;
+        }
+
+        for ( size_t l = 0 ; l < iBounded.size () ; ++l )
+        {
+            float radius = std::sqrt ( iBounded [l] .radius2 ) ;
+            int cells [6] ;
+            computeCells ( iBounded [l] .position - Vector3 ( radius ) , iBounded [l] .position + Vector3 ( radius ) , cells ) ;
+
+            for ( int k = cells [2] ; k <= cells [5] ; ++k )
+            for ( int j = cells [1] ; j <= cells [4] ; ++j )
+            for ( int i = cells [0] ; i <= cells [3] ; ++i )
+            {
+                size_t cell = ( (size_t) k * iGrid [1] + j ) * iGrid [0] + i ;
+
+                if ( pass == 0 )
+                iGridStarts [cell + 1] ++ ;
+                else
+                iGridLights [cursor [cell] ++] = l ;
+            }
+        }
+    }
+
+    iGridVisits.assign ( iBounded.size () , 0 ) ;
+}
+
+void LightAssignment::computeCells ( const Vector3 & min , const Vector3 & max , int cells [6] ) const
+{
+    for ( int a = 0 ; a < 3 ; ++a )
+    {
+        int low = (int) std::floor ( ( min [a] - iGridMin [a] ) / iGridCellSize ) ;
+        int high = (int) std::floor ( ( max [a] - iGridMin [a] ) / iGridCellSize ) ;
+
+        cells [a] = std::min ( std::max ( low , 0 ) , iGrid [a] - 1 ) ;
+        cells [a + 3] = std::min ( std::max ( high , 0 ) , iGrid [a] - 1 ) ;
+    }
+}
+
+size_t LightAssignment::getLightsCount () const
+{
+    return iUnbounded.size () + iBounded.size () ;
+}
+
+size_t LightAssignment::getMaximumLights () const
+{
+    return iMaxLights ;
+}
+
+void LightAssignment::clear ()
+{
+    iUnbounded.clear () ;
+    iBounded.clear () ;
+    iCandidates.clear () ;
+    iSelected.clear () ;
+    iGridStarts.clear () ;
+    iGridLights.clear () ;
+    iGridVisits.clear () ;
+}
+
+GreEndNamespace
@@ -37,6 +37,7 @@ GreBeginNamespace
 
 Material::Material(const std::string& name) : Gre::Renderable(name)
 , iEmission(Color(1.0f, 1.0f, 1.0f, 1.0f))
+, iBlock ( UniformBlockLayout::Standard ( UniformBlockBinding::Material ) ) , iBlockDirty ( true )
 {
     //////////////////////////////////////////////////////////////////////
     // Loads default color values.
@@ -95,6 +96,7 @@ const Color& Material::getAmbient() const
 void Material::setAmbient(const Color &color)
 {
     iAmbient = color;
+    iBlockDirty = true ;
 }
 
 const Color& Material::getDiffuse() const
@@ -105,6 +107,7 @@ const Color& Material::getDiffuse() const
 void Material::setDiffuse(const Color &color)
 {
     iDiffuse = color;
+    iBlockDirty = true ;
 }
 
 const Color& Material::getSpecular() const
@@ -115,6 +118,7 @@ const Color& Material::getSpecular() const
 void Material::setSpecular(const Color &color)
 {
     iSpecular = color;
+    iBlockDirty = true ;
 }
 
 const Color& Material::getEmission() const
@@ -135,6 +139,7 @@ float Material::getShininess() const
 void Material::setShininess(float f)
 {
     iShininess = f;
+    iBlockDirty = true ;
 }
 
 const TextureHolder & Material::getAmbientTexture() const
@@ -199,10 +204,19 @@ void Material::use(const TechniqueHolder &technique) const
         else
         {
             alias = TechniqueParam::None ;
-            technique -> setAliasedParameterStructValue(alias, TechniqueParam::MaterialAmbient, HdwProgVarType::Float3, iAmbient.toFloat3());
-            technique -> setAliasedParameterStructValue(alias, TechniqueParam::MaterialDiffuse, HdwProgVarType::Float3, iDiffuse.toFloat3());
-            technique -> setAliasedParameterStructValue(alias, TechniqueParam::MaterialSpecular, HdwProgVarType::Float3, iSpecular.toFloat3());
-            technique -> setAliasedParameterStructValue(alias, TechniqueParam::MaterialShininess, HdwProgVarType::Float1, iShininess);
+
+            //////////////////////////////////////////////////////////////////////
+            // If the program declares the Material block , the packed block is
+            // bound instead of every values.
+
+            if ( !technique -> hasUniformBlock ( UniformBlockBinding::Material ) ||
+                 !technique -> setUniformBlock ( UniformBlockBinding::Material , getUniformBlock () ) )
+            {
+                technique -> setAliasedParameterStructValue(alias, TechniqueParam::MaterialAmbient, HdwProgVarType::Float3, iAmbient.toFloat3());
+                technique -> setAliasedParameterStructValue(alias, TechniqueParam::MaterialDiffuse, HdwProgVarType::Float3, iDiffuse.toFloat3());
+                technique -> setAliasedParameterStructValue(alias, TechniqueParam::MaterialSpecular, HdwProgVarType::Float3, iSpecular.toFloat3());
+                technique -> setAliasedParameterStructValue(alias, TechniqueParam::MaterialShininess, HdwProgVarType::Float1, iShininess);
+            }
         }
 
         //////////////////////////////////////////////////////////////////////
@@ -219,6 +233,22 @@ void Material::use(const TechniqueHolder &technique) const
     }
 }
 
+const UniformBlock & Material::getUniformBlock () const
+{
+    GreAutolock ;
+
+    if ( iBlockDirty )
+    {
+        iBlock.set ( TechniqueParam::MaterialAmbient , iAmbient.toFloat3() ) ;
+        iBlock.set ( TechniqueParam::MaterialDiffuse , iDiffuse.toFloat3() ) ;
+        iBlock.set ( TechniqueParam::MaterialSpecular , iSpecular.toFloat3() ) ;
+        iBlock.set ( TechniqueParam::MaterialShininess , iShininess ) ;
+        iBlockDirty = false ;
+    }
+
+    return iBlock ;
+}
+
 void Material::setUseTextures ( bool value )
 {
     GreAutolock ;
@@ -0,0 +1,303 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  MatrixCache.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 27/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "MatrixCache.h"
+#include "JobPool.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Number of pending nodes from which 'prepare()' splits the work.
+static const size_t ParallelThreshold = 512 ;
+
+MatrixCache::MatrixCache ( size_t cameras )
+: iCurrent ( -1 ) , iCapacity ( cameras ? cameras : 1 ) , iUses ( 0 )
+{
+    resetStats () ;
+}
+
+MatrixCache::~MatrixCache ()
+{
+
+}
+
+void MatrixCache::begin ( const Matrix4 & view , const Matrix4 & projection )
+{
+    iUses ++ ;
+
+    for ( size_t i = 0 ; i < iSlots.size () ; ++i )
+    {
+        Slot & slot = iSlots [i] ;
+
+        if ( slot.view != view || slot.projection != projection )
+        continue ;
+
+        //////////////////////////////////////////////////////////////////////
+        // Entries not used since the last 'begin()' are dropped , so nodes
+        // removed from the scene don't stay here.
+
+        for ( auto it = slot.entries.begin () ; it != slot.entries.end () ; )
+        {
+            if ( it -> second.frame != slot.frame ) it = slot.entries.erase ( it ) ;
+            else ++it ;
+        }
+
+        slot.frame ++ ;
+        slot.lastuse = iUses ;
+        iCurrent = (int) i ;
+        return ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Takes a new slot , or the least recently used one.
+
+    size_t index = iSlots.size () ;
+
+    if ( iSlots.size () < iCapacity )
+    iSlots.push_back ( Slot () ) ;
+
+    else
+    {
+        index = 0 ;
+
+        for ( size_t i = 1 ; i < iSlots.size () ; ++i )
+        {
+            if ( iSlots [i] .lastuse < iSlots [index] .lastuse )
+            index = i ;
+        }
+    }
+
+    Slot & slot = iSlots [index] ;
+    slot.view = view ;
+    slot.projection = projection ;
+    slot.projectionview = projection * view ;
+    slot.lastuse = iUses ;
+    slot.frame = 0 ;
+    slot.entries.clear () ;
+
+    iCurrent = (int) index ;
+}
+
+void MatrixCache::prepare ( const RenderNodeHolderList & nodes )
+{
+    if ( iCurrent < 0 )
+    return ;
+
+    for ( auto & node : nodes )
+    schedule ( node.getObject () ) ;
+
+    computePending () ;
+}
+
+void MatrixCache::prepare ( const std::vector < const RenderNode * > & nodes )
+{
+    if ( iCurrent < 0 )
+    return ;
+
+    for ( const RenderNode * node : nodes )
+    schedule ( node ) ;
+
+    computePending () ;
+}
+
+const NodeMatrices & MatrixCache::get ( const RenderNode * node )
+{
+    static NodeMatrices identity = { Matrix4 ( 1.0f ) , Matrix4 ( 1.0f ) , Matrix4 ( 1.0f ) , Matrix3 ( 1.0f ) } ;
+
+    if ( iCurrent < 0 || !node )
+    return identity ;
+
+    Slot & slot = iSlots [iCurrent] ;
+    Entry & entry = slot.entries [node] ;
+    uint64_t version = node -> getVisibilityVersion () ;
+
+    if ( entry.frame == slot.frame && entry.version == version )
+    return entry.matrices ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Nodes not given to 'prepare()' , or changed since , are computed here.
+
+    if ( entry.version == version && entry.frame + 1 == slot.frame )
+    {
+        entry.frame = slot.frame ;
+        iStats.reused ++ ;
+        return entry.matrices ;
+    }
+
+    entry.version = version ;
+    entry.frame = slot.frame ;
+
+    if ( Compute ( node -> getModelMatrix () , slot.view , slot.projectionview , entry.matrices ) )
+    iStats.uniform ++ ;
+
+    iStats.computed ++ ;
+    return entry.matrices ;
+}
+
+const Matrix4 & MatrixCache::getProjection () const
+{
+    static Matrix4 identity ( 1.0f ) ;
+
+    if ( iCurrent < 0 )
+    return identity ;
+
+    return iSlots [iCurrent] .projection ;
+}
+
+void MatrixCache::clear ()
+{
+    iSlots.clear () ;
+    iCurrent = -1 ;
+}
+
+const MatrixCacheStats & MatrixCache::getStats () const
+{
+    return iStats ;
+}
+
+void MatrixCache::resetStats ()
+{
+    iStats.computed = 0 ;
+    iStats.reused = 0 ;
+    iStats.uniform = 0 ;
+}
+
+bool MatrixCache::Compute ( const Matrix4 & model , const Matrix4 & view ,
+                            const Matrix4 & projectionview , NodeMatrices & result )
+{
+    bool uniform = false ;
+
+    result.model = model ;
+    result.modelview = view * model ;
+    result.projectionviewmodel = projectionview * model ;
+    result.normal = NormalMatrix ( Matrix3 ( result.modelview ) , &uniform ) ;
+
+    return uniform ;
+}
+
+Matrix3 MatrixCache::NormalMatrix ( const Matrix3 & matrix , bool * uniform )
+{
+    //////////////////////////////////////////////////////////////////////
+    // For a rotation R scaled by s , the inverse-transpose is R / s , that is
+    // the matrix divided by s² : the squared length of any column.
+
+    const float xx = glm::dot ( matrix[0] , matrix[0] ) ;
+    const float yy = glm::dot ( matrix[1] , matrix[1] ) ;
+    const float zz = glm::dot ( matrix[2] , matrix[2] ) ;
+    const float xy = glm::dot ( matrix[0] , matrix[1] ) ;
+    const float xz = glm::dot ( matrix[0] , matrix[2] ) ;
+    const float yz = glm::dot ( matrix[1] , matrix[2] ) ;
+    const float epsilon = 1e-4f * xx ;
+
+    if ( xx > 0.0f && fabsf ( xx - yy ) <= epsilon && fabsf ( xx - zz ) <= epsilon
+      && fabsf ( xy ) <= epsilon && fabsf ( xz ) <= epsilon && fabsf ( yz ) <= epsilon )
+    {
+        if ( uniform ) *uniform = true ;
+        return matrix * ( 1.0f / xx ) ;
+    }
+
+    if ( uniform ) *uniform = false ;
+    return glm::transpose ( glm::inverse ( matrix ) ) ;
+}
+
+void MatrixCache::schedule ( const RenderNode * node )
+{
+    if ( !node )
+    return ;
+
+    Slot & slot = iSlots [iCurrent] ;
+    Entry & entry = slot.entries [node] ;
+    uint64_t version = node -> getVisibilityVersion () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // An entry used last frame with the same version is still valid. A new
+    // entry has a null version , which no node has.
+
+    bool valid = entry.version == version && ( entry.frame == slot.frame || entry.frame + 1 == slot.frame ) ;
+
+    if ( valid )
+    {
+        if ( entry.frame != slot.frame )
+        iStats.reused ++ ;
+
+        entry.frame = slot.frame ;
+        return ;
+    }
+
+    entry.version = version ;
+    entry.frame = slot.frame ;
+    iPending.push_back ( std::make_pair ( &entry , node -> getModelMatrix () ) ) ;
+}
+
+void MatrixCache::computePending ()
+{
+    if ( iPending.empty () )
+    return ;
+
+    const Slot & slot = iSlots [iCurrent] ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Models were read from the nodes while scheduling : computing only
+    // reads the pending array and writes each entry , so it is split among
+    // workers for long lists.
+
+    auto compute = [this , &slot] ( size_t begin , size_t end ) -> size_t {
+        size_t uniforms = 0 ;
+
+        for ( size_t i = begin ; i < end ; ++i )
+        {
+            if ( Compute ( iPending [i] .second , slot.view , slot.projectionview , iPending [i] .first -> matrices ) )
+            uniforms ++ ;
+        }
+
+        return uniforms ;
+    };
+
+    if ( iPending.size () < ParallelThreshold )
+    iStats.uniform += compute ( 0 , iPending.size () ) ;
+
+    else
+    {
+        std::atomic < size_t > uniforms ( 0 ) ;
+
+        JobPool::Get () .parallelFor ( iPending.size () , 128 , [&] ( size_t begin , size_t end ) {
+            uniforms += compute ( begin , end ) ;
+        });
+
+        iStats.uniform += uniforms ;
+    }
+
+    iStats.computed += iPending.size () ;
+    iPending.clear () ;
+}
+
+GreEndNamespace
@@ -34,13 +34,16 @@
 
 #include "ResourceManager.h"
 #include "ObjMeshLoader.h"
+#include "MeshSimplifier.h"
+#include "JobPool.h"
+#include "Profiler.h"
 
 GreBeginNamespace
 
 // ---------------------------------------------------------------------------------------------------
 
 SubMesh::SubMesh ( const std::string & name )
-: Gre::Renderable ( name )
+: Gre::Renderable ( name ) , iCurrentLod ( 0 )
 {
 
 }
@@ -71,7 +74,55 @@ void SubMesh::setIndexBuffer ( const HardwareIndexBufferHolder & buffer )
 
 const HardwareIndexBufferHolder & SubMesh::getIndexBuffer () const
 {
-    GreAutolock ; return iIndexBuffer ;
+    GreAutolock ; return getLodIndexBuffer ( iCurrentLod ) ;
+}
+
+void SubMesh::addLodIndexBuffer ( const HardwareIndexBufferHolder & buffer )
+{
+    GreAutolock ;
+
+    if ( buffer.isInvalid() )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Levels of detail receive updates events as the main index buffer.
+
+    iLodIndexBuffers.push_back ( buffer ) ;
+    addFilteredListener ( buffer , { EventType::Update } ) ;
+}
+
+const HardwareIndexBufferHolder & SubMesh::getLodIndexBuffer ( size_t level ) const
+{
+    GreAutolock ;
+
+    if ( !level || iLodIndexBuffers.empty() )
+    return iIndexBuffer ;
+
+    if ( level > iLodIndexBuffers.size() )
+    return iLodIndexBuffers.back () ;
+
+    return iLodIndexBuffers [level - 1] ;
+}
+
+size_t SubMesh::getLodCount () const
+{
+    GreAutolock ; return iLodIndexBuffers.size () + 1 ;
+}
+
+void SubMesh::clearLodIndexBuffers ()
+{
+    GreAutolock ;
+
+    for ( auto buffer : iLodIndexBuffers )
+    removeListener ( buffer ) ;
+
+    iLodIndexBuffers.clear () ;
+    iCurrentLod = 0 ;
+}
+
+void SubMesh::selectLod ( size_t level ) const
+{
+    GreAutolock ; iCurrentLod = level ;
 }
 
 void SubMesh::addVertexBuffer ( const HardwareVertexBufferHolder & buffer )
@@ -173,6 +224,8 @@ void SubMesh::clear ()
     removeListener ( iIndexBuffer ) ;
     iIndexBuffer.clear () ;
 
+    clearLodIndexBuffers () ;
+
     //////////////////////////////////////////////////////////////////////
     // Destroys local and shared vertex buffers.
 
@@ -193,7 +246,7 @@ void SubMesh::clear ()
 // ---------------------------------------------------------------------------------------------------
 
 Mesh::Mesh ( const std::string & name )
-: Gre::Renderable ( name )
+: Gre::Renderable ( name ) , iCurrentLod ( 0 )
 {
     iBoundingBoxUpdate = true ;
 }
@@ -390,8 +443,10 @@ bool Mesh::bindNextSubMesh ( const TechniqueHolder & technique ) const
     return false ;
 
     //////////////////////////////////////////////////////////////////////
-    // Tries to bind the submesh pointed by the iterator.
+    // Tries to bind the submesh pointed by the iterator , with the level
+    // of detail selected for this drawing.
 
+    ( *iCurrentSubMesh ) -> selectLod ( iCurrentLod ) ;
     iBindSubMesh ( *iCurrentSubMesh , technique ) ;
 
     //////////////////////////////////////////////////////////////////////
@@ -414,6 +469,7 @@ void Mesh::unbindCurrentSubMesh ( const TechniqueHolder & technique ) const
     // Tries to unbind the submesh.
 
     iUnbindSubMesh ( *iCurrentSubMesh , technique ) ;
+    ( *iCurrentSubMesh ) -> selectLod ( 0 ) ;
 
     //////////////////////////////////////////////////////////////////////
     // Sets the next iterator.
@@ -435,6 +491,7 @@ void Mesh::unbind ( const TechniqueHolder & technique ) const
 
     iCurrentSubMeshList.clear () ;
     iCurrentSubMesh = iCurrentSubMeshList.end () ;
+    iCurrentLod = 0 ;
 }
 
 void Mesh::clear ()
@@ -455,6 +512,8 @@ void Mesh::clear ()
     iBoundingBoxUpdate = true ;
     iCurrentSubMeshList.clear () ;
     iCurrentSubMesh = iCurrentSubMeshList.end () ;
+    iLodScreenSizes.clear () ;
+    iCurrentLod = 0 ;
 
     //////////////////////////////////////////////////////////////////////
     // Calls parent clear.
@@ -492,6 +551,43 @@ void Mesh::setDefaultMaterial ( const MaterialHolder & material )
     submesh -> setDefaultMaterial ( material ) ;
 }
 
+size_t Mesh::getLodCount () const
+{
+    GreAutolock ;
+
+    size_t count = 1 ;
+
+    for ( auto submesh : iSubMeshes )
+    count = std::max ( count , submesh -> getLodCount () ) ;
+
+    return count ;
+}
+
+void Mesh::setLodScreenSize ( size_t level , float size )
+{
+    GreAutolock ;
+
+    if ( level >= iLodScreenSizes.size() )
+    iLodScreenSizes.resize ( level + 1 , -1.0f ) ;
+
+    iLodScreenSizes [level] = size ;
+}
+
+float Mesh::getLodScreenSize ( size_t level ) const
+{
+    GreAutolock ;
+
+    if ( level < iLodScreenSizes.size() && iLodScreenSizes [level] >= 0.0f )
+    return iLodScreenSizes [level] ;
+
+    return std::pow ( 0.5f , (float) level ) ;
+}
+
+void Mesh::selectLod ( size_t level ) const
+{
+    GreAutolock ; iCurrentLod = level ;
+}
+
 void Mesh::iBindSubMesh ( const SubMeshHolder & submesh , const TechniqueHolder & technique ) const
 {
     GreAutolock ;
@@ -511,6 +607,11 @@ void Mesh::iBindSubMesh ( const SubMeshHolder & submesh , const TechniqueHolder
     if ( !program -> binded () )
     return ;
 
+    //////////////////////////////////////////////////////////////////////
+    // Attributes locations were resolved when the pipeline state was created.
+
+    const PipelineStateHolder & state = technique -> getPipelineState () ;
+
     //////////////////////////////////////////////////////////////////////
     // For each vertex buffer , binds them to the program.
 
@@ -533,7 +634,12 @@ void Mesh::iBindSubMesh ( const SubMeshHolder & submesh , const TechniqueHolder
 
         for ( auto component : descriptor.getComponents () )
         {
-            program -> setVertexAttrib (technique -> getAttribName ( component.alias ) ,
+            const int location = state -> getAttribLocation ( component.alias ) ;
+
+            if ( location < 0 )
+            continue ;
+
+            program -> setVertexAttrib (location ,
                                         component.elements ,
                                         component.type ,
                                         component.normalize ,
@@ -571,7 +677,12 @@ void Mesh::iBindSubMesh ( const SubMeshHolder & submesh , const TechniqueHolder
 
         for ( auto component : descriptor.getComponents () )
         {
-            program -> setVertexAttrib (technique -> getAttribName ( component.alias ) ,
+            const int location = state -> getAttribLocation ( component.alias ) ;
+
+            if ( location < 0 )
+            continue ;
+
+            program -> setVertexAttrib (location ,
                                         binding.elements ,
                                         component.type ,
                                         component.normalize ,
@@ -705,6 +816,77 @@ MeshHolder MeshManager::findFirstFile(const std::string &filepath)
     return MeshHolder ( nullptr ) ;
 }
 
+void MeshManager::generateLods ( const std::vector < MeshLodSource > & sources , const ResourceLoaderOptions & ops ) const
+{
+    //////////////////////////////////////////////////////////////////////
+    // Reads options.
+
+    int levels = 0 ;
+    float ratio = 0.5f ;
+    float maxerror = 0.05f ;
+
+    auto it = ops.find ( "mesh.lod.levels" ) ;
+    if ( it != ops.end() ) levels = it->second.to<int>() ;
+
+    it = ops.find ( "mesh.lod.ratio" ) ;
+    if ( it != ops.end() ) ratio = it->second.to<float>() ;
+
+    it = ops.find ( "mesh.lod.error" ) ;
+    if ( it != ops.end() ) maxerror = it->second.to<float>() ;
+
+    if ( levels <= 0 || sources.empty() )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Simplifies every submeshes in parallel. Only CPU data is touched by
+    // the jobs : buffers are created afterwards , from this thread.
+
+    std::vector < std::vector < std::vector < unsigned int > > > lods ( sources.size () ) ;
+
+    JobPool::Get () .parallelFor ( sources.size () , 1 , [&] ( size_t begin , size_t end )
+    {
+        for ( size_t i = begin ; i < end ; ++i )
+        {
+            const MeshLodSource & source = sources [i] ;
+
+            if ( !source.positions || !source.vertices || source.indices.empty() )
+            continue ;
+
+            MeshSimplifier simplifier ( source.positions , source.stride , source.vertices ) ;
+            lods [i] = simplifier.buildLods ( source.indices , (size_t) levels , ratio , maxerror ) ;
+        }
+    } ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Creates the index buffers.
+
+    IndexDescriptor idesc ;
+    idesc.setMode ( IndexDrawmode::Triangles ) ;
+    idesc.setType ( IndexType::UnsignedInteger ) ;
+
+    for ( size_t i = 0 ; i < sources.size () ; ++i )
+    {
+        SubMeshHolder submesh = sources[i].submesh ;
+
+        if ( submesh.isInvalid() )
+        continue ;
+
+        for ( const auto & lod : lods [i] )
+        {
+            HardwareIndexBufferHolder ibuf = createIndexBuffer ( lod.data () , lod.size () * sizeof ( unsigned int ) , idesc ) ;
+
+            if ( ibuf.isInvalid() )
+            {
+                GreDebug ( "[WARN] Can't create level of detail for submesh '" ) << submesh->getName() << "'." << gendl ;
+                break ;
+            }
+
+            ibuf -> setEnabled ( true ) ;
+            submesh -> addLodIndexBuffer ( ibuf ) ;
+        }
+    }
+}
+
 MeshHolder MeshManager::loadBundledFile(const std::string &path, const ResourceLoaderOptions &ops)
 {
     GreAutolock ;
@@ -745,6 +927,8 @@ MeshHolder MeshManager::loadBundledFile(const std::string &path, const ResourceL
 
 MeshHolder MeshManager::loadFile(const std::string &path, const ResourceLoaderOptions &ops)
 {
+    GreProfileDetail( "MeshManager::loadFile" , path ) ;
+
     //////////////////////////////////////////////////////////////////////
     // Check input values.
 
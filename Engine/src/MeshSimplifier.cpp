@@ -0,0 +1,433 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  MeshSimplifier.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 16/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "MeshSimplifier.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Symmetric 4x4 matrix summing squared distances to planes ,
+/// weighted by the area of the triangles they come from.
+struct SimplifierQuadric
+{
+    double a2 , ab , ac , ad , b2 , bc , bd , c2 , cd , d2 ;
+
+    /// @brief Sum of the weights , used to normalize the error.
+    double weight ;
+
+    SimplifierQuadric () : a2(0) , ab(0) , ac(0) , ad(0) , b2(0) , bc(0) , bd(0) , c2(0) , cd(0) , d2(0) , weight(0) { }
+
+    void addPlane ( const Vector3 & n , const Vector3 & p , double w )
+    {
+        double a = n.x , b = n.y , c = n.z ;
+        double d = - ( a * p.x + b * p.y + c * p.z ) ;
+
+        a2 += w * a * a ; ab += w * a * b ; ac += w * a * c ; ad += w * a * d ;
+        b2 += w * b * b ; bc += w * b * c ; bd += w * b * d ;
+        c2 += w * c * c ; cd += w * c * d ;
+        d2 += w * d * d ;
+        weight += w ;
+    }
+
+    void add ( const SimplifierQuadric & q )
+    {
+        a2 += q.a2 ; ab += q.ab ; ac += q.ac ; ad += q.ad ;
+        b2 += q.b2 ; bc += q.bc ; bd += q.bd ;
+        c2 += q.c2 ; cd += q.cd ;
+        d2 += q.d2 ;
+        weight += q.weight ;
+    }
+
+    double error ( const Vector3 & v ) const
+    {
+        double x = v.x , y = v.y , z = v.z ;
+
+        double e = a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x
+                 + b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y
+                 + c2 * z * z + 2.0 * cd * z
+                 + d2 ;
+
+        return e > 0.0 ? e : 0.0 ;
+    }
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief An edge candidate to a collapse from 'from' to 'to'.
+struct SimplifierCollapse
+{
+    unsigned int from ;
+    unsigned int to ;
+    double cost ;
+
+    bool operator < ( const SimplifierCollapse & rhs ) const { return cost < rhs.cost ; }
+};
+
+/// @brief Weight given to the planes keeping open borders in place.
+static const double SimplifierBorderWeight = 10.0 ;
+
+/// @brief Minimum cosine between a triangle normal before and after a collapse.
+static const float SimplifierFlipThreshold = 0.2f ;
+
+// ---------------------------------------------------------------------------------------------------
+
+MeshSimplifier::MeshSimplifier ( const void * positions , size_t stride , size_t count )
+: iExtent ( 0.0f )
+{
+    if ( !positions || !count )
+    return ;
+
+    iPositions.resize ( count ) ;
+
+    const char * data = reinterpret_cast < const char * > ( positions ) ;
+
+    for ( size_t i = 0 ; i < count ; ++i )
+    {
+        const float * p = reinterpret_cast < const float * > ( data + i * stride ) ;
+        iPositions [i] = Vector3 ( p[0] , p[1] , p[2] ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Welds vertices by position : sorting them makes equal positions
+    // contiguous , and the first one of each run represents the others.
+
+    std::vector < unsigned int > order ( count ) ;
+    for ( size_t i = 0 ; i < count ; ++i ) order [i] = (unsigned int) i ;
+
+    std::sort ( order.begin () , order.end () , [this] ( unsigned int l , unsigned int r ) {
+        const Vector3 & a = iPositions [l] ;
+        const Vector3 & b = iPositions [r] ;
+        if ( a.x != b.x ) return a.x < b.x ;
+        if ( a.y != b.y ) return a.y < b.y ;
+        if ( a.z != b.z ) return a.z < b.z ;
+        return l < r ;
+    } ) ;
+
+    iWelded.resize ( count ) ;
+
+    for ( size_t i = 0 ; i < count ; ++i )
+    {
+        if ( i > 0 && iPositions [order[i]] == iPositions [order[i-1]] )
+        iWelded [order[i]] = iWelded [order[i-1]] ;
+        else
+        iWelded [order[i]] = order [i] ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Extent is used to make the error threshold independent of the scale.
+
+    Vector3 pmin = iPositions [0] , pmax = iPositions [0] ;
+
+    for ( const Vector3 & p : iPositions )
+    {
+        pmin = glm::min ( pmin , p ) ;
+        pmax = glm::max ( pmax , p ) ;
+    }
+
+    iExtent = glm::length ( pmax - pmin ) ;
+}
+
+MeshSimplifier::~MeshSimplifier ()
+{
+
+}
+
+std::vector < unsigned int > MeshSimplifier::simplify ( const std::vector < unsigned int > & indices ,
+                                                        size_t target , float maxerror ) const
+{
+    std::vector < unsigned int > result ;
+    result.reserve ( indices.size () ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Copies valid triangles only. Out of range indices are dropped instead
+    // of read , as they come from user data.
+
+    const size_t count = iPositions.size () ;
+
+    for ( size_t i = 0 ; i + 2 < indices.size () ; i += 3 )
+    {
+        if ( indices[i] >= count || indices[i+1] >= count || indices[i+2] >= count )
+        continue ;
+
+        result.push_back ( indices[i] ) ;
+        result.push_back ( indices[i+1] ) ;
+        result.push_back ( indices[i+2] ) ;
+    }
+
+    if ( result.size () <= target || iExtent <= 0.0f )
+    return result ;
+
+    const double limit = (double) ( maxerror * iExtent ) * (double) ( maxerror * iExtent ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Accumulates a quadric per welded vertex from the planes of its triangles.
+
+    std::vector < SimplifierQuadric > quadrics ( count ) ;
+
+    for ( size_t i = 0 ; i < result.size () ; i += 3 )
+    {
+        unsigned int w0 = iWelded [result[i]] , w1 = iWelded [result[i+1]] , w2 = iWelded [result[i+2]] ;
+
+        Vector3 n = glm::cross ( iPositions[w1] - iPositions[w0] , iPositions[w2] - iPositions[w0] ) ;
+        float area = glm::length ( n ) ;
+
+        if ( area <= 0.0f )
+        continue ;
+
+        n = n / area ;
+
+        quadrics [w0] .addPlane ( n , iPositions[w0] , area ) ;
+        quadrics [w1] .addPlane ( n , iPositions[w0] , area ) ;
+        quadrics [w2] .addPlane ( n , iPositions[w0] , area ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Open borders only have one triangle on their side. A plane orthogonal
+    // to the triangle , along the edge , keeps them from shrinking.
+
+    std::map < uint64_t , std::pair < int , size_t > > edges ;
+
+    for ( size_t i = 0 ; i < result.size () ; i += 3 )
+    {
+        for ( int e = 0 ; e < 3 ; ++e )
+        {
+            unsigned int a = iWelded [result[i+e]] , b = iWelded [result[i+(e+1)%3]] ;
+            uint64_t key = a < b ? ( (uint64_t) a << 32 ) | b : ( (uint64_t) b << 32 ) | a ;
+
+            auto & edge = edges [key] ;
+            edge.first ++ ;
+            edge.second = i ;
+        }
+    }
+
+    for ( auto & it : edges )
+    {
+        if ( it.second.first != 1 )
+        continue ;
+
+        unsigned int a = (unsigned int) ( it.first >> 32 ) , b = (unsigned int) ( it.first & 0xFFFFFFFF ) ;
+        size_t t = it.second.second ;
+
+        const Vector3 & p0 = iPositions [iWelded[result[t]]] ;
+        const Vector3 & p1 = iPositions [iWelded[result[t+1]]] ;
+        const Vector3 & p2 = iPositions [iWelded[result[t+2]]] ;
+
+        Vector3 edge = iPositions[b] - iPositions[a] ;
+        Vector3 n = glm::cross ( edge , glm::cross ( p1 - p0 , p2 - p0 ) ) ;
+        float length = glm::length ( n ) ;
+
+        if ( length <= 0.0f )
+        continue ;
+
+        n = n / length ;
+        double w = SimplifierBorderWeight * glm::dot ( edge , edge ) ;
+
+        quadrics [a] .addPlane ( n , iPositions[a] , w ) ;
+        quadrics [b] .addPlane ( n , iPositions[a] , w ) ;
+    }
+
+    edges.clear () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Collapses by passes : each pass sorts the edges by cost , then collapses
+    // the cheapest ones not touching a region already modified in this pass.
+
+    std::vector < unsigned int > remap ( count ) ;
+    std::vector < char > locked ( count ) ;
+    std::vector < std::vector < size_t > > adjacency ( count ) ;
+    std::vector < SimplifierCollapse > collapses ;
+
+    while ( result.size () > target )
+    {
+        collapses.clear () ;
+
+        for ( size_t i = 0 ; i < count ; ++i )
+        {
+            remap [i] = (unsigned int) i ;
+            locked [i] = 0 ;
+            adjacency [i] .clear () ;
+        }
+
+        for ( size_t i = 0 ; i < result.size () ; i += 3 )
+        {
+            for ( int e = 0 ; e < 3 ; ++e )
+            {
+                unsigned int a = iWelded [result[i+e]] , b = iWelded [result[i+(e+1)%3]] ;
+                adjacency [a] .push_back ( i ) ;
+
+                if ( a > b )
+                continue ;
+
+                SimplifierQuadric q = quadrics [a] ;
+                q.add ( quadrics [b] ) ;
+
+                double norm = q.weight > 0.0 ? 1.0 / q.weight : 1.0 ;
+                double atob = q.error ( iPositions[b] ) * norm ;
+                double btoa = q.error ( iPositions[a] ) * norm ;
+
+                if ( atob <= btoa ) collapses.push_back ( { a , b , atob } ) ;
+                else collapses.push_back ( { b , a , btoa } ) ;
+            }
+        }
+
+        std::sort ( collapses.begin () , collapses.end () ) ;
+
+        size_t remaining = result.size () / 3 ;
+        size_t collapsed = 0 ;
+
+        for ( const SimplifierCollapse & collapse : collapses )
+        {
+            if ( collapse.cost > limit || remaining * 3 <= target )
+            break ;
+
+            if ( locked [collapse.from] || locked [collapse.to] )
+            continue ;
+
+            //////////////////////////////////////////////////////////////////////
+            // Rejects the collapse if a triangle around 'from' would flip.
+
+            const Vector3 & dest = iPositions [collapse.to] ;
+            bool flips = false ;
+
+            for ( size_t t : adjacency [collapse.from] )
+            {
+                unsigned int w [3] = { iWelded[result[t]] , iWelded[result[t+1]] , iWelded[result[t+2]] } ;
+
+                if ( w[0] == collapse.to || w[1] == collapse.to || w[2] == collapse.to )
+                continue ;
+
+                Vector3 p [3] = { iPositions[w[0]] , iPositions[w[1]] , iPositions[w[2]] } ;
+                Vector3 before = glm::cross ( p[1] - p[0] , p[2] - p[0] ) ;
+
+                for ( int k = 0 ; k < 3 ; ++k )
+                if ( w[k] == collapse.from ) p[k] = dest ;
+
+                Vector3 after = glm::cross ( p[1] - p[0] , p[2] - p[0] ) ;
+
+                if ( glm::dot ( before , after ) < SimplifierFlipThreshold * glm::length ( before ) * glm::length ( after ) )
+                {
+                    flips = true ;
+                    break ;
+                }
+            }
+
+            if ( flips )
+            continue ;
+
+            //////////////////////////////////////////////////////////////////////
+            // Accepts it , and locks every vertex of the modified triangles.
+
+            remap [collapse.from] = collapse.to ;
+            quadrics [collapse.to] .add ( quadrics [collapse.from] ) ;
+
+            for ( size_t t : adjacency [collapse.from] )
+            {
+                locked [iWelded[result[t]]] = 1 ;
+                locked [iWelded[result[t+1]]] = 1 ;
+                locked [iWelded[result[t+2]]] = 1 ;
+            }
+
+            locked [collapse.to] = 1 ;
+
+            remaining = remaining > 2 ? remaining - 2 : 0 ;
+            collapsed ++ ;
+        }
+
+        if ( !collapsed )
+        break ;
+
+        //////////////////////////////////////////////////////////////////////
+        // Rewrites the triangles , dropping the degenerated ones. A moved
+        // vertex takes the welded representative of its destination.
+
+        size_t write = 0 ;
+
+        for ( size_t i = 0 ; i < result.size () ; i += 3 )
+        {
+            unsigned int v [3] ;
+            unsigned int w [3] ;
+
+            for ( int k = 0 ; k < 3 ; ++k )
+            {
+                unsigned int welded = iWelded [result[i+k]] ;
+                w[k] = remap [welded] ;
+                v[k] = w[k] == welded ? result[i+k] : w[k] ;
+            }
+
+            if ( w[0] == w[1] || w[1] == w[2] || w[0] == w[2] )
+            continue ;
+
+            result [write++] = v[0] ;
+            result [write++] = v[1] ;
+            result [write++] = v[2] ;
+        }
+
+        result.resize ( write ) ;
+    }
+
+    return result ;
+}
+
+std::vector < std::vector < unsigned int > > MeshSimplifier::buildLods ( const std::vector < unsigned int > & indices ,
+                                                                         size_t levels , float ratio , float maxerror ) const
+{
+    std::vector < std::vector < unsigned int > > lods ;
+
+    if ( ratio <= 0.0f || ratio >= 1.0f )
+    return lods ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Each level is simplified from the previous one , which is cheaper than
+    // starting again from the full mesh.
+
+    const std::vector < unsigned int > * previous = &indices ;
+
+    for ( size_t level = 0 ; level < levels ; ++level )
+    {
+        size_t target = (size_t) ( previous -> size () / 3 * ratio ) * 3 ;
+        std::vector < unsigned int > lod = simplify ( *previous , target , maxerror ) ;
+
+        if ( lod.empty () || lod.size () >= previous -> size () )
+        break ;
+
+        lods.push_back ( std::move ( lod ) ) ;
+        previous = &lods.back () ;
+    }
+
+    return lods ;
+}
+
+size_t MeshSimplifier::getVerticesCount () const
+{
+    return iPositions.size () ;
+}
+
+GreEndNamespace
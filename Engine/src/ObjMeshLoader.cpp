@@ -155,13 +155,13 @@ void CalculateTangentBinormal ( const OBJ_VERTEX& v1 , const OBJ_VERTEX& v2 , co
     bi.z = bi.z / bilenght ;
 }
 
-void _objecttomesh ( MeshHolder& mesh , OBJ_O* obj , MeshManagerHolder & meshmanager )
+SubMeshHolder _objecttomesh ( MeshHolder& mesh , OBJ_O* obj , MeshManagerHolder & meshmanager )
 {
     if ( !obj )
-    return ;
+    return SubMeshHolder ( nullptr ) ;
 
     if ( obj->verticecount == 0 || mesh.isInvalid() )
-    return ;
+    return SubMeshHolder ( nullptr ) ;
 
     //////////////////////////////////////////////////////////////////////
     // Creates a submesh to add to the mesh.
@@ -169,7 +169,7 @@ void _objecttomesh ( MeshHolder& mesh , OBJ_O* obj , MeshManagerHolder & meshman
     SubMeshHolder submesh = new SubMesh ( mesh->getName() + ".submesh." + std::to_string(mesh->getSubMeshes().size()) ) ;
 
     if ( submesh.isInvalid() )
-    return ;
+    return SubMeshHolder ( nullptr ) ;
 
     if ( obj->indices.size() )
     {
@@ -260,6 +260,8 @@ void _objecttomesh ( MeshHolder& mesh , OBJ_O* obj , MeshManagerHolder & meshman
     BoundingBox bbox ({ obj->ptmax.x, obj->ptmax.y, obj->ptmax.z } ,
                       { obj->ptmin.x, obj->ptmin.y, obj->ptmin.z });
     mesh -> setBoundingBox(bbox) ;
+
+    return submesh ;
 }
 
 MeshHolder ObjMeshLoader::load(const std::string &filepath, const ResourceLoaderOptions & ops) const
@@ -305,6 +307,11 @@ MeshHolder ObjMeshLoader::load(const std::string &filepath, const ResourceLoader
     current -> normalcount = 0 ;
     current -> texcount = 0 ;
 
+    // Objects are converted once the whole file is read , in order to
+    // generate their levels of detail together.
+
+    std::vector < OBJ_O * > objects ;
+
     // These are globals variables.
 
     std::vector < OBJ_V > vertices ;
@@ -329,8 +336,7 @@ MeshHolder ObjMeshLoader::load(const std::string &filepath, const ResourceLoader
             else if ( next == "o" ) {
 
                 if ( current ) {
-                    _objecttomesh(mesh, current, meshmanager) ;
-                    delete current ;
+                    objects.push_back(current) ;
                     current = nullptr ;
                 }
 
@@ -477,11 +483,37 @@ MeshHolder ObjMeshLoader::load(const std::string &filepath, const ResourceLoader
 
     if ( current )
     {
-        _objecttomesh(mesh, current, meshmanager) ;
-        delete current ;
+        objects.push_back(current) ;
         current = nullptr ;
     }
 
+    //////////////////////////////////////////////////////////////////////
+    // Creates the submeshes , then their levels of detail from the CPU
+    // vertices still held by the objects.
+
+    std::vector < MeshLodSource > sources ;
+
+    for ( OBJ_O * object : objects )
+    {
+        SubMeshHolder submesh = _objecttomesh(mesh, object, meshmanager) ;
+
+        if ( submesh.isInvalid() || object->indices.empty() )
+        continue ;
+
+        MeshLodSource source ;
+        source.submesh = submesh ;
+        source.positions = &object->vertexs[0].vertice ;
+        source.stride = sizeof(OBJ_VERTEX) ;
+        source.vertices = object->vertexs.size() ;
+        source.indices.assign(object->indices.begin(), object->indices.end()) ;
+        sources.push_back(source) ;
+    }
+
+    meshmanager -> generateLods ( sources , ops ) ;
+
+    for ( OBJ_O * object : objects )
+    delete object ;
+
     return mesh ;
 }
 
@@ -0,0 +1,517 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  OcclusionBuffer.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 16/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "OcclusionBuffer.h"
+#include "JobPool.h"
+
+#include <cfloat>
+
+GreBeginNamespace
+
+OcclusionBuffer::OcclusionBuffer ( int width , int height )
+: iProjectionView ( 1.0f )
+{
+    iTilesX = std::max ( 1 , ( width + TileSize - 1 ) / TileSize ) ;
+    iTilesY = std::max ( 1 , ( height + TileSize - 1 ) / TileSize ) ;
+    iWidth = iTilesX * TileSize ;
+    iHeight = iTilesY * TileSize ;
+
+    iDepths.resize ( iWidth * iHeight , 1.0f ) ;
+    iTileMaxDepths.resize ( iTilesX * iTilesY , 1.0f ) ;
+    iBins.resize ( iTilesX * iTilesY ) ;
+}
+
+OcclusionBuffer::~OcclusionBuffer ()
+{
+
+}
+
+void OcclusionBuffer::clear ( const Matrix4 & projectionview )
+{
+    iProjectionView = projectionview ;
+
+    std::fill ( iDepths.begin () , iDepths.end () , 1.0f ) ;
+    std::fill ( iTileMaxDepths.begin () , iTileMaxDepths.end () , 1.0f ) ;
+
+    iTriangles.clear () ;
+
+    for ( auto & bin : iBins )
+    bin.clear () ;
+}
+
+void OcclusionBuffer::addTriangles ( const Vector3 * positions , size_t count ,
+                                     const uint32_t * indices , size_t icount ,
+                                     const Matrix4 & model )
+{
+    if ( !positions || !count )
+    return ;
+
+    const Matrix4 mvp = iProjectionView * model ;
+
+    if ( indices )
+    {
+        for ( size_t i = 0 ; i + 2 < icount ; i += 3 )
+        {
+            if ( indices[i] >= count || indices[i+1] >= count || indices[i+2] >= count )
+            continue ;
+
+            addClipTriangle ( mvp * Vector4 ( positions[indices[i]] , 1.0f ) ,
+                              mvp * Vector4 ( positions[indices[i+1]] , 1.0f ) ,
+                              mvp * Vector4 ( positions[indices[i+2]] , 1.0f ) ) ;
+        }
+    }
+
+    else
+    {
+        for ( size_t i = 0 ; i + 2 < count ; i += 3 )
+        {
+            addClipTriangle ( mvp * Vector4 ( positions[i] , 1.0f ) ,
+                              mvp * Vector4 ( positions[i+1] , 1.0f ) ,
+                              mvp * Vector4 ( positions[i+2] , 1.0f ) ) ;
+        }
+    }
+}
+
+bool OcclusionBuffer::addMesh ( const MeshHolder & mesh , const Matrix4 & model )
+{
+    if ( mesh.isInvalid() )
+    return false ;
+
+    bool added = false ;
+
+    std::vector < Vector3 > positions ;
+    std::vector < uint32_t > indices ;
+
+    for ( const SubMeshHolder & submesh : mesh -> getSubMeshes () )
+    {
+        if ( submesh.isInvalid() )
+        continue ;
+
+        //////////////////////////////////////////////////////////////////////
+        // Looks for a local vertex buffer with a CPU copy and a float position
+        // component.
+
+        positions.clear () ;
+
+        for ( const HardwareVertexBufferHolder & buffer : submesh -> getVertexBuffers () )
+        {
+            if ( buffer.isInvalid() || !buffer -> getData () )
+            continue ;
+
+            const VertexDescriptor & desc = buffer -> getVertexDescriptor () ;
+
+            for ( const VertexAttribComponent & component : desc.getComponents () )
+            {
+                if ( component.alias != VertexAttribAlias::Position || component.type != VertexAttribType::Float || component.elements < 3 )
+                continue ;
+
+                size_t stride = desc.getStride ( component ) ;
+                size_t offset = desc.getOffset ( component ) ;
+
+                if ( !stride )
+                break ;
+
+                const char * data = buffer -> getData () ;
+                size_t vertices = buffer -> getSize () / stride ;
+
+                for ( size_t v = 0 ; v < vertices ; ++v )
+                {
+                    const float * p = reinterpret_cast < const float * > ( data + v * stride + offset ) ;
+                    positions.push_back ( Vector3 ( p[0] , p[1] , p[2] ) ) ;
+                }
+
+                break ;
+            }
+
+            if ( !positions.empty() )
+            break ;
+        }
+
+        if ( positions.empty() )
+        continue ;
+
+        //////////////////////////////////////////////////////////////////////
+        // Reads the index buffer if it has a CPU copy. Without index buffer ,
+        // vertices are read as a triangle list.
+
+        const HardwareIndexBufferHolder & ibuffer = submesh -> getIndexBuffer () ;
+        indices.clear () ;
+
+        if ( !ibuffer.isInvalid() && ibuffer -> getData () )
+        {
+            const IndexDescriptor & idesc = ibuffer -> getIndexDescriptor () ;
+
+            if ( idesc.getMode () != IndexDrawmode::Triangles )
+            continue ;
+
+            size_t isize = IndexTypeGetSize ( idesc.getType () ) ;
+
+            if ( !isize )
+            continue ;
+
+            const char * data = ibuffer -> getData () ;
+            size_t icount = ibuffer -> getSize () / isize ;
+
+            for ( size_t i = 0 ; i < icount ; ++i )
+            {
+                if ( isize == sizeof ( unsigned char ) )
+                indices.push_back ( reinterpret_cast < const unsigned char * > ( data ) [i] ) ;
+                else if ( isize == sizeof ( unsigned short ) )
+                indices.push_back ( reinterpret_cast < const unsigned short * > ( data ) [i] ) ;
+                else
+                indices.push_back ( reinterpret_cast < const unsigned int * > ( data ) [i] ) ;
+            }
+
+            addTriangles ( positions.data () , positions.size () , indices.data () , indices.size () , model ) ;
+        }
+
+        else if ( ibuffer.isInvalid() )
+        {
+            addTriangles ( positions.data () , positions.size () , nullptr , 0 , model ) ;
+        }
+
+        else
+        {
+            continue ;
+        }
+
+        added = true ;
+    }
+
+    return added ;
+}
+
+void OcclusionBuffer::addBox ( const BoundingBox & bbox )
+{
+    if ( bbox.isInvalid() )
+    return ;
+
+    const Vector3 & a = bbox.getMin () ;
+    const Vector3 & b = bbox.getMax () ;
+
+    Vector3 corners [8] = {
+        Vector3 ( a.x , a.y , a.z ) , Vector3 ( b.x , a.y , a.z ) ,
+        Vector3 ( b.x , b.y , a.z ) , Vector3 ( a.x , b.y , a.z ) ,
+        Vector3 ( a.x , a.y , b.z ) , Vector3 ( b.x , a.y , b.z ) ,
+        Vector3 ( b.x , b.y , b.z ) , Vector3 ( a.x , b.y , b.z )
+    } ;
+
+    static const uint32_t indices [36] = {
+        0 , 1 , 2 , 0 , 2 , 3 ,
+        4 , 6 , 5 , 4 , 7 , 6 ,
+        0 , 4 , 5 , 0 , 5 , 1 ,
+        3 , 2 , 6 , 3 , 6 , 7 ,
+        0 , 3 , 7 , 0 , 7 , 4 ,
+        1 , 5 , 6 , 1 , 6 , 2
+    } ;
+
+    addTriangles ( corners , 8 , indices , 36 , Matrix4 ( 1.0f ) ) ;
+}
+
+void OcclusionBuffer::addClipTriangle ( const Vector4 & a , const Vector4 & b , const Vector4 & c )
+{
+    //////////////////////////////////////////////////////////////////////
+    // Trivial rejection when the three vertices are outside the same clip
+    // plane.
+
+    if ( a.x > a.w && b.x > b.w && c.x > c.w ) return ;
+    if ( a.x < -a.w && b.x < -b.w && c.x < -c.w ) return ;
+    if ( a.y > a.w && b.y > b.w && c.y > c.w ) return ;
+    if ( a.y < -a.w && b.y < -b.w && c.y < -c.w ) return ;
+    if ( a.z > a.w && b.z > b.w && c.z > c.w ) return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Clips against the near plane ( z + w >= 0 ). Other planes are handled
+    // by clamping the pixel bounds.
+
+    const Vector4 in [3] = { a , b , c } ;
+    float d [3] = { a.z + a.w , b.z + b.w , c.z + c.w } ;
+
+    if ( d[0] >= 0.0f && d[1] >= 0.0f && d[2] >= 0.0f )
+    {
+        addScreenTriangle ( a , b , c ) ;
+        return ;
+    }
+
+    Vector4 out [4] ;
+    int count = 0 ;
+
+    for ( int i = 0 ; i < 3 ; ++i )
+    {
+        int j = ( i + 1 ) % 3 ;
+
+        if ( d[i] >= 0.0f )
+        out [count++] = in [i] ;
+
+        if ( ( d[i] >= 0.0f ) != ( d[j] >= 0.0f ) )
+        {
+            float t = d[i] / ( d[i] - d[j] ) ;
+            out [count++] = in[i] + ( in[j] - in[i] ) * t ;
+        }
+    }
+
+    if ( count >= 3 )
+    addScreenTriangle ( out[0] , out[1] , out[2] ) ;
+
+    if ( count == 4 )
+    addScreenTriangle ( out[0] , out[2] , out[3] ) ;
+}
+
+void OcclusionBuffer::addScreenTriangle ( const Vector4 & a , const Vector4 & b , const Vector4 & c )
+{
+    const Vector4 clip [3] = { a , b , c } ;
+    ScreenTriangle triangle ;
+
+    for ( int i = 0 ; i < 3 ; ++i )
+    {
+        float w = std::max ( clip[i].w , 1e-6f ) ;
+
+        triangle.v[i].x = ( clip[i].x / w * 0.5f + 0.5f ) * (float) iWidth ;
+        triangle.v[i].y = ( clip[i].y / w * 0.5f + 0.5f ) * (float) iHeight ;
+        triangle.v[i].z = std::min ( std::max ( clip[i].z / w * 0.5f + 0.5f , 0.0f ) , 1.0f ) ;
+    }
+
+    float minx = std::min ( triangle.v[0].x , std::min ( triangle.v[1].x , triangle.v[2].x ) ) ;
+    float maxx = std::max ( triangle.v[0].x , std::max ( triangle.v[1].x , triangle.v[2].x ) ) ;
+    float miny = std::min ( triangle.v[0].y , std::min ( triangle.v[1].y , triangle.v[2].y ) ) ;
+    float maxy = std::max ( triangle.v[0].y , std::max ( triangle.v[1].y , triangle.v[2].y ) ) ;
+
+    triangle.minx = std::max ( 0 , (int) std::floor ( minx ) ) ;
+    triangle.miny = std::max ( 0 , (int) std::floor ( miny ) ) ;
+    triangle.maxx = std::min ( iWidth - 1 , (int) std::ceil ( maxx ) ) ;
+    triangle.maxy = std::min ( iHeight - 1 , (int) std::ceil ( maxy ) ) ;
+
+    if ( triangle.minx > triangle.maxx || triangle.miny > triangle.maxy )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Bins the triangle into every tile its bounds overlap.
+
+    uint32_t index = (uint32_t) iTriangles.size () ;
+    iTriangles.push_back ( triangle ) ;
+
+    for ( int ty = triangle.miny / TileSize ; ty <= triangle.maxy / TileSize ; ++ty )
+    for ( int tx = triangle.minx / TileSize ; tx <= triangle.maxx / TileSize ; ++tx )
+    iBins [ ty * iTilesX + tx ] .push_back ( index ) ;
+}
+
+void OcclusionBuffer::rasterize ()
+{
+    if ( iTriangles.empty() )
+    return ;
+
+    JobPool::Get () .parallelFor ( iBins.size () , 1 , [this] ( size_t begin , size_t end )
+    {
+        for ( size_t tile = begin ; tile < end ; ++tile )
+        rasterizeTile ( tile ) ;
+    });
+}
+
+void OcclusionBuffer::rasterizeTile ( size_t tile )
+{
+    const std::vector < uint32_t > & bin = iBins [tile] ;
+
+    if ( bin.empty() )
+    return ;
+
+    int tx0 = (int) ( tile % iTilesX ) * TileSize ;
+    int ty0 = (int) ( tile / iTilesX ) * TileSize ;
+    int tx1 = tx0 + TileSize - 1 ;
+    int ty1 = ty0 + TileSize - 1 ;
+
+    for ( uint32_t index : bin )
+    {
+        const ScreenTriangle & triangle = iTriangles [index] ;
+
+        Vector3 v0 = triangle.v[0] ;
+        Vector3 v1 = triangle.v[1] ;
+        Vector3 v2 = triangle.v[2] ;
+
+        //////////////////////////////////////////////////////////////////////
+        // Occluders are rasterized whatever their winding is : counter-clockwise
+        // triangles are swapped.
+
+        float area = ( v1.x - v0.x ) * ( v2.y - v0.y ) - ( v1.y - v0.y ) * ( v2.x - v0.x ) ;
+
+        if ( std::fabs ( area ) < 1e-8f )
+        continue ;
+
+        if ( area < 0.0f )
+        {
+            std::swap ( v1 , v2 ) ;
+            area = - area ;
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        // Edge functions , and depth as a plane in screen space. Values are
+        // stepped incrementally along the row so the inner loop only has
+        // additions and compares.
+
+        float a0 = v1.y - v2.y , b0 = v2.x - v1.x ;
+        float a1 = v2.y - v0.y , b1 = v0.x - v2.x ;
+        float a2 = v0.y - v1.y , b2 = v1.x - v0.x ;
+
+        float inv = 1.0f / area ;
+        float dzdx = ( a0 * v0.z + a1 * v1.z + a2 * v2.z ) * inv ;
+        float dzdy = ( b0 * v0.z + b1 * v1.z + b2 * v2.z ) * inv ;
+
+        int minx = std::max ( triangle.minx , tx0 ) ;
+        int maxx = std::min ( triangle.maxx , tx1 ) ;
+        int miny = std::max ( triangle.miny , ty0 ) ;
+        int maxy = std::min ( triangle.maxy , ty1 ) ;
+
+        float px = (float) minx + 0.5f ;
+        float py = (float) miny + 0.5f ;
+
+        float w0row = ( v2.x - v1.x ) * ( py - v1.y ) - ( v2.y - v1.y ) * ( px - v1.x ) ;
+        float w1row = ( v0.x - v2.x ) * ( py - v2.y ) - ( v0.y - v2.y ) * ( px - v2.x ) ;
+        float w2row = ( v1.x - v0.x ) * ( py - v0.y ) - ( v1.y - v0.y ) * ( px - v0.x ) ;
+        float zrow = ( w0row * v0.z + w1row * v1.z + w2row * v2.z ) * inv ;
+
+        for ( int y = miny ; y <= maxy ; ++y )
+        {
+            float w0 = w0row , w1 = w1row , w2 = w2row , z = zrow ;
+            float * depths = &iDepths [ y * iWidth ] ;
+
+            for ( int x = minx ; x <= maxx ; ++x )
+            {
+                if ( w0 >= 0.0f && w1 >= 0.0f && w2 >= 0.0f && z < depths[x] )
+                depths [x] = z ;
+
+                w0 += a0 ; w1 += a1 ; w2 += a2 ; z += dzdx ;
+            }
+
+            w0row += b0 ; w1row += b1 ; w2row += b2 ; zrow += dzdy ;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Updates the farthest depth of this tile.
+
+    float farthest = 0.0f ;
+
+    for ( int y = ty0 ; y <= ty1 ; ++y )
+    for ( int x = tx0 ; x <= tx1 ; ++x )
+    farthest = std::max ( farthest , iDepths [ y * iWidth + x ] ) ;
+
+    iTileMaxDepths [tile] = farthest ;
+}
+
+bool OcclusionBuffer::isVisible ( const BoundingBox & bbox ) const
+{
+    if ( bbox.isInvalid() || iTriangles.empty() )
+    return true ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Projects the eight corners and keeps the screen bounds and nearest
+    // depth. A box crossing the near plane may cover the whole screen.
+
+    const Vector3 & a = bbox.getMin () ;
+    const Vector3 & b = bbox.getMax () ;
+
+    float minx = FLT_MAX , miny = FLT_MAX , maxx = - FLT_MAX , maxy = - FLT_MAX ;
+    float nearest = 1.0f ;
+
+    for ( int i = 0 ; i < 8 ; ++i )
+    {
+        Vector4 corner ( i & 1 ? b.x : a.x , i & 2 ? b.y : a.y , i & 4 ? b.z : a.z , 1.0f ) ;
+        Vector4 clip = iProjectionView * corner ;
+
+        if ( clip.z + clip.w < 0.0f || clip.w <= 1e-6f )
+        return true ;
+
+        float x = ( clip.x / clip.w * 0.5f + 0.5f ) * (float) iWidth ;
+        float y = ( clip.y / clip.w * 0.5f + 0.5f ) * (float) iHeight ;
+        float z = clip.z / clip.w * 0.5f + 0.5f ;
+
+        minx = std::min ( minx , x ) ; maxx = std::max ( maxx , x ) ;
+        miny = std::min ( miny , y ) ; maxy = std::max ( maxy , y ) ;
+        nearest = std::min ( nearest , z ) ;
+    }
+
+    int x0 = std::max ( 0 , (int) std::floor ( minx ) ) ;
+    int y0 = std::max ( 0 , (int) std::floor ( miny ) ) ;
+    int x1 = std::min ( iWidth - 1 , (int) std::ceil ( maxx ) ) ;
+    int y1 = std::min ( iHeight - 1 , (int) std::ceil ( maxy ) ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Off-screen boxes are left to the frustum culling.
+
+    if ( x0 > x1 || y0 > y1 )
+    return true ;
+
+    nearest = std::max ( nearest , 0.0f ) ;
+
+    for ( int ty = y0 / TileSize ; ty <= y1 / TileSize ; ++ty )
+    for ( int tx = x0 / TileSize ; tx <= x1 / TileSize ; ++tx )
+    {
+        //////////////////////////////////////////////////////////////////////
+        // Every pixel of the tile is nearer than the box : the tile hides it.
+
+        if ( nearest > iTileMaxDepths [ ty * iTilesX + tx ] )
+        continue ;
+
+        int px0 = std::max ( x0 , tx * TileSize ) , px1 = std::min ( x1 , tx * TileSize + TileSize - 1 ) ;
+        int py0 = std::max ( y0 , ty * TileSize ) , py1 = std::min ( y1 , ty * TileSize + TileSize - 1 ) ;
+
+        for ( int y = py0 ; y <= py1 ; ++y )
+        for ( int x = px0 ; x <= px1 ; ++x )
+        {
+            if ( nearest <= iDepths [ y * iWidth + x ] )
+            return true ;
+        }
+    }
+
+    return false ;
+}
+
+size_t OcclusionBuffer::getTrianglesCount () const
+{
+    return iTriangles.size () ;
+}
+
+int OcclusionBuffer::getWidth () const
+{
+    return iWidth ;
+}
+
+int OcclusionBuffer::getHeight () const
+{
+    return iHeight ;
+}
+
+float OcclusionBuffer::getDepth ( int x , int y ) const
+{
+    return iDepths [ y * iWidth + x ] ;
+}
+
+GreEndNamespace
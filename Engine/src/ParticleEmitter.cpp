@@ -0,0 +1,528 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  ParticleEmitter.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "ParticleEmitter.h"
+#include "ResourceManager.h"
+#include "JobPool.h"
+
+#include <cstring>
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+// Small xorshift generator , one per emission job.
+
+struct ParticleRandom
+{
+    uint64_t state ;
+
+    ParticleRandom ( uint64_t seed ) : state ( seed ? seed : 0x9E3779B97F4A7C15ULL ) { }
+
+    float next ()
+    {
+        state ^= state >> 12 ;
+        state ^= state << 25 ;
+        state ^= state >> 27 ;
+        return (float) ( ( state * 0x2545F4914F6CDD1DULL ) >> 40 ) / 16777216.0f ;
+    }
+};
+
+//////////////////////////////////////////////////////////////////////
+// Number of meshes in the ring.
+
+static const size_t ParticleMeshesCount = 3 ;
+
+ParticleEmitter::ParticleEmitter ( const RenderScene * creator , const std::string & name , size_t capacity )
+: RenderNode ( creator , name )
+, iCount ( 0 ) , iCapacity ( capacity )
+, iRate ( 0.0f ) , iRemainder ( 0.0f )
+, iLifeMin ( 1.0f ) , iLifeMax ( 1.0f )
+, iSpeedMin ( 1.0f ) , iSpeedMax ( 1.0f )
+, iDirection ( 0.0f , 1.0f , 0.0f ) , iSpread ( 0.0f )
+, iEmissionRadius ( 0.0f )
+, iGravity ( 0.0f , 0.0f , 0.0f ) , iDamping ( 0.0f )
+, iColorBegin ( 1.0f , 1.0f , 1.0f , 1.0f ) , iColorEnd ( 1.0f , 1.0f , 1.0f , 0.0f )
+, iSeed ( 0x853C49E6748FEA9BULL )
+, iOrigin ( 0.0f , 0.0f , 0.0f )
+, iNextMesh ( 0 )
+{
+    resize () ;
+}
+
+ParticleEmitter::~ParticleEmitter () noexcept ( false )
+{
+
+}
+
+void ParticleEmitter::setCapacity ( size_t capacity )
+{
+    GreAutolock ;
+
+    iCapacity = capacity ;
+    iCount = std::min ( iCount , iCapacity ) ;
+    resize () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Index buffers are sized for the old capacity.
+
+    iMeshes.clear () ;
+}
+
+size_t ParticleEmitter::getCapacity () const
+{
+    GreAutolock ; return iCapacity ;
+}
+
+size_t ParticleEmitter::getCount () const
+{
+    GreAutolock ; return iCount ;
+}
+
+void ParticleEmitter::setRate ( float rate )
+{
+    GreAutolock ; iRate = std::max ( rate , 0.0f ) ;
+}
+
+float ParticleEmitter::getRate () const
+{
+    GreAutolock ; return iRate ;
+}
+
+void ParticleEmitter::setLifetime ( float min , float max )
+{
+    GreAutolock ; iLifeMin = min ; iLifeMax = std::max ( min , max ) ;
+}
+
+void ParticleEmitter::setSpeed ( float min , float max )
+{
+    GreAutolock ; iSpeedMin = min ; iSpeedMax = std::max ( min , max ) ;
+}
+
+void ParticleEmitter::setDirection ( const Vector3 & direction , float spread )
+{
+    GreAutolock ;
+
+    iDirection = glm::length ( direction ) > 0.0f ? glm::normalize ( direction ) : Vector3 ( 0.0f , 1.0f , 0.0f ) ;
+    iSpread = std::min ( std::max ( spread , 0.0f ) , 1.0f ) ;
+}
+
+void ParticleEmitter::setEmissionRadius ( float radius )
+{
+    GreAutolock ; iEmissionRadius = std::max ( radius , 0.0f ) ;
+}
+
+void ParticleEmitter::setGravity ( const Vector3 & gravity )
+{
+    GreAutolock ; iGravity = gravity ;
+}
+
+void ParticleEmitter::setDamping ( float damping )
+{
+    GreAutolock ; iDamping = std::max ( damping , 0.0f ) ;
+}
+
+void ParticleEmitter::setColors ( const Color & begin , const Color & end )
+{
+    GreAutolock ;
+
+    iColorBegin = begin.toFloat4 () ;
+    iColorEnd = end.toFloat4 () ;
+}
+
+size_t ParticleEmitter::emit ( size_t count )
+{
+    GreAutolock ;
+
+    size_t first = iCount ;
+    count = std::min ( count , iCapacity - iCount ) ;
+
+    if ( !count )
+    return 0 ;
+
+    //////////////////////////////////////////////////////////////////////
+    // New particles are born around the world position of the node. Each
+    // job gets its own seed , so the result doesn't depend on which
+    // thread runs which chunk.
+
+    const Matrix4 & model = getModelMatrix () ;
+    iOrigin = Vector3 ( model[3][0] , model[3][1] , model[3][2] ) ;
+
+    uint64_t seed = iSeed ;
+    iSeed = iSeed * 6364136223846793005ULL + 1442695040888963407ULL ;
+
+    JobPool::Get () .parallelFor ( count , ChunkSize , [&] ( size_t begin , size_t end ) {
+        spawn ( first + begin , first + end , seed ^ ( ( begin + 1 ) * 0x9E3779B97F4A7C15ULL ) ) ;
+    } ) ;
+
+    iCount += count ;
+    return count ;
+}
+
+void ParticleEmitter::simulate ( float elapsed )
+{
+    GreAutolock ;
+
+    if ( elapsed > 0.0f )
+    {
+        JobPool::Get () .parallelFor ( iCount , ChunkSize , [&] ( size_t begin , size_t end ) {
+            integrate ( begin , end , elapsed ) ;
+        } ) ;
+
+        kill () ;
+
+        iRemainder += iRate * elapsed ;
+        size_t count = (size_t) iRemainder ;
+        iRemainder -= (float) count ;
+
+        emit ( count ) ;
+    }
+
+    write () ;
+    upload () ;
+}
+
+void ParticleEmitter::clearParticles ()
+{
+    GreAutolock ;
+
+    iCount = 0 ;
+    iRemainder = 0.0f ;
+    write () ;
+    upload () ;
+}
+
+const std::vector < ParticleVertex > & ParticleEmitter::getVertices () const
+{
+    GreAutolock ; return iVertices ;
+}
+
+void ParticleEmitter::onUpdateEvent ( const UpdateEvent & e )
+{
+    RenderNode::onUpdateEvent ( e ) ;
+    simulate ( e.elapsedTime.count () ) ;
+}
+
+void ParticleEmitter::resize ()
+{
+    iPositionX.resize ( iCapacity ) ; iPositionY.resize ( iCapacity ) ; iPositionZ.resize ( iCapacity ) ;
+    iVelocityX.resize ( iCapacity ) ; iVelocityY.resize ( iCapacity ) ; iVelocityZ.resize ( iCapacity ) ;
+    iAge.resize ( iCapacity ) ; iLife.resize ( iCapacity ) ;
+
+    iIndices.resize ( iCapacity ) ;
+
+    for ( size_t i = 0 ; i < iCapacity ; ++i )
+    iIndices [i] = (unsigned int) i ;
+}
+
+void ParticleEmitter::integrate ( size_t begin , size_t end , float elapsed )
+{
+    //////////////////////////////////////////////////////////////////////
+    // Plain loops over each array , so the compiler can vectorize them.
+
+    const float damping = std::max ( 1.0f - iDamping * elapsed , 0.0f ) ;
+    const float gx = iGravity.x * elapsed ;
+    const float gy = iGravity.y * elapsed ;
+    const float gz = iGravity.z * elapsed ;
+
+    float * px = iPositionX.data () ; float * vx = iVelocityX.data () ;
+    float * py = iPositionY.data () ; float * vy = iVelocityY.data () ;
+    float * pz = iPositionZ.data () ; float * vz = iVelocityZ.data () ;
+    float * age = iAge.data () ;
+
+    for ( size_t i = begin ; i < end ; ++i )
+    vx [i] = ( vx [i] + gx ) * damping ;
+    for ( size_t i = begin ; i < end ; ++i )
+    vy [i] = ( vy [i] + gy ) * damping ;
+    for ( size_t i = begin ; i < end ; ++i )
+    vz [i] = ( vz [i] + gz ) * damping ;
+
+    for ( size_t i = begin ; i < end ; ++i )
+    px [i] += vx [i] * elapsed ;
+    for ( size_t i = begin ; i < end ; ++i )
+    py [i] += vy [i] * elapsed ;
+    for ( size_t i = begin ; i < end ; ++i )
+    pz [i] += vz [i] * elapsed ;
+
+    for ( size_t i = begin ; i < end ; ++i )
+    age [i] += elapsed ;
+}
+
+size_t ParticleEmitter::compact ( size_t begin , size_t end )
+{
+    size_t alive = begin ;
+
+    for ( size_t i = begin ; i < end ; ++i )
+    {
+        if ( iAge [i] >= iLife [i] )
+        continue ;
+
+        if ( alive != i )
+        {
+            iPositionX [alive] = iPositionX [i] ; iPositionY [alive] = iPositionY [i] ; iPositionZ [alive] = iPositionZ [i] ;
+            iVelocityX [alive] = iVelocityX [i] ; iVelocityY [alive] = iVelocityY [i] ; iVelocityZ [alive] = iVelocityZ [i] ;
+            iAge [alive] = iAge [i] ; iLife [alive] = iLife [i] ;
+        }
+
+        alive++ ;
+    }
+
+    return alive - begin ;
+}
+
+void ParticleEmitter::move ( size_t destination , size_t source , size_t count )
+{
+    if ( destination == source || !count )
+    return ;
+
+    const size_t bytes = count * sizeof ( float ) ;
+
+    memmove ( &iPositionX [destination] , &iPositionX [source] , bytes ) ;
+    memmove ( &iPositionY [destination] , &iPositionY [source] , bytes ) ;
+    memmove ( &iPositionZ [destination] , &iPositionZ [source] , bytes ) ;
+    memmove ( &iVelocityX [destination] , &iVelocityX [source] , bytes ) ;
+    memmove ( &iVelocityY [destination] , &iVelocityY [source] , bytes ) ;
+    memmove ( &iVelocityZ [destination] , &iVelocityZ [source] , bytes ) ;
+    memmove ( &iAge [destination] , &iAge [source] , bytes ) ;
+    memmove ( &iLife [destination] , &iLife [source] , bytes ) ;
+}
+
+void ParticleEmitter::spawn ( size_t begin , size_t end , uint64_t seed )
+{
+    ParticleRandom random ( seed ) ;
+
+    for ( size_t i = begin ; i < end ; ++i )
+    {
+        //////////////////////////////////////////////////////////////////////
+        // Uniform direction on the sphere , mixed with the emitter's direction
+        // by the spread.
+
+        float z = random.next () * 2.0f - 1.0f ;
+        float phi = random.next () * 6.28318531f ;
+        float r = sqrtf ( std::max ( 1.0f - z * z , 0.0f ) ) ;
+        Vector3 unit ( r * cosf ( phi ) , r * sinf ( phi ) , z ) ;
+
+        Vector3 direction = iDirection * ( 1.0f - iSpread ) + unit * iSpread ;
+        float length = glm::length ( direction ) ;
+        direction = length > 1e-6f ? direction / length : iDirection ;
+
+        float speed = iSpeedMin + ( iSpeedMax - iSpeedMin ) * random.next () ;
+        float distance = iEmissionRadius * cbrtf ( random.next () ) ;
+
+        iPositionX [i] = iOrigin.x + unit.x * distance ;
+        iPositionY [i] = iOrigin.y + unit.y * distance ;
+        iPositionZ [i] = iOrigin.z + unit.z * distance ;
+        iVelocityX [i] = direction.x * speed ;
+        iVelocityY [i] = direction.y * speed ;
+        iVelocityZ [i] = direction.z * speed ;
+        iAge [i] = 0.0f ;
+        iLife [i] = iLifeMin + ( iLifeMax - iLifeMin ) * random.next () ;
+    }
+}
+
+void ParticleEmitter::kill ()
+{
+    if ( !iCount )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Each job compacts its own chunk , then chunks are moved one after the
+    // other to close the gaps.
+
+    const size_t chunks = ( iCount + ChunkSize - 1 ) / ChunkSize ;
+    std::vector < size_t > alive ( chunks ) ;
+
+    JobPool::Get () .parallelFor ( chunks , 1 , [&] ( size_t begin , size_t end ) {
+        for ( size_t c = begin ; c < end ; ++c )
+        alive [c] = compact ( c * ChunkSize , std::min ( ( c + 1 ) * ChunkSize , iCount ) ) ;
+    } ) ;
+
+    size_t count = alive [0] ;
+
+    for ( size_t c = 1 ; c < chunks ; ++c )
+    {
+        move ( count , c * ChunkSize , alive [c] ) ;
+        count += alive [c] ;
+    }
+
+    iCount = count ;
+}
+
+void ParticleEmitter::write ()
+{
+    iVertices.resize ( iCount ) ;
+
+    if ( !iCount )
+    {
+        setBoundingBox ( BoundingBox () ) ;
+        return ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Vertices are relative to the node , while the bounding box stays in
+    // world space like every other node's one.
+
+    const Matrix4 inverse = glm::inverse ( getModelMatrix () ) ;
+    const Vector4 colordelta = iColorEnd - iColorBegin ;
+
+    const size_t chunks = ( iCount + ChunkSize - 1 ) / ChunkSize ;
+    std::vector < Vector3 > mins ( chunks ) , maxs ( chunks ) ;
+
+    JobPool::Get () .parallelFor ( chunks , 1 , [&] ( size_t begin , size_t end ) {
+        for ( size_t c = begin ; c < end ; ++c )
+        {
+            const size_t first = c * ChunkSize ;
+            const size_t last = std::min ( first + ChunkSize , iCount ) ;
+
+            Vector3 min ( iPositionX [first] , iPositionY [first] , iPositionZ [first] ) ;
+            Vector3 max = min ;
+
+            for ( size_t i = first ; i < last ; ++i )
+            {
+                const float x = iPositionX [i] , y = iPositionY [i] , z = iPositionZ [i] ;
+
+                min.x = std::min ( min.x , x ) ; max.x = std::max ( max.x , x ) ;
+                min.y = std::min ( min.y , y ) ; max.y = std::max ( max.y , y ) ;
+                min.z = std::min ( min.z , z ) ; max.z = std::max ( max.z , z ) ;
+
+                ParticleVertex & vertex = iVertices [i] ;
+                vertex.position [0] = inverse[0][0] * x + inverse[1][0] * y + inverse[2][0] * z + inverse[3][0] ;
+                vertex.position [1] = inverse[0][1] * x + inverse[1][1] * y + inverse[2][1] * z + inverse[3][1] ;
+                vertex.position [2] = inverse[0][2] * x + inverse[1][2] * y + inverse[2][2] * z + inverse[3][2] ;
+
+                const float t = std::min ( iAge [i] / iLife [i] , 1.0f ) ;
+
+                for ( int k = 0 ; k < 4 ; ++k )
+                {
+                    const float channel = std::min ( std::max ( iColorBegin [k] + colordelta [k] * t , 0.0f ) , 1.0f ) ;
+                    vertex.color [k] = (unsigned char) ( channel * 255.0f + 0.5f ) ;
+                }
+            }
+
+            mins [c] = min ;
+            maxs [c] = max ;
+        }
+    } ) ;
+
+    Vector3 min = mins [0] , max = maxs [0] ;
+
+    for ( size_t c = 1 ; c < chunks ; ++c )
+    {
+        min = glm::min ( min , mins [c] ) ;
+        max = glm::max ( max , maxs [c] ) ;
+    }
+
+    setBoundingBox ( BoundingBox ( min , max ) ) ;
+}
+
+void ParticleEmitter::upload ()
+{
+    ResourceManagerHolder resources = ResourceManager::Get () ;
+
+    if ( resources.isInvalid() || !iCount )
+    return ;
+
+    MeshManagerHolder manager = resources -> getMeshManager () ;
+
+    if ( manager.isInvalid() )
+    return ;
+
+    const size_t vertexbytes = iCount * sizeof ( ParticleVertex ) ;
+    const size_t indexbytes = iCount * sizeof ( unsigned int ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Creates the ring the first time. Each mesh has one vertex buffer
+    // and one index buffer drawing points.
+
+    if ( iMeshes.empty () )
+    {
+        VertexDescriptor vdesc ;
+        vdesc.addComponent ( VertexAttribAlias::Position , 3 , VertexAttribType::Float , false , 3 * sizeof ( float ) ) ;
+        vdesc.addComponent ( VertexAttribAlias::Color , 4 , VertexAttribType::UnsignedByte , true , 4 * sizeof ( unsigned char ) ) ;
+
+        IndexDescriptor idesc ;
+        idesc.setMode ( IndexDrawmode::Points ) ;
+        idesc.setType ( IndexType::UnsignedInteger ) ;
+
+        for ( size_t k = 0 ; k < ParticleMeshesCount ; ++k )
+        {
+            std::string name = getName () + ".particles." + std::to_string ( k ) ;
+
+            HardwareVertexBufferHolder vbuf = manager -> createVertexBuffer ( iVertices.data () , vertexbytes , vdesc ) ;
+            HardwareIndexBufferHolder ibuf = manager -> createIndexBuffer ( iIndices.data () , indexbytes , idesc ) ;
+
+            if ( vbuf.isInvalid() || ibuf.isInvalid() )
+            {
+                GreDebug ( "[WARN] Can't create buffers for particles '" ) << name << "'." << gendl ;
+                iMeshes.clear () ;
+                return ;
+            }
+
+            vbuf -> setEnabled ( true ) ;
+            ibuf -> setEnabled ( true ) ;
+
+            MeshHolder mesh = manager -> loadBlank ( name ) ;
+
+            if ( mesh.isInvalid() )
+            {
+                iMeshes.clear () ;
+                return ;
+            }
+
+            SubMeshHolder submesh = new SubMesh ( name + ".submesh" ) ;
+            submesh -> addVertexBuffer ( vbuf ) ;
+            submesh -> setIndexBuffer ( ibuf ) ;
+            mesh -> addSubMesh ( submesh ) ;
+
+            iMeshes.push_back ( mesh ) ;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Writes the next mesh of the ring.
+
+    MeshHolder & mesh = iMeshes [iNextMesh] ;
+    iNextMesh = ( iNextMesh + 1 ) % iMeshes.size () ;
+
+    const SubMeshHolder & submesh = mesh -> getSubMeshes () .front () ;
+    HardwareVertexBufferHolder vbuf = submesh -> getVertexBuffers () .front () ;
+    HardwareIndexBufferHolder ibuf = submesh -> getIndexBuffer () ;
+
+    vbuf -> clearData () ;
+    vbuf -> addData ( reinterpret_cast < const char * > ( iVertices.data () ) , vertexbytes ) ;
+    ibuf -> clearData () ;
+    ibuf -> addData ( reinterpret_cast < const char * > ( iIndices.data () ) , indexbytes ) ;
+
+    mesh -> setBoundingBox ( getBoundingBox () ) ;
+    setMesh ( mesh ) ;
+}
+
+GreEndNamespace
@@ -0,0 +1,126 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  PipelineState.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "PipelineState.h"
+
+GreBeginNamespace
+
+CullMode CullModeFromString ( const std::string & mode )
+{
+    if ( mode == "Back" ) return CullMode::Back ;
+    if ( mode == "Front" ) return CullMode::Front ;
+    return CullMode::None ;
+}
+
+bool RasterState::operator == ( const RasterState & rhs ) const
+{
+    return depthtest == rhs.depthtest && depthwrite == rhs.depthwrite
+        && culling == rhs.culling && blending == rhs.blending ;
+}
+
+bool RasterState::operator != ( const RasterState & rhs ) const
+{
+    return !( *this == rhs ) ;
+}
+
+// -----------------------------------------------------------------------------
+// PipelineState implementation.
+
+PipelineState::PipelineState (const std::string & name ,
+                              const HardwareProgramHolder & program ,
+                              const RenderFramebufferHolder & framebuffer ,
+                              const RasterState & raster ,
+                              const std::map < VertexAttribAlias , std::string > & attribs )
+: Gre::Resource ( name )
+, iProgram ( program ) , iFramebuffer ( framebuffer ) , iRasterState ( raster ) , iLinkVersion ( 0 )
+{
+    for ( size_t i = 0 ; i < VertexAttribAliasCount ; ++i )
+    iAttribLocations [i] = -1 ;
+
+    if ( iProgram.isInvalid() )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Resolves the locations once , instead of looking for the names each
+    // time a submesh is bound.
+
+    for ( auto & attrib : attribs )
+    iAttribLocations [(size_t) attrib.first] = iProgram -> getAttribLocation ( attrib.second ) ;
+
+    iLinkVersion = iProgram -> getLinkVersion () ;
+}
+
+PipelineState::~PipelineState () noexcept ( false )
+{
+
+}
+
+const HardwareProgramHolder & PipelineState::getProgram () const
+{
+    return iProgram ;
+}
+
+const RenderFramebufferHolder & PipelineState::getFramebuffer () const
+{
+    return iFramebuffer ;
+}
+
+const RasterState & PipelineState::getRasterState () const
+{
+    return iRasterState ;
+}
+
+int PipelineState::getAttribLocation ( const VertexAttribAlias & alias ) const
+{
+    return iAttribLocations [(size_t) alias] ;
+}
+
+size_t PipelineState::getLinkVersion () const
+{
+    return iLinkVersion ;
+}
+
+bool PipelineState::isIdentical ( const PipelineState & rhs ) const
+{
+    if ( this == &rhs )
+    return true ;
+
+    if ( iProgram.getObject () != rhs.iProgram.getObject () || iFramebuffer.getObject () != rhs.iFramebuffer.getObject () )
+    return false ;
+
+    if ( iRasterState != rhs.iRasterState || iLinkVersion != rhs.iLinkVersion )
+    return false ;
+
+    return !memcmp ( iAttribLocations , rhs.iAttribLocations , sizeof ( iAttribLocations ) ) ;
+}
+
+GreEndNamespace
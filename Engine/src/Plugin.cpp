@@ -32,6 +32,7 @@
 
 #include "Plugin.h"
 #include "Platform.h"
+#include "Profiler.h"
 
 GreBeginNamespace
 
@@ -207,6 +208,7 @@ uint32_t PluginManager::loadFromBundle(const ResourceBundleHolder &bundle)
 
 PluginHolder PluginManager::loadFromBundledFile ( const std::string & path , const std::vector<std::string> & bundlepaths )
 {
+    GreProfileDetail( "PluginManager::loadFromBundledFile" , path ) ;
     GreAutolock ;
 
     // First , try to see if the given plugin has already been loaded. To do this , we look for a plugin with the same
@@ -0,0 +1,311 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  Profiler.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <sstream>
+
+GreBeginNamespace
+
+const size_t Profiler::RingSize ;
+std::atomic < bool > Profiler::iCapturing ( false ) ;
+
+//////////////////////////////////////////////////////////////////////
+// Scopes of the calling thread. Owned by the global profiler , which
+// lives longer than every thread using it.
+
+static thread_local void * ProfilerCurrentThread = nullptr ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Writes a JSON string , with quotes.
+static void ProfilerWriteJsonString ( std::ostream & stream , const std::string & value )
+{
+    stream << '"' ;
+
+    for ( char c : value )
+    {
+        switch ( c )
+        {
+            case '"' : stream << "\\\"" ; break ;
+            case '\\' : stream << "\\\\" ; break ;
+            case '\n' : stream << "\\n" ; break ;
+            case '\t' : stream << "\\t" ; break ;
+            case '\r' : stream << "\\r" ; break ;
+
+            default :
+            if ( (unsigned char) c < 0x20 ) stream << ' ' ;
+            else stream << c ;
+        }
+    }
+
+    stream << '"' ;
+}
+
+Profiler & Profiler::Get ()
+{
+    static Profiler profiler ;
+    return profiler ;
+}
+
+Profiler::Profiler ()
+: iEpoch ( std::chrono::steady_clock::now () ) , iFrame ( 0 ) , iLastFrame ( 0 )
+{
+
+}
+
+Profiler::~Profiler ()
+{
+    iCapturing.store ( false ) ;
+}
+
+void Profiler::capture ( size_t frames )
+{
+    clear () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The current frame is captured from now , then 'frames' whole frames.
+
+    iLastFrame.store ( frames ? iFrame.load () + frames + 1 : 0 ) ;
+    iCapturing.store ( true ) ;
+}
+
+void Profiler::stop ()
+{
+    iCapturing.store ( false ) ;
+}
+
+void Profiler::newFrame ()
+{
+    uint64_t frame = ++ iFrame ;
+    uint64_t last = iLastFrame.load () ;
+
+    if ( last && frame >= last )
+    {
+        iCapturing.store ( false ) ;
+        iLastFrame.store ( 0 ) ;
+    }
+}
+
+uint64_t Profiler::getFrame () const
+{
+    return iFrame.load () ;
+}
+
+void Profiler::begin ( const char * name , const std::string & detail )
+{
+    ThreadData & data = getThreadData () ;
+
+    OpenScope scope ;
+    scope.name = name ;
+    scope.detail = detail ;
+    scope.frame = iFrame.load ( std::memory_order_relaxed ) ;
+    scope.begin = now () ;
+
+    data.stack.push_back ( std::move ( scope ) ) ;
+}
+
+void Profiler::end ()
+{
+    uint64_t time = now () ;
+    ThreadData & data = getThreadData () ;
+
+    if ( data.stack.empty () )
+    return ;
+
+    OpenScope & scope = data.stack.back () ;
+
+    {
+        std::lock_guard < std::mutex > lock ( data.mutex ) ;
+
+        if ( data.ring.empty () )
+        data.ring.resize ( RingSize ) ;
+
+        ProfilerEvent & event = data.ring [data.head] ;
+        event.name = scope.name ;
+        event.detail.swap ( scope.detail ) ;
+        event.begin = scope.begin ;
+        event.end = time ;
+        event.thread = data.id ;
+        event.depth = (uint32_t) data.stack.size () - 1 ;
+        event.frame = scope.frame ;
+
+        data.head = ( data.head + 1 ) % RingSize ;
+        data.count = std::min ( data.count + 1 , RingSize ) ;
+    }
+
+    data.stack.pop_back () ;
+}
+
+void Profiler::setThreadName ( const std::string & name )
+{
+    ThreadData & data = getThreadData () ;
+
+    std::lock_guard < std::mutex > lock ( data.mutex ) ;
+    data.name = name ;
+}
+
+std::vector < ProfilerEvent > Profiler::getEvents () const
+{
+    std::vector < ProfilerEvent > events ;
+    std::lock_guard < std::mutex > lock ( iMutex ) ;
+
+    for ( const auto & data : iThreads )
+    {
+        std::lock_guard < std::mutex > threadlock ( data -> mutex ) ;
+
+        size_t first = ( data -> head + RingSize - data -> count ) % RingSize ;
+
+        for ( size_t i = 0 ; i < data -> count ; ++i )
+        events.push_back ( data -> ring [( first + i ) % RingSize] ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Scopes are recorded when they end : sorting by beginning puts parents
+    // before their children.
+
+    std::stable_sort ( events.begin () , events.end () , [] ( const ProfilerEvent & lhs , const ProfilerEvent & rhs ) {
+        if ( lhs.begin != rhs.begin ) return lhs.begin < rhs.begin ;
+        return lhs.depth < rhs.depth ;
+    });
+
+    return events ;
+}
+
+void Profiler::clear ()
+{
+    std::lock_guard < std::mutex > lock ( iMutex ) ;
+
+    for ( auto & data : iThreads )
+    {
+        std::lock_guard < std::mutex > threadlock ( data -> mutex ) ;
+
+        data -> head = 0 ;
+        data -> count = 0 ;
+    }
+}
+
+std::string Profiler::exportChromeTrace () const
+{
+    std::vector < ProfilerEvent > events = getEvents () ;
+    std::ostringstream stream ;
+
+    stream << "{\"traceEvents\":[" ;
+    bool first = true ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Names the threads first.
+
+    {
+        std::lock_guard < std::mutex > lock ( iMutex ) ;
+
+        for ( const auto & data : iThreads )
+        {
+            std::lock_guard < std::mutex > threadlock ( data -> mutex ) ;
+
+            if ( data -> name.empty () )
+            continue ;
+
+            if ( !first ) stream << ',' ;
+            first = false ;
+
+            stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << data -> id << ",\"args\":{\"name\":" ;
+            ProfilerWriteJsonString ( stream , data -> name ) ;
+            stream << "}}" ;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Scopes are complete events , in microseconds.
+
+    stream.setf ( std::ios::fixed ) ;
+    stream.precision ( 3 ) ;
+
+    for ( const ProfilerEvent & event : events )
+    {
+        if ( !first ) stream << ',' ;
+        first = false ;
+
+        std::string name = event.name ? event.name : "" ;
+
+        if ( !event.detail.empty () )
+        name += " : " + event.detail ;
+
+        stream << "{\"name\":" ;
+        ProfilerWriteJsonString ( stream , name ) ;
+        stream << ",\"cat\":\"gre\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread
+               << ",\"ts\":" << (double) event.begin / 1000.0
+               << ",\"dur\":" << (double) ( event.end - event.begin ) / 1000.0
+               << ",\"args\":{\"frame\":" << event.frame << ",\"depth\":" << event.depth << "}}" ;
+    }
+
+    stream << "],\"displayTimeUnit\":\"ms\"}" ;
+    return stream.str () ;
+}
+
+bool Profiler::saveChromeTrace ( const std::string & path ) const
+{
+    std::ofstream stream ( path , std::ios::out | std::ios::trunc ) ;
+
+    if ( !stream )
+    {
+        GreDebug ( "[WARN] Can't open file '" ) << path << "' to save the profiler trace." << gendl ;
+        return false ;
+    }
+
+    stream << exportChromeTrace () ;
+    return stream.good () ;
+}
+
+Profiler::ThreadData & Profiler::getThreadData ()
+{
+    if ( ProfilerCurrentThread )
+    return * static_cast < ThreadData * > ( ProfilerCurrentThread ) ;
+
+    std::lock_guard < std::mutex > lock ( iMutex ) ;
+
+    ThreadData * data = new ThreadData () ;
+    data -> id = (uint32_t) iThreads.size () ;
+    data -> head = 0 ;
+    data -> count = 0 ;
+
+    iThreads.push_back ( std::unique_ptr < ThreadData > ( data ) ) ;
+    ProfilerCurrentThread = data ;
+    return * data ;
+}
+
+uint64_t Profiler::now () const
+{
+    return (uint64_t) std::chrono::duration_cast < std::chrono::nanoseconds > ( std::chrono::steady_clock::now () - iEpoch ) .count () ;
+}
+
+GreEndNamespace
@@ -35,11 +35,20 @@ THE SOFTWARE.
 
 GreBeginNamespace
 
+//////////////////////////////////////////////////////////////////////
+/// @brief Source of visibility versions. Shared by every nodes , so a node
+/// created where a destroyed one was never has the same version.
+static std::atomic < uint64_t > NodeVisibilityVersion ( 0 ) ;
+
 RenderNode::RenderNode ( const RenderScene * creator , const std::string & name )
 : Gre::Renderable ( name )
 , iCreator ( creator )
 , iParent ( nullptr ) , iMesh ( nullptr )
 , iMaterial ( nullptr ) , iEmissiveMaterial ( nullptr )
+, iLightRadius ( 0.0f )
+, iOccluder ( false ) , iShadowCaster ( true )
+, iStatic ( false ) , iBatched ( false )
+, iLodLevel ( 0 ) , iLodHysteresis ( 0.1f )
 , iPosition ( 0.0f , 0.0f , 0.0f )
 , iTarget ( 0.0f , 0.0f , 1.0f )
 , iScale ( 1.0f , 1.0f , 1.0f )
@@ -51,6 +60,7 @@ RenderNode::RenderNode ( const RenderScene * creator , const std::string & name
 , iBoundingboxDirty ( false )
 , iManualBoundingBox ( false )
 , iActiveViewMatrix ( false )
+, iVisibilityVersion ( ++NodeVisibilityVersion )
 {
 
 }
@@ -98,6 +108,10 @@ bool RenderNode::add ( RenderNodeHolder & node )
         node -> iParent = RenderNodeHolder ( this ) ;
         iChildren.push_back( node ) ;
         addFilteredListener( node , { EventType::Update } ) ;
+
+        if ( iCreator )
+        const_cast<RenderScene*>(iCreator) -> attach ( this , node ) ;
+
         return true ;
     }
 
@@ -123,6 +137,10 @@ bool RenderNode::add ( RenderNodeHolder & node )
     node -> iParent = RenderNodeHolder ( this ) ;
     iChildren.push_back ( node ) ;
     addFilteredListener ( node , { EventType::Update } ) ;
+
+    if ( iCreator )
+    const_cast<RenderScene*>(iCreator) -> attach ( this , node ) ;
+
     return true ;
 }
 
@@ -141,6 +159,9 @@ bool RenderNode::remove ( RenderNodeHolder & node )
 
     if ( it != iChildren.end() )
     {
+        if ( iCreator )
+        const_cast<RenderScene*>(iCreator) -> detach ( *it ) ;
+
         (*it) -> iParent = nullptr ;
         removeListener ( *it ) ;
         iChildren.erase ( it ) ;
@@ -171,6 +192,9 @@ void RenderNode::clearChildren ()
 
     for ( auto & child : iChildren )
     {
+        if ( iCreator )
+        const_cast<RenderScene*>(iCreator) -> detach ( child ) ;
+
         child -> iParent = nullptr ;
         removeListener ( child ) ;
     }
@@ -195,6 +219,8 @@ void RenderNode::setMesh ( const MeshHolder & mesh )
 
     if ( !iManualBoundingBox )
     iBoundingboxDirty = true ;
+
+    updateDrawable () ;
 }
 
 const MaterialHolder & RenderNode::getMaterial () const
@@ -204,7 +230,10 @@ const MaterialHolder & RenderNode::getMaterial () const
 
 void RenderNode::setMaterial ( const MaterialHolder & material )
 {
-    GreAutolock ; iMaterial = material ;
+    GreAutolock ;
+
+    iMaterial = material ;
+    updateDrawable () ;
 }
 
 const MaterialHolder & RenderNode::getEmissiveMaterial () const
@@ -214,7 +243,162 @@ const MaterialHolder & RenderNode::getEmissiveMaterial () const
 
 void RenderNode::setEmissiveMaterial ( const MaterialHolder & material )
 {
-    GreAutolock ; iEmissiveMaterial = material ;
+    GreAutolock ;
+
+    iEmissiveMaterial = material ;
+    updateProxy () ;
+}
+
+float RenderNode::getLightRadius () const
+{
+    GreAutolock ; return iLightRadius ;
+}
+
+void RenderNode::setLightRadius ( float radius )
+{
+    GreAutolock ;
+
+    iLightRadius = radius ;
+    updateProxy () ;
+}
+
+bool RenderNode::illuminates ( const BoundingBox & bbox ) const
+{
+    GreAutolock ;
+
+    if ( iEmissiveMaterial.isInvalid() )
+    return false ;
+
+    if ( iLightRadius <= 0.0f || bbox.isInvalid() )
+    return true ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Distance from the light position to the closest point of the box ,
+    // compared to the light radius.
+
+    Vector3 closest = glm::min ( glm::max ( iPosition , bbox.getMin() ) , bbox.getMax() ) ;
+    Vector3 delta = closest - iPosition ;
+
+    return glm::dot ( delta , delta ) <= iLightRadius * iLightRadius ;
+}
+
+bool RenderNode::isOccluder () const
+{
+    GreAutolock ; return iOccluder ;
+}
+
+void RenderNode::setOccluder ( bool value )
+{
+    GreAutolock ; iOccluder = value ;
+}
+
+bool RenderNode::isShadowCaster () const
+{
+    GreAutolock ; return iShadowCaster ;
+}
+
+void RenderNode::setShadowCaster ( bool value )
+{
+    GreAutolock ;
+
+    iShadowCaster = value ;
+    updateProxy () ;
+}
+
+bool RenderNode::isStatic () const
+{
+    GreAutolock ; return iStatic ;
+}
+
+void RenderNode::setStatic ( bool value )
+{
+    GreAutolock ;
+
+    iStatic = value ;
+    updateProxy () ;
+}
+
+bool RenderNode::isBatched () const
+{
+    GreAutolock ; return iBatched ;
+}
+
+void RenderNode::setBatched ( bool value )
+{
+    GreAutolock ;
+
+    if ( iBatched != value )
+    {
+        iBatched = value ;
+        iVisibilityVersion = ++NodeVisibilityVersion ;
+        updateProxy () ;
+    }
+}
+
+size_t RenderNode::getLodLevel () const
+{
+    GreAutolock ; return iLodLevel ;
+}
+
+size_t RenderNode::updateLod ( const Vector3 & camera , float projscale )
+{
+    GreAutolock ;
+
+    iLodLevel = SelectLod ( iMesh , iBoundingBox , iLodLevel , iLodHysteresis , camera , projscale ) ;
+    return iLodLevel ;
+}
+
+size_t RenderNode::SelectLod ( const MeshHolder & mesh , const BoundingBox & bbox , size_t current ,
+                               float hysteresis , const Vector3 & camera , float projscale )
+{
+    if ( mesh.isInvalid() || bbox.isInvalid() )
+    return 0 ;
+
+    size_t count = mesh -> getLodCount () ;
+
+    if ( count <= 1 )
+    return 0 ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Projected size of the bounding sphere. A camera inside the sphere
+    // always uses the full detail.
+
+    Vector3 center = ( bbox.getMin() + bbox.getMax() ) * 0.5f ;
+    float radius = glm::length ( bbox.getMax() - bbox.getMin() ) * 0.5f ;
+    float distance = glm::length ( center - camera ) ;
+
+    if ( distance <= radius )
+    return 0 ;
+
+    float size = radius * projscale / distance ;
+
+    //////////////////////////////////////////////////////////////////////
+    // A level coarser than the current one must be reached by going below
+    // its threshold minus the hysteresis , and a finer one by going above
+    // its threshold plus the hysteresis.
+
+    size_t level = 0 ;
+
+    for ( size_t i = 1 ; i < count ; ++i )
+    {
+        float threshold = mesh -> getLodScreenSize ( i ) ;
+        threshold *= i > current ? 1.0f - hysteresis : 1.0f + hysteresis ;
+
+        if ( size < threshold )
+        level = i ;
+    }
+
+    return level ;
+}
+
+float RenderNode::getLodHysteresis () const
+{
+    GreAutolock ; return iLodHysteresis ;
+}
+
+void RenderNode::setLodHysteresis ( float value )
+{
+    GreAutolock ; iLodHysteresis = value ;
 }
 
 void RenderNode::translate ( const Vector3 & direction )
@@ -332,6 +516,8 @@ void RenderNode::setBoundingBox ( const BoundingBox & bbox )
     iBoundingBox = bbox ;
     iManualBoundingBox = true ;
     iBoundingboxDirty = true ;
+    iVisibilityVersion = ++NodeVisibilityVersion ;
+    updateProxy () ;
 }
 
 bool RenderNode::isManualBoundingBox () const
@@ -376,6 +562,13 @@ void RenderNode::update ()
         recalculateparent = true ;
     }
 
+    //////////////////////////////////////////////////////////////////////
+    // A manual bounding box is already set , but the node must still be
+    // moved in the scene tree.
+
+    else if ( iBoundingboxDirty )
+    recalculateparent = true ;
+
     iBoundingboxDirty = false ;
 
     //////////////////////////////////////////////////////////////////////
@@ -425,11 +618,16 @@ void RenderNode::update ()
         recalculateparent = true ;
     }
 
+    if ( recalculateparent )
+    {
+        iVisibilityVersion = ++NodeVisibilityVersion ;
+        updateProxy () ;
+    }
+
     if ( recalculateparent && iCreator && !iParent.isInvalid() )
     {
         RenderNodeHolder thisnode (this) ;
-        const_cast<RenderScene*>(iCreator) -> remove ( thisnode ) ;
-        const_cast<RenderScene*>(iCreator) -> add ( thisnode ) ;
+        const_cast<RenderScene*>(iCreator) -> relocate ( thisnode ) ;
     }
 }
 
@@ -440,28 +638,93 @@ void RenderNode::sort ( const Matrix4 & projectionview , RenderNodeHolderList &
     for ( auto & child : iChildren )
     child -> sort ( projectionview , result ) ;
 
-    if ( iBoundingBox.isInvalid() )
-    return ;
+    if ( isVisible ( projectionview ) )
+    result.push_back ( RenderNodeHolder(this) ) ;
+}
+
+bool RenderNode::isVisible ( const Matrix4 & projectionview ) const
+{
+    GreAutolock ;
+
+    if ( iBoundingBox.isInvalid() || iBatched )
+    return false ;
 
     float diameter = iBoundingBox.diameterlen () ;
     Vector4 center = Vector4 ( iBoundingBox.center () , 1.0f ) ;
 
     Vector4 coords = glm::normalize ( projectionview * iModelMatrix * center ) ;
 
-    if ( coords.z < -diameter ) return ;
-    if ( fabsf(coords.x) > 1 + diameter || fabsf(coords.y) > 1 + diameter ) return ;
-    result.push_back ( RenderNodeHolder(this) ) ;
+    if ( coords.z < -diameter ) return false ;
+    if ( fabsf(coords.x) > 1 + diameter || fabsf(coords.y) > 1 + diameter ) return false ;
+    return true ;
+}
+
+uint64_t RenderNode::getVisibilityVersion () const
+{
+    GreAutolock ; return iVisibilityVersion ;
 }
 
-void RenderNode::lights ( const Matrix4 & projectionview , RenderNodeHolderList & result ) const
+void RenderNode::snapshot ( RenderSnapshot & snapshot ) const
 {
     GreAutolock ;
 
-    for ( auto & child : iChildren )
-    child -> lights ( projectionview , result ) ;
+    if ( !iMesh.isInvalid() && !iBoundingBox.isInvalid() && !iBatched )
+    {
+        RenderSnapshotItem item ;
+        item.node = this ;
+        item.mesh = iMesh ;
+        item.material = iMaterial ;
+        item.model = iModelMatrix ;
+        item.bbox = iBoundingBox ;
+        item.lod = iLodLevel ;
+        item.lodhysteresis = iLodHysteresis ;
+        item.caster = iShadowCaster ;
+        snapshot.items.push_back ( item ) ;
+    }
 
     if ( !iEmissiveMaterial.isInvalid() )
-    result.push_back ( RenderNodeHolder(this) ) ;
+    {
+        RenderSnapshotLight light ;
+        light.node = this ;
+        light.material = iEmissiveMaterial ;
+        light.position = iPosition ;
+        light.direction = iForwardDirection ;
+        light.view = iViewMatrix ;
+        light.radius = iLightRadius ;
+        snapshot.lights.push_back ( light ) ;
+    }
+
+    if ( iActiveViewMatrix )
+    {
+        RenderSnapshotCamera camera ;
+        camera.node = this ;
+        camera.position = iPosition ;
+        camera.direction = iForwardDirection ;
+        camera.view = iViewMatrix ;
+        snapshot.cameras.push_back ( camera ) ;
+    }
+}
+
+void RenderNode::updateProxy () const
+{
+    if ( iCreator )
+    const_cast<RenderScene*>(iCreator) -> updateProxy ( this ) ;
+}
+
+void RenderNode::updateDrawable ()
+{
+    iVisibilityVersion = ++NodeVisibilityVersion ;
+    updateProxy () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Batches hold a copy of the static nodes' geometry , grouped by
+    // material : the node must leave its chunk and be merged again.
+
+    if ( iStatic && iCreator && !iParent.isInvalid() )
+    {
+        RenderNodeHolder thisnode ( this ) ;
+        const_cast<RenderScene*>(iCreator) -> relocate ( thisnode ) ;
+    }
 }
 
 const Matrix4 & RenderNode::getViewMatrix () const
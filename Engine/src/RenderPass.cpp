@@ -32,11 +32,19 @@
 
 #include "RenderPass.h"
 #include "Renderer.h"
+#include "LightAssignment.h"
+#include "JobPool.h"
+#include "ResourceManager.h"
+#include "RenderStatistics.h"
 
 GreBeginNamespace
 
 RenderPass::RenderPass ( const std::string & name )
 : Gre::Renderable ( name )
+, iOcclusionCulling ( false )
+, iShadowPass ( false ) , iShadowCasters ( 0 ) , iShadowLight ( nullptr )
+, iShadowCaching ( false ) , iShadowCache ( nullptr )
+, iShadowCacheValid ( false ) , iShadowCacheVersion ( 0 )
 {
 
 }
@@ -48,7 +56,10 @@ RenderPass::~RenderPass () noexcept ( false )
 
 void RenderPass::setScene ( const RenderSceneHolder & scene )
 {
-    GreAutolock ; iScene = scene ;
+    GreAutolock ;
+
+    iScene = scene ;
+    iShadowCacheValid = false ;
 }
 
 const RenderSceneHolder & RenderPass::getScene () const
@@ -82,6 +93,13 @@ void RenderPass::use ( const TechniqueHolder & technique ) const
             if ( !param.isInvalid() )
             param -> use ( technique ) ;
         }
+
+        //////////////////////////////////////////////////////////////////////
+        // Targets read by this pass are bound as any aliased texture.
+
+        for ( const auto & read : iReads )
+        if ( !read.texture.isInvalid() )
+        technique -> setAliasedTexture ( read.alias , read.texture ) ;
     }
 
     TechniqueParamBinder::use(technique);
@@ -101,6 +119,18 @@ void RenderPass::render ( const Renderer * renderer ) const
 {
     GreAutolock ;
 
+    const RenderSnapshot * snapshot = nullptr ;
+
+    if ( !iScene.isInvalid() && iScene -> isSnapshotEnabled () )
+    snapshot = iScene -> acquireSnapshot () ;
+
+    render ( renderer , snapshot ) ;
+}
+
+void RenderPass::render ( const Renderer * renderer , const RenderSnapshot * snapshot ) const
+{
+    GreAutolock ;
+
     if ( renderer && !iTechnique.isInvalid() )
     {
         //////////////////////////////////////////////////////////////////////
@@ -108,18 +138,22 @@ void RenderPass::render ( const Renderer * renderer ) const
         // binding to be draw by the renderer.
 
         for ( auto tech : iPreProcessTechniques )
-        renderTechnique ( renderer , tech ) ;
+        renderTechnique ( renderer , tech , snapshot ) ;
 
         //////////////////////////////////////////////////////////////////////
-        // Uses the main technique.
+        // Uses the main technique , drawing to the targets written by this
+        // pass.
+
+        if ( !iWrites.empty() )
+        attachTargets ( renderer , iTechnique ) ;
 
-        renderTechnique ( renderer , iTechnique ) ;
+        renderTechnique ( renderer , iTechnique , snapshot ) ;
 
         //////////////////////////////////////////////////////////////////////
         // Uses postprocessing techniques.
 
         for ( auto tech : iPostProcessTechniques )
-        renderTechnique ( renderer , tech ) ;
+        renderTechnique ( renderer , tech , snapshot ) ;
     }
 }
 
@@ -133,7 +167,234 @@ const std::vector < RenderableHolder > & RenderPass::getSelfUsedRenderables () c
     GreAutolock ; return iSelfUsedParams ;
 }
 
-void RenderPass::renderTechnique(const Gre::Renderer *renderer, const TechniqueHolder &technique) const
+void RenderPass::setOcclusionCulling ( bool value )
+{
+    GreAutolock ; iOcclusionCulling = value ;
+}
+
+bool RenderPass::isOcclusionCulling () const
+{
+    GreAutolock ; return iOcclusionCulling ;
+}
+
+const OcclusionStats & RenderPass::getOcclusionStats () const
+{
+    GreAutolock ; return iOcclusionStats ;
+}
+
+void RenderPass::setShadowPass ( bool value )
+{
+    GreAutolock ; iShadowPass = value ;
+}
+
+bool RenderPass::isShadowPass () const
+{
+    GreAutolock ; return iShadowPass ;
+}
+
+void RenderPass::setShadowLight ( const RenderNodeHolder & light )
+{
+    GreAutolock ;
+
+    iShadowLight = light ;
+    iShadowCacheValid = false ;
+}
+
+const RenderNodeHolder & RenderPass::getShadowLight () const
+{
+    GreAutolock ; return iShadowLight ;
+}
+
+size_t RenderPass::getShadowCastersCount () const
+{
+    GreAutolock ; return iShadowCasters ;
+}
+
+void RenderPass::setShadowCaching ( bool value )
+{
+    GreAutolock ;
+
+    iShadowCaching = value ;
+    iShadowCacheValid = false ;
+}
+
+bool RenderPass::isShadowCaching () const
+{
+    GreAutolock ; return iShadowCaching ;
+}
+
+void RenderPass::invalidateShadowCache ()
+{
+    GreAutolock ; iShadowCacheValid = false ;
+}
+
+const MatrixCache & RenderPass::getMatrixCache () const
+{
+    GreAutolock ; return iMatrices ;
+}
+
+void RenderPass::addRead ( const std::string & target , const TechniqueParam & alias )
+{
+    GreAutolock ;
+
+    RenderPassTarget read ;
+    read.name = target ;
+    read.alias = alias ;
+    read.attachment = RenderFramebufferAttachement::Null ;
+
+    iReads.push_back ( read ) ;
+}
+
+void RenderPass::addWrite ( const std::string & target , const RenderFramebufferAttachement & attachment )
+{
+    GreAutolock ;
+
+    RenderPassTarget write ;
+    write.name = target ;
+    write.alias = TechniqueParam::None ;
+    write.attachment = attachment ;
+
+    iWrites.push_back ( write ) ;
+}
+
+void RenderPass::clearTargets ()
+{
+    GreAutolock ;
+
+    iReads.clear () ;
+    iWrites.clear () ;
+}
+
+const std::vector < RenderPassTarget > & RenderPass::getReads () const
+{
+    GreAutolock ; return iReads ;
+}
+
+const std::vector < RenderPassTarget > & RenderPass::getWrites () const
+{
+    GreAutolock ; return iWrites ;
+}
+
+void RenderPass::setTargetTexture ( const std::string & target , const TextureHolder & texture ) const
+{
+    GreAutolock ;
+
+    for ( const auto & read : iReads )
+    if ( read.name == target )
+    read.texture = texture ;
+
+    for ( const auto & write : iWrites )
+    if ( write.name == target )
+    write.texture = texture ;
+}
+
+void RenderPass::attachTargets ( const Renderer * renderer , const TechniqueHolder & technique ) const
+{
+    if ( technique.isInvalid() )
+    return ;
+
+    RenderFramebufferHolder framebuffer = technique -> getFramebuffer () ;
+
+    if ( framebuffer.isInvalid() )
+    return ;
+
+    auto framebuffers = ResourceManager::Get () -> getFramebufferManager () ;
+
+    if ( !framebuffers.isInvalid() && framebuffers -> getNull () .getObject () == framebuffer.getObject () )
+    {
+        GreDebug ( "[WARN] Pass '" ) << getName () << "' writes targets with the default framebuffer." << gendl ;
+        return ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // The framebuffer is bound here without the renderer : the bound state
+    // is forgotten , so the technique binds its framebuffer again.
+
+    renderer -> unbindPipelineState () ;
+    framebuffer -> bind () ;
+
+    for ( const auto & write : iWrites )
+    if ( !write.texture.isInvalid() )
+    framebuffer -> setAttachment ( write.attachment , write.texture ) ;
+
+    framebuffer -> unbind () ;
+}
+
+void RenderPass::cullOccludedNodes ( const Matrix4 & projectionview , RenderNodeHolderList & nodes ) const
+{
+    GreAutolock ;
+
+    iOcclusionStats = OcclusionStats () ;
+    iOcclusionBuffer.clear ( projectionview ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Rasterizes visible occluders. Meshes without a CPU copy of their
+    // vertices are skipped : their bounding box covers more than the mesh ,
+    // and would hide nodes seen through it.
+
+    std::vector < RenderNode * > candidates ;
+
+    for ( auto & node : nodes )
+    {
+        if ( node.isInvalid() )
+        continue ;
+
+        if ( !node -> isOccluder() )
+        {
+            candidates.push_back ( node.getObject() ) ;
+            continue ;
+        }
+
+        if ( iOcclusionBuffer.addMesh ( node -> getMesh () , node -> getModelMatrix () ) )
+        iOcclusionStats.occluders ++ ;
+    }
+
+    if ( !iOcclusionStats.occluders || candidates.empty() )
+    return ;
+
+    iOcclusionBuffer.rasterize () ;
+    iOcclusionStats.triangles = iOcclusionBuffer.getTrianglesCount () ;
+    iOcclusionStats.tested = candidates.size () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Tests the other nodes' bounding boxes on the JobPool. The buffer is
+    // only read here.
+
+    std::vector < char > visible ( candidates.size () , 1 ) ;
+
+    JobPool::Get () .parallelFor ( candidates.size () , 64 , [&] ( size_t begin , size_t end )
+    {
+        for ( size_t i = begin ; i < end ; ++i )
+        visible [i] = iOcclusionBuffer.isVisible ( candidates[i] -> getBoundingBox () ) ? 1 : 0 ;
+    });
+
+    //////////////////////////////////////////////////////////////////////
+    // Candidates were collected in the list order , so a second walk finds
+    // them at the same index.
+
+    size_t index = 0 ;
+
+    for ( auto it = nodes.begin () ; it != nodes.end () ; )
+    {
+        if ( it -> isInvalid() || (*it) -> isOccluder() )
+        {
+            ++ it ;
+            continue ;
+        }
+
+        if ( !visible [index++] )
+        {
+            it = nodes.erase ( it ) ;
+            iOcclusionStats.culled ++ ;
+            RenderStatistics::CountNodes ( 0 , 1 ) ;
+        }
+
+        else
+        ++ it ;
+    }
+}
+
+void RenderPass::renderTechnique(const Gre::Renderer *renderer, const TechniqueHolder &technique, const RenderSnapshot *snapshot) const
 {
     if ( technique.isInvalid() )
     return ;
@@ -151,14 +412,14 @@ void RenderPass::renderTechnique(const Gre::Renderer *renderer, const TechniqueH
     if ( framebuffer.isInvalid() )
     return ;
 
-    technique -> bind () ;
+    technique -> bind ( renderer ) ;
 
     Surface ctxtsurf = renderer -> getRenderContextSurface () ;
     Surface viewsurf = framebuffer -> getViewport().makeSurface( ctxtsurf ) ;
 
     if ( viewsurf.isZero() )
     {
-        technique -> unbind () ;
+        technique -> unbind ( renderer ) ;
         return ;
     }
 
@@ -185,7 +446,24 @@ void RenderPass::renderTechnique(const Gre::Renderer *renderer, const TechniqueH
         if ( iCamera.isInvalid() )
         {
             technique -> reset () ;
-            technique -> unbind () ;
+            technique -> unbind ( renderer ) ;
+            return ;
+        }
+
+        //////////////////////////////////////////////////////////////////////
+        // When the scene publishes snapshots , the one of the frame is drawn
+        // instead of the nodes , which the update thread may be modifying.
+
+        if ( !iScene.isInvalid() && iScene -> isSnapshotEnabled () )
+        {
+            if ( snapshot && iShadowPass )
+            renderSnapshotShadowCasters ( renderer , technique , *snapshot ) ;
+
+            else if ( snapshot )
+            renderSnapshot ( renderer , technique , *snapshot ) ;
+
+            technique -> reset () ;
+            technique -> unbind ( renderer ) ;
             return ;
         }
 
@@ -193,31 +471,63 @@ void RenderPass::renderTechnique(const Gre::Renderer *renderer, const TechniqueH
         const Matrix4 & projection = technique -> getProjectionMatrix () ;
         const Matrix4 viewprojection = projection * view ;
 
-        technique -> setAliasedParameterValue ( TechniqueParam::CameraPosition , HdwProgVarType::Float3 , iCamera -> getPosition() ) ;
-        technique -> setAliasedParameterValue ( TechniqueParam::CameraDirection , HdwProgVarType::Float3 , iCamera -> getDirection() ) ;
-        technique -> setAliasedParameterValue ( TechniqueParam::ProjectionMatrix , HdwProgVarType::Matrix4 , projection ) ;
-        technique -> setAliasedParameterValue ( TechniqueParam::ViewMatrix , HdwProgVarType::Matrix4 , view ) ;
-        technique -> setAliasedParameterValue ( TechniqueParam::ProjectionViewMatrix , HdwProgVarType::Matrix4 , viewprojection ) ;
+        setCameraUniforms ( technique , iCamera -> getPosition() , iCamera -> getDirection() , view , projection , viewprojection ) ;
+
+        iMatrices.begin ( view , projection ) ;
+
+        if ( iShadowPass && !iScene.isInvalid() )
+        {
+            renderShadowCasters ( renderer , technique ) ;
+            technique -> reset () ;
+            technique -> unbind ( renderer ) ;
+            return ;
+        }
 
         RenderNodeHolderList nodes ;
         RenderNodeHolderList lights ;
+        LightAssignment assignment ;
 
         if ( !iScene.isInvalid() )
         {
+            //////////////////////////////////////////////////////////////////////
+            // Lights are culled against the view frustum once , then cached by the
+            // assignment to give each node its own bounded light list.
+
             if ( technique->getLightingMode() != TechniqueLightingMode::None )
-            lights = iScene -> lights ( viewprojection ) ;
+            {
+                lights = iScene -> lights ( viewprojection ) ;
+                assignment.prepare ( lights , technique -> getMaximumLights () ) ;
+            }
 
             nodes = iScene -> sort ( viewprojection ) ;
+
+            if ( iOcclusionCulling )
+            cullOccludedNodes ( viewprojection , nodes ) ;
+
+            iMatrices.prepare ( nodes ) ;
+
             iScene -> use ( technique ) ;
         }
 
+        RenderNodeHolderList nodelights ;
+
         if ( !nodes.empty() )
         {
             //////////////////////////////////////////////////////////////////////
             // For each nodes , bind lights , bind material , draw it with renderer.
-            //GreDebug ( "[WARN] :: SIZE = " ) << nodes.size () << gendl ;
+            // Only the lights reaching the node's bounding box are bound , and
+            // the mesh is drawn at the level of detail fitting its screen size.
+
+            const Vector3 & camera = iCamera -> getPosition () ;
+
             for ( auto node : nodes )
-            renderTechniqueWithNodeAndLights ( renderer , technique , node , lights ) ;
+            {
+                node -> updateLod ( camera , projection[1][1] ) ;
+
+                nodelights.clear () ;
+                assignment.assign ( node -> getBoundingBox () , nodelights ) ;
+                renderTechniqueWithNodeAndLights ( renderer , technique , node , nodelights ) ;
+            }
         }
 
         else
@@ -226,7 +536,8 @@ void RenderPass::renderTechnique(const Gre::Renderer *renderer, const TechniqueH
             //////////////////////////////////////////////////////////////////////
             // Depending on lighting mode , bind lights and call technique.
 
-            renderTechniqueWithLights ( renderer , technique , RenderNodeHolder ( nullptr ) , lights ) ;
+            assignment.assign ( BoundingBox () , nodelights ) ;
+            renderTechniqueWithLights ( renderer , technique , RenderNodeHolder ( nullptr ) , nodelights ) ;
         }
 
     }
@@ -236,7 +547,169 @@ void RenderPass::renderTechnique(const Gre::Renderer *renderer, const TechniqueH
     // and textures counter.
 
     technique -> reset () ;
-    technique -> unbind () ;
+    technique -> unbind ( renderer ) ;
+}
+
+void RenderPass::renderShadowCasters ( const Renderer * renderer ,
+                                       const TechniqueHolder & technique ) const
+{
+    iShadowCasters = 0 ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The shadow map holds the depth seen by one light only : the shadow
+    // light , or the first light of the scene. Lights are not culled by the
+    // camera : casters are culled by the light's own frustum.
+
+    std::vector < const RenderNode * > lights ;
+    iScene -> lights ( lights ) ;
+
+    RenderNodeHolder light ( nullptr ) ;
+
+    for ( const RenderNode * candidate : lights )
+    {
+        if ( iShadowLight.isInvalid() || candidate == iShadowLight.getObject () )
+        {
+            light = RenderNodeHolder ( candidate ) ;
+            break ;
+        }
+    }
+
+    if ( light.isInvalid() )
+    return ;
+
+    iScene -> use ( technique ) ;
+
+    const RenderFramebufferHolder & framebuffer = technique -> getFramebuffer () ;
+
+    if ( !iShadowCaching || !prepareShadowCache ( framebuffer ) )
+    {
+        drawShadowCasters ( renderer , technique , light , ShadowCasterFilter::All ) ;
+        return ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // The cache is valid while no static node changed and the light has
+    // the same projection-view matrix.
+
+    const Matrix4 lightmatrix = technique -> getProjectionMatrix () * light -> getViewMatrix () ;
+
+    bool valid = iShadowCacheValid
+              && iShadowCacheVersion == iScene -> getStaticVersion ()
+              && iShadowCacheLight == lightmatrix ;
+
+    //////////////////////////////////////////////////////////////////////
+    // When valid , the static depth is copied from the cache. Else static
+    // casters are drawn and copied to the cache. The version is read after
+    // drawing , as static batches may have been built meanwhile.
+
+    if ( valid )
+    valid = framebuffer -> copy ( *iShadowCache.getObject () , RenderFramebufferAttachement::Depth ) ;
+
+    if ( !valid )
+    {
+        drawShadowCasters ( renderer , technique , light , ShadowCasterFilter::Static ) ;
+
+        iShadowCacheValid = iShadowCache -> copy ( *framebuffer.getObject () , RenderFramebufferAttachement::Depth ) ;
+        iShadowCacheVersion = iScene -> getStaticVersion () ;
+        iShadowCacheLight = lightmatrix ;
+
+        if ( !iShadowCacheValid )
+        GreDebug ( "[WARN] Shadow cache of pass '" ) << getName () << "' can't be copied." << gendl ;
+    }
+
+    drawShadowCasters ( renderer , technique , light , ShadowCasterFilter::Dynamic ) ;
+}
+
+void RenderPass::drawShadowCasters ( const Renderer * renderer ,
+                                     const TechniqueHolder & technique ,
+                                     const RenderNodeHolder & light ,
+                                     ShadowCasterFilter filter ) const
+{
+    //////////////////////////////////////////////////////////////////////
+    // The light draws the casters it sees , with its own view matrix bound
+    // as the camera's one.
+
+    const Matrix4 & projection = technique -> getProjectionMatrix () ;
+    const Matrix4 & view = light -> getViewMatrix () ;
+    const Matrix4 lightprojectionview = projection * view ;
+
+    setCameraUniforms ( technique , light -> getPosition() , light -> getDirection() , view , projection , lightprojectionview ) ;
+
+    iCasters.clear () ;
+    iScene -> casters ( lightprojectionview , iCasters , filter ) ;
+
+    iMatrices.begin ( view , projection ) ;
+    iMatrices.prepare ( iCasters ) ;
+
+    RenderNodeHolderList nodelights ;
+    nodelights.push_back ( light ) ;
+
+    for ( const RenderNode * caster : iCasters )
+    renderTechniqueWithNodeAndLights ( renderer , technique , RenderNodeHolder ( caster ) , nodelights ) ;
+
+    iShadowCasters += iCasters.size () ;
+}
+
+bool RenderPass::prepareShadowCache ( const RenderFramebufferHolder & framebuffer ) const
+{
+    if ( !iShadowCache.isInvalid() )
+    return true ;
+
+    if ( framebuffer.isInvalid() )
+    return false ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The cache texture is made like the framebuffer's depth texture , so
+    // depth can be copied from one to the other.
+
+    const TextureHolder & depth = framebuffer -> getAttachment ( RenderFramebufferAttachement::Depth ) .texture ;
+
+    if ( depth.isInvalid() || depth -> getPixelBuffer () .isInvalid() )
+    {
+        GreDebug ( "[WARN] Pass '" ) << getName () << "' has no depth texture to cache." << gendl ;
+        return false ;
+    }
+
+    auto textures = ResourceManager::Get () -> getTextureManager () ;
+    auto framebuffers = ResourceManager::Get () -> getFramebufferManager () ;
+
+    if ( textures.isInvalid() || framebuffers.isInvalid() )
+    return false ;
+
+    const SoftwarePixelBufferHolder pixels = depth -> getPixelBuffer () ;
+    const Surface & surface = pixels -> getSurface () ;
+    size_t psize = PixelFormatGetCount ( pixels -> getPixelFormat () ) * PixelTypeGetSize ( pixels -> getPixelType () ) ;
+
+    TextureHolder cachetexture = textures -> loadFromNewPixelBuffer ( getName () + ".shadowcache.depth" ,
+                                                                     surface.width , surface.height , pixels -> getDepth () ,
+                                                                     pixels -> getPixelFormat () ,
+                                                                     pixels -> getInternalPixelFormat () ,
+                                                                     pixels -> getPixelType () ,
+                                                                     depth -> getType () , (int) psize ) ;
+
+    if ( cachetexture.isInvalid() )
+    return false ;
+
+    RenderFramebufferHolder cache = framebuffers -> loadBlank ( getName () + ".shadowcache" ) ;
+
+    if ( cache.isInvalid() )
+    return false ;
+
+    cache -> bind () ;
+    cache -> setAttachment ( RenderFramebufferAttachement::Depth , cachetexture ) ;
+    cache -> setViewport ( framebuffer -> getViewport () ) ;
+    cache -> setReadBuffer ( RenderColorBuffer::None ) ;
+    cache -> setWriteBuffer ( RenderColorBuffer::None ) ;
+    cache -> unbind () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The technique's framebuffer was bound before : binds it again.
+
+    framebuffer -> bind () ;
+
+    iShadowCache = cache ;
+    iShadowCacheValid = false ;
+    return true ;
 }
 
 void RenderPass::renderTechniqueWithNodeAndLights (const Renderer* renderer ,
@@ -252,37 +725,35 @@ void RenderPass::renderTechniqueWithNodeAndLights (const Renderer* renderer ,
 
     //////////////////////////////////////////////////////////////////////
     // If node is not invalid , see if it has preprocessing techniques. If
-    // this is the case , we unbind the current technique and binds the
-    // preprocessed technique , making a rendering exclusively for the current
-    // node.
+    // this is the case , each preprocessing technique binds its pipeline state ,
+    // making a rendering exclusively for the current node , and the current
+    // technique binds its own again.
 
     auto preprocess = node -> getPreProcessTechniques () ;
 
-    if ( !preprocess.empty() )
-    technique -> unbind () ;
-
     for ( auto tech : preprocess )
     renderTechniqueWithNode ( renderer , tech , node , lights ) ;
 
     if ( !preprocess.empty() )
     {
-        technique -> bind () ;
+        technique -> bind ( renderer ) ;
         renderer -> setViewport ( technique->getFramebuffer()->getViewport() ) ;
     }
 
     //////////////////////////////////////////////////////////////////////
-    // As we also need to make the 'NormalMatrix' parameter , we should calculate
-    // it here and directly sets it to the technique.
+    // Node matrices come from the cache prepared for the current camera.
+    // Pre and post processing techniques may have another projection : only
+    // the last product is computed for them.
 
     if ( !iCamera.isInvalid() )
     {
-        const Matrix4 & view = iCamera -> getViewMatrix () ;
-        const Matrix4 & model = node -> getModelMatrix () ;
-        const Matrix4 modelview = model * view ;
-        const Matrix3 normal = glm::transpose(glm::inverse( Matrix3(modelview) )) ;
+        const NodeMatrices & matrices = iMatrices.get ( node.getObject () ) ;
+        const Matrix4 & projection = technique -> getProjectionMatrix () ;
 
-        technique -> setAliasedParameterValue ( TechniqueParam::ModelMatrix , HdwProgVarType::Matrix4 , model ) ;
-        technique -> setAliasedParameterValue ( TechniqueParam::NormalMatrix3 , HdwProgVarType::Matrix3 , normal ) ;
+        if ( projection == iMatrices.getProjection () )
+        setObjectUniforms ( technique , matrices.model , matrices.modelview , matrices.normal , matrices.projectionviewmodel ) ;
+        else
+        setObjectUniforms ( technique , matrices.model , matrices.modelview , matrices.normal , projection * matrices.modelview ) ;
     }
 
     //////////////////////////////////////////////////////////////////////
@@ -304,20 +775,17 @@ void RenderPass::renderTechniqueWithNodeAndLights (const Renderer* renderer ,
 
     //////////////////////////////////////////////////////////////////////
     // If node is not invalid , see if it has postprocessing techniques. If
-    // this is the case , we unbind the current technique and binds the
-    // postprocessed technique , making a rendering exclusively for the current
-    // node.
+    // this is the case , each postprocessing technique binds its pipeline state ,
+    // making a rendering exclusively for the current node , and the current
+    // technique binds its own again.
 
     auto postprocess = node -> getPostProcessTechniques () ;
 
-    if ( !postprocess.empty() )
-    technique -> unbind () ;
-
     for ( auto tech : postprocess )
     renderTechniqueWithNode ( renderer , tech , node , lights ) ;
 
     if ( !postprocess.empty() )
-    technique -> bind () ;
+    technique -> bind ( renderer ) ;
 }
 
 void RenderPass::renderTechniqueWithLights (const Renderer* renderer ,
@@ -333,15 +801,25 @@ void RenderPass::renderTechniqueWithLights (const Renderer* renderer ,
 
     if ( technique -> getLightingMode() == TechniqueLightingMode::AllLights )
     {
+        int count = 0 ;
+
         for ( auto light : lights )
-        if ( !light.isInvalid() )
-        light -> bindEmissiveMaterial ( technique ) ;
+        {
+            if ( light.isInvalid() )
+            continue ;
+
+            light -> bindEmissiveMaterial ( technique ) ;
+            count++ ;
+        }
 
+        technique -> setAliasedParameterValue ( TechniqueParam::LightCount , HdwProgVarType::Int1 , count ) ;
         renderTechniqueWithNode ( renderer , technique , node ) ;
     }
 
     else if ( technique -> getLightingMode() == TechniqueLightingMode::PerLight )
     {
+        technique -> setAliasedParameterValue ( TechniqueParam::LightCount , HdwProgVarType::Int1 , 1 ) ;
+
         for ( auto light : lights )
         {
             if ( light.isInvalid() )
@@ -375,7 +853,7 @@ void RenderPass::renderTechniqueWithNode (const Renderer* renderer ,
     // First binds the technique. Binding the technique should also binds
     // the framebuffer if it has one.
 
-    technique -> bind () ;
+    technique -> bind ( renderer ) ;
 
     //////////////////////////////////////////////////////////////////////
     // If technique is Self-Rendered , use it and use the renderer to draw
@@ -395,11 +873,7 @@ void RenderPass::renderTechniqueWithNode (const Renderer* renderer ,
             const Matrix4 & projection = technique -> getProjectionMatrix () ;
             const Matrix4 viewprojection = projection * view ;
 
-            technique -> setAliasedParameterValue ( TechniqueParam::CameraPosition , HdwProgVarType::Float3 , iCamera -> getPosition() ) ;
-            technique -> setAliasedParameterValue ( TechniqueParam::CameraDirection , HdwProgVarType::Float3 , iCamera -> getDirection() ) ;
-            technique -> setAliasedParameterValue ( TechniqueParam::ProjectionMatrix , HdwProgVarType::Matrix4 , projection ) ;
-            technique -> setAliasedParameterValue ( TechniqueParam::ViewMatrix , HdwProgVarType::Matrix4 , view ) ;
-            technique -> setAliasedParameterValue ( TechniqueParam::ProjectionViewMatrix , HdwProgVarType::Matrix4 , viewprojection ) ;
+            setCameraUniforms ( technique , iCamera -> getPosition() , iCamera -> getDirection() , view , projection , viewprojection ) ;
         }
 
         if ( !iScene.isInvalid() )
@@ -409,11 +883,11 @@ void RenderPass::renderTechniqueWithNode (const Renderer* renderer ,
     }
 
     //////////////////////////////////////////////////////////////////////
-    // Unbinding the technique should unbind the framebuffer , reste lights
-    // and textures counter.
+    // Resets lights and textures counter. The pipeline state stays bound :
+    // the calling technique binds its own again , which does nothing if it
+    // is identical.
 
     technique -> reset () ;
-    technique -> unbind () ;
 }
 
 void RenderPass::renderTechniqueWithNode (const Renderer* renderer ,
@@ -433,24 +907,373 @@ void RenderPass::renderTechniqueWithNode (const Renderer* renderer ,
         if ( node->getMesh().isInvalid() )
         return ;
 
-        auto mesh = node -> getMesh () ;
-        mesh -> bind ( technique ) ;
+        drawMesh ( renderer , technique , node -> getMesh () , node -> getMaterial () , node -> getLodLevel () ) ;
+    }
+}
+
+void RenderPass::drawMesh (const Renderer* renderer ,
+                           const TechniqueHolder & technique ,
+                           const MeshHolder & mesh ,
+                           const MaterialHolder & material ,
+                           size_t lod ) const
+{
+    if ( mesh.isInvalid() )
+    return ;
+
+    mesh -> selectLod ( lod ) ;
+    mesh -> bind ( technique ) ;
+
+    while ( mesh -> bindNextSubMesh ( technique ) )
+    {
+        auto submesh = mesh -> getCurrentSubMesh () ;
+        auto submaterial = submesh -> getDefaultMaterial () ;
+
+        if ( material.isInvalid() && !submaterial.isInvalid() )
+        submaterial -> use ( technique ) ;
+
+        renderer -> drawSubMesh ( submesh ) ;
+
+        mesh -> unbindCurrentSubMesh ( technique ) ;
+    }
+
+    mesh -> unbind ( technique ) ;
+}
+
+void RenderPass::renderSnapshot (const Renderer* renderer ,
+                                 const TechniqueHolder & technique ,
+                                 const RenderSnapshot & snapshot ) const
+{
+    //////////////////////////////////////////////////////////////////////
+    // The camera must be in the snapshot : its node is only used to find
+    // it , not read.
+
+    const RenderSnapshotCamera * camera = snapshot.findCamera ( iCamera.getObject () ) ;
+
+    if ( !camera )
+    return ;
+
+    const Matrix4 & view = camera -> view ;
+    const Matrix4 & projection = technique -> getProjectionMatrix () ;
+
+    setCameraUniforms ( technique , camera -> position , camera -> direction , view , projection , projection * view ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Items are recorded on the JobPool , then executed in order on this
+    // thread.
+
+    recordSnapshot ( technique , snapshot , iCommandBuffers ) ;
+
+    for ( const CommandBuffer & buffer : iCommandBuffers )
+    {
+        if ( !buffer.isEmpty () )
+        renderer -> execute ( buffer ) ;
+    }
+}
+
+bool RenderPass::recordSnapshot (const TechniqueHolder & technique ,
+                                 const RenderSnapshot & snapshot ,
+                                 CommandBufferList & buffers ) const
+{
+    GreAutolock ;
+
+    for ( CommandBuffer & buffer : buffers )
+    buffer.clear () ;
+
+    const RenderSnapshotCamera * camera = snapshot.findCamera ( iCamera.getObject () ) ;
+
+    if ( !camera || technique.isInvalid() )
+    return false ;
+
+    const Matrix4 & view = camera -> view ;
+    const Matrix4 projection = technique -> getProjectionMatrix () ;
+    const Matrix4 viewprojection = projection * view ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Lights are assigned by index in the snapshot's lights list. As
+    // 'LightAssignment::assign()' uses scratch buffers , every job uses its
+    // own copy.
+
+    LightAssignment assignment ;
+
+    if ( technique -> getLightingMode () != TechniqueLightingMode::None )
+    assignment.prepare ( snapshot.lights , technique -> getMaximumLights () ) ;
+
+    const bool objectblock = technique -> hasUniformBlock ( UniformBlockBinding::Object ) ;
+    const UniformBlockLayout & layout = technique -> getUniformBlock ( UniformBlockBinding::Object ) .getLayout () ;
+    const Frustum frustum ( viewprojection ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // One buffer for each chunk of items : executing them in order draws
+    // the items in the snapshot's order.
+
+    const size_t count = snapshot.items.size () ;
+    const size_t chunks = ( count + SnapshotChunkSize - 1 ) / SnapshotChunkSize ;
+
+    if ( buffers.size () < chunks )
+    buffers.resize ( chunks ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Items start from the level selected for their node by the previous
+    // snapshot , or from the node's level for new nodes. Jobs only write
+    // their own items levels.
 
-        while ( mesh -> bindNextSubMesh ( technique ) )
+    iSnapshotItemLods.resize ( count ) ;
+
+    for ( size_t i = 0 ; i < count ; ++i )
+    {
+        const RenderSnapshotItem & item = snapshot.items [i] ;
+        auto it = iSnapshotLods.find ( item.node ) ;
+        iSnapshotItemLods [i] = it != iSnapshotLods.end () ? it -> second : item.lod ;
+    }
+
+    JobPool::Get () .parallelFor ( chunks , 1 , [&] ( size_t begin , size_t end )
+    {
+        LightAssignment lights = assignment ;
+        UniformBlock block ( layout ) ;
+        std::vector < size_t > indexes ;
+        std::vector < const RenderSnapshotLight * > itemlights ;
+
+        for ( size_t chunk = begin ; chunk < end ; ++chunk )
         {
-            auto submesh = mesh -> getCurrentSubMesh () ;
-            auto material = submesh -> getDefaultMaterial () ;
+            CommandBuffer & buffer = buffers [chunk] ;
+            buffer.setTechnique ( technique.getObject () ) ;
+
+            const size_t last = std::min ( count , ( chunk + 1 ) * SnapshotChunkSize ) ;
 
-            if ( node -> getMaterial().isInvalid() && !material.isInvalid() )
-            material -> use ( technique ) ;
+            for ( size_t i = chunk * SnapshotChunkSize ; i < last ; ++i )
+            {
+                const RenderSnapshotItem & item = snapshot.items [i] ;
 
-            renderer -> drawSubMesh ( submesh ) ;
+                if ( frustum.intersect ( item.bbox ) == IntersectionResult::Outside )
+                continue ;
 
-            mesh -> unbindCurrentSubMesh ( technique ) ;
+                indexes.clear () ;
+                itemlights.clear () ;
+                lights.assign ( item.bbox , indexes ) ;
+
+                for ( size_t index : indexes )
+                itemlights.push_back ( &snapshot.lights [index] ) ;
+
+                size_t & lod = iSnapshotItemLods [i] ;
+                lod = RenderNode::SelectLod ( item.mesh , item.bbox , lod , item.lodhysteresis ,
+                                              camera -> position , projection[1][1] ) ;
+
+                recordSnapshotItem ( buffer , technique , item , view , projection , itemlights , lod ,
+                                     objectblock ? &block : nullptr ) ;
+            }
         }
+    });
+
+    //////////////////////////////////////////////////////////////////////
+    // Only the nodes of this snapshot are kept , so removed nodes are
+    // forgotten.
+
+    iSnapshotLods.clear () ;
 
-        mesh -> unbind ( technique ) ;
+    for ( size_t i = 0 ; i < count ; ++i )
+    iSnapshotLods [snapshot.items [i] .node] = iSnapshotItemLods [i] ;
+
+    return true ;
+}
+
+void RenderPass::recordSnapshotItem (CommandBuffer & buffer ,
+                                     const TechniqueHolder & technique ,
+                                     const RenderSnapshotItem & item ,
+                                     const Matrix4 & view ,
+                                     const Matrix4 & projection ,
+                                     const std::vector < const RenderSnapshotLight * > & lights ,
+                                     size_t lod ,
+                                     UniformBlock * objectblock ) const
+{
+    const Matrix4 & model = item.model ;
+    const Matrix4 modelview = view * model ;
+    const Matrix3 normal = MatrixCache::NormalMatrix ( Matrix3 ( modelview ) ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The Object block needs every matrices , while only the model and normal
+    // ones are set without it.
+
+    if ( objectblock )
+    {
+        objectblock -> set ( TechniqueParam::ModelMatrix , model ) ;
+        objectblock -> set ( TechniqueParam::ModelViewMatrix , modelview ) ;
+        objectblock -> set ( TechniqueParam::ProjectionViewModelMatrix , projection * modelview ) ;
+        objectblock -> set ( TechniqueParam::NormalMatrix3 , normal ) ;
+        buffer.setUniformBlock ( UniformBlockBinding::Object , *objectblock ) ;
+    }
+
+    else
+    {
+        buffer.setParameter ( TechniqueParam::ModelMatrix , HdwProgVarType::Matrix4 , model ) ;
+        buffer.setParameter ( TechniqueParam::NormalMatrix3 , HdwProgVarType::Matrix3 , normal ) ;
     }
+
+    if ( !item.material.isInvalid() )
+    buffer.useMaterial ( item.material.getObject () ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Binds lights as 'renderTechniqueWithLights()' does.
+
+    const Mesh * mesh = item.mesh.getObject () ;
+    const bool hasmaterial = !item.material.isInvalid () ;
+
+    if ( technique -> getLightingMode() == TechniqueLightingMode::AllLights )
+    {
+        for ( const RenderSnapshotLight * light : lights )
+        recordSnapshotLight ( buffer , projection , *light ) ;
+
+        buffer.setParameter ( TechniqueParam::LightCount , HdwProgVarType::Int1 , (int) lights.size () ) ;
+        buffer.drawMesh ( mesh , hasmaterial , lod ) ;
+    }
+
+    else if ( technique -> getLightingMode() == TechniqueLightingMode::PerLight )
+    {
+        buffer.setParameter ( TechniqueParam::LightCount , HdwProgVarType::Int1 , 1 ) ;
+
+        for ( const RenderSnapshotLight * light : lights )
+        {
+            recordSnapshotLight ( buffer , projection , *light ) ;
+            buffer.drawMesh ( mesh , hasmaterial , lod ) ;
+            buffer.resetLights () ;
+        }
+    }
+
+    else
+    {
+        buffer.drawMesh ( mesh , hasmaterial , lod ) ;
+    }
+
+    buffer.resetTechnique () ;
+}
+
+void RenderPass::recordSnapshotLight ( CommandBuffer & buffer , const Matrix4 & projection , const RenderSnapshotLight & light ) const
+{
+    if ( light.material.isInvalid() )
+    return ;
+
+    buffer.useMaterial ( light.material.getObject () ) ;
+    buffer.setLightParameter ( TechniqueParam::LightPosition , HdwProgVarType::Float3 , light.position ) ;
+    buffer.setLightParameter ( TechniqueParam::LightDirection , HdwProgVarType::Float3 , light.direction ) ;
+    buffer.setLightParameter ( TechniqueParam::LightShadowMatrix , HdwProgVarType::Matrix4 , projection * light.view ) ;
+}
+
+void RenderPass::renderSnapshotShadowCasters (const Renderer* renderer ,
+                                              const TechniqueHolder & technique ,
+                                              const RenderSnapshot & snapshot ) const
+{
+    iShadowCasters = 0 ;
+
+    const RenderSnapshotCamera * camera = snapshot.findCamera ( iCamera.getObject () ) ;
+
+    if ( !camera )
+    return ;
+
+    const Matrix4 & projection = technique -> getProjectionMatrix () ;
+    std::vector < const RenderSnapshotLight * > itemlights ( 1 ) ;
+
+    const bool objectblock = technique -> hasUniformBlock ( UniformBlockBinding::Object ) ;
+    UniformBlock block ( technique -> getUniformBlock ( UniformBlockBinding::Object ) .getLayout () ) ;
+
+    if ( iCommandBuffers.empty () )
+    iCommandBuffers.resize ( 1 ) ;
+
+    CommandBuffer & buffer = iCommandBuffers [0] ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Only one light draws in the shadow map , chosen as for the nodes ,
+    // without culling the lights by the camera.
+
+    const RenderSnapshotLight * light = nullptr ;
+
+    for ( const RenderSnapshotLight & candidate : snapshot.lights )
+    {
+        if ( iShadowLight.isInvalid() || candidate.node == iShadowLight.getObject () )
+        {
+            light = &candidate ;
+            break ;
+        }
+    }
+
+    if ( !light )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The light's frustum has no near plane : casters between the light
+    // and the near plane still cast shadows in it.
+
+    const Matrix4 lightprojectionview = projection * light -> view ;
+    Frustum frustum ( lightprojectionview ) ;
+    frustum.disablePlane ( 4 ) ;
+
+    setCameraUniforms ( technique , light -> position , light -> direction , light -> view , projection , lightprojectionview ) ;
+
+    itemlights [0] = light ;
+
+    buffer.clear () ;
+    buffer.setTechnique ( technique.getObject () ) ;
+
+    for ( const RenderSnapshotItem & item : snapshot.items )
+    {
+        if ( !item.caster || frustum.intersect ( item.bbox ) == IntersectionResult::Outside )
+        continue ;
+
+        recordSnapshotItem ( buffer , technique , item , light -> view , projection , itemlights , item.lod ,
+                             objectblock ? &block : nullptr ) ;
+        iShadowCasters ++ ;
+    }
+
+    renderer -> execute ( buffer ) ;
+}
+
+void RenderPass::setCameraUniforms (const TechniqueHolder & technique ,
+                                    const Vector3 & position ,
+                                    const Vector3 & direction ,
+                                    const Matrix4 & view ,
+                                    const Matrix4 & projection ,
+                                    const Matrix4 & projectionview ) const
+{
+    if ( technique -> hasUniformBlock ( UniformBlockBinding::Pass ) )
+    {
+        UniformBlock & block = technique -> getUniformBlock ( UniformBlockBinding::Pass ) ;
+        block.set ( TechniqueParam::ViewMatrix , view ) ;
+        block.set ( TechniqueParam::ProjectionMatrix , projection ) ;
+        block.set ( TechniqueParam::ProjectionViewMatrix , projectionview ) ;
+        block.set ( TechniqueParam::CameraPosition , position ) ;
+        block.set ( TechniqueParam::CameraDirection , direction ) ;
+
+        if ( technique -> setUniformBlock ( UniformBlockBinding::Pass , block ) )
+        return ;
+    }
+
+    technique -> setAliasedParameterValue ( TechniqueParam::CameraPosition , HdwProgVarType::Float3 , position ) ;
+    technique -> setAliasedParameterValue ( TechniqueParam::CameraDirection , HdwProgVarType::Float3 , direction ) ;
+    technique -> setAliasedParameterValue ( TechniqueParam::ProjectionMatrix , HdwProgVarType::Matrix4 , projection ) ;
+    technique -> setAliasedParameterValue ( TechniqueParam::ViewMatrix , HdwProgVarType::Matrix4 , view ) ;
+    technique -> setAliasedParameterValue ( TechniqueParam::ProjectionViewMatrix , HdwProgVarType::Matrix4 , projectionview ) ;
+}
+
+void RenderPass::setObjectUniforms (const TechniqueHolder & technique ,
+                                    const Matrix4 & model ,
+                                    const Matrix4 & modelview ,
+                                    const Matrix3 & normal ,
+                                    const Matrix4 & projectionviewmodel ) const
+{
+    if ( technique -> hasUniformBlock ( UniformBlockBinding::Object ) )
+    {
+        UniformBlock & block = technique -> getUniformBlock ( UniformBlockBinding::Object ) ;
+        block.set ( TechniqueParam::ModelMatrix , model ) ;
+        block.set ( TechniqueParam::ModelViewMatrix , modelview ) ;
+        block.set ( TechniqueParam::ProjectionViewModelMatrix , projectionviewmodel ) ;
+        block.set ( TechniqueParam::NormalMatrix3 , normal ) ;
+
+        if ( technique -> setUniformBlock ( UniformBlockBinding::Object , block ) )
+        return ;
+    }
+
+    technique -> setAliasedParameterValue ( TechniqueParam::ModelMatrix , HdwProgVarType::Matrix4 , model ) ;
+    technique -> setAliasedParameterValue ( TechniqueParam::ModelViewMatrix , HdwProgVarType::Matrix4 , modelview ) ;
+    technique -> setAliasedParameterValue ( TechniqueParam::NormalMatrix3 , HdwProgVarType::Matrix3 , normal ) ;
+    technique -> setAliasedParameterValue ( TechniqueParam::ProjectionViewModelMatrix , HdwProgVarType::Matrix4 , projectionviewmodel ) ;
 }
 
 GreEndNamespace
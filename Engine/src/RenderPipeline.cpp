@@ -33,13 +33,38 @@ THE SOFTWARE.
 #include "RenderPipeline.h"
 #include "Renderer.h"
 #include "ResourceManager.h"
+#include "Profiler.h"
 
 GreBeginNamespace
 
 // -----------------------------------------------------------------------------
 // RenderPipeline implementation.
 
-RenderPipeline::RenderPipeline ( const std::string & name ) : Gre::Resource ( name )
+typedef std::map < const RenderScene * , const RenderSnapshot * > FrameSnapshots ;
+
+//////////////////////////////////////////////////////////////////////
+// Returns the snapshot of the pass's scene for this frame. It is acquired
+// by the first pass using the scene , so every passes of the frame draw
+// the same update even if a new snapshot is published meanwhile.
+
+static const RenderSnapshot * GetFrameSnapshot ( const RenderPass * pass , FrameSnapshots & snapshots )
+{
+    const RenderSceneHolder & scene = pass -> getScene () ;
+
+    if ( scene.isInvalid() || !scene -> isSnapshotEnabled () )
+    return nullptr ;
+
+    auto it = snapshots.find ( scene.getObject() ) ;
+
+    if ( it != snapshots.end() )
+    return it -> second ;
+
+    const RenderSnapshot * snapshot = scene -> acquireSnapshot () ;
+    snapshots [scene.getObject()] = snapshot ;
+    return snapshot ;
+}
+
+RenderPipeline::RenderPipeline ( const std::string & name ) : Gre::Resource ( name ) , iFrameGraph ( name )
 {
 
 }
@@ -151,11 +176,39 @@ void RenderPipeline::render ( const Renderer* renderer ) const
         return ;
     }
 
+    std::vector < const RenderPass * > passes ;
+    passes.reserve ( iPasses.size() ) ;
+
     for ( auto it : iPasses )
     {
         if ( !it.second.isInvalid() )
-        it.second -> render( renderer ) ;
+        passes.push_back ( it.second.getObject() ) ;
     }
+
+    //////////////////////////////////////////////////////////////////////
+    // The frame graph orders and culls the passes. Without any target , it
+    // returns them in index order.
+
+    std::vector < const RenderPass * > order ;
+    iStatistics.beginFrame() ;
+
+    {
+        GreProfile( "FrameGraph::compile" ) ;
+        order = iFrameGraph.compile( passes ) ;
+    }
+
+    FrameSnapshots snapshots ;
+
+    for ( const RenderPass * pass : order )
+    {
+        GreProfileDetail( "RenderPass::render" , pass -> getName() ) ;
+
+        iStatistics.beginPass( pass -> getName() ) ;
+        pass -> render( renderer , GetFrameSnapshot( pass , snapshots ) ) ;
+        iStatistics.endPass() ;
+    }
+
+    iStatistics.endFrame() ;
 }
 
 void RenderPipeline::renderReversed ( const Renderer* renderer ) const
@@ -168,11 +221,52 @@ void RenderPipeline::renderReversed ( const Renderer* renderer ) const
         return ;
     }
 
+    iStatistics.beginFrame() ;
+    FrameSnapshots snapshots ;
+
     for ( std::map < uint8_t , RenderPassHolder >::const_reverse_iterator it = iPasses.rbegin() ; it != iPasses.rend() ; it++ )
     {
-        if ( !it->second.isInvalid() )
-        it->second -> render( renderer ) ;
+        if ( it->second.isInvalid() )
+        continue ;
+
+        GreProfileDetail( "RenderPass::render" , it->second -> getName() ) ;
+
+        iStatistics.beginPass( it->second -> getName() ) ;
+        it->second -> render( renderer , GetFrameSnapshot( it->second.getObject() , snapshots ) ) ;
+        iStatistics.endPass() ;
     }
+
+    iStatistics.endFrame() ;
+}
+
+void RenderPipeline::addTarget ( const std::string & name , const FrameGraphTarget & target )
+{
+    GreAutolock ; iFrameGraph.addTarget( name , target ) ;
+}
+
+void RenderPipeline::importTarget ( const std::string & name , const TextureHolder & texture )
+{
+    GreAutolock ; iFrameGraph.importTarget( name , texture ) ;
+}
+
+void RenderPipeline::removeTarget ( const std::string & name )
+{
+    GreAutolock ; iFrameGraph.removeTarget( name ) ;
+}
+
+const FrameGraphStats & RenderPipeline::getFrameGraphStats () const
+{
+    GreAutolock ; return iFrameGraph.getStats() ;
+}
+
+const RenderStatistics & RenderPipeline::getStatistics () const
+{
+    GreAutolock ; return iStatistics ;
+}
+
+RenderStatistics & RenderPipeline::getStatistics ()
+{
+    GreAutolock ; return iStatistics ;
 }
 
 // -----------------------------------------------------------------------------
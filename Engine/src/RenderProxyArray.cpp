@@ -0,0 +1,247 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  RenderProxyArray.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 26/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "RenderProxyArray.h"
+
+GreBeginNamespace
+
+RenderProxyArray::RenderProxyArray ()
+: iStaticVersion ( 0 )
+{
+
+}
+
+RenderProxyArray::~RenderProxyArray ()
+{
+
+}
+
+void RenderProxyArray::insert ( const RenderNode * node )
+{
+    if ( !node )
+    return ;
+
+    auto it = iIndices.find ( node ) ;
+
+    if ( it != iIndices.end () )
+    {
+        update ( node ) ;
+        return ;
+    }
+
+    iIndices [node] = iProxies.size () ;
+    iProxies.push_back ( RenderProxy () ) ;
+    Fill ( node , iProxies.back () ) ;
+
+    if ( iProxies.back () .staticnode )
+    iStaticVersion ++ ;
+}
+
+void RenderProxyArray::update ( const RenderNode * node )
+{
+    auto it = iIndices.find ( node ) ;
+
+    if ( it == iIndices.end () )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // A node becoming static or dynamic also changes the static nodes.
+
+    RenderProxy & proxy = iProxies [it -> second] ;
+    bool wasstatic = proxy.staticnode ;
+
+    Fill ( node , proxy ) ;
+
+    if ( wasstatic || proxy.staticnode )
+    iStaticVersion ++ ;
+}
+
+void RenderProxyArray::remove ( const RenderNode * node )
+{
+    auto it = iIndices.find ( node ) ;
+
+    if ( it == iIndices.end () )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The last proxy takes the place of the removed one.
+
+    size_t index = it -> second ;
+    iIndices.erase ( it ) ;
+
+    if ( iProxies [index] .staticnode )
+    iStaticVersion ++ ;
+
+    if ( index + 1 < iProxies.size () )
+    {
+        iProxies [index] = iProxies.back () ;
+        iIndices [iProxies [index] .node] = index ;
+    }
+
+    iProxies.pop_back () ;
+}
+
+bool RenderProxyArray::contains ( const RenderNode * node ) const
+{
+    return iIndices.find ( node ) != iIndices.end () ;
+}
+
+void RenderProxyArray::clear ()
+{
+    iProxies.clear () ;
+    iIndices.clear () ;
+}
+
+size_t RenderProxyArray::getCount () const
+{
+    return iProxies.size () ;
+}
+
+const std::vector < RenderProxy > & RenderProxyArray::getProxies () const
+{
+    return iProxies ;
+}
+
+void RenderProxyArray::cull ( const Matrix4 & projectionview , std::vector < const RenderNode * > & result ) const
+{
+    for ( const RenderProxy & proxy : iProxies )
+    {
+        if ( proxy.drawable && IsVisible ( projectionview , proxy ) )
+        result.push_back ( proxy.node ) ;
+    }
+}
+
+void RenderProxyArray::cull ( const Matrix4 & projectionview , VisibilityCache & cache , std::vector < const RenderNode * > & result ) const
+{
+    for ( const RenderProxy & proxy : iProxies )
+    {
+        bool visible = false ;
+
+        if ( !cache.lookup ( proxy.node , proxy.version , visible ) )
+        visible = proxy.drawable && IsVisible ( projectionview , proxy ) ;
+
+        cache.record ( proxy.node , proxy.version , visible ) ;
+
+        if ( visible )
+        result.push_back ( proxy.node ) ;
+    }
+}
+
+void RenderProxyArray::lights ( const Frustum & frustum , std::vector < const RenderNode * > & result ) const
+{
+    for ( const RenderProxy & proxy : iProxies )
+    {
+        if ( !proxy.light )
+        continue ;
+
+        //////////////////////////////////////////////////////////////////////
+        // A bounded light can only lit visible nodes if its influence sphere
+        // touches the view frustum.
+
+        if ( proxy.radius > 0.0f && frustum.intersect ( proxy.position , proxy.radius ) == IntersectionResult::Outside )
+        continue ;
+
+        result.push_back ( proxy.node ) ;
+    }
+}
+
+void RenderProxyArray::lights ( std::vector < const RenderNode * > & result ) const
+{
+    for ( const RenderProxy & proxy : iProxies )
+    {
+        if ( proxy.light )
+        result.push_back ( proxy.node ) ;
+    }
+}
+
+void RenderProxyArray::casters ( const Frustum & frustum , std::vector < const RenderNode * > & result ,
+                                 ShadowCasterFilter filter ) const
+{
+    for ( const RenderProxy & proxy : iProxies )
+    {
+        if ( !proxy.drawable || !proxy.caster )
+        continue ;
+
+        if ( filter == ShadowCasterFilter::Static && !proxy.staticnode )
+        continue ;
+
+        if ( filter == ShadowCasterFilter::Dynamic && proxy.staticnode )
+        continue ;
+
+        if ( frustum.intersect ( Vector3 ( proxy.center ) , proxy.diameter * 0.5f ) != IntersectionResult::Outside )
+        result.push_back ( proxy.node ) ;
+    }
+}
+
+uint64_t RenderProxyArray::getStaticVersion () const
+{
+    return iStaticVersion ;
+}
+
+bool RenderProxyArray::IsVisible ( const Matrix4 & projectionview , const RenderProxy & proxy )
+{
+    Vector4 coords = glm::normalize ( projectionview * proxy.model * proxy.center ) ;
+
+    if ( coords.z < -proxy.diameter ) return false ;
+    if ( fabsf(coords.x) > 1 + proxy.diameter || fabsf(coords.y) > 1 + proxy.diameter ) return false ;
+    return true ;
+}
+
+void RenderProxyArray::Fill ( const RenderNode * node , RenderProxy & proxy )
+{
+    const BoundingBox & bbox = node -> getBoundingBox () ;
+
+    proxy.node = node ;
+    proxy.model = node -> getModelMatrix () ;
+    proxy.version = node -> getVisibilityVersion () ;
+    proxy.drawable = !bbox.isInvalid () && !node -> isBatched () ;
+
+    if ( proxy.drawable )
+    {
+        proxy.center = Vector4 ( bbox.center () , 1.0f ) ;
+        proxy.diameter = bbox.diameterlen () ;
+    }
+
+    else
+    {
+        proxy.center = Vector4 ( 0.0f , 0.0f , 0.0f , 1.0f ) ;
+        proxy.diameter = 0.0f ;
+    }
+
+    proxy.light = !node -> getEmissiveMaterial () .isInvalid () ;
+    proxy.position = node -> getPosition () ;
+    proxy.radius = node -> getLightRadius () ;
+    proxy.caster = node -> isShadowCaster () ;
+    proxy.staticnode = node -> isStatic () ;
+}
+
+GreEndNamespace
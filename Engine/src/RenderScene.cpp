@@ -31,13 +31,24 @@ THE SOFTWARE.
 */
 
 #include "RenderScene.h"
+#include "Profiler.h"
+#include "RenderStatistics.h"
 
 GreBeginNamespace
 
 RenderScene::RenderScene ( const std::string & name ) : Gre::Renderable ( name )
+, iVersion ( 0 ) , iSnapshotEnabled ( false ) , iSnapshotFrame ( 0 )
 {
     iRoot = create ( name + ".root" ) ;
+    iProxies.insert ( iRoot.getObject () ) ;
+    iSnapshotNodes [ iRoot.getObject () ] = std::make_shared < const RenderNodeHolder > ( iRoot ) ;
     addFilteredListener ( iRoot , { EventType::Update } ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Nodes receive the update event before the scene , so the snapshot
+    // published in 'onUpdateEvent()' sees the updated nodes.
+
+    EventProceeder::setTransmitBehaviour ( EventProceederTransmitBehaviour::SendsBefore ) ;
 }
 
 RenderScene::~RenderScene () noexcept ( false )
@@ -58,7 +69,17 @@ bool RenderScene::add ( RenderNodeHolder & node )
     return false ;
 
     node -> update () ;
-    return iRoot -> add ( node ) ;
+
+    if ( !iRoot -> add ( node ) )
+    return false ;
+
+    if ( node -> isStatic () )
+    iStaticBatcher.add ( node ) ;
+
+    iSpatialIndex.update ( node ) ;
+
+    iVersion ++ ;
+    return true ;
 }
 
 bool RenderScene::remove ( RenderNodeHolder & node )
@@ -68,16 +89,158 @@ bool RenderScene::remove ( RenderNodeHolder & node )
     if ( iRoot.isInvalid() )
     return false ;
 
-    return iRoot -> remove ( node ) ;
+    iStaticBatcher.remove ( node ) ;
+
+    if ( !iRoot -> remove ( node ) )
+    return false ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Children leave the scene with the node.
+
+    std::vector < RenderNodeHolder > removed ( 1 , node ) ;
+
+    while ( !removed.empty () )
+    {
+        RenderNodeHolder current = removed.back () ;
+        removed.pop_back () ;
+
+        iSpatialIndex.remove ( current ) ;
+
+        for ( auto & child : current -> getChildren () )
+        removed.push_back ( child ) ;
+    }
+
+    iVersion ++ ;
+    return true ;
+}
+
+bool RenderScene::relocate ( RenderNodeHolder & node )
+{
+    GreAutolock ;
+
+    if ( iRoot.isInvalid() || node.isInvalid() )
+    return false ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Static nodes may be batched : they are removed from the batcher and
+    // added again , so their chunk is merged again.
+
+    iStaticBatcher.remove ( node ) ;
+    iRoot -> remove ( node ) ;
+    iVersion ++ ;
+
+    if ( !iRoot -> add ( node ) )
+    {
+        iSpatialIndex.remove ( node ) ;
+        return false ;
+    }
+
+    if ( node -> isStatic () )
+    iStaticBatcher.add ( node ) ;
+
+    iSpatialIndex.update ( node ) ;
+    return true ;
+}
+
+void RenderScene::attach ( const RenderNode * parent , const RenderNodeHolder & node )
+{
+    GreAutolock ;
+
+    if ( node.isInvalid() || !iProxies.contains ( parent ) )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Children added to the node before it entered the scene come with it.
+
+    std::vector < RenderNodeHolder > added ( 1 , node ) ;
+
+    while ( !added.empty () )
+    {
+        RenderNodeHolder current = added.back () ;
+        added.pop_back () ;
+
+        iProxies.insert ( current.getObject () ) ;
+        iSnapshotNodes [ current.getObject () ] = std::make_shared < const RenderNodeHolder > ( current ) ;
+
+        for ( auto & child : current -> getChildren () )
+        added.push_back ( child ) ;
+    }
+
+    iVersion ++ ;
+}
+
+void RenderScene::detach ( const RenderNodeHolder & node )
+{
+    GreAutolock ;
+
+    if ( node.isInvalid() || !iProxies.contains ( node.getObject () ) )
+    return ;
+
+    std::vector < RenderNodeHolder > removed ( 1 , node ) ;
+
+    while ( !removed.empty () )
+    {
+        RenderNodeHolder current = removed.back () ;
+        removed.pop_back () ;
+
+        iProxies.remove ( current.getObject () ) ;
+        iSnapshotNodes.erase ( current.getObject () ) ;
+
+        for ( auto & child : current -> getChildren () )
+        removed.push_back ( child ) ;
+    }
+
+    iVersion ++ ;
+}
+
+void RenderScene::updateProxy ( const RenderNode * node )
+{
+    GreAutolock ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The node may become visible or hidden : lists cached by 'sort()' are
+    // not valid anymore.
+
+    iProxies.update ( node ) ;
+    iVersion ++ ;
 }
 
 const RenderNodeHolderList RenderScene::sort ( const Matrix4 & projectionview ) const
 {
+    GreProfile( "RenderScene::sort" ) ;
     GreAutolock ;
 
+    //////////////////////////////////////////////////////////////////////
+    // Batches are built first , as building changes the batched flag of
+    // nodes and so the scene version.
+
+    if ( iStaticBatcher.isDirty () )
+    {
+        iStaticBatcher.build ( this ) ;
+        iVersion ++ ;
+    }
+
     RenderNodeHolderList result ;
-    iRoot -> sort ( projectionview , result ) ;
 
+    if ( iVisibilityCache.find ( projectionview , iVersion , result ) )
+    {
+        RenderStatistics::CountNodes ( iProxies.getCount () , iProxies.getCount () - std::min ( iProxies.getCount () , result.size () ) ) ;
+        return result ;
+    }
+
+    iCulled.clear () ;
+    iProxies.cull ( projectionview , iVisibilityCache , iCulled ) ;
+    RenderStatistics::CountNodes ( iProxies.getCount () , iProxies.getCount () - iCulled.size () ) ;
+
+    for ( const RenderNode * node : iCulled )
+    result.push_back ( RenderNodeHolder ( node ) ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Batched nodes are skipped by the tree , their batches are added here.
+
+    iStaticBatcher.visible ( Frustum ( projectionview ) , result ) ;
+
+    iVisibilityCache.store ( result ) ;
     return result ;
 }
 
@@ -85,12 +248,71 @@ const RenderNodeHolderList RenderScene::lights ( const Matrix4 & projectionview
 {
     GreAutolock ;
 
+    iCulled.clear () ;
+    iProxies.lights ( Frustum ( projectionview ) , iCulled ) ;
+
     RenderNodeHolderList result ;
-    iRoot -> lights ( projectionview , result ) ;
+
+    for ( const RenderNode * node : iCulled )
+    result.push_back ( RenderNodeHolder ( node ) ) ;
 
     return result ;
 }
 
+void RenderScene::cull ( const Matrix4 & projectionview , std::vector < const RenderNode * > & result ) const
+{
+    GreAutolock ;
+
+    if ( iStaticBatcher.isDirty () )
+    {
+        iStaticBatcher.build ( this ) ;
+        iVersion ++ ;
+    }
+
+    size_t count = result.size () ;
+    iProxies.cull ( projectionview , result ) ;
+    RenderStatistics::CountNodes ( iProxies.getCount () , iProxies.getCount () - ( result.size () - count ) ) ;
+
+    iStaticBatcher.visible ( Frustum ( projectionview ) , result ) ;
+}
+
+void RenderScene::lights ( const Matrix4 & projectionview , std::vector < const RenderNode * > & result ) const
+{
+    GreAutolock ;
+    iProxies.lights ( Frustum ( projectionview ) , result ) ;
+}
+
+void RenderScene::lights ( std::vector < const RenderNode * > & result ) const
+{
+    GreAutolock ;
+    iProxies.lights ( result ) ;
+}
+
+void RenderScene::casters ( const Matrix4 & lightprojectionview , std::vector < const RenderNode * > & result ,
+                            ShadowCasterFilter filter ) const
+{
+    GreAutolock ;
+
+    if ( iStaticBatcher.isDirty () )
+    {
+        iStaticBatcher.build ( this ) ;
+        iVersion ++ ;
+    }
+
+    Frustum frustum ( lightprojectionview ) ;
+    frustum.disablePlane ( 4 ) ;
+
+    iProxies.casters ( frustum , result , filter ) ;
+
+    if ( filter != ShadowCasterFilter::Dynamic )
+    iStaticBatcher.visible ( frustum , result ) ;
+}
+
+uint64_t RenderScene::getStaticVersion () const
+{
+    GreAutolock ; return iProxies.getStaticVersion () ;
+}
+
 const RenderNodeHolder & RenderScene::getRoot () const
 {
     GreAutolock ; return iRoot ;
@@ -101,6 +323,102 @@ RenderNodeHolder & RenderScene::getRoot ()
     GreAutolock ; return iRoot ;
 }
 
+void RenderScene::buildStaticBatches ()
+{
+    GreAutolock ;
+
+    if ( iStaticBatcher.isDirty () )
+    {
+        iStaticBatcher.build ( this ) ;
+        iVersion ++ ;
+    }
+}
+
+uint64_t RenderScene::getVersion () const
+{
+    GreAutolock ; return iVersion ;
+}
+
+VisibilityCache & RenderScene::getVisibilityCache ()
+{
+    GreAutolock ; return iVisibilityCache ;
+}
+
+const SpatialIndex & RenderScene::getSpatialIndex () const
+{
+    return iSpatialIndex ;
+}
+
+const RenderProxyArray & RenderScene::getProxies () const
+{
+    GreAutolock ; return iProxies ;
+}
+
+StaticBatcher & RenderScene::getStaticBatcher ()
+{
+    GreAutolock ; return iStaticBatcher ;
+}
+
+void RenderScene::setSnapshotEnabled ( bool value )
+{
+    GreAutolock ; iSnapshotEnabled = value ;
+}
+
+bool RenderScene::isSnapshotEnabled () const
+{
+    return iSnapshotEnabled ;
+}
+
+void RenderScene::publishSnapshot ()
+{
+    std::lock_guard < std::mutex > publishing ( iSnapshotMutex ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Node setters lock the node , then the scene in 'updateProxy()'. The
+    // nodes are collected under the scene lock and read after it is released ,
+    // so the scene lock and a node lock are never held together here.
+
+    std::vector < std::shared_ptr < const RenderNodeHolder > > nodes ;
+    RenderNodeHolderList batches ;
+
+    {
+        GreAutolock ;
+
+        if ( iRoot.isInvalid() )
+        return ;
+
+        nodes.reserve ( iSnapshotNodes.size () ) ;
+
+        for ( auto & node : iSnapshotNodes )
+        nodes.push_back ( node.second ) ;
+
+        batches = iStaticBatcher.getBatches () ;
+    }
+
+    RenderSnapshot & snapshot = iSnapshots.getWriteSnapshot () ;
+    snapshot.clear () ;
+
+    for ( auto & node : nodes )
+    ( *node ) -> snapshot ( snapshot ) ;
+
+    for ( auto & batch : batches )
+    batch -> snapshot ( snapshot ) ;
+    snapshot.frame = ++iSnapshotFrame ;
+
+    iSnapshots.publish () ;
+}
+
+const RenderSnapshot * RenderScene::acquireSnapshot () const
+{
+    return iSnapshots.acquire () ;
+}
+
+void RenderScene::onUpdateEvent ( const UpdateEvent & )
+{
+    if ( iSnapshotEnabled )
+    publishSnapshot () ;
+}
+
 // -----------------------------------------------------------------------------
 // RenderSceneLoader
 
@@ -147,6 +465,7 @@ RenderSceneManager::~RenderSceneManager () noexcept ( false )
 
 RenderSceneHolder RenderSceneManager::load ( const std::string & name , const ResourceLoaderOptions & ops )
 {
+    GreProfileDetail( "RenderSceneManager::load" , name ) ;
     GreAutolock ;
 
     //////////////////////////////////////////////////////////////////////
@@ -208,6 +527,16 @@ RenderSceneHolder RenderSceneManager::load ( const std::string & name , const Re
         scene -> getRoot() -> setBoundingBox ( BoundingBox(rootsize) ) ;
     }
 
+    auto chunksizeit = ops.find ( "scene.batch.chunksize" ) ;
+
+    if ( chunksizeit != ops.end() )
+    scene -> getStaticBatcher() .setChunkSize ( chunksizeit->second.to < float > () ) ;
+
+    auto cachesizeit = ops.find ( "scene.visibility.cachesize" ) ;
+
+    if ( cachesizeit != ops.end() )
+    scene -> getVisibilityCache() .setCapacity ( (size_t) cachesizeit->second.to < int > () ) ;
+
     GreDebug ( "[INFO] Successfully created scene '" ) << name << "'." << gendl ;
     return scene ;
 }
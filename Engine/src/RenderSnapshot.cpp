@@ -0,0 +1,109 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  RenderSnapshot.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 18/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "RenderSnapshot.h"
+
+GreBeginNamespace
+
+RenderSnapshot::RenderSnapshot ()
+: frame ( 0 )
+{
+
+}
+
+RenderSnapshot::~RenderSnapshot ()
+{
+
+}
+
+void RenderSnapshot::clear ()
+{
+    items.clear () ;
+    lights.clear () ;
+    cameras.clear () ;
+    frame = 0 ;
+}
+
+const RenderSnapshotCamera * RenderSnapshot::findCamera ( const RenderNode * node ) const
+{
+    for ( const RenderSnapshotCamera & camera : cameras )
+    if ( camera.node == node )
+    return &camera ;
+
+    return nullptr ;
+}
+
+// ---------------------------------------------------------------------------------------------------
+
+RenderSnapshotBuffer::RenderSnapshotBuffer ()
+: iWrite ( 0 ) , iRead ( 1 ) , iShared ( 2 ) , iReadValid ( false )
+{
+
+}
+
+RenderSnapshotBuffer::~RenderSnapshotBuffer ()
+{
+
+}
+
+RenderSnapshot & RenderSnapshotBuffer::getWriteSnapshot ()
+{
+    return iSnapshots [iWrite] ;
+}
+
+void RenderSnapshotBuffer::publish ()
+{
+    //////////////////////////////////////////////////////////////////////
+    // Gives the written snapshot to the shared slot and takes the one that
+    // was there. If it was not read yet , it is simply overwritten later.
+
+    unsigned int previous = iShared.exchange ( iWrite | Fresh , std::memory_order_acq_rel ) ;
+    iWrite = previous & ~Fresh ;
+}
+
+const RenderSnapshot * RenderSnapshotBuffer::acquire ()
+{
+    //////////////////////////////////////////////////////////////////////
+    // Takes the shared snapshot only if a new one was published. Else ,
+    // keeps reading the current one.
+
+    if ( iShared.load ( std::memory_order_acquire ) & Fresh )
+    {
+        unsigned int previous = iShared.exchange ( iRead , std::memory_order_acq_rel ) ;
+        iRead = previous & ~Fresh ;
+        iReadValid = true ;
+    }
+
+    return iReadValid ? &iSnapshots [iRead] : nullptr ;
+}
+
+GreEndNamespace
@@ -0,0 +1,320 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  RenderStatistics.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "RenderStatistics.h"
+#include "HardwareIndexBuffer.h"
+#include "HardwareProgram.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+// Global counters increased by the hooks.
+
+static std::atomic < size_t > NodesVisited ( 0 ) ;
+static std::atomic < size_t > NodesCulled ( 0 ) ;
+static std::atomic < size_t > DrawCalls ( 0 ) ;
+static std::atomic < size_t > Triangles ( 0 ) ;
+static std::atomic < size_t > Vertices ( 0 ) ;
+static std::atomic < size_t > TechniqueBinds ( 0 ) ;
+static std::atomic < size_t > FramebufferBinds ( 0 ) ;
+static std::atomic < size_t > TextureBinds ( 0 ) ;
+static std::atomic < size_t > UploadBytes ( 0 ) ;
+static std::atomic < size_t > LightsBound ( 0 ) ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Returns 'value - start' , or 'value' if the counter was reset.
+static size_t RenderCounterDelta ( size_t value , size_t start )
+{
+    return value >= start ? value - start : value ;
+}
+
+// -----------------------------------------------------------------------------
+// RenderCounters implementation.
+
+RenderCounters::RenderCounters ()
+: nodesVisited ( 0 ) , nodesCulled ( 0 )
+, drawCalls ( 0 ) , triangles ( 0 ) , vertices ( 0 )
+, techniqueBinds ( 0 ) , framebufferBinds ( 0 ) , textureBinds ( 0 )
+, uniformsIssued ( 0 ) , uniformsFiltered ( 0 )
+, uploadBytes ( 0 ) , lightsBound ( 0 )
+{
+
+}
+
+RenderCounters & RenderCounters::operator += ( const RenderCounters & rhs )
+{
+    nodesVisited += rhs.nodesVisited ;
+    nodesCulled += rhs.nodesCulled ;
+    drawCalls += rhs.drawCalls ;
+    triangles += rhs.triangles ;
+    vertices += rhs.vertices ;
+    techniqueBinds += rhs.techniqueBinds ;
+    framebufferBinds += rhs.framebufferBinds ;
+    textureBinds += rhs.textureBinds ;
+    uniformsIssued += rhs.uniformsIssued ;
+    uniformsFiltered += rhs.uniformsFiltered ;
+    uploadBytes += rhs.uploadBytes ;
+    lightsBound += rhs.lightsBound ;
+    return *this ;
+}
+
+RenderCounters RenderCounters::operator - ( const RenderCounters & rhs ) const
+{
+    RenderCounters result ;
+    result.nodesVisited = RenderCounterDelta ( nodesVisited , rhs.nodesVisited ) ;
+    result.nodesCulled = RenderCounterDelta ( nodesCulled , rhs.nodesCulled ) ;
+    result.drawCalls = RenderCounterDelta ( drawCalls , rhs.drawCalls ) ;
+    result.triangles = RenderCounterDelta ( triangles , rhs.triangles ) ;
+    result.vertices = RenderCounterDelta ( vertices , rhs.vertices ) ;
+    result.techniqueBinds = RenderCounterDelta ( techniqueBinds , rhs.techniqueBinds ) ;
+    result.framebufferBinds = RenderCounterDelta ( framebufferBinds , rhs.framebufferBinds ) ;
+    result.textureBinds = RenderCounterDelta ( textureBinds , rhs.textureBinds ) ;
+    result.uniformsIssued = RenderCounterDelta ( uniformsIssued , rhs.uniformsIssued ) ;
+    result.uniformsFiltered = RenderCounterDelta ( uniformsFiltered , rhs.uniformsFiltered ) ;
+    result.uploadBytes = RenderCounterDelta ( uploadBytes , rhs.uploadBytes ) ;
+    result.lightsBound = RenderCounterDelta ( lightsBound , rhs.lightsBound ) ;
+    return result ;
+}
+
+void RenderCounters::maximize ( const RenderCounters & rhs )
+{
+    nodesVisited = std::max ( nodesVisited , rhs.nodesVisited ) ;
+    nodesCulled = std::max ( nodesCulled , rhs.nodesCulled ) ;
+    drawCalls = std::max ( drawCalls , rhs.drawCalls ) ;
+    triangles = std::max ( triangles , rhs.triangles ) ;
+    vertices = std::max ( vertices , rhs.vertices ) ;
+    techniqueBinds = std::max ( techniqueBinds , rhs.techniqueBinds ) ;
+    framebufferBinds = std::max ( framebufferBinds , rhs.framebufferBinds ) ;
+    textureBinds = std::max ( textureBinds , rhs.textureBinds ) ;
+    uniformsIssued = std::max ( uniformsIssued , rhs.uniformsIssued ) ;
+    uniformsFiltered = std::max ( uniformsFiltered , rhs.uniformsFiltered ) ;
+    uploadBytes = std::max ( uploadBytes , rhs.uploadBytes ) ;
+    lightsBound = std::max ( lightsBound , rhs.lightsBound ) ;
+}
+
+RenderCounters RenderCounters::operator / ( size_t value ) const
+{
+    RenderCounters result = *this ;
+
+    if ( !value )
+    return result ;
+
+    result.nodesVisited /= value ;
+    result.nodesCulled /= value ;
+    result.drawCalls /= value ;
+    result.triangles /= value ;
+    result.vertices /= value ;
+    result.techniqueBinds /= value ;
+    result.framebufferBinds /= value ;
+    result.textureBinds /= value ;
+    result.uniformsIssued /= value ;
+    result.uniformsFiltered /= value ;
+    result.uploadBytes /= value ;
+    result.lightsBound /= value ;
+    return result ;
+}
+
+// -----------------------------------------------------------------------------
+// RenderStatistics implementation.
+
+RenderStatistics::RenderStatistics ( size_t history )
+: iHistorySize ( history ) , iFrames ( 0 )
+{
+
+}
+
+RenderStatistics::~RenderStatistics ()
+{
+
+}
+
+void RenderStatistics::beginFrame ()
+{
+    iCurrent = RenderFrameStatistics () ;
+    iCurrent.frame = iFrames ++ ;
+    iFrameStart = GetCounters () ;
+}
+
+void RenderStatistics::endFrame ()
+{
+    iCurrent.total = GetCounters () - iFrameStart ;
+
+    if ( !iHistorySize )
+    return ;
+
+    iHistory.push_back ( iCurrent ) ;
+
+    while ( iHistory.size () > iHistorySize )
+    iHistory.pop_front () ;
+}
+
+void RenderStatistics::beginPass ( const std::string & name )
+{
+    iPassName = name ;
+    iPassStart = GetCounters () ;
+}
+
+void RenderStatistics::endPass ()
+{
+    RenderPassStatistics pass ;
+    pass.name = iPassName ;
+    pass.counters = GetCounters () - iPassStart ;
+
+    iCurrent.passes.push_back ( pass ) ;
+}
+
+void RenderStatistics::setPasses ( const std::vector < RenderPassStatistics > & passes )
+{
+    iCurrent.passes = passes ;
+}
+
+const RenderFrameStatistics & RenderStatistics::getLastFrame () const
+{
+    static const RenderFrameStatistics empty ;
+
+    if ( iHistory.empty () )
+    return empty ;
+
+    return iHistory.back () ;
+}
+
+const std::deque < RenderFrameStatistics > & RenderStatistics::getHistory () const
+{
+    return iHistory ;
+}
+
+RenderCounters RenderStatistics::getAverage () const
+{
+    RenderCounters sum ;
+
+    for ( const RenderFrameStatistics & frame : iHistory )
+    sum += frame.total ;
+
+    return sum / iHistory.size () ;
+}
+
+RenderCounters RenderStatistics::getMaximum () const
+{
+    RenderCounters maximum ;
+
+    for ( const RenderFrameStatistics & frame : iHistory )
+    maximum.maximize ( frame.total ) ;
+
+    return maximum ;
+}
+
+void RenderStatistics::setHistorySize ( size_t frames )
+{
+    iHistorySize = frames ;
+
+    while ( iHistory.size () > iHistorySize )
+    iHistory.pop_front () ;
+}
+
+size_t RenderStatistics::getHistorySize () const
+{
+    return iHistorySize ;
+}
+
+void RenderStatistics::clear ()
+{
+    iHistory.clear () ;
+}
+
+RenderCounters RenderStatistics::GetCounters ()
+{
+    RenderCounters counters ;
+    counters.nodesVisited = NodesVisited.load ( std::memory_order_relaxed ) ;
+    counters.nodesCulled = NodesCulled.load ( std::memory_order_relaxed ) ;
+    counters.drawCalls = DrawCalls.load ( std::memory_order_relaxed ) ;
+    counters.triangles = Triangles.load ( std::memory_order_relaxed ) ;
+    counters.vertices = Vertices.load ( std::memory_order_relaxed ) ;
+    counters.techniqueBinds = TechniqueBinds.load ( std::memory_order_relaxed ) ;
+    counters.framebufferBinds = FramebufferBinds.load ( std::memory_order_relaxed ) ;
+    counters.textureBinds = TextureBinds.load ( std::memory_order_relaxed ) ;
+    counters.uniformsIssued = HardwareProgram::GetUniformMisses () ;
+    counters.uniformsFiltered = HardwareProgram::GetUniformHits () ;
+    counters.uploadBytes = UploadBytes.load ( std::memory_order_relaxed ) ;
+    counters.lightsBound = LightsBound.load ( std::memory_order_relaxed ) ;
+    return counters ;
+}
+
+void RenderStatistics::CountNodes ( size_t visited , size_t culled )
+{
+    NodesVisited.fetch_add ( visited , std::memory_order_relaxed ) ;
+    NodesCulled.fetch_add ( culled , std::memory_order_relaxed ) ;
+}
+
+void RenderStatistics::CountDraw ( size_t vertices , size_t triangles )
+{
+    DrawCalls.fetch_add ( 1 , std::memory_order_relaxed ) ;
+    Vertices.fetch_add ( vertices , std::memory_order_relaxed ) ;
+    Triangles.fetch_add ( triangles , std::memory_order_relaxed ) ;
+}
+
+void RenderStatistics::CountDraw ( const HardwareIndexBuffer & indices )
+{
+    size_t count = indices.count () ;
+    size_t triangles = 0 ;
+
+    if ( indices.getIndexDescriptor () .getMode () == IndexDrawmode::Triangles )
+    triangles = count / 3 ;
+
+    CountDraw ( count , triangles ) ;
+}
+
+void RenderStatistics::CountTechniqueBind ()
+{
+    TechniqueBinds.fetch_add ( 1 , std::memory_order_relaxed ) ;
+}
+
+void RenderStatistics::CountFramebufferBind ()
+{
+    FramebufferBinds.fetch_add ( 1 , std::memory_order_relaxed ) ;
+}
+
+void RenderStatistics::CountTextureBind ()
+{
+    TextureBinds.fetch_add ( 1 , std::memory_order_relaxed ) ;
+}
+
+void RenderStatistics::CountUpload ( size_t bytes )
+{
+    UploadBytes.fetch_add ( bytes , std::memory_order_relaxed ) ;
+}
+
+void RenderStatistics::CountLights ( size_t lights )
+{
+    LightsBound.fetch_add ( lights , std::memory_order_relaxed ) ;
+}
+
+GreEndNamespace
@@ -33,6 +33,7 @@
 #include "Renderer.h"
 #include "ResourceManager.h"
 #include "RenderContext.h"
+#include "Profiler.h"
 
 GreBeginNamespace
 
@@ -54,6 +55,7 @@ Renderer::~Renderer() noexcept ( false )
 
 void Renderer::render() const
 {
+    GreProfileDetail( "Renderer::render" , getName() ) ;
     GreAutolock ;
 
     if ( iInstalled )
@@ -70,14 +72,211 @@ void Renderer::render() const
 
         iContext -> bind() ;
 
+        //////////////////////////////////////////////////////////////////////
+        // Another context may have changed the bound states : the first state
+        // of the frame is always bound.
+
+        iPipelineState.clear () ;
+        iPipelineStats = PipelineStats () ;
+        iStatistics.beginFrame () ;
+
         if ( !iPipeline.isInvalid() )
-        iPipeline -> render( this ) ;
+        {
+            iPipeline -> render( this ) ;
+            iStatistics.setPasses ( iPipeline -> getStatistics().getLastFrame().passes ) ;
+        }
+
+        unbindPipelineState () ;
+        iStatistics.endFrame () ;
 
         iContext -> flush() ;
         iContext -> unbind() ;
     }
 }
 
+bool Renderer::bindPipelineState ( const PipelineStateHolder & state ) const
+{
+    GreAutolock ;
+
+    if ( state.isInvalid() )
+    return false ;
+
+    const PipelineState * current = iPipelineState.getObject () ;
+
+    if ( current && current -> isIdentical ( *state.getObject() ) )
+    {
+        iPipelineStats.skipped ++ ;
+        return true ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Binds only what differs from the current state. Binding a framebuffer
+    // may reset the raster states on some backends : they are applied again
+    // in this case.
+
+    const RenderFramebufferHolder & framebuffer = state -> getFramebuffer () ;
+    const HardwareProgramHolder & program = state -> getProgram () ;
+    bool framebufferchanged = false ;
+
+    if ( !current || current -> getFramebuffer().getObject() != framebuffer.getObject() )
+    {
+        if ( !framebuffer.isInvalid() )
+        framebuffer -> bind () ;
+
+        framebufferchanged = true ;
+        iPipelineStats.framebuffers ++ ;
+    }
+
+    if ( !current || current -> getProgram().getObject() != program.getObject() )
+    {
+        if ( !program.isInvalid() )
+        program -> use () ;
+
+        iPipelineStats.programs ++ ;
+    }
+
+    if ( !current || framebufferchanged || current -> getRasterState() != state -> getRasterState() )
+    {
+        setRasterState ( state -> getRasterState () ) ;
+        iPipelineStats.rasters ++ ;
+    }
+
+    iPipelineState = state ;
+    iPipelineStats.binds ++ ;
+    return true ;
+}
+
+void Renderer::unbindPipelineState () const
+{
+    GreAutolock ;
+
+    if ( iPipelineState.isInvalid() )
+    return ;
+
+    if ( !iPipelineState -> getProgram().isInvalid() )
+    iPipelineState -> getProgram() -> unuse () ;
+
+    if ( !iPipelineState -> getFramebuffer().isInvalid() )
+    iPipelineState -> getFramebuffer() -> unbind () ;
+
+    iPipelineState.clear () ;
+}
+
+void Renderer::setRasterState ( const RasterState & ) const
+{
+
+}
+
+const PipelineStats & Renderer::getPipelineStats () const
+{
+    GreAutolock ; return iPipelineStats ;
+}
+
+const RenderStatistics & Renderer::getStatistics () const
+{
+    GreAutolock ; return iStatistics ;
+}
+
+RenderStatistics & Renderer::getStatistics ()
+{
+    GreAutolock ; return iStatistics ;
+}
+
+void Renderer::execute ( const CommandBuffer & buffer ) const
+{
+    GreAutolock ;
+
+    TechniqueHolder technique ;
+
+    for ( const Command & command : buffer.getCommands () )
+    {
+        switch ( command.type )
+        {
+            case CommandType::SetTechnique :
+            technique = TechniqueHolder ( command.technique ) ;
+            break ;
+
+            case CommandType::BindTechnique :
+            technique = TechniqueHolder ( command.technique ) ;
+
+            if ( !technique.isInvalid() )
+            technique -> bind ( this ) ;
+            break ;
+
+            case CommandType::UnbindTechnique :
+            if ( !technique.isInvalid() )
+            technique -> unbind ( this ) ;
+            break ;
+
+            case CommandType::SetParameter :
+            if ( !technique.isInvalid() )
+            technique -> setAliasedParameterValue ( (TechniqueParam) command.param , command.vartype , buffer.getValue ( command ) ) ;
+            break ;
+
+            case CommandType::SetLightParameter :
+            if ( !technique.isInvalid() )
+            technique -> setAliasedParameterStructValue ( technique -> getCurrentLightAlias () , (TechniqueParam) command.param ,
+                                                          command.vartype , buffer.getValue ( command ) ) ;
+            break ;
+
+            case CommandType::SetUniformBlock :
+            if ( !technique.isInvalid() )
+            {
+                UniformBlockBinding binding = (UniformBlockBinding) command.param ;
+                UniformBlock & block = technique -> getUniformBlock ( binding ) ;
+
+                if ( block.setData ( buffer.getPayload ( command.offset ) , command.size ) )
+                technique -> setUniformBlock ( binding , block ) ;
+            }
+            break ;
+
+            case CommandType::UseMaterial :
+            if ( !technique.isInvalid() && command.material )
+            command.material -> use ( technique ) ;
+            break ;
+
+            case CommandType::ResetLights :
+            if ( !technique.isInvalid() )
+            technique -> resetLights () ;
+            break ;
+
+            case CommandType::ResetTechnique :
+            if ( !technique.isInvalid() )
+            technique -> reset () ;
+            break ;
+
+            case CommandType::DrawMesh :
+            if ( !technique.isInvalid() && command.mesh )
+            {
+                const Mesh * mesh = command.mesh ;
+                mesh -> selectLod ( command.offset ) ;
+                mesh -> bind ( technique ) ;
+
+                while ( mesh -> bindNextSubMesh ( technique ) )
+                {
+                    auto submesh = mesh -> getCurrentSubMesh () ;
+                    auto submaterial = submesh -> getDefaultMaterial () ;
+
+                    if ( !command.param && !submaterial.isInvalid() )
+                    submaterial -> use ( technique ) ;
+
+                    drawSubMesh ( submesh ) ;
+
+                    mesh -> unbindCurrentSubMesh ( technique ) ;
+                }
+
+                mesh -> unbind ( technique ) ;
+            }
+            break ;
+
+            case CommandType::Draw :
+            if ( !technique.isInvalid() )
+            draw ( technique ) ;
+            break ;
+        }
+    }
+}
+
 bool Renderer::installManagers ()
 {
     GreAutolock ;
@@ -290,6 +489,7 @@ RendererManager::~RendererManager() noexcept ( false )
 
 RendererHolder RendererManager::load(const std::string &name, const Gre::RendererOptions &options)
 {
+    GreProfileDetail( "RendererManager::load" , name ) ;
     GreAutolock ;
 
     if ( !name.empty() )
@@ -359,6 +559,7 @@ RendererHolder RendererManager::load(const std::string &name, const Gre::Rendere
 
 void RendererManager::render() const
 {
+    GreProfile( "RendererManager::render" ) ;
     GreAutolock ;
 
     for ( auto renderer : iHolders )
@@ -0,0 +1,636 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SceneStreamer.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 22/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "SceneStreamer.h"
+#include "ResourceManager.h"
+
+#include <fstream>
+#include <sstream>
+#include <set>
+
+GreBeginNamespace
+
+SceneStreamer::SceneStreamer ( const std::string & name , const RenderSceneHolder & scene )
+: Gre::Resource ( name ) , iScene ( scene )
+, iLoadDistance ( 100.0f ) , iUnloadDistance ( 150.0f )
+, iMemoryBudget ( 256 * 1024 * 1024 ) , iMemoryUsage ( 0 )
+, iFrameBudget ( 0.002f ) , iMaxJobs ( 2 )
+{
+
+}
+
+SceneStreamer::~SceneStreamer () noexcept ( false )
+{
+    //////////////////////////////////////////////////////////////////////
+    // Jobs write to the cells' data : they must end before the cells are
+    // destroyed.
+
+    for ( Cell & cell : iCells )
+    {
+        if ( cell.job.valid() )
+        cell.job.wait () ;
+    }
+}
+
+void SceneStreamer::addCell ( const std::string & path , const BoundingBox & bounds )
+{
+    GreAutolock ;
+
+    Cell cell ;
+    cell.path = path ;
+    cell.bounds = bounds ;
+    cell.state = StreamingCellState::Unloaded ;
+    cell.distance = std::numeric_limits < float > :: max () ;
+    cell.memory = 0 ;
+    cell.attached = 0 ;
+
+    iCells.push_back ( std::move ( cell ) ) ;
+}
+
+bool SceneStreamer::addCells ( const std::string & indexpath )
+{
+    GreAutolock ;
+
+    std::ifstream stream ( indexpath ) ;
+
+    if ( !stream )
+    {
+        GreDebug ( "[WARN] Can't open cells index '" ) << indexpath << "'." << gendl ;
+        return false ;
+    }
+
+    std::string directory = Platform::GetFileDirectory ( indexpath ) ;
+    std::string line ;
+
+    while ( std::getline ( stream , line ) )
+    {
+        std::istringstream iss ( line ) ;
+        std::string keyword , path ;
+        Vector3 min , max ;
+
+        if ( !( iss >> keyword ) || keyword [0] == '#' )
+        continue ;
+
+        if ( keyword != "cell" || !( iss >> path >> min.x >> min.y >> min.z >> max.x >> max.y >> max.z ) )
+        {
+            GreDebug ( "[WARN] Invalid line in cells index '" ) << indexpath << "' : '" << line << "'." << gendl ;
+            continue ;
+        }
+
+        if ( !directory.empty() && path [0] != '/' && path [0] != Platform::GetSeparator() )
+        path = directory + Platform::GetSeparator() + path ;
+
+        BoundingBox bounds ;
+        bounds.add ( min ) ;
+        bounds.add ( max ) ;
+
+        addCell ( path , bounds ) ;
+    }
+
+    return true ;
+}
+
+void SceneStreamer::setCamera ( const RenderNodeHolder & camera )
+{
+    GreAutolock ; iCamera = camera ;
+}
+
+void SceneStreamer::setLoadDistance ( float distance )
+{
+    GreAutolock ; iLoadDistance = distance ;
+}
+
+void SceneStreamer::setUnloadDistance ( float distance )
+{
+    GreAutolock ; iUnloadDistance = distance ;
+}
+
+void SceneStreamer::setMemoryBudget ( size_t bytes )
+{
+    GreAutolock ; iMemoryBudget = bytes ;
+}
+
+void SceneStreamer::setFrameBudget ( float seconds )
+{
+    GreAutolock ; iFrameBudget = seconds ;
+}
+
+void SceneStreamer::update ( const Vector3 & camera )
+{
+    GreAutolock ;
+
+    if ( iScene.isInvalid() )
+    return ;
+
+    TimePoint start = Time::now () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Updates the distances , and collects the cells whose file has been
+    // read. A cell which went out of range while loading is dropped.
+
+    size_t loading = 0 ;
+
+    for ( Cell & cell : iCells )
+    {
+        cell.distance = Distance ( cell.bounds , camera ) ;
+
+        if ( cell.state != StreamingCellState::Loading )
+        continue ;
+
+        if ( cell.job.wait_for ( std::chrono::seconds ( 0 ) ) != std::future_status::ready )
+        {
+            loading ++ ;
+            continue ;
+        }
+
+        cell.job.get () ;
+
+        if ( cell.data && cell.data -> success && cell.distance <= iUnloadDistance )
+        {
+            cell.state = StreamingCellState::Attaching ;
+            cell.attached = 0 ;
+        }
+
+        else
+        {
+            cell.state = StreamingCellState::Unloaded ;
+            cell.data.reset () ;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Detaches the cells out of range. Then , while the memory used by the
+    // remaining cells exceeds the budget , detaches the farthest ones.
+
+    std::vector < Cell* > sorted ;
+    size_t remaining = 0 ;
+
+    for ( Cell & cell : iCells )
+    {
+        bool inscene = cell.state == StreamingCellState::Attaching
+                    || cell.state == StreamingCellState::Attached ;
+
+        if ( inscene && cell.distance > iUnloadDistance )
+        cell.state = StreamingCellState::Detaching ;
+
+        else if ( inscene )
+        remaining += cell.memory ;
+
+        sorted.push_back ( &cell ) ;
+    }
+
+    std::sort ( sorted.begin() , sorted.end() , [] ( const Cell* a , const Cell* b ) {
+        return a -> distance < b -> distance ;
+    } ) ;
+
+    for ( auto it = sorted.rbegin() ; it != sorted.rend() && remaining > iMemoryBudget ; ++it )
+    {
+        Cell & cell = * (*it) ;
+
+        if ( cell.state != StreamingCellState::Attaching && cell.state != StreamingCellState::Attached )
+        continue ;
+
+        cell.state = StreamingCellState::Detaching ;
+        remaining -= cell.memory ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Starts reading the nearest cells in range , as long as the memory
+    // allows it.
+
+    for ( Cell* cellptr : sorted )
+    {
+        if ( loading >= iMaxJobs || remaining >= iMemoryBudget )
+        break ;
+
+        Cell & cell = * cellptr ;
+
+        if ( cell.distance > iLoadDistance )
+        break ;
+
+        if ( cell.state != StreamingCellState::Unloaded )
+        continue ;
+
+        std::shared_ptr < CellData > data = std::make_shared < CellData > () ;
+        std::string path = cell.path ;
+
+        cell.data = data ;
+        cell.state = StreamingCellState::Loading ;
+        cell.job = JobPool::Get().submit ( [data , path] () {
+            SceneStreamer::ReadCell ( path , *data ) ;
+        } ) ;
+
+        loading ++ ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Attaches and detaches nodes until the frame budget is spent. Detaching
+    // comes first to free memory , then the nearest cells are attached. One
+    // node is always processed , so streaming progresses even when the
+    // budget is very low.
+
+    bool processed = false ;
+
+    for ( Cell* cellptr : sorted )
+    {
+        Cell & cell = * cellptr ;
+
+        while ( cell.state == StreamingCellState::Detaching )
+        {
+            if ( processed && Duration ( Time::now() - start ).count() >= iFrameBudget )
+            return ;
+
+            detachNext ( cell ) ;
+            processed = true ;
+        }
+    }
+
+    for ( Cell* cellptr : sorted )
+    {
+        Cell & cell = * cellptr ;
+
+        while ( cell.state == StreamingCellState::Attaching )
+        {
+            if ( processed && Duration ( Time::now() - start ).count() >= iFrameBudget )
+            return ;
+
+            attachNext ( cell ) ;
+            processed = true ;
+        }
+    }
+}
+
+size_t SceneStreamer::getMemoryUsage () const
+{
+    GreAutolock ; return iMemoryUsage ;
+}
+
+size_t SceneStreamer::getCellsCount () const
+{
+    GreAutolock ; return iCells.size () ;
+}
+
+StreamingCellState SceneStreamer::getCellState ( size_t cell ) const
+{
+    GreAutolock ;
+
+    if ( cell >= iCells.size() )
+    return StreamingCellState::Unloaded ;
+
+    return iCells [cell] .state ;
+}
+
+void SceneStreamer::onUpdateEvent ( const UpdateEvent & )
+{
+    GreAutolock ;
+
+    if ( !iCamera.isInvalid() )
+    update ( iCamera -> getPosition () ) ;
+}
+
+void SceneStreamer::ReadCell ( const std::string & path , CellData & data )
+{
+    data.success = false ;
+
+    std::ifstream stream ( path ) ;
+
+    if ( !stream )
+    {
+        GreDebug ( "[WARN] Can't open cell '" ) << path << "'." << gendl ;
+        return ;
+    }
+
+    std::string line ;
+    NodeEntry entry ;
+    bool innode = false ;
+
+    while ( std::getline ( stream , line ) )
+    {
+        std::istringstream iss ( line ) ;
+        std::string keyword ;
+
+        if ( !( iss >> keyword ) || keyword [0] == '#' )
+        continue ;
+
+        if ( keyword == "node" )
+        {
+            entry = NodeEntry () ;
+            entry.scale = Vector3 ( 1.0f , 1.0f , 1.0f ) ;
+            entry.hastarget = false ;
+            entry.isstatic = false ;
+            iss >> entry.name ;
+            innode = true ;
+        }
+
+        else if ( !innode )
+        {
+            GreDebug ( "[WARN] Keyword '" ) << keyword << "' outside a node in cell '" << path << "'." << gendl ;
+        }
+
+        else if ( keyword == "mesh" )
+        iss >> entry.mesh ;
+
+        else if ( keyword == "material" )
+        iss >> entry.material ;
+
+        else if ( keyword == "position" )
+        iss >> entry.position.x >> entry.position.y >> entry.position.z ;
+
+        else if ( keyword == "target" )
+        {
+            iss >> entry.target.x >> entry.target.y >> entry.target.z ;
+            entry.hastarget = true ;
+        }
+
+        else if ( keyword == "scale" )
+        iss >> entry.scale.x >> entry.scale.y >> entry.scale.z ;
+
+        else if ( keyword == "static" )
+        entry.isstatic = true ;
+
+        else if ( keyword == "end" )
+        {
+            data.entries.push_back ( entry ) ;
+            innode = false ;
+        }
+
+        else
+        {
+            GreDebug ( "[WARN] Unknown keyword '" ) << keyword << "' in cell '" << path << "'." << gendl ;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Reads the mesh files once , so they are in the system's file cache
+    // when the main thread loads them.
+
+    std::set < std::string > meshes ;
+
+    for ( const NodeEntry & e : data.entries )
+    {
+        if ( !e.mesh.empty() && meshes.insert ( e.mesh ) .second )
+        {
+            std::ifstream file ( e.mesh , std::ios::binary ) ;
+            char buffer [4096] ;
+
+            while ( file.read ( buffer , sizeof ( buffer ) ) || file.gcount() > 0 ) ;
+        }
+    }
+
+    data.success = true ;
+}
+
+void SceneStreamer::attachNext ( Cell & cell )
+{
+    if ( !cell.data || cell.attached >= cell.data -> entries.size() )
+    {
+        cell.state = StreamingCellState::Attached ;
+        cell.data.reset () ;
+        return ;
+    }
+
+    const NodeEntry & entry = cell.data -> entries [cell.attached] ;
+    cell.attached ++ ;
+
+    RenderNodeHolder node = iScene -> create ( entry.name ) ;
+
+    if ( node.isInvalid() )
+    return ;
+
+    std::string meshpath ;
+
+    if ( !entry.mesh.empty() )
+    {
+        size_t memory = 0 ;
+        MeshHolder mesh = acquireMesh ( entry.mesh , memory ) ;
+
+        if ( !mesh.isInvalid() )
+        {
+            node -> setMesh ( mesh ) ;
+            meshpath = entry.mesh ;
+
+            if ( cell.meshusers [meshpath] ++ == 0 )
+            cell.memory += memory ;
+        }
+    }
+
+    if ( !entry.material.empty() )
+    {
+        MaterialHolder material = ResourceManager::Get() -> getMaterialManager() -> get ( entry.material ) ;
+
+        if ( material.isInvalid() )
+        GreDebug ( "[WARN] Material '" ) << entry.material << "' not found for node '" << entry.name << "'." << gendl ;
+        else
+        node -> setMaterial ( material ) ;
+    }
+
+    node -> setPosition ( entry.position ) ;
+
+    if ( entry.hastarget )
+    node -> look ( entry.target ) ;
+
+    node -> scale ( entry.scale ) ;
+    node -> setStatic ( entry.isstatic ) ;
+
+    if ( !iScene -> add ( node ) )
+    {
+        if ( !meshpath.empty() )
+        releaseCellMesh ( cell , meshpath ) ;
+
+        return ;
+    }
+
+    cell.nodes.push_back ( node ) ;
+    cell.meshes.push_back ( meshpath ) ;
+
+    if ( cell.attached >= cell.data -> entries.size() )
+    {
+        cell.state = StreamingCellState::Attached ;
+        cell.data.reset () ;
+    }
+}
+
+void SceneStreamer::detachNext ( Cell & cell )
+{
+    if ( cell.nodes.empty() )
+    {
+        cell.state = StreamingCellState::Unloaded ;
+        cell.memory = 0 ;
+        cell.meshusers.clear () ;
+        cell.attached = 0 ;
+        cell.data.reset () ;
+        return ;
+    }
+
+    RenderNodeHolder node = cell.nodes.back () ;
+    std::string meshpath = cell.meshes.back () ;
+
+    cell.nodes.pop_back () ;
+    cell.meshes.pop_back () ;
+
+    iScene -> remove ( node ) ;
+
+    if ( !meshpath.empty() )
+    releaseCellMesh ( cell , meshpath ) ;
+
+    if ( cell.nodes.empty() )
+    {
+        cell.state = StreamingCellState::Unloaded ;
+        cell.memory = 0 ;
+        cell.meshusers.clear () ;
+        cell.attached = 0 ;
+        cell.data.reset () ;
+    }
+}
+
+void SceneStreamer::releaseCellMesh ( Cell & cell , const std::string & path )
+{
+    auto it = cell.meshusers.find ( path ) ;
+
+    if ( it != cell.meshusers.end() && -- ( it -> second ) == 0 )
+    {
+        auto mesh = iMeshes.find ( path ) ;
+
+        if ( mesh != iMeshes.end() )
+        cell.memory -= std::min ( cell.memory , mesh -> second.memory ) ;
+
+        cell.meshusers.erase ( it ) ;
+    }
+
+    releaseMesh ( path ) ;
+}
+
+MeshHolder SceneStreamer::acquireMesh ( const std::string & path , size_t & memory )
+{
+    auto it = iMeshes.find ( path ) ;
+
+    if ( it != iMeshes.end() )
+    {
+        it -> second.users ++ ;
+        memory = it -> second.memory ;
+        return it -> second.mesh ;
+    }
+
+    MeshManagerHolder manager = ResourceManager::Get() -> getMeshManager () ;
+
+    if ( manager.isInvalid() )
+    return MeshHolder ( nullptr ) ;
+
+    MeshHolder mesh = manager -> findFirstFile ( path ) ;
+
+    if ( mesh.isInvalid() )
+    mesh = manager -> loadFile ( path , ResourceLoaderOptions () ) ;
+
+    if ( mesh.isInvalid() )
+    {
+        GreDebug ( "[WARN] Can't load mesh '" ) << path << "'." << gendl ;
+        return MeshHolder ( nullptr ) ;
+    }
+
+    MeshEntry entry ;
+    entry.mesh = mesh ;
+    entry.users = 1 ;
+    entry.memory = MeshMemory ( mesh ) ;
+
+    iMeshes [path] = entry ;
+    iMemoryUsage += entry.memory ;
+    memory = entry.memory ;
+
+    return mesh ;
+}
+
+void SceneStreamer::releaseMesh ( const std::string & path )
+{
+    auto it = iMeshes.find ( path ) ;
+
+    if ( it == iMeshes.end() )
+    return ;
+
+    if ( -- ( it -> second.users ) > 0 )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // No node uses the mesh anymore : removes it from the manager so its
+    // buffers are destroyed.
+
+    MeshManagerHolder manager = ResourceManager::Get() -> getMeshManager () ;
+
+    if ( !manager.isInvalid() )
+    manager -> remove ( it -> second.mesh ) ;
+
+    iMemoryUsage -= std::min ( iMemoryUsage , it -> second.memory ) ;
+    iMeshes.erase ( it ) ;
+}
+
+size_t SceneStreamer::MeshMemory ( const MeshHolder & mesh )
+{
+    size_t memory = 0 ;
+
+    for ( const SubMeshHolder & submesh : mesh -> getSubMeshes () )
+    {
+        if ( submesh.isInvalid() )
+        continue ;
+
+        for ( const HardwareVertexBufferHolder & buffer : submesh -> getVertexBuffers () )
+        {
+            if ( !buffer.isInvalid() )
+            memory += buffer -> getSize () ;
+        }
+
+        for ( size_t level = 0 ; level < submesh -> getLodCount () ; ++level )
+        {
+            const HardwareIndexBufferHolder & buffer = submesh -> getLodIndexBuffer ( level ) ;
+
+            if ( !buffer.isInvalid() )
+            memory += buffer -> getSize () ;
+        }
+    }
+
+    return memory ;
+}
+
+float SceneStreamer::Distance ( const BoundingBox & box , const Vector3 & point )
+{
+    if ( box.isInvalid() )
+    return std::numeric_limits < float > :: max () ;
+
+    const Vector3 & min = box.getMin () ;
+    const Vector3 & max = box.getMax () ;
+
+    Vector3 delta ( std::max ( 0.0f , std::max ( min.x - point.x , point.x - max.x ) ) ,
+                    std::max ( 0.0f , std::max ( min.y - point.y , point.y - max.y ) ) ,
+                    std::max ( 0.0f , std::max ( min.z - point.z , point.z - max.z ) ) ) ;
+
+    return glm::length ( delta ) ;
+}
+
+GreEndNamespace
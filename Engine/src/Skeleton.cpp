@@ -0,0 +1,163 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  Skeleton.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "Skeleton.h"
+
+GreBeginNamespace
+
+Matrix4 BoneTransform::toMatrix () const
+{
+    Matrix3 rs = glm::mat3_cast ( rotation ) ;
+    rs [0] *= scale.x ;
+    rs [1] *= scale.y ;
+    rs [2] *= scale.z ;
+
+    Matrix4 result ( rs ) ;
+    result [3] = Vector4 ( translation , 1.0f ) ;
+    return result ;
+}
+
+// -----------------------------------------------------------------------------
+
+Skeleton::Skeleton ( const std::string & name )
+: Resource ( name )
+{
+
+}
+
+Skeleton::~Skeleton () noexcept ( false )
+{
+
+}
+
+int Skeleton::addBone ( const std::string & name , int parent , const BoneTransform & bind )
+{
+    GreAutolock ;
+
+    if ( parent >= (int) iBones.size () || parent < -1 )
+    {
+        GreDebug ( "[WARN] Bone '" ) << name << "' has an invalid parent." << gendl ;
+        return -1 ;
+    }
+
+    Matrix4 matrix = bind.toMatrix () ;
+
+    if ( parent >= 0 )
+    matrix = iBindMatrices [parent] * matrix ;
+
+    Bone bone ;
+    bone.name = name ;
+    bone.parent = parent ;
+    bone.bind = bind ;
+    bone.inversebind = glm::inverse ( matrix ) ;
+
+    iBones.push_back ( bone ) ;
+    iBindPose.push_back ( bind ) ;
+    iBindMatrices.push_back ( matrix ) ;
+
+    return (int) iBones.size () - 1 ;
+}
+
+int Skeleton::findBone ( const std::string & name ) const
+{
+    GreAutolock ;
+
+    for ( size_t i = 0 ; i < iBones.size () ; ++i )
+    if ( iBones [i] .name == name )
+    return (int) i ;
+
+    return -1 ;
+}
+
+const std::vector < Bone > & Skeleton::getBones () const
+{
+    GreAutolock ; return iBones ;
+}
+
+size_t Skeleton::getBonesCount () const
+{
+    GreAutolock ; return iBones.size () ;
+}
+
+const Pose & Skeleton::getBindPose () const
+{
+    GreAutolock ; return iBindPose ;
+}
+
+void Skeleton::computePalette ( const Pose & pose , std::vector < Matrix4 > & palette ) const
+{
+    GreAutolock ;
+
+    const size_t count = std::min ( pose.size () , iBones.size () ) ;
+    palette.resize ( iBones.size () ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Parents come first , so 'palette' holds the model space matrix of
+    // every parent when its children are reached. The inverse bind matrix
+    // is applied in a second pass.
+
+    for ( size_t i = 0 ; i < iBones.size () ; ++i )
+    {
+        Matrix4 local = i < count ? pose [i] .toMatrix () : iBindPose [i] .toMatrix () ;
+        palette [i] = iBones [i] .parent >= 0 ? palette [iBones [i] .parent] * local : local ;
+    }
+
+    for ( size_t i = 0 ; i < iBones.size () ; ++i )
+    palette [i] = palette [i] * iBones [i] .inversebind ;
+}
+
+void Skeleton::Blend ( const Pose & from , const Pose & to , float weight , Pose & result )
+{
+    const size_t count = std::min ( from.size () , to.size () ) ;
+    result.resize ( count ) ;
+
+    for ( size_t i = 0 ; i < count ; ++i )
+    {
+        result [i] .translation = glm::mix ( from [i] .translation , to [i] .translation , weight ) ;
+        result [i] .rotation = Nlerp ( from [i] .rotation , to [i] .rotation , weight ) ;
+        result [i] .scale = glm::mix ( from [i] .scale , to [i] .scale , weight ) ;
+    }
+}
+
+Quaternion Skeleton::Nlerp ( const Quaternion & from , const Quaternion & to , float weight )
+{
+    const float sign = glm::dot ( from , to ) < 0.0f ? -1.0f : 1.0f ;
+    const float a = 1.0f - weight ;
+    const float b = weight * sign ;
+
+    Quaternion result ( a * from.w + b * to.w , a * from.x + b * to.x ,
+                        a * from.y + b * to.y , a * from.z + b * to.z ) ;
+
+    return glm::normalize ( result ) ;
+}
+
+GreEndNamespace
@@ -0,0 +1,502 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SkinnedNode.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "SkinnedNode.h"
+#include "ResourceManager.h"
+#include "JobPool.h"
+
+#include <cstring>
+
+#if defined ( __SSE__ ) || defined ( _M_X64 )
+#   include <xmmintrin.h>
+#   define GRE_SKINNING_SSE
+#endif
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+// Number of meshes in the ring.
+
+static const size_t SkinnedMeshesCount = 2 ;
+
+SkinnedNode::SkinnedNode ( const RenderScene * creator , const std::string & name )
+: RenderNode ( creator , name )
+, iMaxBone ( 0 )
+, iTime ( 0.0f ) , iLoop ( true )
+, iPreviousTime ( 0.0f ) , iPreviousLoop ( true )
+, iFadeDuration ( 0.0f ) , iFadeTime ( 0.0f )
+, iSpeed ( 1.0f ) , iAutoAnimate ( true )
+, iNextMesh ( 0 )
+{
+
+}
+
+SkinnedNode::~SkinnedNode () noexcept ( false )
+{
+
+}
+
+void SkinnedNode::setSkeleton ( const SkeletonHolder & skeleton )
+{
+    GreAutolock ;
+
+    iSkeleton = skeleton ;
+    iPose.clear () ;
+    iPreviousPose.clear () ;
+    iPalette.clear () ;
+
+    if ( !iSkeleton.isInvalid() )
+    iPose = iSkeleton -> getBindPose () ;
+}
+
+const SkeletonHolder & SkinnedNode::getSkeleton () const
+{
+    GreAutolock ; return iSkeleton ;
+}
+
+bool SkinnedNode::setSkinnedMesh ( const MeshHolder & mesh )
+{
+    GreAutolock ;
+
+    iParts.clear () ;
+    iMeshes.clear () ;
+    iMaxBone = 0 ;
+
+    if ( mesh.isInvalid() )
+    return false ;
+
+    for ( const SubMeshHolder & submesh : mesh -> getSubMeshes () )
+    {
+        if ( submesh -> getVertexBuffers () .empty () )
+        continue ;
+
+        HardwareVertexBufferHolder vbuffer = submesh -> getVertexBuffers () .front () ;
+        const VertexDescriptor & descriptor = vbuffer -> getVertexDescriptor () ;
+
+        SkinnedPart part ;
+        part.submesh = submesh ;
+        part.stride = descriptor.getSize () ;
+        part.position = part.indices = part.weights = (size_t) -1 ;
+        part.normal = -1 ;
+
+        //////////////////////////////////////////////////////////////////////
+        // Finds the components the skinning reads.
+
+        for ( const VertexAttribComponent & component : descriptor.getComponents () )
+        {
+            const size_t offset = descriptor.getOffset ( component ) ;
+            const bool float3 = component.type == VertexAttribType::Float && component.elements == 3 ;
+
+            if ( component.alias == VertexAttribAlias::Position && float3 )
+            part.position = offset ;
+            else if ( component.alias == VertexAttribAlias::Normal && float3 )
+            part.normal = (int) offset ;
+            else if ( component.alias == VertexAttribAlias::BoneIndices && component.type == VertexAttribType::UnsignedByte && component.elements == 4 )
+            part.indices = offset ;
+            else if ( component.alias == VertexAttribAlias::BoneWeights && component.type == VertexAttribType::Float && component.elements == 4 )
+            part.weights = offset ;
+        }
+
+        if ( !vbuffer -> getData () || !part.stride || part.position == (size_t) -1 ||
+             part.indices == (size_t) -1 || part.weights == (size_t) -1 )
+        {
+            GreDebug ( "[WARN] Submesh '" ) << submesh -> getName () << "' can't be skinned." << gendl ;
+            iParts.clear () ;
+            return false ;
+        }
+
+        part.count = vbuffer -> getSize () / part.stride ;
+        part.source.assign ( vbuffer -> getData () , vbuffer -> getData () + part.count * part.stride ) ;
+        part.output = part.source ;
+
+        for ( size_t v = 0 ; v < part.count ; ++v )
+        {
+            const unsigned char * indices = reinterpret_cast < const unsigned char * > ( part.source.data () + v * part.stride + part.indices ) ;
+
+            for ( int j = 0 ; j < 4 ; ++j )
+            iMaxBone = std::max ( iMaxBone , (size_t) indices [j] ) ;
+        }
+
+        iParts.push_back ( std::move ( part ) ) ;
+    }
+
+    return !iParts.empty () ;
+}
+
+void SkinnedNode::play ( const AnimationClipHolder & clip , bool loop , float fade )
+{
+    GreAutolock ;
+
+    if ( fade > 0.0f && !iClip.isInvalid() )
+    {
+        iPreviousClip = iClip ;
+        iPreviousTime = iTime ;
+        iPreviousLoop = iLoop ;
+        iFadeDuration = fade ;
+        iFadeTime = 0.0f ;
+    }
+
+    else
+    {
+        iPreviousClip.clear () ;
+        iFadeDuration = 0.0f ;
+    }
+
+    iClip = clip ;
+    iTime = 0.0f ;
+    iLoop = loop ;
+}
+
+const AnimationClipHolder & SkinnedNode::getClip () const
+{
+    GreAutolock ; return iClip ;
+}
+
+void SkinnedNode::setTime ( float time )
+{
+    GreAutolock ; iTime = time ;
+}
+
+float SkinnedNode::getTime () const
+{
+    GreAutolock ; return iTime ;
+}
+
+void SkinnedNode::setSpeed ( float speed )
+{
+    GreAutolock ; iSpeed = speed ;
+}
+
+float SkinnedNode::getSpeed () const
+{
+    GreAutolock ; return iSpeed ;
+}
+
+void SkinnedNode::setAutoAnimate ( bool value )
+{
+    GreAutolock ; iAutoAnimate = value ;
+}
+
+bool SkinnedNode::isAutoAnimate () const
+{
+    GreAutolock ; return iAutoAnimate ;
+}
+
+void SkinnedNode::animate ( float elapsed )
+{
+    GreAutolock ;
+
+    if ( iSkeleton.isInvalid() )
+    return ;
+
+    const Pose & bind = iSkeleton -> getBindPose () ;
+    elapsed *= iSpeed ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Samples the clip played. Bones it doesn't animate stay in the bind
+    // pose.
+
+    iTime += elapsed ;
+    iPose = bind ;
+
+    if ( !iClip.isInvalid() )
+    iClip -> sample ( iTime , iLoop , iPose ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Blends the previous clip out during the cross fade.
+
+    if ( !iPreviousClip.isInvalid() )
+    {
+        iPreviousTime += elapsed ;
+        iFadeTime += elapsed ;
+
+        if ( iFadeTime >= iFadeDuration )
+        {
+            iPreviousClip.clear () ;
+        }
+
+        else
+        {
+            iPreviousPose = bind ;
+            iPreviousClip -> sample ( iPreviousTime , iPreviousLoop , iPreviousPose ) ;
+            Skeleton::Blend ( iPreviousPose , iPose , iFadeTime / iFadeDuration , iPose ) ;
+        }
+    }
+
+    iSkeleton -> computePalette ( iPose , iPalette ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Skins the vertices.
+
+    if ( iParts.empty () )
+    return ;
+
+    if ( iMaxBone >= iPalette.size () )
+    {
+        GreDebug ( "[WARN] Node '" ) << getName () << "' uses more bones than its skeleton has." << gendl ;
+        return ;
+    }
+
+    iSkinnedBox = BoundingBox () ;
+
+    for ( SkinnedPart & part : iParts )
+    Skin ( part , iPalette , iSkinnedBox ) ;
+}
+
+void SkinnedNode::upload ()
+{
+    GreAutolock ;
+
+    if ( iParts.empty () )
+    return ;
+
+    ResourceManagerHolder resources = ResourceManager::Get () ;
+
+    if ( resources.isInvalid() )
+    return ;
+
+    MeshManagerHolder manager = resources -> getMeshManager () ;
+
+    if ( manager.isInvalid() )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Creates the ring the first time. Each skinned submesh has its own
+    // vertex buffer and shares the index buffer and the material of the
+    // bind submesh.
+
+    if ( iMeshes.empty () )
+    {
+        for ( size_t k = 0 ; k < SkinnedMeshesCount ; ++k )
+        {
+            std::string name = getName () + ".skinned." + std::to_string ( k ) ;
+            MeshHolder mesh = manager -> loadBlank ( name ) ;
+
+            if ( mesh.isInvalid() )
+            {
+                iMeshes.clear () ;
+                return ;
+            }
+
+            for ( const SkinnedPart & part : iParts )
+            {
+                HardwareVertexBufferHolder source = part.submesh -> getVertexBuffers () .front () ;
+                HardwareVertexBufferHolder vbuf = manager -> createVertexBuffer ( part.output.data () , part.output.size () , source -> getVertexDescriptor () ) ;
+
+                if ( vbuf.isInvalid() )
+                {
+                    GreDebug ( "[WARN] Can't create buffers for skinned mesh '" ) << name << "'." << gendl ;
+                    iMeshes.clear () ;
+                    return ;
+                }
+
+                vbuf -> setEnabled ( true ) ;
+
+                SubMeshHolder submesh = new SubMesh ( part.submesh -> getName () + ".skinned" ) ;
+                submesh -> addVertexBuffer ( vbuf ) ;
+                submesh -> setIndexBuffer ( part.submesh -> getIndexBuffer () ) ;
+                submesh -> setDefaultMaterial ( part.submesh -> getDefaultMaterial () ) ;
+                mesh -> addSubMesh ( submesh ) ;
+            }
+
+            iMeshes.push_back ( mesh ) ;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Writes the next mesh of the ring. The node's bounding box is updated
+    // from the mesh's one.
+
+    MeshHolder & mesh = iMeshes [iNextMesh] ;
+    iNextMesh = ( iNextMesh + 1 ) % iMeshes.size () ;
+
+    auto part = iParts.begin () ;
+
+    for ( const SubMeshHolder & submesh : mesh -> getSubMeshes () )
+    {
+        HardwareVertexBufferHolder vbuf = submesh -> getVertexBuffers () .front () ;
+        vbuf -> clearData () ;
+        vbuf -> addData ( part -> output.data () , part -> output.size () ) ;
+        ++part ;
+    }
+
+    mesh -> setBoundingBox ( iSkinnedBox ) ;
+    setMesh ( mesh ) ;
+    update () ;
+}
+
+const Pose & SkinnedNode::getPose () const
+{
+    GreAutolock ; return iPose ;
+}
+
+const std::vector < Matrix4 > & SkinnedNode::getPalette () const
+{
+    GreAutolock ; return iPalette ;
+}
+
+const std::vector < SkinnedPart > & SkinnedNode::getParts () const
+{
+    GreAutolock ; return iParts ;
+}
+
+void SkinnedNode::Animate ( const std::vector < SkinnedNode * > & nodes , float elapsed )
+{
+    JobPool::Get () .parallelFor ( nodes.size () , 1 , [&] ( size_t begin , size_t end ) {
+        for ( size_t i = begin ; i < end ; ++i )
+        nodes [i] -> animate ( elapsed ) ;
+    } ) ;
+
+    for ( SkinnedNode * node : nodes )
+    node -> upload () ;
+}
+
+void SkinnedNode::Skin ( SkinnedPart & part , const std::vector < Matrix4 > & palette , BoundingBox & bbox )
+{
+    const float * matrices = &palette [0] [0] [0] ;
+    const char * source = part.source.data () ;
+    char * output = part.output.data () ;
+
+    Vector3 min ( std::numeric_limits < float > ::max () ) ;
+    Vector3 max ( -std::numeric_limits < float > ::max () ) ;
+
+    for ( size_t v = 0 ; v < part.count ; ++v )
+    {
+        const char * in = source + v * part.stride ;
+        char * out = output + v * part.stride ;
+
+        const unsigned char * indices = reinterpret_cast < const unsigned char * > ( in + part.indices ) ;
+        const float * weights = reinterpret_cast < const float * > ( in + part.weights ) ;
+        const float * position = reinterpret_cast < const float * > ( in + part.position ) ;
+        float result [4] ;
+
+#ifdef GRE_SKINNING_SSE
+
+        //////////////////////////////////////////////////////////////////////
+        // Blends the four columns of the bones matrices , then transforms the
+        // position and the normal with the blended matrix. Matrices are column
+        // major , so each column is one SSE register.
+
+        __m128 c0 = _mm_setzero_ps () , c1 = _mm_setzero_ps () , c2 = _mm_setzero_ps () , c3 = _mm_setzero_ps () ;
+
+        for ( int j = 0 ; j < 4 ; ++j )
+        {
+            const float * m = matrices + indices [j] * 16 ;
+            const __m128 w = _mm_set1_ps ( weights [j] ) ;
+
+            c0 = _mm_add_ps ( c0 , _mm_mul_ps ( w , _mm_loadu_ps ( m ) ) ) ;
+            c1 = _mm_add_ps ( c1 , _mm_mul_ps ( w , _mm_loadu_ps ( m + 4 ) ) ) ;
+            c2 = _mm_add_ps ( c2 , _mm_mul_ps ( w , _mm_loadu_ps ( m + 8 ) ) ) ;
+            c3 = _mm_add_ps ( c3 , _mm_mul_ps ( w , _mm_loadu_ps ( m + 12 ) ) ) ;
+        }
+
+        __m128 p = _mm_add_ps ( _mm_add_ps ( _mm_mul_ps ( c0 , _mm_set1_ps ( position [0] ) ) ,
+                                             _mm_mul_ps ( c1 , _mm_set1_ps ( position [1] ) ) ) ,
+                                _mm_add_ps ( _mm_mul_ps ( c2 , _mm_set1_ps ( position [2] ) ) , c3 ) ) ;
+        _mm_storeu_ps ( result , p ) ;
+        memcpy ( out + part.position , result , 3 * sizeof ( float ) ) ;
+
+        if ( part.normal >= 0 )
+        {
+            const float * normal = reinterpret_cast < const float * > ( in + part.normal ) ;
+
+            __m128 n = _mm_add_ps ( _mm_add_ps ( _mm_mul_ps ( c0 , _mm_set1_ps ( normal [0] ) ) ,
+                                                 _mm_mul_ps ( c1 , _mm_set1_ps ( normal [1] ) ) ) ,
+                                    _mm_mul_ps ( c2 , _mm_set1_ps ( normal [2] ) ) ) ;
+
+            float skinned [4] ;
+            _mm_storeu_ps ( skinned , n ) ;
+            float length = sqrtf ( skinned [0] * skinned [0] + skinned [1] * skinned [1] + skinned [2] * skinned [2] ) ;
+            float scale = length > 0.0f ? 1.0f / length : 0.0f ;
+
+            for ( int k = 0 ; k < 3 ; ++k )
+            skinned [k] *= scale ;
+
+            memcpy ( out + part.normal , skinned , 3 * sizeof ( float ) ) ;
+        }
+
+#else
+
+        float c [16] = { 0.0f } ;
+
+        for ( int j = 0 ; j < 4 ; ++j )
+        {
+            const float * m = matrices + indices [j] * 16 ;
+
+            for ( int k = 0 ; k < 16 ; ++k )
+            c [k] += weights [j] * m [k] ;
+        }
+
+        for ( int k = 0 ; k < 3 ; ++k )
+        result [k] = c [k] * position [0] + c [4 + k] * position [1] + c [8 + k] * position [2] + c [12 + k] ;
+
+        memcpy ( out + part.position , result , 3 * sizeof ( float ) ) ;
+
+        if ( part.normal >= 0 )
+        {
+            const float * normal = reinterpret_cast < const float * > ( in + part.normal ) ;
+            float skinned [3] ;
+
+            for ( int k = 0 ; k < 3 ; ++k )
+            skinned [k] = c [k] * normal [0] + c [4 + k] * normal [1] + c [8 + k] * normal [2] ;
+
+            float length = sqrtf ( skinned [0] * skinned [0] + skinned [1] * skinned [1] + skinned [2] * skinned [2] ) ;
+            float scale = length > 0.0f ? 1.0f / length : 0.0f ;
+
+            for ( int k = 0 ; k < 3 ; ++k )
+            skinned [k] *= scale ;
+
+            memcpy ( out + part.normal , skinned , 3 * sizeof ( float ) ) ;
+        }
+
+#endif
+
+        min = glm::min ( min , Vector3 ( result [0] , result [1] , result [2] ) ) ;
+        max = glm::max ( max , Vector3 ( result [0] , result [1] , result [2] ) ) ;
+    }
+
+    if ( part.count )
+    bbox.add ( BoundingBox ( min , max ) ) ;
+}
+
+void SkinnedNode::onUpdateEvent ( const UpdateEvent & e )
+{
+    RenderNode::onUpdateEvent ( e ) ;
+
+    if ( isAutoAnimate () )
+    {
+        animate ( e.elapsedTime.count () ) ;
+        upload () ;
+    }
+}
+
+GreEndNamespace
@@ -0,0 +1,445 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SpatialIndex.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 24/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "SpatialIndex.h"
+
+GreBeginNamespace
+
+SpatialIndex::SpatialIndex ( float margin )
+: iTree ( margin ) , iReaders ( 0 ) , iWriting ( false )
+{
+
+}
+
+SpatialIndex::~SpatialIndex ()
+{
+
+}
+
+void SpatialIndex::update ( const RenderNodeHolder & node )
+{
+    if ( node.isInvalid() )
+    return ;
+
+    BoundingBox box = node -> getBoundingBox () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // A removed entry is released after the lock , as the last holder of
+    // its node may lock it.
+
+    std::shared_ptr < IndexedNode > released ;
+    ExclusiveLock lock ( *this ) ;
+
+    auto it = iNodes.find ( node.getObject () ) ;
+
+    if ( box.isInvalid() )
+    {
+        if ( it != iNodes.end () )
+        {
+            iTree.remove ( it -> second -> proxy ) ;
+            released = it -> second ;
+            iNodes.erase ( it ) ;
+        }
+    }
+
+    else if ( it != iNodes.end () )
+    {
+        iTree.move ( it -> second -> proxy , box ) ;
+    }
+
+    else
+    {
+        std::shared_ptr < IndexedNode > indexed = std::make_shared < IndexedNode > () ;
+        indexed -> node = node ;
+        indexed -> proxy = iTree.insert ( box , (void*) indexed.get () ) ;
+        iNodes [node.getObject ()] = indexed ;
+    }
+}
+
+void SpatialIndex::remove ( const RenderNodeHolder & node )
+{
+    if ( node.isInvalid() )
+    return ;
+
+    std::shared_ptr < IndexedNode > released ;
+    ExclusiveLock lock ( *this ) ;
+
+    auto it = iNodes.find ( node.getObject () ) ;
+
+    if ( it != iNodes.end () )
+    {
+        iTree.remove ( it -> second -> proxy ) ;
+        released = it -> second ;
+        iNodes.erase ( it ) ;
+    }
+}
+
+void SpatialIndex::clear ()
+{
+    std::unordered_map < const RenderNode * , std::shared_ptr < IndexedNode > > released ;
+    ExclusiveLock lock ( *this ) ;
+
+    iTree.clear () ;
+    iNodes.swap ( released ) ;
+}
+
+bool SpatialIndex::raycast ( const Vector3 & origin , const Vector3 & direction , float maxdistance ,
+                             RaycastHit & hit , bool triangles ) const
+{
+    float length = glm::length ( direction ) ;
+
+    if ( length <= 0.0f )
+    return false ;
+
+    Vector3 dir = direction / length ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Only the boxes are tested under the lock. Without triangles , the
+    // tree shortens the ray to each box hit and the last one is the
+    // nearest. With triangles , every box hit is kept , as the triangles
+    // are tested once the lock is released.
+
+    std::vector < std::pair < float , IndexedNodeHolder > > candidates ;
+
+    {
+        SharedLock lock ( *this ) ;
+
+        iTree.raycast ( origin , dir , maxdistance , [&] ( void * userdata , float entry ) -> float {
+
+            const IndexedNode * indexed = reinterpret_cast < const IndexedNode * > ( userdata ) ;
+
+            if ( triangles )
+            {
+                candidates.push_back ( std::make_pair ( entry , indexed -> shared_from_this () ) ) ;
+                return -1.0f ;
+            }
+
+            candidates.assign ( 1 , std::make_pair ( entry , indexed -> shared_from_this () ) ) ;
+            return entry ;
+        } ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Candidates are tested near to far , until the nearest hit is closer
+    // than the next box.
+
+    std::sort ( candidates.begin () , candidates.end () , [] ( const std::pair < float , IndexedNodeHolder > & lhs ,
+                                                              const std::pair < float , IndexedNodeHolder > & rhs ) {
+        return lhs.first < rhs.first ;
+    } ) ;
+
+    const IndexedNode * nearest = nullptr ;
+    float distance = maxdistance ;
+    bool triangle = false ;
+
+    for ( const auto & candidate : candidates )
+    {
+        if ( nearest && candidate.first >= distance )
+        break ;
+
+        float result = candidate.first ;
+        bool refined = false ;
+
+        if ( triangles )
+        {
+            float t = RaycastTriangles ( candidate.second -> node.getObject () , origin , dir , distance ) ;
+
+            if ( t == -1.0f )
+            continue ;
+
+            if ( t >= 0.0f )
+            {
+                result = t ;
+                refined = true ;
+            }
+        }
+
+        if ( result < distance || !nearest )
+        {
+            nearest = candidate.second.get () ;
+            distance = result ;
+            triangle = refined ;
+        }
+    }
+
+    if ( nearest )
+    {
+        hit.node = nearest -> node ;
+        hit.distance = distance ;
+        hit.point = origin + dir * distance ;
+        hit.triangle = triangle ;
+    }
+
+    return nearest != nullptr ;
+}
+
+void SpatialIndex::overlapSphere ( const Vector3 & center , float radius , RenderNodeHolderList & result ) const
+{
+    IndexedNodeHolderList entries ;
+
+    {
+        SharedLock lock ( *this ) ;
+
+        iTree.querySphere ( center , radius , [&] ( void * userdata ) -> bool {
+            entries.push_back ( reinterpret_cast < const IndexedNode * > ( userdata ) -> shared_from_this () ) ;
+            return true ;
+        } ) ;
+    }
+
+    for ( const IndexedNodeHolder & entry : entries )
+    result.push_back ( entry -> node ) ;
+}
+
+void SpatialIndex::overlapBox ( const BoundingBox & box , RenderNodeHolderList & result ) const
+{
+    if ( box.isInvalid() )
+    return ;
+
+    IndexedNodeHolderList entries ;
+
+    {
+        SharedLock lock ( *this ) ;
+
+        iTree.queryBox ( box.getMin () , box.getMax () , [&] ( void * userdata ) -> bool {
+            entries.push_back ( reinterpret_cast < const IndexedNode * > ( userdata ) -> shared_from_this () ) ;
+            return true ;
+        } ) ;
+    }
+
+    for ( const IndexedNodeHolder & entry : entries )
+    result.push_back ( entry -> node ) ;
+}
+
+void SpatialIndex::nearest ( const Vector3 & point , size_t count , RenderNodeHolderList & result ) const
+{
+    std::vector < std::pair < float , void * > > nodes ;
+    IndexedNodeHolderList entries ;
+
+    nodes.reserve ( count ) ;
+    entries.reserve ( count ) ;
+
+    {
+        SharedLock lock ( *this ) ;
+
+        iTree.nearest ( point , count , [&] ( void * , const Vector3 & min , const Vector3 & max ) -> float {
+            return std::sqrt ( AabbTree::SquaredDistance ( min , max , point ) ) ;
+        } , nodes ) ;
+
+        for ( auto & node : nodes )
+        entries.push_back ( reinterpret_cast < const IndexedNode * > ( node.second ) -> shared_from_this () ) ;
+    }
+
+    for ( const IndexedNodeHolder & entry : entries )
+    result.push_back ( entry -> node ) ;
+}
+
+size_t SpatialIndex::getCount () const
+{
+    SharedLock lock ( *this ) ;
+    return iTree.getCount () ;
+}
+
+float SpatialIndex::RaycastTriangles ( const RenderNode * node , const Vector3 & origin ,
+                                       const Vector3 & direction , float maxdistance )
+{
+    MeshHolder mesh = node -> getMesh () ;
+
+    if ( mesh.isInvalid() )
+    return -2.0f ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Triangles are tested in model space : the ray is transformed by the
+    // inverse model matrix. Distances along the transformed direction are
+    // converted back to world distances at the end.
+
+    Matrix4 inverse = glm::inverse ( node -> getModelMatrix () ) ;
+    Vector3 o = Vector3 ( inverse * Vector4 ( origin , 1.0f ) ) ;
+    Vector3 d = Vector3 ( inverse * Vector4 ( direction , 0.0f ) ) ;
+
+    float scale = glm::length ( d ) ;
+
+    if ( scale <= 0.0f )
+    return -2.0f ;
+
+    d = d / scale ;
+    float localmax = maxdistance * scale ;
+
+    float nearest = -1.0f ;
+    bool tested = false ;
+
+    for ( const SubMeshHolder & submesh : mesh -> getSubMeshes () )
+    {
+        if ( submesh.isInvalid() )
+        continue ;
+
+        //////////////////////////////////////////////////////////////////////
+        // Looks for a vertex buffer with a CPU copy and a float position ,
+        // as 'OcclusionBuffer::addMesh()' does. The full detail index buffer
+        // is used , whatever the selected level of detail.
+
+        const char * vertices = nullptr ;
+        size_t stride = 0 , offset = 0 , vcount = 0 ;
+
+        for ( const HardwareVertexBufferHolder & buffer : submesh -> getVertexBuffers () )
+        {
+            if ( buffer.isInvalid() || !buffer -> getData () )
+            continue ;
+
+            const VertexDescriptor & desc = buffer -> getVertexDescriptor () ;
+
+            for ( const VertexAttribComponent & component : desc.getComponents () )
+            {
+                if ( component.alias != VertexAttribAlias::Position || component.type != VertexAttribType::Float || component.elements < 3 )
+                continue ;
+
+                stride = desc.getStride ( component ) ;
+                offset = desc.getOffset ( component ) ;
+
+                if ( stride )
+                {
+                    vertices = buffer -> getData () ;
+                    vcount = buffer -> getSize () / stride ;
+                }
+
+                break ;
+            }
+
+            if ( vertices )
+            break ;
+        }
+
+        if ( !vertices )
+        continue ;
+
+        const HardwareIndexBufferHolder & ibuffer = submesh -> getLodIndexBuffer ( 0 ) ;
+        const char * indices = nullptr ;
+        size_t isize = 0 , icount = vcount ;
+
+        if ( !ibuffer.isInvalid() )
+        {
+            const IndexDescriptor & idesc = ibuffer -> getIndexDescriptor () ;
+            isize = IndexTypeGetSize ( idesc.getType () ) ;
+
+            if ( !ibuffer -> getData () || idesc.getMode () != IndexDrawmode::Triangles || !isize )
+            continue ;
+
+            indices = ibuffer -> getData () ;
+            icount = ibuffer -> getSize () / isize ;
+        }
+
+        tested = true ;
+
+        auto index = [&] ( size_t i ) -> size_t {
+            if ( !indices ) return i ;
+            if ( isize == sizeof ( unsigned char ) ) return reinterpret_cast < const unsigned char * > ( indices ) [i] ;
+            if ( isize == sizeof ( unsigned short ) ) return reinterpret_cast < const unsigned short * > ( indices ) [i] ;
+            return reinterpret_cast < const unsigned int * > ( indices ) [i] ;
+        } ;
+
+        auto position = [&] ( size_t v ) -> Vector3 {
+            const float * p = reinterpret_cast < const float * > ( vertices + v * stride + offset ) ;
+            return Vector3 ( p[0] , p[1] , p[2] ) ;
+        } ;
+
+        for ( size_t i = 0 ; i + 2 < icount ; i += 3 )
+        {
+            size_t i0 = index ( i ) , i1 = index ( i + 1 ) , i2 = index ( i + 2 ) ;
+
+            if ( i0 >= vcount || i1 >= vcount || i2 >= vcount )
+            continue ;
+
+            //////////////////////////////////////////////////////////////////////
+            // Moller-Trumbore , both faces.
+
+            Vector3 p0 = position ( i0 ) ;
+            Vector3 e1 = position ( i1 ) - p0 ;
+            Vector3 e2 = position ( i2 ) - p0 ;
+
+            Vector3 pvec = glm::cross ( d , e2 ) ;
+            float det = glm::dot ( e1 , pvec ) ;
+
+            if ( std::fabs ( det ) < 1e-8f )
+            continue ;
+
+            float invdet = 1.0f / det ;
+            Vector3 tvec = o - p0 ;
+
+            float u = glm::dot ( tvec , pvec ) * invdet ;
+            if ( u < 0.0f || u > 1.0f ) continue ;
+
+            Vector3 qvec = glm::cross ( tvec , e1 ) ;
+            float v = glm::dot ( d , qvec ) * invdet ;
+            if ( v < 0.0f || u + v > 1.0f ) continue ;
+
+            float t = glm::dot ( e2 , qvec ) * invdet ;
+
+            if ( t >= 0.0f && t <= localmax && ( nearest < 0.0f || t < nearest ) )
+            nearest = t ;
+        }
+    }
+
+    if ( !tested )
+    return -2.0f ;
+
+    return nearest < 0.0f ? -1.0f : nearest / scale ;
+}
+
+void SpatialIndex::lockShared () const
+{
+    std::unique_lock < std::mutex > lock ( iMutex ) ;
+    iCondition.wait ( lock , [this] () { return !iWriting ; } ) ;
+    iReaders ++ ;
+}
+
+void SpatialIndex::unlockShared () const
+{
+    std::unique_lock < std::mutex > lock ( iMutex ) ;
+
+    if ( -- iReaders == 0 )
+    iCondition.notify_all () ;
+}
+
+void SpatialIndex::lockExclusive () const
+{
+    std::unique_lock < std::mutex > lock ( iMutex ) ;
+    iCondition.wait ( lock , [this] () { return !iWriting && iReaders == 0 ; } ) ;
+    iWriting = true ;
+}
+
+void SpatialIndex::unlockExclusive () const
+{
+    std::unique_lock < std::mutex > lock ( iMutex ) ;
+    iWriting = false ;
+    iCondition.notify_all () ;
+}
+
+GreEndNamespace
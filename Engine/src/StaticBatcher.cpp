@@ -0,0 +1,528 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  StaticBatcher.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 20/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "StaticBatcher.h"
+#include "ResourceManager.h"
+#include "JobPool.h"
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+/// @brief CPU data of a part , read on the calling thread before the
+/// merging jobs start.
+struct StaticBatchInput
+{
+    Matrix4 model ;
+    const char * vertices ;
+    size_t vertexcount ;
+    const char * indices ;
+    size_t indexsize ;
+    size_t indexcount ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Result of a merging job.
+struct StaticBatchOutput
+{
+    std::vector < char > vertices ;
+    std::vector < unsigned int > indices ;
+    BoundingBox bbox ;
+};
+
+bool StaticBatcher::ChunkKey::operator < ( const ChunkKey & rhs ) const
+{
+    if ( group != rhs.group ) return group < rhs.group ;
+    if ( x != rhs.x ) return x < rhs.x ;
+    if ( y != rhs.y ) return y < rhs.y ;
+    return z < rhs.z ;
+}
+
+StaticBatcher::StaticBatcher ( float chunksize )
+: iChunkSize ( chunksize ) , iBatchesCount ( 0 )
+{
+
+}
+
+StaticBatcher::~StaticBatcher ()
+{
+
+}
+
+bool StaticBatcher::add ( const RenderNodeHolder & node )
+{
+    if ( node.isInvalid() )
+    return false ;
+
+    if ( iNodes.find ( node.getObject() ) != iNodes.end() )
+    return true ;
+
+    const MeshHolder & mesh = node -> getMesh () ;
+    const BoundingBox & bbox = node -> getBoundingBox () ;
+
+    if ( mesh.isInvalid() || bbox.isInvalid() || mesh -> getSubMeshes().empty() )
+    return false ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Every submesh must be mergeable , else the node is drawn normally.
+
+    for ( auto & submesh : mesh -> getSubMeshes () )
+    if ( !IsMergeable ( submesh ) )
+    return false ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The cell is chosen from the bounding box center , so a node always
+    // belongs to exactly one chunk per group.
+
+    Vector3 center = ( bbox.getMin() + bbox.getMax() ) * 0.5f ;
+    float size = iChunkSize > 0.0f ? iChunkSize : 1.0f ;
+
+    int x = (int) std::floor ( center.x / size ) ;
+    int y = (int) std::floor ( center.y / size ) ;
+    int z = (int) std::floor ( center.z / size ) ;
+
+    std::vector < ChunkKey > & keys = iNodes [node.getObject()] ;
+
+    for ( auto & submesh : mesh -> getSubMeshes () )
+    {
+        MaterialHolder material = node -> getMaterial () ;
+
+        if ( material.isInvalid() )
+        material = submesh -> getDefaultMaterial () ;
+
+        const VertexDescriptor & descriptor = submesh -> getVertexBuffers().front() -> getVertexDescriptor () ;
+
+        ChunkKey key ;
+        key.group = findGroup ( material , descriptor ) ;
+        key.x = x ; key.y = y ; key.z = z ;
+
+        Chunk & chunk = iChunks [key] ;
+        chunk.parts.push_back ( { node , submesh } ) ;
+        chunk.dirty = true ;
+
+        if ( std::find_if ( keys.begin() , keys.end() , [&key] ( const ChunkKey & k ) { return !(k < key) && !(key < k) ; } ) == keys.end() )
+        keys.push_back ( key ) ;
+    }
+
+    return true ;
+}
+
+void StaticBatcher::remove ( const RenderNodeHolder & node )
+{
+    if ( node.isInvalid() )
+    return ;
+
+    auto it = iNodes.find ( node.getObject() ) ;
+
+    if ( it == iNodes.end() )
+    return ;
+
+    for ( const ChunkKey & key : it->second )
+    {
+        auto cit = iChunks.find ( key ) ;
+
+        if ( cit == iChunks.end() )
+        continue ;
+
+        std::vector < Part > & parts = cit->second.parts ;
+        parts.erase ( std::remove_if ( parts.begin() , parts.end() , [&node] ( const Part & part ) {
+            return part.node == node ;
+        } ) , parts.end() ) ;
+
+        cit->second.dirty = true ;
+    }
+
+    iNodes.erase ( it ) ;
+
+    RenderNodeHolder removed = node ;
+    removed -> setBatched ( false ) ;
+}
+
+bool StaticBatcher::isDirty () const
+{
+    for ( auto & it : iChunks )
+    if ( it.second.dirty )
+    return true ;
+
+    return false ;
+}
+
+void StaticBatcher::build ( const RenderScene * scene )
+{
+    MeshManagerHolder manager = ResourceManager::Get () -> getMeshManager () ;
+
+    if ( manager.isInvalid() )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Collects the dirty chunks and reads their data. Empty chunks are
+    // destroyed directly.
+
+    std::vector < Chunk * > chunks ;
+    std::vector < size_t > groups ;
+    std::vector < std::vector < StaticBatchInput > > inputs ;
+
+    for ( auto it = iChunks.begin () ; it != iChunks.end () ; )
+    {
+        Chunk & chunk = it->second ;
+
+        if ( !chunk.dirty )
+        {
+            ++it ;
+            continue ;
+        }
+
+        if ( !chunk.batch.isInvalid() )
+        {
+            manager -> remove ( chunk.batch -> getMesh () ) ;
+            chunk.batch.clear () ;
+        }
+
+        if ( chunk.parts.empty() )
+        {
+            it = iChunks.erase ( it ) ;
+            continue ;
+        }
+
+        std::vector < StaticBatchInput > input ;
+
+        for ( const Part & part : chunk.parts )
+        {
+            HardwareVertexBufferHolder vbuffer = part.submesh -> getVertexBuffers().front() ;
+            HardwareIndexBufferHolder ibuffer = part.submesh -> getIndexBuffer () ;
+
+            StaticBatchInput entry ;
+            entry.model = part.node -> getModelMatrix () ;
+            entry.vertices = vbuffer -> getData () ;
+            entry.vertexcount = vbuffer -> getSize () / vbuffer -> getVertexDescriptor().getSize () ;
+            entry.indices = nullptr ;
+            entry.indexsize = 0 ;
+            entry.indexcount = 0 ;
+
+            if ( !ibuffer.isInvalid() )
+            {
+                entry.indices = ibuffer -> getData () ;
+                entry.indexsize = IndexTypeGetSize ( ibuffer -> getIndexDescriptor().getType() ) ;
+                entry.indexcount = ibuffer -> getSize () / entry.indexsize ;
+            }
+
+            input.push_back ( entry ) ;
+        }
+
+        chunks.push_back ( &chunk ) ;
+        groups.push_back ( it->first.group ) ;
+        inputs.push_back ( input ) ;
+        ++it ;
+    }
+
+    if ( chunks.empty() )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Merges the chunks in parallel. Positions are transformed by the model
+    // matrix , normals , tangents and binormals by the normal matrix.
+
+    std::vector < StaticBatchOutput > outputs ( chunks.size () ) ;
+    std::vector < VertexDescriptor > descriptors ( chunks.size () ) ;
+
+    for ( size_t i = 0 ; i < chunks.size () ; ++i )
+    descriptors [i] = iGroups [groups[i]] .descriptor ;
+
+    JobPool::Get () .parallelFor ( chunks.size () , 1 , [&] ( size_t begin , size_t end )
+    {
+        for ( size_t c = begin ; c < end ; ++c )
+        {
+            const VertexDescriptor & descriptor = descriptors [c] ;
+            StaticBatchOutput & output = outputs [c] ;
+            const size_t stride = descriptor.getSize () ;
+
+            for ( const StaticBatchInput & input : inputs [c] )
+            {
+                const unsigned int first = (unsigned int) ( output.vertices.size () / stride ) ;
+                const Matrix3 normalmatrix = glm::transpose ( glm::inverse ( Matrix3 ( input.model ) ) ) ;
+
+                output.vertices.insert ( output.vertices.end () , input.vertices , input.vertices + input.vertexcount * stride ) ;
+                char * vertices = output.vertices.data () + first * stride ;
+
+                for ( const VertexAttribComponent & component : descriptor.getComponents () )
+                {
+                    if ( component.type != VertexAttribType::Float || component.elements != 3 )
+                    continue ;
+
+                    bool position = component.alias == VertexAttribAlias::Position ;
+                    bool direction = component.alias == VertexAttribAlias::Normal ||
+                                     component.alias == VertexAttribAlias::Tangents ||
+                                     component.alias == VertexAttribAlias::Binormals ;
+
+                    if ( !position && !direction )
+                    continue ;
+
+                    size_t offset = descriptor.getOffset ( component ) ;
+
+                    for ( size_t v = 0 ; v < input.vertexcount ; ++v )
+                    {
+                        float * p = reinterpret_cast < float * > ( vertices + v * stride + offset ) ;
+                        Vector3 value ( p[0] , p[1] , p[2] ) ;
+
+                        if ( position )
+                        {
+                            value = Vector3 ( input.model * Vector4 ( value , 1.0f ) ) ;
+                            output.bbox.add ( value ) ;
+                        }
+
+                        else if ( glm::length ( value ) > 0.0f )
+                        {
+                            value = glm::normalize ( normalmatrix * value ) ;
+                        }
+
+                        p[0] = value.x ; p[1] = value.y ; p[2] = value.z ;
+                    }
+                }
+
+                //////////////////////////////////////////////////////////////////////
+                // Indices are offset by the vertices already merged. Without index
+                // buffer , vertices are drawn in order.
+
+                if ( !input.indices )
+                {
+                    for ( size_t i = 0 ; i < input.vertexcount ; ++i )
+                    output.indices.push_back ( first + (unsigned int) i ) ;
+                    continue ;
+                }
+
+                for ( size_t i = 0 ; i < input.indexcount ; ++i )
+                {
+                    unsigned int index ;
+
+                    if ( input.indexsize == sizeof ( unsigned char ) )
+                    index = reinterpret_cast < const unsigned char * > ( input.indices ) [i] ;
+                    else if ( input.indexsize == sizeof ( unsigned short ) )
+                    index = reinterpret_cast < const unsigned short * > ( input.indices ) [i] ;
+                    else
+                    index = reinterpret_cast < const unsigned int * > ( input.indices ) [i] ;
+
+                    output.indices.push_back ( first + index ) ;
+                }
+            }
+        }
+    } ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Creates the buffers and the batch nodes on this thread.
+
+    IndexDescriptor idesc ;
+    idesc.setMode ( IndexDrawmode::Triangles ) ;
+    idesc.setType ( IndexType::UnsignedInteger ) ;
+
+    for ( size_t c = 0 ; c < chunks.size () ; ++c )
+    {
+        Chunk & chunk = *chunks [c] ;
+        StaticBatchOutput & output = outputs [c] ;
+        chunk.dirty = false ;
+
+        if ( output.indices.empty() )
+        continue ;
+
+        std::string name = "staticbatch." + std::to_string ( iBatchesCount++ ) ;
+
+        HardwareVertexBufferHolder vbuf = manager -> createVertexBuffer ( output.vertices.data () , output.vertices.size () , descriptors [c] ) ;
+        HardwareIndexBufferHolder ibuf = manager -> createIndexBuffer ( output.indices.data () , output.indices.size () * sizeof ( unsigned int ) , idesc ) ;
+
+        if ( vbuf.isInvalid() || ibuf.isInvalid() )
+        {
+            GreDebug ( "[WARN] Can't create buffers for static batch '" ) << name << "'." << gendl ;
+            continue ;
+        }
+
+        vbuf -> setEnabled ( true ) ;
+        ibuf -> setEnabled ( true ) ;
+
+        MeshHolder mesh = manager -> loadBlank ( name ) ;
+
+        if ( mesh.isInvalid() )
+        continue ;
+
+        SubMeshHolder submesh = new SubMesh ( name + ".submesh" ) ;
+        submesh -> addVertexBuffer ( vbuf ) ;
+        submesh -> setIndexBuffer ( ibuf ) ;
+        submesh -> setDefaultMaterial ( iGroups [groups[c]] .material ) ;
+        mesh -> addSubMesh ( submesh ) ;
+        mesh -> setBoundingBox ( output.bbox ) ;
+
+        RenderNodeHolder batch = new RenderNode ( scene , name ) ;
+        batch -> setMesh ( mesh ) ;
+        batch -> setBoundingBox ( output.bbox ) ;
+        batch -> update () ;
+
+        chunk.batch = batch ;
+
+        for ( Part & part : chunk.parts )
+        part.node -> setBatched ( true ) ;
+    }
+}
+
+void StaticBatcher::visible ( const Frustum & frustum , RenderNodeHolderList & result ) const
+{
+    for ( auto & it : iChunks )
+    {
+        const RenderNodeHolder & batch = it.second.batch ;
+
+        if ( batch.isInvalid() )
+        continue ;
+
+        if ( frustum.intersect ( batch -> getBoundingBox () ) != IntersectionResult::Outside )
+        result.push_back ( batch ) ;
+    }
+}
+
+void StaticBatcher::visible ( const Frustum & frustum , std::vector < const RenderNode * > & result ) const
+{
+    for ( auto & it : iChunks )
+    {
+        const RenderNodeHolder & batch = it.second.batch ;
+
+        if ( batch.isInvalid() )
+        continue ;
+
+        if ( frustum.intersect ( batch -> getBoundingBox () ) != IntersectionResult::Outside )
+        result.push_back ( batch.getObject () ) ;
+    }
+}
+
+RenderNodeHolderList StaticBatcher::getBatches () const
+{
+    RenderNodeHolderList result ;
+
+    for ( auto & it : iChunks )
+    if ( !it.second.batch.isInvalid() )
+    result.push_back ( it.second.batch ) ;
+
+    return result ;
+}
+
+float StaticBatcher::getChunkSize () const
+{
+    return iChunkSize ;
+}
+
+void StaticBatcher::setChunkSize ( float size )
+{
+    if ( size == iChunkSize )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Every node must be distributed in the new cells.
+
+    std::vector < RenderNodeHolder > nodes ;
+
+    for ( auto & it : iChunks )
+    for ( const Part & part : it.second.parts )
+    if ( std::find ( nodes.begin() , nodes.end() , part.node ) == nodes.end() )
+    nodes.push_back ( part.node ) ;
+
+    clear () ;
+    iChunkSize = size ;
+
+    for ( auto & node : nodes )
+    add ( node ) ;
+}
+
+size_t StaticBatcher::getChunksCount () const
+{
+    return iChunks.size () ;
+}
+
+void StaticBatcher::clear ()
+{
+    MeshManagerHolder manager = ResourceManager::Get () -> getMeshManager () ;
+
+    for ( auto & it : iChunks )
+    {
+        for ( Part & part : it.second.parts )
+        part.node -> setBatched ( false ) ;
+
+        if ( !it.second.batch.isInvalid() && !manager.isInvalid() )
+        manager -> remove ( it.second.batch -> getMesh () ) ;
+    }
+
+    iChunks.clear () ;
+    iNodes.clear () ;
+    iGroups.clear () ;
+}
+
+size_t StaticBatcher::findGroup ( const MaterialHolder & material , const VertexDescriptor & descriptor )
+{
+    for ( size_t i = 0 ; i < iGroups.size () ; ++i )
+    if ( iGroups[i].material == material && iGroups[i].descriptor == descriptor )
+    return i ;
+
+    iGroups.push_back ( { material , descriptor } ) ;
+    return iGroups.size () - 1 ;
+}
+
+bool StaticBatcher::IsMergeable ( const SubMeshHolder & submesh )
+{
+    if ( submesh.isInvalid() )
+    return false ;
+
+    if ( submesh -> getVertexBuffers().size() != 1 || !submesh -> getSharedVertexBuffers().empty() )
+    return false ;
+
+    const HardwareVertexBufferHolder & vbuffer = submesh -> getVertexBuffers().front() ;
+
+    if ( vbuffer.isInvalid() || !vbuffer -> getData () || !vbuffer -> getSize () )
+    return false ;
+
+    const VertexDescriptor & descriptor = vbuffer -> getVertexDescriptor () ;
+    bool position = false ;
+
+    for ( const VertexAttribComponent & component : descriptor.getComponents () )
+    if ( component.alias == VertexAttribAlias::Position )
+    position = component.elements == 3 && component.type == VertexAttribType::Float ;
+
+    if ( !descriptor.getSize () || !position )
+    return false ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Checks the index buffer , if there is one.
+
+    const HardwareIndexBufferHolder & ibuffer = submesh -> getIndexBuffer () ;
+
+    if ( ibuffer.isInvalid() )
+    return true ;
+
+    if ( !ibuffer -> getData () || ibuffer -> getIndexDescriptor().getMode () != IndexDrawmode::Triangles )
+    return false ;
+
+    return IndexTypeGetSize ( ibuffer -> getIndexDescriptor().getType () ) > 0 ;
+}
+
+GreEndNamespace
@@ -33,6 +33,7 @@
 #include "Technique.h"
 #include "Renderer.h"
 #include "ResourceManager.h"
+#include "RenderStatistics.h"
 
 #include "TechniqueFilePreprocessor.h"
 
@@ -55,6 +56,8 @@ TechniqueParam TechniqueParamFromString ( const std::string & p )
     if ( p == "ProjectionViewMatrix" ) return TechniqueParam::ProjectionViewMatrix ;
     if ( p == "NormalMatrix" ) return TechniqueParam::NormalMatrix ;
     if ( p == "NormalMatrix3" ) return TechniqueParam::NormalMatrix3 ;
+    if ( p == "ModelViewMatrix" ) return TechniqueParam::ModelViewMatrix ;
+    if ( p == "ProjectionViewModelMatrix" ) return TechniqueParam::ProjectionViewModelMatrix ;
 
     if ( p == "CameraPosition" ) return TechniqueParam::CameraPosition ;
     if ( p == "CameraDirection" ) return TechniqueParam::CameraDirection ;
@@ -77,6 +80,7 @@ TechniqueParam TechniqueParamFromString ( const std::string & p )
     if ( p == "Light7" ) return TechniqueParam::Light7 ;
     if ( p == "Light8" ) return TechniqueParam::Light8 ;
     if ( p == "Light9" ) return TechniqueParam::Light9 ;
+    if ( p == "LightCount" ) return TechniqueParam::LightCount ;
 
     if ( p == "LightAmbient" ) return TechniqueParam::LightAmbient ;
     if ( p == "LightDiffuse" ) return TechniqueParam::LightDiffuse ;
@@ -136,6 +140,16 @@ Technique::Technique ( const std::string & name )
     iLightingMode = TechniqueLightingMode::AllLights ;
     iCurrentLight = -1 ;
     iSelfRendered = false ;
+    iUniformTableDirty = true ;
+    iUniformTableProgram = nullptr ;
+    iUniformTableVersion = 0 ;
+    iPipelineStateDirty = true ;
+
+    for ( size_t i = 0 ; i < UniformBlockBindingCount ; ++i )
+    {
+        iBlocks [i].setLayout ( UniformBlockLayout::Standard ( (UniformBlockBinding) i ) ) ;
+        iBoundBlocks [i] = nullptr ;
+    }
 
     // Loads always the null framebuffer.
 
@@ -157,7 +171,7 @@ const HardwareProgramHolder & Technique::getHardwareProgram () const
 
 void Technique::setHardwareProgram ( const HardwareProgramHolder& program )
 {
-    GreAutolock ; iProgram = program ;
+    GreAutolock ; iProgram = program ; iUniformTableDirty = true ; iPipelineStateDirty = true ;
 }
 
 TechniqueLightingMode Technique::getLightingMode () const
@@ -177,12 +191,40 @@ const RenderFramebufferHolder & Technique::getFramebuffer() const
 
 void Technique::setFramebuffer(const RenderFramebufferHolder &framebuffer)
 {
-    GreAutolock ; iFramebuffer = framebuffer ;
+    GreAutolock ; iFramebuffer = framebuffer ; iPipelineStateDirty = true ;
+}
+
+void Technique::setRasterState ( const RasterState & state )
+{
+    GreAutolock ; iRasterState = state ; iPipelineStateDirty = true ;
+}
+
+const RasterState & Technique::getRasterState () const
+{
+    GreAutolock ; return iRasterState ;
+}
+
+const PipelineStateHolder & Technique::getPipelineState () const
+{
+    GreAutolock ;
+
+    //////////////////////////////////////////////////////////////////////
+    // A new state is created , so a renderer still holding the old one sees
+    // a different state.
+
+    if ( iPipelineStateDirty || iPipelineState.isInvalid() ||
+        ( !iProgram.isInvalid() && iPipelineState -> getLinkVersion() != iProgram -> getLinkVersion() ) )
+    {
+        iPipelineState = new PipelineState ( getName () , iProgram , iFramebuffer , iRasterState , iAttribAliases ) ;
+        iPipelineStateDirty = false ;
+    }
+
+    return iPipelineState ;
 }
 
 void Technique::setAlias ( const TechniqueParam & param , const std::string & alias )
 {
-    GreAutolock ; iAliases[param] = alias ;
+    GreAutolock ; iAliases[param] = alias ; iUniformTableDirty = true ;
 }
 
 std::string Technique::getAlias ( const TechniqueParam & param ) const
@@ -203,6 +245,31 @@ void Technique::setAliasedParameterStructValue (const TechniqueParam & alias1 ,
     if ( iProgram.isInvalid() )
     return ;
 
+    //////////////////////////////////////////////////////////////////////
+    // Uses the uniforms table when the structure alias is in it.
+
+    updateUniformTable () ;
+    int slot = getUniformSlot ( alias1 ) ;
+
+    if ( slot >= 0 )
+    {
+        if ( !slot || !iUniformSlots [slot] )
+        {
+            setAliasedParameterValue ( alias2 , type , value ) ;
+            return ;
+        }
+
+        if ( !iProgram->binded() )
+        return ;
+
+        const TechniqueUniform & uniform = iUniformTable [slot * TechniqueParamCount + (size_t) alias2] ;
+
+        if ( uniform.location >= 0 && uniform.type == type )
+        iProgram -> setUniform ( uniform.location , type , value ) ;
+
+        return ;
+    }
+
     //////////////////////////////////////////////////////////////////////
     // Checks both aliases. If both are empty , don't send . If one is empty ,
     // sends to second.
@@ -234,23 +301,28 @@ void Technique::setAliasedParameterValue (const TechniqueParam & name ,
     if ( iProgram.isInvalid() )
     return ;
 
+    updateUniformTable () ;
+
     //////////////////////////////////////////////////////////////////////
     // Checks for an eventual 'GlobSet' action.
 
-    auto globset = findGlobSets ( name ) ;
+    if ( iGlobSetParams [(size_t) name] )
+    {
+        auto globset = findGlobSets ( name ) ;
 
-    for ( auto globsetit : globset )
-    ResourceManager::Get() -> getTechniqueManager () -> setGlobalValue ( globsetit , value ) ;
+        for ( auto globsetit : globset )
+        ResourceManager::Get() -> getTechniqueManager () -> setGlobalValue ( globsetit , value ) ;
+    }
 
     //////////////////////////////////////////////////////////////////////
     // Now see if the program has the given parameter registered.
 
     if ( iProgram->binded() )
     {
-        auto alias = getAlias (name) ;
-        if ( alias.empty() ) return ;
+        const TechniqueUniform & uniform = iUniformTable [(size_t) name] ;
 
-        iProgram -> setUniform ( alias , type , value ) ;
+        if ( uniform.location >= 0 && uniform.type == type )
+        iProgram -> setUniform ( uniform.location , type , value ) ;
     }
 }
 
@@ -271,6 +343,7 @@ void Technique::setNamedParameterValue (const std::string & name ,
 void Technique::bind () const
 {
     GreAutolock ;
+    RenderStatistics::CountTechniqueBind () ;
 
     if ( !iFramebuffer.isInvalid() )
     iFramebuffer -> bind () ;
@@ -281,21 +354,105 @@ void Technique::bind () const
     if ( !iProgram.isInvalid() )
     {
         iProgram -> use () ;
+        bindParameters () ;
+    }
+}
 
-        //////////////////////////////////////////////////////////////////////
-        // If bound , we must check the globals associated with this technique.
+void Technique::bind ( const Renderer * renderer ) const
+{
+    GreAutolock ;
 
-        if ( iProgram -> binded() )
+    if ( !renderer )
+    {
+        bind () ;
+        return ;
+    }
+
+    RenderStatistics::CountTechniqueBind () ;
+    renderer -> bindPipelineState ( getPipelineState () ) ;
+
+    if ( !iProgram.isInvalid() )
+    bindParameters () ;
+}
+
+void Technique::bindParameters () const
+{
+    //////////////////////////////////////////////////////////////////////
+    // If bound , we must check the blocks and the globals associated with
+    // this technique.
+
+    if ( !iProgram -> binded() )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Binding points are shared by every programs : our own blocks are
+    // bound again , the others will be set again by their owners.
+
+    for ( size_t i = 0 ; i < UniformBlockBindingCount ; ++i )
+    {
+        const UniformBlock * bound = iBoundBlocks [i] ;
+        iBoundBlocks [i] = nullptr ;
+
+        if ( bound == &iBlocks [i] )
+        setUniformBlock ( (UniformBlockBinding) i , iBlocks [i] ) ;
+    }
+
+    auto techmanager = ResourceManager::Get() -> getTechniqueManager() ;
+
+    if ( hasUniformBlock ( UniformBlockBinding::Frame ) &&
+         setUniformBlock ( UniformBlockBinding::Frame , techmanager -> getGlobalsBlock () ) )
+    return ;
+
+    for ( auto globalias : iGlobALiases )
+    {
+        auto global = techmanager -> getGlobal ( globalias.first ) ;
+        iProgram -> setUniform ( globalias.second , global.type , global.value ) ;
+    }
+}
+
+bool Technique::hasUniformBlock ( const UniformBlockBinding & binding ) const
+{
+    GreAutolock ;
+    return !iProgram.isInvalid() && iProgram -> hasUniformBlock ( binding ) ;
+}
+
+bool Technique::setUniformBlock ( const UniformBlockBinding & binding , const UniformBlock & block ) const
+{
+    GreAutolock ;
+
+    if ( iProgram.isInvalid() || !block.getSize() || !iProgram -> hasUniformBlock ( binding ) )
+    return false ;
+
+    UniformArena & arena = UniformArena::Get () ;
+    const size_t generation = arena.getGeneration () ;
+    const size_t offset = arena.push ( block ) ;
+
+    if ( !iProgram -> setUniformBlock ( binding , arena , offset , block.getSize() ) )
+    return false ;
+
+    iBoundBlocks [(size_t) binding] = &block ;
+
+    //////////////////////////////////////////////////////////////////////
+    // If the arena started again at zero , the blocks bound before are not
+    // staged anymore : stages and binds them again.
+
+    if ( arena.getGeneration () != generation )
+    {
+        for ( size_t i = 0 ; i < UniformBlockBindingCount ; ++i )
         {
-            auto techmanager = ResourceManager::Get() -> getTechniqueManager() ;
+            const UniformBlock * bound = iBoundBlocks [i] ;
 
-            for ( auto globalias : iGlobALiases )
-            {
-                auto global = techmanager -> getGlobal ( globalias.first ) ;
-                iProgram -> setUniform ( globalias.second , global.type , global.value ) ;
-            }
+            if ( bound && i != (size_t) binding )
+            iProgram -> setUniformBlock ( (UniformBlockBinding) i , arena , arena.push ( *bound ) , bound -> getSize() ) ;
         }
     }
+
+    return true ;
+}
+
+UniformBlock & Technique::getUniformBlock ( const UniformBlockBinding & binding ) const
+{
+    return iBlocks [(size_t) binding] ;
 }
 
 void Technique::unbind () const
@@ -309,6 +466,16 @@ void Technique::unbind () const
     iFramebuffer -> unbind () ;
 }
 
+void Technique::unbind ( const Renderer * renderer ) const
+{
+    GreAutolock ;
+
+    if ( renderer )
+    renderer -> unbindPipelineState () ;
+    else
+    unbind () ;
+}
+
 TechniqueParam Technique::getNextLightAlias () const
 {
     GreAutolock ;
@@ -319,6 +486,8 @@ TechniqueParam Technique::getNextLightAlias () const
     TechniqueParam alias = (TechniqueParam) ((int)TechniqueParam::Light0 + iCurrentLight + 1) ;
     iCurrentLight ++ ;
 
+    RenderStatistics::CountLights ( 1 ) ;
+
     return alias ;
 }
 
@@ -340,6 +509,18 @@ void Technique::resetLights () const
     GreAutolock ; iCurrentLight = -1 ;
 }
 
+size_t Technique::getMaximumLights () const
+{
+    GreAutolock ;
+
+    size_t aliases = (size_t) TechniqueParam::Light9 - (size_t) TechniqueParam::Light0 + 1 ;
+
+    if ( iProgram.isInvalid() )
+    return aliases ;
+
+    return std::min ( aliases , (size_t) iProgram -> getMaximumLights () ) ;
+}
+
 void Technique::setAliasedTextureStruct (const TechniqueParam & alias1 ,
                                          const TechniqueParam & alias2 ,
                                          const TextureHolder & tex) const
@@ -349,6 +530,33 @@ void Technique::setAliasedTextureStruct (const TechniqueParam & alias1 ,
     if ( iProgram.isInvalid() )
     return ;
 
+    //////////////////////////////////////////////////////////////////////
+    // Uses the uniforms table when the structure alias is in it.
+
+    updateUniformTable () ;
+    int slot = getUniformSlot ( alias1 ) ;
+
+    if ( slot >= 0 )
+    {
+        if ( !slot || !iUniformSlots [slot] )
+        {
+            setAliasedTexture ( alias2 , tex ) ;
+            return ;
+        }
+
+        if ( !iProgram->binded() )
+        return ;
+
+        const TechniqueUniform & uniform = iUniformTable [slot * TechniqueParamCount + (size_t) alias2] ;
+        int unit = bindTexture ( tex ) ;
+        HdwProgVarType textype = HdwProgVarTypeFromTextureType ( tex->getType() ) ;
+
+        if ( uniform.location >= 0 && uniform.type == textype )
+        iProgram -> setUniform ( uniform.location , textype , unit ) ;
+
+        return ;
+    }
+
     //////////////////////////////////////////////////////////////////////
     // Checks both aliases. If one is empty , just send to name2.
 
@@ -392,18 +600,22 @@ void Technique::setAliasedTexture(const Gre::TechniqueParam &param, const Textur
 
     else if ( iProgram->binded() )
     {
-        auto alias = getAlias ( param ) ;
-        if ( alias.empty() ) return ;
+        updateUniformTable () ;
+
+        const TechniqueUniform & uniform = iUniformTable [(size_t) param] ;
+        if ( !uniform.named ) return ;
 
         int unit = bindTexture ( tex ) ;
         HdwProgVarType textype = HdwProgVarTypeFromTextureType ( tex->getType() ) ;
-        iProgram -> setUniform(alias, textype, unit);
+
+        if ( uniform.location >= 0 && uniform.type == textype )
+        iProgram -> setUniform ( uniform.location , textype , unit ) ;
     }
 }
 
 void Technique::setAttribName(const Gre::VertexAttribAlias &alias, const std::string &name)
 {
-    GreAutolock ; iAttribAliases[alias] = name ;
+    GreAutolock ; iAttribAliases[alias] = name ; iPipelineStateDirty = true ;
 }
 
 const std::string Technique::getAttribName ( const VertexAttribAlias & alias ) const
@@ -473,7 +685,7 @@ const Matrix4 Technique::getProjectionMatrix () const
 
 void Technique::addGlobSet ( const std::string & globname , const TechniqueParam & techparam )
 {
-    GreAutolock ; iGlobSets[globname] = techparam ;
+    GreAutolock ; iGlobSets[globname] = techparam ; iUniformTableDirty = true ;
 }
 
 const std::vector < std::string > Technique::findGlobSets ( const TechniqueParam & param ) const
@@ -511,6 +723,71 @@ int Technique::bindTexture ( const TextureHolder & texture ) const
     return unit ;
 }
 
+void Technique::updateUniformTable () const
+{
+    if ( !iUniformTableDirty && iUniformTableProgram == iProgram.getObject() &&
+         ( iProgram.isInvalid() || iUniformTableVersion == iProgram -> getLinkVersion () ) )
+    return ;
+
+    const size_t slots = (size_t) TechniqueParam::Light9 - (size_t) TechniqueParam::Light0 + 2 ;
+
+    iUniformTable.assign ( slots * TechniqueParamCount , TechniqueUniform { false , -1 , HdwProgVarType::None } ) ;
+    iUniformSlots.assign ( slots , false ) ;
+    iGlobSetParams.assign ( TechniqueParamCount , false ) ;
+
+    for ( auto & globset : iGlobSets )
+    iGlobSetParams [(size_t) globset.second] = true ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Resolves each name the string functions would build : 'param' alone
+    // in slot 0 , and 'light.param' in the light slots.
+
+    iUniformSlots [0] = !getAlias ( TechniqueParam::None ) .empty () ;
+
+    for ( size_t slot = 0 ; slot < slots ; ++slot )
+    {
+        std::string prefix ;
+
+        if ( slot )
+        {
+            prefix = getAlias ( (TechniqueParam) ( (size_t) TechniqueParam::Light0 + slot - 1 ) ) ;
+            iUniformSlots [slot] = !prefix.empty () ;
+
+            if ( prefix.empty () )
+            continue ;
+        }
+
+        for ( auto & alias : iAliases )
+        {
+            if ( alias.second.empty () )
+            continue ;
+
+            TechniqueUniform & uniform = iUniformTable [slot * TechniqueParamCount + (size_t) alias.first] ;
+            std::string name = prefix.empty () ? alias.second : prefix + "." + alias.second ;
+
+            uniform.named = true ;
+
+            if ( !iProgram.isInvalid() )
+            iProgram -> findUniform ( name , uniform.location , uniform.type ) ;
+        }
+    }
+
+    iUniformTableDirty = false ;
+    iUniformTableProgram = iProgram.getObject() ;
+    iUniformTableVersion = iProgram.isInvalid() ? 0 : iProgram -> getLinkVersion () ;
+}
+
+int Technique::getUniformSlot ( const TechniqueParam & alias ) const
+{
+    if ( alias == TechniqueParam::None )
+    return iUniformSlots [0] ? -1 : 0 ;
+
+    if ( alias >= TechniqueParam::Light0 && alias <= TechniqueParam::Light9 )
+    return (int) alias - (int) TechniqueParam::Light0 + 1 ;
+
+    return -1 ;
+}
+
 void Technique::onUpdateEvent(const Gre::UpdateEvent &e)
 {
 
@@ -523,6 +800,8 @@ TechniqueManager::TechniqueManager ( const std::string & name )
 {
     //////////////////////////////////////////////////////////////////////
     // Always load a Global named 'null'.
+    iGlobalsLayoutDirty = true ;
+    iGlobalsBlockDirty = true ;
     addGlobal ( "null" , HdwProgVarType::None , (float) 0.0f ) ;
 }
 
@@ -586,6 +865,7 @@ void TechniqueManager::addGlobal ( const std::string & name , const HdwProgVarTy
     var.type = type ;
     var.value = value ;
     iGlobalsByName [name] = var ;
+    iGlobalsLayoutDirty = true ;
 
     //////////////////////////////////////////////////////////////////////
     // Informs !
@@ -608,6 +888,7 @@ void TechniqueManager::setGlobalValue ( const std::string & name , const RealPro
     // Sets new value.
 
     var->second.value = value ;
+    iGlobalsBlockDirty = true ;
 }
 
 const HardwareProgramVariable & TechniqueManager::getGlobal ( const std::string & name ) const
@@ -626,4 +907,41 @@ const HardwareProgramVariable & TechniqueManager::getGlobal ( const std::string
     return globit->second ;
 }
 
+const UniformBlock & TechniqueManager::getGlobalsBlock () const
+{
+    GreAutolock ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Builds the layout again only when a global was added.
+
+    if ( iGlobalsLayoutDirty )
+    {
+        UniformBlockLayout layout ;
+
+        for ( auto & global : iGlobalsByName )
+        if ( UniformBlockLayout::GetAlignment ( global.second.type ) )
+        layout.addMember ( global.first , global.second.type ) ;
+
+        iGlobalsBlock.setLayout ( layout ) ;
+        iGlobalsLayoutDirty = false ;
+        iGlobalsBlockDirty = true ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Members are in the same order as the globals.
+
+    if ( iGlobalsBlockDirty )
+    {
+        int member = 0 ;
+
+        for ( auto & global : iGlobalsByName )
+        if ( UniformBlockLayout::GetAlignment ( global.second.type ) )
+        iGlobalsBlock.set ( member ++ , global.second.value ) ;
+
+        iGlobalsBlockDirty = false ;
+    }
+
+    return iGlobalsBlock ;
+}
+
 GreEndNamespace
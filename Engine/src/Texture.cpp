@@ -34,6 +34,8 @@
 
 #include "Platform.h"
 #include "ResourceManager.h"
+#include "Profiler.h"
+#include "RenderStatistics.h"
 
 GreBeginNamespace
 
@@ -96,6 +98,7 @@ Texture::~Texture() noexcept(false)
 void Texture::bind() const
 {
     GreAutolock ; _bind () ;
+    RenderStatistics::CountTextureBind () ;
 }
 
 void Texture::unbind() const
@@ -273,6 +276,7 @@ TextureHolder TextureManager::loadFile(const std::string & name ,
                                        const TextureType & type ,
                                        const ResourceLoaderOptions & ops)
 {
+    GreProfileDetail( "TextureManager::loadFile" , path ) ;
     GreAutolock ;
 
     //////////////////////////////////////////////////////////////////////
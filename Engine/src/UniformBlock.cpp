@@ -0,0 +1,442 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  UniformBlock.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "UniformBlock.h"
+#include "Technique.h"
+
+#include <atomic>
+#include <cstring>
+
+GreBeginNamespace
+
+//////////////////////////////////////////////////////////////////////
+// Generations are shared by every arenas , so a block staged in an arena
+// is never taken as staged in another one.
+
+static std::atomic < size_t > ArenaGenerations ( 0 ) ;
+
+const char* UniformBlockName ( const UniformBlockBinding & binding )
+{
+    switch ( binding )
+    {
+        case UniformBlockBinding::Frame : return "GreFrame" ;
+        case UniformBlockBinding::Pass : return "GrePass" ;
+        case UniformBlockBinding::Material : return "GreMaterial" ;
+        case UniformBlockBinding::Object : return "GreObject" ;
+        default : return "" ;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// UniformBlockLayout implementation.
+
+UniformBlockLayout::UniformBlockLayout ()
+: iSize ( 0 )
+{
+
+}
+
+bool UniformBlockLayout::addMember ( const std::string & name , const HdwProgVarType & type )
+{
+    const size_t alignment = GetAlignment ( type ) ;
+
+    if ( !alignment )
+    {
+        GreDebug ( "[WARN] Uniform block member '" ) << name << "' has a type not allowed in blocks." << gendl ;
+        return false ;
+    }
+
+    UniformBlockMember member ;
+    member.name = name ;
+    member.param = TechniqueParam::None ;
+    member.type = type ;
+    member.offset = ( iSize + alignment - 1 ) / alignment * alignment ;
+
+    iSize = member.offset + GetSize ( type ) ;
+    iMembers.push_back ( member ) ;
+    return true ;
+}
+
+bool UniformBlockLayout::addMember ( const TechniqueParam & param , const HdwProgVarType & type )
+{
+    if ( !addMember ( std::string () , type ) )
+    return false ;
+
+    iMembers.back().param = param ;
+    return true ;
+}
+
+int UniformBlockLayout::findMember ( const std::string & name ) const
+{
+    for ( size_t i = 0 ; i < iMembers.size () ; ++i )
+    if ( iMembers[i].name == name ) return (int) i ;
+
+    return -1 ;
+}
+
+int UniformBlockLayout::findMember ( const TechniqueParam & param ) const
+{
+    for ( size_t i = 0 ; i < iMembers.size () ; ++i )
+    if ( iMembers[i].param == param ) return (int) i ;
+
+    return -1 ;
+}
+
+const std::vector < UniformBlockMember > & UniformBlockLayout::getMembers () const
+{
+    return iMembers ;
+}
+
+size_t UniformBlockLayout::getSize () const
+{
+    return ( iSize + 15 ) / 16 * 16 ;
+}
+
+void UniformBlockLayout::clear ()
+{
+    iMembers.clear () ;
+    iSize = 0 ;
+}
+
+size_t UniformBlockLayout::GetAlignment ( const HdwProgVarType & type )
+{
+    switch ( type )
+    {
+        case HdwProgVarType::Float1 :
+        case HdwProgVarType::Int1 :
+        case HdwProgVarType::UnsignedInt1 :
+        case HdwProgVarType::Bool1 : return 4 ;
+
+        case HdwProgVarType::Float2 :
+        case HdwProgVarType::Int2 :
+        case HdwProgVarType::UnsignedInt2 :
+        case HdwProgVarType::Bool2 : return 8 ;
+
+        case HdwProgVarType::Float3 :
+        case HdwProgVarType::Int3 :
+        case HdwProgVarType::UnsignedInt3 :
+        case HdwProgVarType::Bool3 :
+        case HdwProgVarType::Float4 :
+        case HdwProgVarType::Int4 :
+        case HdwProgVarType::UnsignedInt4 :
+        case HdwProgVarType::Bool4 :
+        case HdwProgVarType::Matrix2 :
+        case HdwProgVarType::Matrix3 :
+        case HdwProgVarType::Matrix4 : return 16 ;
+
+        default : return 0 ;
+    }
+}
+
+size_t UniformBlockLayout::GetSize ( const HdwProgVarType & type )
+{
+    switch ( type )
+    {
+        case HdwProgVarType::Float1 :
+        case HdwProgVarType::Int1 :
+        case HdwProgVarType::UnsignedInt1 :
+        case HdwProgVarType::Bool1 : return 4 ;
+
+        case HdwProgVarType::Float2 :
+        case HdwProgVarType::Int2 :
+        case HdwProgVarType::UnsignedInt2 :
+        case HdwProgVarType::Bool2 : return 8 ;
+
+        case HdwProgVarType::Float3 :
+        case HdwProgVarType::Int3 :
+        case HdwProgVarType::UnsignedInt3 :
+        case HdwProgVarType::Bool3 : return 12 ;
+
+        case HdwProgVarType::Float4 :
+        case HdwProgVarType::Int4 :
+        case HdwProgVarType::UnsignedInt4 :
+        case HdwProgVarType::Bool4 : return 16 ;
+
+        //////////////////////////////////////////////////////////////////////
+        // Each column of a matrix is aligned as a vec4.
+
+        case HdwProgVarType::Matrix2 : return 32 ;
+        case HdwProgVarType::Matrix3 : return 48 ;
+        case HdwProgVarType::Matrix4 : return 64 ;
+
+        default : return 0 ;
+    }
+}
+
+const UniformBlockLayout & UniformBlockLayout::Standard ( const UniformBlockBinding & binding )
+{
+    //////////////////////////////////////////////////////////////////////
+    // Matrices are placed first , so vectors don't leave holes between
+    // them.
+
+    static const UniformBlockLayout frame ;
+
+    static const UniformBlockLayout pass = [] () {
+        UniformBlockLayout layout ;
+        layout.addMember ( TechniqueParam::ViewMatrix , HdwProgVarType::Matrix4 ) ;
+        layout.addMember ( TechniqueParam::ProjectionMatrix , HdwProgVarType::Matrix4 ) ;
+        layout.addMember ( TechniqueParam::ProjectionViewMatrix , HdwProgVarType::Matrix4 ) ;
+        layout.addMember ( TechniqueParam::CameraPosition , HdwProgVarType::Float3 ) ;
+        layout.addMember ( TechniqueParam::CameraDirection , HdwProgVarType::Float3 ) ;
+        return layout ;
+    } () ;
+
+    static const UniformBlockLayout material = [] () {
+        UniformBlockLayout layout ;
+        layout.addMember ( TechniqueParam::MaterialAmbient , HdwProgVarType::Float3 ) ;
+        layout.addMember ( TechniqueParam::MaterialDiffuse , HdwProgVarType::Float3 ) ;
+        layout.addMember ( TechniqueParam::MaterialSpecular , HdwProgVarType::Float3 ) ;
+        layout.addMember ( TechniqueParam::MaterialShininess , HdwProgVarType::Float1 ) ;
+        return layout ;
+    } () ;
+
+    static const UniformBlockLayout object = [] () {
+        UniformBlockLayout layout ;
+        layout.addMember ( TechniqueParam::ModelMatrix , HdwProgVarType::Matrix4 ) ;
+        layout.addMember ( TechniqueParam::ModelViewMatrix , HdwProgVarType::Matrix4 ) ;
+        layout.addMember ( TechniqueParam::ProjectionViewModelMatrix , HdwProgVarType::Matrix4 ) ;
+        layout.addMember ( TechniqueParam::NormalMatrix3 , HdwProgVarType::Matrix3 ) ;
+        return layout ;
+    } () ;
+
+    switch ( binding )
+    {
+        case UniformBlockBinding::Pass : return pass ;
+        case UniformBlockBinding::Material : return material ;
+        case UniformBlockBinding::Object : return object ;
+        default : return frame ;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// UniformBlock implementation.
+
+UniformBlock::UniformBlock ( const UniformBlockLayout & layout )
+: iVersion ( 1 ) , iStagedGeneration ( 0 ) , iStagedVersion ( 0 ) , iStagedOffset ( 0 )
+{
+    setLayout ( layout ) ;
+}
+
+void UniformBlock::setLayout ( const UniformBlockLayout & layout )
+{
+    iLayout = layout ;
+    iData.assign ( layout.getSize () , 0 ) ;
+    iVersion ++ ;
+}
+
+const UniformBlockLayout & UniformBlock::getLayout () const
+{
+    return iLayout ;
+}
+
+bool UniformBlock::set ( int member , const RealProgramVariable & value )
+{
+    if ( member < 0 || (size_t) member >= iLayout.getMembers().size() )
+    return false ;
+
+    const UniformBlockMember & desc = iLayout.getMembers() [member] ;
+    const size_t size = UniformBlockLayout::GetSize ( desc.type ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Packs the value as std140 : booleans are stored on four bytes , and
+    // matrices columns on sixteen bytes.
+
+    char packed [64] ;
+    memset ( packed , 0 , sizeof ( packed ) ) ;
+
+    switch ( desc.type )
+    {
+        case HdwProgVarType::Bool1 :
+        case HdwProgVarType::Bool2 :
+        case HdwProgVarType::Bool3 :
+        case HdwProgVarType::Bool4 :
+        {
+            const bool* values = &value.b4 [0] ;
+
+            for ( size_t i = 0 ; i < size / 4 ; ++i )
+            {
+                const int b = values [i] ? 1 : 0 ;
+                memcpy ( packed + i * 4 , &b , 4 ) ;
+            }
+
+            break ;
+        }
+
+        case HdwProgVarType::Matrix2 :
+        for ( int c = 0 ; c < 2 ; ++c )
+        memcpy ( packed + c * 16 , &value.m2 [c][0] , 8 ) ;
+        break ;
+
+        case HdwProgVarType::Matrix3 :
+        for ( int c = 0 ; c < 3 ; ++c )
+        memcpy ( packed + c * 16 , &value.m3 [c][0] , 12 ) ;
+        break ;
+
+        default :
+        memcpy ( packed , &value , size ) ;
+        break ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // The version changes only if the packed bytes differ.
+
+    char* data = &iData [desc.offset] ;
+
+    if ( memcmp ( data , packed , size ) )
+    {
+        memcpy ( data , packed , size ) ;
+        iVersion ++ ;
+    }
+
+    return true ;
+}
+
+bool UniformBlock::set ( const TechniqueParam & param , const RealProgramVariable & value )
+{
+    return set ( iLayout.findMember ( param ) , value ) ;
+}
+
+bool UniformBlock::setData ( const char* data , size_t size )
+{
+    if ( !data || size != iData.size () )
+    return false ;
+
+    if ( size && memcmp ( &iData [0] , data , size ) )
+    {
+        memcpy ( &iData [0] , data , size ) ;
+        iVersion ++ ;
+    }
+
+    return true ;
+}
+
+const char* UniformBlock::getData () const
+{
+    return iData.data () ;
+}
+
+size_t UniformBlock::getSize () const
+{
+    return iData.size () ;
+}
+
+size_t UniformBlock::getVersion () const
+{
+    return iVersion ;
+}
+
+// -----------------------------------------------------------------------------
+// UniformArena implementation.
+
+UniformArena & UniformArena::Get ()
+{
+    static UniformArena arena ;
+    return arena ;
+}
+
+UniformArena::UniformArena ( size_t capacity , size_t alignment )
+: iData ( capacity , 0 ) , iSize ( 0 ) , iAlignment ( alignment ? alignment : 1 )
+, iGeneration ( ++ ArenaGenerations )
+{
+
+}
+
+size_t UniformArena::push ( const UniformBlock & block )
+{
+    //////////////////////////////////////////////////////////////////////
+    // A block which did not change since it was staged in this generation
+    // is still at the same offset.
+
+    if ( block.iStagedGeneration == iGeneration && block.iStagedVersion == block.iVersion )
+    return block.iStagedOffset ;
+
+    const size_t size = block.getSize () ;
+    size_t offset = ( iSize + iAlignment - 1 ) / iAlignment * iAlignment ;
+
+    if ( offset + size > iData.size () )
+    {
+        clear () ;
+        offset = 0 ;
+
+        if ( size > iData.size () )
+        iData.resize ( size ) ;
+    }
+
+    if ( size )
+    memcpy ( &iData [offset] , block.getData () , size ) ;
+
+    iSize = offset + size ;
+
+    block.iStagedGeneration = iGeneration ;
+    block.iStagedVersion = block.iVersion ;
+    block.iStagedOffset = offset ;
+    return offset ;
+}
+
+void UniformArena::clear ()
+{
+    iSize = 0 ;
+    iGeneration = ++ ArenaGenerations ;
+}
+
+void UniformArena::setAlignment ( size_t alignment )
+{
+    iAlignment = alignment ? alignment : 1 ;
+    clear () ;
+}
+
+size_t UniformArena::getAlignment () const
+{
+    return iAlignment ;
+}
+
+const char* UniformArena::getData () const
+{
+    return iData.data () ;
+}
+
+size_t UniformArena::getSize () const
+{
+    return iSize ;
+}
+
+size_t UniformArena::getCapacity () const
+{
+    return iData.size () ;
+}
+
+size_t UniformArena::getGeneration () const
+{
+    return iGeneration ;
+}
+
+GreEndNamespace
@@ -43,6 +43,8 @@ VertexAttribAlias VertexAttribFromString ( const std::string & attrib )
     if ( attrib == "Texture" ) return VertexAttribAlias::Texture ;
     if ( attrib == "Tangents" ) return VertexAttribAlias::Tangents ;
     if ( attrib == "Binormals" ) return VertexAttribAlias::Binormals ;
+    if ( attrib == "BoneIndices" ) return VertexAttribAlias::BoneIndices ;
+    if ( attrib == "BoneWeights" ) return VertexAttribAlias::BoneWeights ;
     return VertexAttribAlias::Position ;
 }
 
@@ -124,4 +126,22 @@ const VertexAttribComponent VertexDescriptor::findComponent(const Gre::VertexAtt
     return VertexAttribComponent () ;
 }
 
+bool VertexDescriptor::operator == ( const VertexDescriptor & rhs ) const
+{
+    if ( iSize != rhs.iSize || iComponents.size() != rhs.iComponents.size() )
+        return false ;
+
+    for ( size_t i = 0 ; i < iComponents.size() ; ++i )
+    {
+        const VertexAttribComponent & l = iComponents[i] ;
+        const VertexAttribComponent & r = rhs.iComponents[i] ;
+
+        if ( l.alias != r.alias || l.elements != r.elements || l.type != r.type ||
+             l.normalize != r.normalize || l.size != r.size )
+            return false ;
+    }
+
+    return true ;
+}
+
 GreEndNamespace
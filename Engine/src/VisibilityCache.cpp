@@ -0,0 +1,217 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  VisibilityCache.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 23/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "VisibilityCache.h"
+
+GreBeginNamespace
+
+float VisibilityCacheStats::getHitRate () const
+{
+    size_t queries = hits + partials + misses ;
+    return queries ? (float) hits / (float) queries : 0.0f ;
+}
+
+float VisibilityCacheStats::getNodeReuseRate () const
+{
+    size_t nodes = reused + tested ;
+    return nodes ? (float) reused / (float) nodes : 0.0f ;
+}
+
+VisibilityCache::VisibilityCache ( size_t capacity )
+: iCurrent ( -1 ) , iCapacity ( capacity ) , iQueries ( 0 )
+{
+    resetStats () ;
+}
+
+VisibilityCache::~VisibilityCache ()
+{
+
+}
+
+bool VisibilityCache::find ( const Matrix4 & projectionview , uint64_t version , RenderNodeHolderList & result )
+{
+    iCurrent = -1 ;
+    iQueries ++ ;
+
+    if ( !iCapacity )
+    return false ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Looks for an entry with the same matrix. Matrices are compared
+    // exactly : a camera which moved , even slightly , is a miss.
+
+    for ( size_t i = 0 ; i < iEntries.size () ; ++i )
+    {
+        Entry & entry = iEntries [i] ;
+
+        if ( !entry.valid || entry.projectionview != projectionview )
+        continue ;
+
+        entry.lastuse = iQueries ;
+
+        if ( entry.version == version )
+        {
+            iStats.hits ++ ;
+            result.insert ( result.end() , entry.result.begin() , entry.result.end() ) ;
+            return true ;
+        }
+
+        iStats.partials ++ ;
+        entry.version = version ;
+        entry.recorded.clear () ;
+        iCurrent = (int) i ;
+        return false ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Takes a new entry , or the least recently used one.
+
+    iStats.misses ++ ;
+
+    size_t index = iEntries.size () ;
+
+    if ( iEntries.size () < iCapacity )
+    iEntries.push_back ( Entry () ) ;
+
+    else
+    {
+        index = 0 ;
+
+        for ( size_t i = 1 ; i < iEntries.size () ; ++i )
+        {
+            if ( iEntries [i] .lastuse < iEntries [index] .lastuse )
+            index = i ;
+        }
+    }
+
+    Entry & entry = iEntries [index] ;
+    entry.projectionview = projectionview ;
+    entry.version = version ;
+    entry.valid = false ;
+    entry.lastuse = iQueries ;
+    entry.result.clear () ;
+    entry.nodes.clear () ;
+    entry.recorded.clear () ;
+
+    iCurrent = (int) index ;
+    return false ;
+}
+
+bool VisibilityCache::lookup ( const RenderNode * node , uint64_t version , bool & visible )
+{
+    if ( iCurrent < 0 )
+    return false ;
+
+    const Entry & entry = iEntries [iCurrent] ;
+    auto it = entry.nodes.find ( node ) ;
+
+    if ( it == entry.nodes.end () || it -> second.version != version )
+    return false ;
+
+    visible = it -> second.visible ;
+    iStats.reused ++ ;
+    return true ;
+}
+
+void VisibilityCache::record ( const RenderNode * node , uint64_t version , bool visible )
+{
+    if ( iCurrent < 0 )
+    {
+        iStats.tested ++ ;
+        return ;
+    }
+
+    Entry & entry = iEntries [iCurrent] ;
+
+    auto it = entry.nodes.find ( node ) ;
+
+    if ( it == entry.nodes.end () || it -> second.version != version )
+    iStats.tested ++ ;
+
+    NodeResult & nodeResult = entry.recorded [node] ;
+    nodeResult.version = version ;
+    nodeResult.visible = visible ;
+}
+
+void VisibilityCache::store ( const RenderNodeHolderList & result )
+{
+    if ( iCurrent < 0 )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Nodes removed from the scene were not recorded : swapping drops them.
+
+    Entry & entry = iEntries [iCurrent] ;
+    entry.nodes.swap ( entry.recorded ) ;
+    entry.recorded.clear () ;
+    entry.result = result ;
+    entry.valid = true ;
+
+    iCurrent = -1 ;
+}
+
+void VisibilityCache::clear ()
+{
+    iEntries.clear () ;
+    iCurrent = -1 ;
+}
+
+void VisibilityCache::setCapacity ( size_t capacity )
+{
+    iCapacity = capacity ;
+
+    if ( iEntries.size () > iCapacity )
+    iEntries.resize ( iCapacity ) ;
+
+    iCurrent = -1 ;
+}
+
+size_t VisibilityCache::getCapacity () const
+{
+    return iCapacity ;
+}
+
+const VisibilityCacheStats & VisibilityCache::getStats () const
+{
+    return iStats ;
+}
+
+void VisibilityCache::resetStats ()
+{
+    iStats.hits = 0 ;
+    iStats.partials = 0 ;
+    iStats.misses = 0 ;
+    iStats.reused = 0 ;
+    iStats.tested = 0 ;
+}
+
+GreEndNamespace
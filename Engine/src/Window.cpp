@@ -31,6 +31,7 @@
  */
 
 #include "Window.h"
+#include "Profiler.h"
 
 GreBeginNamespace
 
@@ -222,6 +223,7 @@ void WindowManager::addGlobalKeyListener ( const EventProceederHolder & proceede
 
 void WindowManager::pollEvents ( const Duration& elapsed ) const
 {
+    GreProfile( "WindowManager::pollEvents" ) ;
     _pollEvents () ;
 }
 
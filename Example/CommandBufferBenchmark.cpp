@@ -0,0 +1,235 @@
+//
+//  CommandBufferBenchmark.cpp
+//  GRE
+//
+//  Created by Jacques Tronconi on 28/06/2017.
+//
+//
+
+#include "RenderPass.h"
+#include "Renderer.h"
+#include "JobPool.h"
+#include "ResourceManager.h"
+
+#include <random>
+
+using namespace Gre ;
+
+//////////////////////////////////////////////////////////////////////
+// Measures the time taken to record the command buffers of a snapshot
+// pass , and to execute them. Nothing is sent to a GPU : the program
+// only accepts uniforms , the meshes don't bind anything and the renderer
+// either counts the commands or replays them without drawing.
+
+static const size_t ItemsCount = 100000 ;
+static const size_t LightsCount = 32 ;
+static const size_t FramesCount = 30 ;
+
+//////////////////////////////////////////////////////////////////////
+// A program accepting every uniforms.
+
+class BenchmarkProgram : public HardwareProgram
+{
+public:
+
+    BenchmarkProgram ( const std::string & name ) : HardwareProgram ( name ) { }
+
+    virtual bool binded () const { return iBinded ; }
+    virtual void setVertexAttrib ( const std::string & , size_t , VertexAttribType , bool , size_t , void * ) const { }
+    virtual void disableVertexAttribs () const { }
+    virtual void bindTextureUnit ( int ) const { }
+    virtual unsigned int getMaximumLights () const { return 8 ; }
+
+protected:
+
+    virtual void _bind () const { iBinded = true ; }
+    virtual void _unbind () const { iBinded = false ; }
+    virtual bool _attachShader ( const HardwareShaderHolder & ) { return true ; }
+    virtual bool _finalize () { return true ; }
+    virtual void _deleteProgram () { }
+    virtual bool _setUniform ( int , const HdwProgVarType & , const RealProgramVariable & ) const { return true ; }
+};
+
+//////////////////////////////////////////////////////////////////////
+// A mesh binding nothing.
+
+class BenchmarkMesh : public Mesh
+{
+public:
+
+    BenchmarkMesh ( const std::string & name ) : Mesh ( name ) { }
+
+protected:
+
+    virtual void iBind ( const TechniqueHolder & ) const { }
+    virtual void iUnbind ( const TechniqueHolder & ) const { }
+    virtual void iBindSubMesh ( const SubMeshHolder & , const TechniqueHolder & ) const { }
+    virtual void iUnbindSubMesh ( const SubMeshHolder & , const TechniqueHolder & ) const { }
+};
+
+//////////////////////////////////////////////////////////////////////
+// A renderer which only counts the commands , or replays them through
+// 'Renderer::execute()' and counts the submeshes drawn.
+
+class BenchmarkRenderer : public Renderer
+{
+public:
+
+    BenchmarkRenderer () : Renderer ( "benchmark" , RendererOptions () ) , replay ( false ) , commands ( 0 ) , submeshes ( 0 ) { }
+
+    virtual void setClearRegion ( const Surface & ) const { }
+    virtual void setViewport ( const Viewport & ) const { }
+    virtual void setClearColor ( const Color & ) const { }
+    virtual void setClearDepth ( float ) const { }
+    virtual void clearBuffers ( const ClearBuffers & ) const { }
+    virtual void draw ( const TechniqueHolder & ) const { }
+    virtual void drawSubMesh ( const SubMeshHolder & ) const { submeshes ++ ; }
+
+    virtual void execute ( const CommandBuffer & buffer ) const
+    {
+        commands += buffer.getCommands () .size () ;
+
+        if ( replay )
+        Renderer::execute ( buffer ) ;
+    }
+
+    bool replay ;
+    mutable size_t commands ;
+    mutable size_t submeshes ;
+
+protected:
+
+    virtual MeshManagerHolder iCreateMeshManager () const { return MeshManagerHolder ( nullptr ) ; }
+    virtual HardwareProgramManagerInternalCreator* iCreateProgramManagerCreator () const { return nullptr ; }
+    virtual TextureInternalCreator* iCreateTextureCreator () const { return nullptr ; }
+    virtual RenderFramebufferInternalCreator* iCreateFramebufferCreator () const { return nullptr ; }
+};
+
+void Run ()
+{
+    std::mt19937 random ( 42 ) ;
+    std::uniform_real_distribution < float > position ( -1.5f , 1.5f ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // A technique lit by every lights , drawing a mesh with one submesh.
+
+    HardwareProgramHolder program = new BenchmarkProgram ( "program" ) ;
+    program -> finalize () ;
+
+    TechniqueHolder technique = new Technique ( "technique" ) ;
+    technique -> setHardwareProgram ( program ) ;
+    technique -> setLightingMode ( TechniqueLightingMode::AllLights ) ;
+
+    MeshHolder mesh = new BenchmarkMesh ( "mesh" ) ;
+    mesh -> addSubMesh ( SubMeshHolder ( new SubMesh ( "submesh" ) ) ) ;
+
+    MaterialHolder material = new Material ( "material" ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The snapshot : the camera sees the unit cube , so some items and
+    // lights are outside.
+
+    Holder < RenderNode > camera = new RenderNode ( nullptr , "camera" ) ;
+    RenderSnapshot snapshot ;
+
+    RenderSnapshotCamera view ;
+    view.node = camera.getObject () ;
+    view.position = Vector3 ( 0.0f , 0.0f , 0.0f ) ;
+    view.direction = Vector3 ( 0.0f , 0.0f , -1.0f ) ;
+    view.view = Matrix4 ( 1.0f ) ;
+    snapshot.cameras.push_back ( view ) ;
+
+    for ( size_t i = 0 ; i < ItemsCount ; ++i )
+    {
+        Vector3 center ( position ( random ) , position ( random ) , position ( random ) ) ;
+
+        RenderSnapshotItem item ;
+        item.node = nullptr ;
+        item.mesh = mesh ;
+        item.material = material ;
+        item.model = glm::translate ( Matrix4 ( 1.0f ) , center ) ;
+        item.bbox = BoundingBox ( center - Vector3 ( 0.01f ) , center + Vector3 ( 0.01f ) ) ;
+        item.lod = 0 ;
+        item.lodhysteresis = 0.0f ;
+        item.caster = true ;
+        snapshot.items.push_back ( item ) ;
+    }
+
+    for ( size_t i = 0 ; i < LightsCount ; ++i )
+    {
+        RenderSnapshotLight light ;
+        light.node = nullptr ;
+        light.material = MaterialHolder ( new Material ( "light" + std::to_string ( i ) ) ) ;
+        light.position = Vector3 ( position ( random ) , position ( random ) , position ( random ) ) ;
+        light.direction = Vector3 ( 0.0f , -1.0f , 0.0f ) ;
+        light.view = Matrix4 ( 1.0f ) ;
+        light.radius = 0.5f ;
+        snapshot.lights.push_back ( light ) ;
+    }
+
+    RenderPassHolder pass = new RenderPass ( "pass" ) ;
+    pass -> setCamera ( RenderNodeHolder ( camera.getObject () ) ) ;
+
+    Holder < BenchmarkRenderer > renderer = new BenchmarkRenderer () ;
+    CommandBufferList buffers ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Records the buffers , then executes them : first only counting the
+    // commands , then replaying them.
+
+    float recording = 0.0f ;
+    float counting = 0.0f ;
+    float replaying = 0.0f ;
+    size_t draws = 0 ;
+    size_t payload = 0 ;
+
+    for ( size_t i = 0 ; i < FramesCount ; ++i )
+    {
+        TimePoint start = Time::now () ;
+        pass -> recordSnapshot ( technique , snapshot , buffers ) ;
+        recording += Duration ( Time::now () - start ) .count () ;
+
+        renderer -> replay = false ;
+        start = Time::now () ;
+
+        for ( const CommandBuffer & buffer : buffers )
+        renderer -> execute ( buffer ) ;
+
+        counting += Duration ( Time::now () - start ) .count () ;
+
+        renderer -> replay = true ;
+        start = Time::now () ;
+
+        for ( const CommandBuffer & buffer : buffers )
+        renderer -> execute ( buffer ) ;
+
+        replaying += Duration ( Time::now () - start ) .count () ;
+    }
+
+    for ( const CommandBuffer & buffer : buffers )
+    {
+        draws += buffer.getDrawsCount () ;
+        payload += buffer.getPayloadSize () ;
+    }
+
+    GreDebug ( "[INFO] Recorded " ) << buffers.size () << " buffers , " << renderer -> commands / ( 2 * FramesCount ) << " commands , "
+                                    << draws << " draws , " << payload << " bytes : " << recording * 1000.0f / FramesCount
+                                    << " ms average on " << JobPool::Get () .getThreadsCount () << " threads." << gendl ;
+
+    GreDebug ( "[INFO] Executed : " ) << counting * 1000.0f / FramesCount << " ms counting , "
+                                      << replaying * 1000.0f / FramesCount << " ms replaying , "
+                                      << renderer -> submeshes / FramesCount << " submeshes drawn." << gendl ;
+}
+
+int main ()
+{
+    //////////////////////////////////////////////////////////////////////
+    // Techniques and materials need the default manager , but no plugin is
+    // loaded.
+
+    ResourceManager::CreateDefault () ;
+    Run () ;
+    ResourceManager::Destroy () ;
+
+    return 0 ;
+}
@@ -172,6 +172,12 @@ bool MyApplicationExample::createScene()
         renderpass  = pipeline -> getPass ( 2 ) ;
 
         renderpass -> addNamedParameter("shadows", HdwProgVarType::Bool1, (int) 1) ;
+
+        //////////////////////////////////////////////////////////////////////
+        // The first pass renders the depth map : it draws what the light sees
+        // instead of what its camera sees.
+
+        renderpass2 -> setShadowPass ( true ) ;
     }
 
     return true ;
@@ -282,6 +288,7 @@ void MyApplicationExample::loadScene ( void )
     cubenode2 -> scale ( 10.0f , 0.3f , 10.0f ) ;
     cubenode2 -> setMesh( cube ) ;
     cubenode2 -> setMaterial( material ) ;
+    cubenode2 -> setShadowCaster ( false ) ;
 
     scene -> add ( cubenode2 ) ;
 
@@ -301,6 +308,7 @@ void MyApplicationExample::loadScene ( void )
 
     scene -> add ( lightnode ) ;
     renderpass2 -> setCamera ( lightnode ) ;
+    renderpass2 -> setShadowLight ( lightnode ) ;
 
     //////////////////////////////////////////////////////////////////////
     // Creates the camera. The camera has position , direction , but also
@@ -0,0 +1,65 @@
+//
+//  ParticleBenchmark.cpp
+//  GRE
+//
+//  Created by Jacques Tronconi on 28/06/2017.
+//
+//
+
+#include "ParticleEmitter.h"
+#include "JobPool.h"
+
+using namespace Gre ;
+
+//////////////////////////////////////////////////////////////////////
+// Measures the time taken by a ParticleEmitter to simulate one million
+// particles and to write their vertices. The emitter has no scene and
+// no mesh manager , so nothing is uploaded.
+
+static const size_t ParticlesCount = 1000000 ;
+static const size_t FramesCount = 120 ;
+static const float FrameTime = 1.0f / 60.0f ;
+
+int main ()
+{
+    Holder < ParticleEmitter > emitter = new ParticleEmitter ( nullptr , "benchmark" , ParticlesCount ) ;
+
+    emitter -> setLifetime ( 4.0f , 8.0f ) ;
+    emitter -> setSpeed ( 1.0f , 10.0f ) ;
+    emitter -> setDirection ( Vector3 ( 0.0f , 1.0f , 0.0f ) , 0.5f ) ;
+    emitter -> setEmissionRadius ( 2.0f ) ;
+    emitter -> setGravity ( Vector3 ( 0.0f , -9.81f , 0.0f ) ) ;
+    emitter -> setDamping ( 0.1f ) ;
+    emitter -> setColors ( Color ( 1.0f , 0.8f , 0.2f , 1.0f ) , Color ( 0.2f , 0.2f , 0.2f , 0.0f ) ) ;
+    emitter -> setRate ( ParticlesCount / 6.0f ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Fills the emitter.
+
+    TimePoint start = Time::now () ;
+    emitter -> emit ( ParticlesCount ) ;
+
+    GreDebug ( "[INFO] Emitted " ) << emitter -> getCount () << " particles in "
+                                   << Duration ( Time::now () - start ) .count () << " s." << gendl ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Simulates some frames.
+
+    float slowest = 0.0f ;
+    start = Time::now () ;
+
+    for ( size_t i = 0 ; i < FramesCount ; ++i )
+    {
+        TimePoint frame = Time::now () ;
+        emitter -> simulate ( FrameTime ) ;
+        slowest = std::max ( slowest , Duration ( Time::now () - frame ) .count () ) ;
+    }
+
+    float average = Duration ( Time::now () - start ) .count () / FramesCount ;
+
+    GreDebug ( "[INFO] Simulated " ) << FramesCount << " frames : " << average * 1000.0f << " ms average , "
+                                     << slowest * 1000.0f << " ms slowest , " << emitter -> getCount ()
+                                     << " particles alive on " << JobPool::Get () .getThreadsCount () << " threads." << gendl ;
+
+    return 0 ;
+}
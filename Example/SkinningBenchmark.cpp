@@ -0,0 +1,167 @@
+//
+//  SkinningBenchmark.cpp
+//  GRE
+//
+//  Created by Jacques Tronconi on 28/06/2017.
+//
+//
+
+#include "SkinnedNode.h"
+#include "SoftwareVertexBuffer.h"
+#include "JobPool.h"
+
+using namespace Gre ;
+
+//////////////////////////////////////////////////////////////////////
+// Measures the time taken to animate and skin a crowd of characters.
+// Each character is a column of vertices bent by a chain of bones ,
+// playing a clip sampled at 30 keys per second. There is no mesh manager ,
+// so nothing is uploaded.
+
+static const size_t CharactersCount = 300 ;
+static const size_t BonesCount = 32 ;
+static const size_t VerticesCount = 4096 ;
+static const size_t FramesCount = 60 ;
+static const float FrameTime = 1.0f / 60.0f ;
+
+//////////////////////////////////////////////////////////////////////
+// A mesh only holding CPU data , as no renderer is loaded.
+
+class BenchmarkMesh : public Mesh
+{
+public:
+
+    BenchmarkMesh ( const std::string & name ) : Mesh ( name ) { }
+
+protected:
+
+    virtual void iBind ( const TechniqueHolder & ) const { }
+    virtual void iUnbind ( const TechniqueHolder & ) const { }
+};
+
+struct SkinnedVertex
+{
+    float position [3] ;
+    float normal [3] ;
+    unsigned char indices [4] ;
+    float weights [4] ;
+};
+
+int main ()
+{
+    //////////////////////////////////////////////////////////////////////
+    // A chain of bones , one unit long each.
+
+    SkeletonHolder skeleton = new Skeleton ( "chain" ) ;
+
+    for ( size_t b = 0 ; b < BonesCount ; ++b )
+    {
+        BoneTransform bind ;
+        bind.translation = Vector3 ( 0.0f , b ? 1.0f : 0.0f , 0.0f ) ;
+        skeleton -> addBone ( "bone" + std::to_string ( b ) , (int) b - 1 , bind ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // A clip bending every bone , then compressed.
+
+    AnimationClipHolder clip = new AnimationClip ( "bend" , 2.0f ) ;
+
+    for ( size_t b = 0 ; b < BonesCount ; ++b )
+    {
+        for ( size_t k = 0 ; k <= 60 ; ++k )
+        {
+            float time = k / 30.0f ;
+            float angle = 0.2f * sinf ( time * 3.14159265f + b * 0.3f ) ;
+            clip -> addRotationKey ( b , time , glm::angleAxis ( angle , Vector3 ( 0.0f , 0.0f , 1.0f ) ) ) ;
+            clip -> addTranslationKey ( b , time , Vector3 ( 0.0f , b ? 1.0f : 0.0f , 0.0f ) ) ;
+        }
+    }
+
+    size_t keys = clip -> getKeysCount () ;
+    size_t removed = clip -> compress ( 0.001f ) ;
+
+    GreDebug ( "[INFO] Compressed clip : " ) << keys << " keys , " << removed << " removed , "
+                                             << clip -> getKeysSize () << " bytes." << gendl ;
+
+    //////////////////////////////////////////////////////////////////////
+    // A column of vertices , each one bound to the two nearest bones.
+
+    std::vector < SkinnedVertex > vertices ( VerticesCount ) ;
+    float height = (float) ( BonesCount - 1 ) ;
+
+    for ( size_t v = 0 ; v < VerticesCount ; ++v )
+    {
+        float y = height * v / ( VerticesCount - 1 ) ;
+        float angle = v * 0.7f ;
+        size_t bone = std::min ( (size_t) y , BonesCount - 2 ) ;
+        float weight = y - bone ;
+
+        SkinnedVertex & vertex = vertices [v] ;
+        vertex.position [0] = cosf ( angle ) * 0.3f ; vertex.position [1] = y ; vertex.position [2] = sinf ( angle ) * 0.3f ;
+        vertex.normal [0] = cosf ( angle ) ; vertex.normal [1] = 0.0f ; vertex.normal [2] = sinf ( angle ) ;
+        vertex.indices [0] = (unsigned char) bone ; vertex.indices [1] = (unsigned char) ( bone + 1 ) ;
+        vertex.indices [2] = vertex.indices [3] = 0 ;
+        vertex.weights [0] = 1.0f - weight ; vertex.weights [1] = weight ;
+        vertex.weights [2] = vertex.weights [3] = 0.0f ;
+    }
+
+    VertexDescriptor descriptor ;
+    descriptor.addComponent ( VertexAttribAlias::Position , 3 , VertexAttribType::Float , false , 3 * sizeof ( float ) ) ;
+    descriptor.addComponent ( VertexAttribAlias::Normal , 3 , VertexAttribType::Float , true , 3 * sizeof ( float ) ) ;
+    descriptor.addComponent ( VertexAttribAlias::BoneIndices , 4 , VertexAttribType::UnsignedByte , false , 4 * sizeof ( unsigned char ) ) ;
+    descriptor.addComponent ( VertexAttribAlias::BoneWeights , 4 , VertexAttribType::Float , false , 4 * sizeof ( float ) ) ;
+
+    HardwareVertexBufferHolder vbuffer = new SoftwareVertexBuffer ( "column.vertices" ) ;
+    vbuffer -> setVertexDescriptor ( descriptor ) ;
+    vbuffer -> addData ( reinterpret_cast < const char * > ( vertices.data () ) , vertices.size () * sizeof ( SkinnedVertex ) ) ;
+
+    SubMeshHolder submesh = new SubMesh ( "column.submesh" ) ;
+    submesh -> addVertexBuffer ( vbuffer ) ;
+
+    MeshHolder mesh = new BenchmarkMesh ( "column" ) ;
+    mesh -> addSubMesh ( submesh ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The crowd.
+
+    std::vector < Holder < SkinnedNode > > holders ;
+    std::vector < SkinnedNode * > characters ;
+
+    for ( size_t c = 0 ; c < CharactersCount ; ++c )
+    {
+        Holder < SkinnedNode > character = new SkinnedNode ( nullptr , "character" + std::to_string ( c ) ) ;
+        character -> setSkeleton ( skeleton ) ;
+
+        if ( !character -> setSkinnedMesh ( mesh ) )
+        return 1 ;
+
+        character -> play ( clip , true ) ;
+        character -> setTime ( c * 0.01f ) ;
+        character -> setAutoAnimate ( false ) ;
+
+        holders.push_back ( character ) ;
+        characters.push_back ( character.getObject () ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Animates some frames.
+
+    float slowest = 0.0f ;
+    TimePoint start = Time::now () ;
+
+    for ( size_t i = 0 ; i < FramesCount ; ++i )
+    {
+        TimePoint frame = Time::now () ;
+        SkinnedNode::Animate ( characters , FrameTime ) ;
+        slowest = std::max ( slowest , Duration ( Time::now () - frame ) .count () ) ;
+    }
+
+    float average = Duration ( Time::now () - start ) .count () / FramesCount ;
+
+    GreDebug ( "[INFO] Animated " ) << CharactersCount << " characters ( " << BonesCount << " bones , "
+                                    << VerticesCount << " vertices ) : " << average * 1000.0f << " ms average , "
+                                    << slowest * 1000.0f << " ms slowest on " << JobPool::Get () .getThreadsCount ()
+                                    << " threads." << gendl ;
+
+    return 0 ;
+}
@@ -0,0 +1,154 @@
+//
+//  SpatialBenchmark.cpp
+//  GRE
+//
+//  Created by Jacques Tronconi on 24/06/2017.
+//
+//
+
+#include "AabbTree.h"
+#include "JobPool.h"
+
+#include <random>
+
+using namespace Gre ;
+
+//////////////////////////////////////////////////////////////////////
+// Measures the queries per second of the AabbTree used by the scenes'
+// spatial index. Nodes are small random boxes spread in a cube. Each
+// query kind runs on one thread , then on every JobPool threads.
+
+static const size_t NodesCount = 100000 ;
+static const size_t QueriesCount = 200000 ;
+static const float WorldSize = 1000.0f ;
+
+struct Query
+{
+    Vector3 origin ;
+    Vector3 direction ;
+};
+
+template < typename Function >
+void Measure ( const char * name , size_t count , Function function )
+{
+    //////////////////////////////////////////////////////////////////////
+    // Single thread.
+
+    TimePoint start = Time::now () ;
+    size_t found = 0 ;
+
+    for ( size_t i = 0 ; i < count ; ++i )
+    found += function ( i ) ;
+
+    float single = Duration ( Time::now () - start ) .count () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Every threads.
+
+    std::atomic < size_t > parallelfound ( 0 ) ;
+    start = Time::now () ;
+
+    JobPool::Get () .parallelFor ( count , 1024 , [&] ( size_t begin , size_t end ) {
+        size_t local = 0 ;
+        for ( size_t i = begin ; i < end ; ++i )
+        local += function ( i ) ;
+        parallelfound += local ;
+    } ) ;
+
+    float parallel = Duration ( Time::now () - start ) .count () ;
+
+    GreDebug ( "[INFO] " ) << name << " : " << (size_t) ( count / single ) << " queries/s , "
+                           << (size_t) ( count / parallel ) << " queries/s on " << JobPool::Get () .getThreadsCount ()
+                           << " threads ( " << found << " results )." << gendl ;
+}
+
+int main ()
+{
+    std::mt19937 random ( 42 ) ;
+    std::uniform_real_distribution < float > position ( 0.0f , WorldSize ) ;
+    std::uniform_real_distribution < float > size ( 0.5f , 4.0f ) ;
+    std::uniform_real_distribution < float > unit ( -1.0f , 1.0f ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Builds the tree.
+
+    std::vector < BoundingBox > boxes ;
+    std::vector < int > proxies ;
+    AabbTree tree ( 0.5f ) ;
+
+    TimePoint start = Time::now () ;
+
+    for ( size_t i = 0 ; i < NodesCount ; ++i )
+    {
+        Vector3 min ( position ( random ) , position ( random ) , position ( random ) ) ;
+        Vector3 max = min + Vector3 ( size ( random ) , size ( random ) , size ( random ) ) ;
+
+        boxes.push_back ( BoundingBox ( min , max ) ) ;
+        proxies.push_back ( tree.insert ( boxes.back () , (void*) i ) ) ;
+    }
+
+    GreDebug ( "[INFO] Inserted " ) << NodesCount << " nodes in " << Duration ( Time::now () - start ) .count ()
+                                    << " s , height " << tree.getHeight () << "." << gendl ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Moves every node a bit , then far away for one node out of ten.
+
+    start = Time::now () ;
+    size_t reinserted = 0 ;
+
+    for ( size_t i = 0 ; i < NodesCount ; ++i )
+    {
+        Vector3 offset = i % 10 ? Vector3 ( unit ( random ) , unit ( random ) , unit ( random ) ) * 0.2f
+                                : Vector3 ( unit ( random ) , unit ( random ) , unit ( random ) ) * 50.0f ;
+
+        boxes [i] = BoundingBox ( boxes [i] .getMin () + offset , boxes [i] .getMax () + offset ) ;
+        reinserted += tree.move ( proxies [i] , boxes [i] ) ? 1 : 0 ;
+    }
+
+    GreDebug ( "[INFO] Moved " ) << NodesCount << " nodes in " << Duration ( Time::now () - start ) .count ()
+                                 << " s , " << reinserted << " reinserted , height " << tree.getHeight () << "." << gendl ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Prepares the queries.
+
+    std::vector < Query > queries ( QueriesCount ) ;
+
+    for ( Query & query : queries )
+    {
+        query.origin = Vector3 ( position ( random ) , position ( random ) , position ( random ) ) ;
+        query.direction = glm::normalize ( Vector3 ( unit ( random ) , unit ( random ) , unit ( random ) ) + Vector3 ( 0.0f , 0.0f , 0.001f ) ) ;
+    }
+
+    Measure ( "Raycast ( 200 units )" , QueriesCount , [&] ( size_t i ) -> size_t {
+        const Query & q = queries [i] ;
+        bool hit = false ;
+        tree.raycast ( q.origin , q.direction , 200.0f , [&] ( void * , float entry ) -> float {
+            hit = true ; return entry ;
+        } ) ;
+        return hit ? 1 : 0 ;
+    } ) ;
+
+    Measure ( "Sphere overlap ( radius 10 )" , QueriesCount , [&] ( size_t i ) -> size_t {
+        size_t count = 0 ;
+        tree.querySphere ( queries [i] .origin , 10.0f , [&] ( void * ) -> bool { count ++ ; return true ; } ) ;
+        return count ;
+    } ) ;
+
+    Measure ( "Box overlap ( 20 units )" , QueriesCount , [&] ( size_t i ) -> size_t {
+        size_t count = 0 ;
+        Vector3 half ( 10.0f , 10.0f , 10.0f ) ;
+        tree.queryBox ( queries [i] .origin - half , queries [i] .origin + half , [&] ( void * ) -> bool { count ++ ; return true ; } ) ;
+        return count ;
+    } ) ;
+
+    Measure ( "8 nearest" , QueriesCount , [&] ( size_t i ) -> size_t {
+        std::vector < std::pair < float , void * > > result ;
+        const Vector3 & point = queries [i] .origin ;
+        tree.nearest ( point , 8 , [&] ( void * , const Vector3 & min , const Vector3 & max ) -> float {
+            return std::sqrt ( AabbTree::SquaredDistance ( min , max , point ) ) ;
+        } , result ) ;
+        return result.size () ;
+    } ) ;
+
+    return 0 ;
+}
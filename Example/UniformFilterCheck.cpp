@@ -0,0 +1,158 @@
+//
+//  UniformFilterCheck.cpp
+//  GRE
+//
+//  Created by Jacques Tronconi on 28/06/2017.
+//
+//
+
+#include "HardwareProgram.h"
+
+using namespace Gre ;
+
+//////////////////////////////////////////////////////////////////////
+// Checks the uniforms filter of HardwareProgram against a program which
+// counts the values really sent to its backend. Every 'setUniform()'
+// not reaching '_setUniform()' must be counted as a hit , every other
+// one as a miss.
+
+//////////////////////////////////////////////////////////////////////
+// A program counting the uniforms sent to the backend. 'failing' makes
+// the backend refuse every values.
+
+class CheckProgram : public HardwareProgram
+{
+public:
+
+    CheckProgram ( const std::string & name ) : HardwareProgram ( name ) , failing ( false ) , calls ( 0 ) { }
+
+    virtual bool binded () const { return iBinded ; }
+    virtual void setVertexAttrib ( const std::string & , size_t , VertexAttribType , bool , size_t , void * ) const { }
+    virtual void disableVertexAttribs () const { }
+    virtual void bindTextureUnit ( int ) const { }
+    virtual unsigned int getMaximumLights () const { return 8 ; }
+
+    bool failing ;
+    mutable size_t calls ;
+
+protected:
+
+    virtual void _bind () const { iBinded = true ; }
+    virtual void _unbind () const { iBinded = false ; }
+    virtual bool _attachShader ( const HardwareShaderHolder & ) { return true ; }
+    virtual void _deleteProgram () { }
+
+    virtual bool _finalize ()
+    {
+        addUniform ( "u_color" , 0 , HdwProgVarType::Float4 ) ;
+        addUniform ( "u_position" , 1 , HdwProgVarType::Float3 ) ;
+        addUniform ( "u_texture" , 2 , HdwProgVarType::Sampler2D ) ;
+        return true ;
+    }
+
+    virtual bool _setUniform ( int , const HdwProgVarType & , const RealProgramVariable & ) const
+    {
+        calls ++ ; return !failing ;
+    }
+
+    void addUniform ( const std::string & name , int location , const HdwProgVarType & type )
+    {
+        HardwareProgramVariable variable ;
+        variable.name = name ;
+        variable.location = location ;
+        variable.type = type ;
+        iUniforms.insert ( std::make_pair ( name , variable ) ) ;
+    }
+};
+
+//////////////////////////////////////////////////////////////////////
+// Compares the counters with the expected numbers and the backend calls.
+
+static bool Check ( const std::string & step , const Holder < CheckProgram > & program , size_t hits , size_t misses )
+{
+    bool valid = HardwareProgram::GetUniformHits () == hits
+              && HardwareProgram::GetUniformMisses () == misses
+              && HardwareProgram::GetUniformMisses () == program -> calls
+              && HardwareProgram::GetUniformCalls () == hits + misses ;
+
+    if ( valid )
+    GreDebug ( "[INFO] " ) << step << " : " << hits << " hits , " << misses << " misses." << gendl ;
+
+    else
+    GreDebug ( "[WARN] " ) << step << " : expected " << hits << " hits and " << misses << " misses , got "
+                           << HardwareProgram::GetUniformHits () << " hits , " << HardwareProgram::GetUniformMisses ()
+                           << " misses and " << program -> calls << " backend calls." << gendl ;
+
+    return valid ;
+}
+
+int main ()
+{
+    Holder < CheckProgram > program = new CheckProgram ( "program" ) ;
+    program -> finalize () ;
+
+    bool valid = true ;
+    HardwareProgram::ResetUniformCalls () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The same value set again is filtered , a new one is sent.
+
+    for ( int i = 0 ; i < 10 ; ++i )
+    program -> setUniform ( 0 , HdwProgVarType::Float4 , RealProgramVariable ( Vector4 ( 1.0f , 0.0f , 0.0f , 1.0f ) ) ) ;
+
+    valid &= Check ( "Same value" , program , 9 , 1 ) ;
+
+    for ( int i = 0 ; i < 10 ; ++i )
+    program -> setUniform ( 0 , HdwProgVarType::Float4 , RealProgramVariable ( Vector4 ( (float) i , 0.0f , 0.0f , 1.0f ) ) ) ;
+
+    valid &= Check ( "Changing value" , program , 9 , 11 ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Only the bytes of the given type are compared : a different 'w' does
+    // not change a Float3.
+
+    program -> setUniform ( 1 , HdwProgVarType::Float3 , RealProgramVariable ( Vector4 ( 1.0f , 2.0f , 3.0f , 4.0f ) ) ) ;
+    program -> setUniform ( 1 , HdwProgVarType::Float3 , RealProgramVariable ( Vector4 ( 1.0f , 2.0f , 3.0f , 5.0f ) ) ) ;
+
+    valid &= Check ( "Type size" , program , 10 , 12 ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Setting by name goes through the same filter , and a value of another
+    // type is refused before reaching it.
+
+    program -> setUniform ( "u_texture" , HdwProgVarType::Sampler2D , RealProgramVariable ( 3 ) ) ;
+    program -> setUniform ( "u_texture" , HdwProgVarType::Sampler2D , RealProgramVariable ( 3 ) ) ;
+    program -> setUniform ( "u_texture" , HdwProgVarType::Float1 , RealProgramVariable ( 3.0f ) ) ;
+
+    valid &= Check ( "Names" , program , 11 , 13 ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // A value refused by the backend is sent again next time.
+
+    program -> failing = true ;
+    program -> setUniform ( 2 , HdwProgVarType::Sampler2D , RealProgramVariable ( 4 ) ) ;
+    program -> failing = false ;
+    program -> setUniform ( 2 , HdwProgVarType::Sampler2D , RealProgramVariable ( 4 ) ) ;
+    program -> setUniform ( 2 , HdwProgVarType::Sampler2D , RealProgramVariable ( 4 ) ) ;
+
+    valid &= Check ( "Backend failure" , program , 12 , 15 ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Unknown locations are never filtered.
+
+    program -> setUniform ( -1 , HdwProgVarType::Float1 , RealProgramVariable ( 1.0f ) ) ;
+    program -> setUniform ( -1 , HdwProgVarType::Float1 , RealProgramVariable ( 1.0f ) ) ;
+
+    valid &= Check ( "Unknown location" , program , 12 , 17 ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Linking again forgets the values of the previous link.
+
+    program -> reset () ;
+    program -> finalize () ;
+    program -> setUniform ( 0 , HdwProgVarType::Float4 , RealProgramVariable ( Vector4 ( 9.0f , 0.0f , 0.0f , 1.0f ) ) ) ;
+
+    valid &= Check ( "Relink" , program , 12 , 18 ) ;
+
+    return valid ? 0 : 1 ;
+}
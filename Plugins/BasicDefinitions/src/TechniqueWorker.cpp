@@ -90,6 +90,7 @@ bool TechniqueWorker::process ( const DefinitionFileNode * node ,
     auto fm = ResourceManager::Get() -> getFramebufferManager() ;
 
     TechniqueHolder technique = tm -> loadBlank( techname );
+    RasterState raster ;
 
     for ( auto subnode : node -> getChildren() )
     {
@@ -147,6 +148,30 @@ bool TechniqueWorker::process ( const DefinitionFileNode * node ,
             technique -> setFramebuffer( fb );
         }
 
+        else if ( subnode -> getDefinitionWord( 0 ) == "DepthTest" &&
+            subnode -> countWords() >= 2 )
+        {
+            raster.depthtest = subnode -> getDefinitionWord( 1 ) == "true" ;
+        }
+
+        else if ( subnode -> getDefinitionWord( 0 ) == "DepthWrite" &&
+            subnode -> countWords() >= 2 )
+        {
+            raster.depthwrite = subnode -> getDefinitionWord( 1 ) == "true" ;
+        }
+
+        else if ( subnode -> getDefinitionWord( 0 ) == "Culling" &&
+            subnode -> countWords() >= 2 )
+        {
+            raster.culling = CullModeFromString( subnode -> getDefinitionWord( 1 ) );
+        }
+
+        else if ( subnode -> getDefinitionWord( 0 ) == "Blending" &&
+            subnode -> countWords() >= 2 )
+        {
+            raster.blending = subnode -> getDefinitionWord( 1 ) == "true" ;
+        }
+
         else if ( subnode -> getName() == "Self-Rendered" )
         {
             technique -> setSelfRendered( true );
@@ -173,6 +198,12 @@ bool TechniqueWorker::process ( const DefinitionFileNode * node ,
         }
     }
 
+    //////////////////////////////////////////////////////////////////////
+    // Creates the pipeline state now , so drawing doesn't have to.
+
+    technique -> setRasterState( raster );
+    technique -> getPipelineState();
+
     tm -> loadFromHolder( technique );
     GreDebug( "[INFO] Loaded Technique '" ) << techname << "'." << gendl ;
     return true ;
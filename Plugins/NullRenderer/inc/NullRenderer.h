@@ -0,0 +1,780 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  NullRenderer.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef NullRenderer_h
+#define NullRenderer_h
+
+#include <Renderer.h>
+
+#include <atomic>
+#include <sstream>
+
+class NullRenderer ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A backend call , as recorded by a tracing NullRenderer.
+//////////////////////////////////////////////////////////////////////
+struct NullRendererCall
+{
+    /// @brief Name of the backend function , as 'drawSubMesh'.
+    std::string function ;
+
+    /// @brief Arguments of the call , separated by commas.
+    std::string arguments ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A render context without any window. Binding and flushing it
+/// does nothing , and its surface is given at creation.
+//////////////////////////////////////////////////////////////////////
+class NullRenderContext : public Gre::RenderContext
+{
+public:
+
+    POOLED ( Gre::Pools::Resource )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    NullRenderContext ( const std::string & name , const Gre::Surface & surface ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~NullRenderContext () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void bind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void unbind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Counts the frames flushed.
+    //////////////////////////////////////////////////////////////////////
+    virtual void flush () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::Surface getSurface () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the surface , as a window resize would.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setSurface ( const Gre::Surface & surface ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of calls to 'flush()'.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getFramesCount () const ;
+
+protected:
+
+    /// @brief Surface of the context.
+    Gre::Surface iSurface ;
+
+    /// @brief Number of frames flushed.
+    mutable size_t iFrames ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A framebuffer without storage. Attachments are always accepted.
+//////////////////////////////////////////////////////////////////////
+class NullFramebuffer : public Gre::RenderFramebuffer
+{
+public:
+
+    POOLED ( Gre::Pools::Render )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    NullFramebuffer ( const NullRenderer * renderer , const std::string & name ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~NullFramebuffer () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void bind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void unbind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool binded () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isComplete () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records the copy and returns true.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool copy ( const Gre::RenderFramebuffer & source , const Gre::RenderFramebufferAttachement & attachment ) const ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool bindAttachment ( const Gre::FramebufferAttachment & attachment ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void unbindAttachment ( const Gre::FramebufferAttachment & attachment ) const ;
+
+protected:
+
+    /// @brief Renderer recording the calls.
+    const NullRenderer * iRenderer ;
+
+    /// @brief Property to hold the bind state of the framebuffer.
+    mutable bool iBinded ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Null Framebuffer Creator.
+//////////////////////////////////////////////////////////////////////
+class NullFramebufferCreator : public Gre::RenderFramebufferInternalCreator
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    NullFramebufferCreator ( const NullRenderer * renderer ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~NullFramebufferCreator () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::RenderFramebuffer* load ( const std::string & name , const Gre::ResourceLoaderOptions& options ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::RenderFramebuffer* loadNull () const ;
+
+protected:
+
+    /// @brief Parent's renderer.
+    const NullRenderer * iRenderer ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A texture keeping its pixel buffers on the CPU.
+//////////////////////////////////////////////////////////////////////
+class NullTexture : public Gre::Texture
+{
+public:
+
+    POOLED ( Gre::Pools::Render )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    NullTexture (const NullRenderer * renderer ,
+                 const std::string & name , const Gre::TextureType & type ,
+                 const Gre::SoftwarePixelBufferHolderList & buffers) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~NullTexture () noexcept ( false ) ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void _bind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void _unbind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records the size of the pixel buffers as if they were
+    /// uploaded.
+    //////////////////////////////////////////////////////////////////////
+    virtual void _setBuffer ( ) const ;
+
+protected:
+
+    /// @brief Renderer recording the calls.
+    const NullRenderer * iRenderer ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Null Texture Creator.
+//////////////////////////////////////////////////////////////////////
+class NullTextureCreator : public Gre::TextureInternalCreator
+{
+public:
+
+    POOLED ( Gre::Pools::Manager )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    NullTextureCreator ( const NullRenderer * renderer ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~NullTextureCreator () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::Texture* load (const std::string & name ,
+                                const Gre::SoftwarePixelBufferHolderList & buffers ,
+                                const Gre::TextureType & type ,
+                                const Gre::ResourceLoaderOptions & ops ) const ;
+
+protected:
+
+    /// @brief
+    const NullRenderer * iRenderer ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A shader which is never compiled. Its source is kept so the
+/// program can find its uniforms and attributes.
+//////////////////////////////////////////////////////////////////////
+class NullShader : public Gre::HardwareShader
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    NullShader ( const std::string & name , const Gre::ShaderType & type , const std::string & src ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~NullShader () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns an empty log.
+    //////////////////////////////////////////////////////////////////////
+    virtual const std::string& getErrorLog () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the source with its '#include' directives expanded.
+    //////////////////////////////////////////////////////////////////////
+    virtual const std::string& getRealSource () const ;
+
+protected:
+
+    /// @brief
+    std::string iErrorLog ;
+
+    /// @brief Source with included files.
+    std::string iRealSource ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A program accepting every uniforms.
+///
+/// The uniforms , uniform blocks and vertex attributes are found by
+/// scanning the GLSL sources of the shaders , so techniques resolve the
+/// same locations as with a real driver. Structures and arrays are
+/// expanded as a driver names them ( 'lights[0].position' ). Unlike a
+/// driver , unused uniforms are also listed.
+//////////////////////////////////////////////////////////////////////
+class NullProgram : public Gre::HardwareProgram
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    NullProgram ( const NullRenderer * renderer , const std::string & name ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~NullProgram () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void _bind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void _unbind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool _attachShader ( const Gre::HardwareShaderHolder & hwdShader ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Scans the attached shaders' sources.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool _finalize () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void _deleteProgram () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool binded () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void disableVertexAttribs () const ;
+
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void setVertexAttrib (const std::string & attrib ,
+                                  size_t elements ,
+                                  Gre::VertexAttribType type ,
+                                  bool normalize ,
+                                  size_t stride ,
+                                  void * pointer) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void setVertexAttrib (int location ,
+                                  size_t elements ,
+                                  Gre::VertexAttribType type ,
+                                  bool normalize ,
+                                  size_t stride ,
+                                  void * pointer) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void bindTextureUnit ( int unit ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool _setUniform ( int location , const Gre::HdwProgVarType & type , const Gre::RealProgramVariable & value ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool _setUniformBlock ( int index , const Gre::UniformBlockBinding & binding ,
+                                    const Gre::UniformArena & arena , size_t offset , size_t size ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns 10 , as the OpenGl program.
+    //////////////////////////////////////////////////////////////////////
+    virtual unsigned int getMaximumLights () const ;
+
+protected:
+
+    /// @brief Renderer recording the calls.
+    const NullRenderer * iRenderer ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Null HardwareProgramManagerCreator.
+//////////////////////////////////////////////////////////////////////
+class NullProgramManagerCreator : public Gre::HardwareProgramManagerInternalCreator
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    NullProgramManagerCreator ( const NullRenderer * renderer ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~NullProgramManagerCreator () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::HardwareShaderHolder loadShader (const Gre::ShaderType & type ,
+                                                  const std::string & name ,
+                                                  const std::string & source) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::HardwareProgramHolder loadProgram (const std::string & name ,
+                                                    const Gre::HardwareShaderHolderList & shaders) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns "GLSL" , so the bundles made for the OpenGlRenderer
+    /// are loaded unchanged.
+    //////////////////////////////////////////////////////////////////////
+    virtual const std::string getCompiler () const ;
+
+protected:
+
+    /// @brief
+    const NullRenderer * iRenderer ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Null Index Buffer. Only the size of the data is kept.
+//////////////////////////////////////////////////////////////////////
+class NullHardwareIndexBuffer : public Gre::HardwareIndexBuffer
+{
+public:
+
+    POOLED ( Gre::Pools::HdwBuffer )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    NullHardwareIndexBuffer ( const NullRenderer * renderer , size_t sz , const Gre::IndexDescriptor& desc ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~NullHardwareIndexBuffer () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void bind() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void unbind() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void addData(const char* vdata, size_t sz);
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns null , as the OpenGl buffers.
+    //////////////////////////////////////////////////////////////////////
+    virtual const char* getData() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void clearData();
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getSize() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t count() const;
+
+protected:
+
+    /// @brief Renderer recording the calls.
+    const NullRenderer * iRenderer ;
+
+    /// @brief
+    size_t iSize ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Null Vertex Buffer. Only the size of the data is kept.
+//////////////////////////////////////////////////////////////////////
+class NullHardwareVertexBuffer : public Gre::HardwareVertexBuffer
+{
+public:
+
+    POOLED ( Gre::Pools::HdwBuffer )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    NullHardwareVertexBuffer ( const NullRenderer * renderer , size_t sz , const Gre::VertexDescriptor& desc ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~NullHardwareVertexBuffer () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void bind() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void unbind() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void addData(const char* vdata, size_t sz);
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns null , as the OpenGl buffers.
+    //////////////////////////////////////////////////////////////////////
+    virtual const char* getData() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void clearData();
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getSize() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t count() const;
+
+protected:
+
+    /// @brief Renderer recording the calls.
+    const NullRenderer * iRenderer ;
+
+    /// @brief
+    size_t iSize ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Null Gre::MeshManager.
+//////////////////////////////////////////////////////////////////////
+class NullMeshManager : public Gre::MeshManager
+{
+public:
+
+    POOLED ( Gre::Pools::Manager )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    NullMeshManager ( const NullRenderer * renderer ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~NullMeshManager () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::HardwareVertexBufferHolder createVertexBuffer ( const void* data , size_t sz , const Gre::VertexDescriptor& desc ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::HardwareIndexBufferHolder createIndexBuffer ( const void* data , size_t sz , const Gre::IndexDescriptor& desc ) const  ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::Mesh* create ( const std::string & name ) const ;
+
+protected:
+
+    /// @brief
+    const NullRenderer * iRenderer ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A Gre::Renderer doing no GPU work.
+///
+/// Every resources are created as with a real backend , and every
+/// backend calls are made , so the whole pipeline runs on the CPU as it
+/// does with the OpenGlRenderer. When tracing , each call is recorded
+/// with its arguments : tests can compare traces between two versions ,
+/// and benchmarks can count the calls.
+///
+/// The renderer is loaded when the RendererOptions holds 'Renderer.Backend'
+/// set to "Null". 'Renderer.Trace' ( bool ) enables tracing , and
+/// 'Renderer.Size' ( string , as "1024x768" ) gives the size of the
+/// NullRenderContext created by the loader.
+///
+//////////////////////////////////////////////////////////////////////
+class NullRenderer : public Gre::Renderer
+{
+public:
+
+    POOLED ( Gre::Pools::Render )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    NullRenderer ( const std::string& name , const Gre::RendererOptions& options ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~NullRenderer () noexcept ( false ) ;
+
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void setClearRegion ( const Gre::Surface & box ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void setViewport ( const Gre::Viewport & viewport ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void setClearColor ( const Gre::Color & color ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void setClearDepth ( float value ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void clearBuffers ( const Gre::ClearBuffers & buffers ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void draw ( const Gre::TechniqueHolder & technique ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void drawSubMesh ( const Gre::SubMeshHolder & submesh ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void setRasterState ( const Gre::RasterState & state ) const ;
+
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Enables or disables the recording of the backend calls.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setTracing ( bool value ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isTracing () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records a call if tracing. Arguments are formatted only when
+    /// tracing , so a disabled trace costs one test.
+    //////////////////////////////////////////////////////////////////////
+    template < typename ... Args >
+    void trace ( const char * function , const Args & ... args ) const
+    {
+        if ( !iTracing )
+        return ;
+
+        std::ostringstream stream ;
+        iFormat ( stream , args... ) ;
+        iRecord ( function , stream.str () ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns a copy of the recorded calls.
+    //////////////////////////////////////////////////////////////////////
+    virtual std::vector < NullRendererCall > getTrace () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of recorded calls to given function.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getCallsCount ( const std::string & function ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Removes the recorded calls.
+    //////////////////////////////////////////////////////////////////////
+    virtual void clearTrace () ;
+
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::MeshManagerHolder iCreateMeshManager ( ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::HardwareProgramManagerInternalCreator * iCreateProgramManagerCreator ( ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::TextureInternalCreator* iCreateTextureCreator ( ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::RenderFramebufferInternalCreator* iCreateFramebufferCreator ( ) const ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Ends the arguments recursion.
+    //////////////////////////////////////////////////////////////////////
+    void iFormat ( std::ostringstream & ) const { }
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Writes the arguments separated by commas.
+    //////////////////////////////////////////////////////////////////////
+    template < typename First , typename ... Args >
+    void iFormat ( std::ostringstream & stream , const First & first , const Args & ... args ) const
+    {
+        stream << first ;
+
+        if ( sizeof ... ( args ) )
+        stream << " , " ;
+
+        iFormat ( stream , args... ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Appends a call to the trace.
+    //////////////////////////////////////////////////////////////////////
+    void iRecord ( const char * function , const std::string & arguments ) const ;
+
+protected:
+
+    /// @brief True if the calls are recorded. Read by every threads creating
+    /// resources.
+    std::atomic < bool > iTracing ;
+
+    /// @brief Recorded calls.
+    mutable std::vector < NullRendererCall > iTrace ;
+
+    /// @brief Protects 'iTrace'.
+    mutable std::mutex iTraceMutex ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A NullRenderer Loader.
+//////////////////////////////////////////////////////////////////////
+class NullRendererLoader : public Gre::RendererLoader
+{
+public:
+
+    POOLED ( Gre::Pools::Loader )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    NullRendererLoader () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~NullRendererLoader () noexcept ( false ) ;
+
+    ////////////////////////////////////////////////////////////////////////
+    /// @brief Returns a clone of this object.
+    ////////////////////////////////////////////////////////////////////////
+    virtual Gre::ResourceLoader* clone() const;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns false.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isLoadable( const std::string& filepath ) const;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if 'Renderer.Backend' is "Null".
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isCompatible ( const Gre::RendererOptions& options ) const;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Creates a NullRenderer with its NullRenderContext.
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::RendererHolder load ( const std::string& name , const Gre::RendererOptions& options ) const;
+};
+
+#endif /* NullRenderer_h */
@@ -0,0 +1,113 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  NullFramebufferCreator.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "NullRenderer.h"
+
+NullFramebuffer::NullFramebuffer ( const NullRenderer * renderer , const std::string & name )
+: Gre::RenderFramebuffer ( name ) , iRenderer ( renderer ) , iBinded ( false )
+{
+
+}
+
+NullFramebuffer::~NullFramebuffer() noexcept ( false )
+{
+
+}
+
+void NullFramebuffer::bind() const
+{
+    GreAutolock ; iBinded = true ;
+    Gre::RenderStatistics::CountFramebufferBind () ;
+    iRenderer -> trace ( "bindFramebuffer" , getName() ) ;
+}
+
+void NullFramebuffer::unbind() const
+{
+    GreAutolock ; iBinded = false ;
+    iRenderer -> trace ( "unbindFramebuffer" , getName() ) ;
+}
+
+bool NullFramebuffer::binded () const
+{
+    GreAutolock ; return iBinded ;
+}
+
+bool NullFramebuffer::isComplete () const
+{
+    return true ;
+}
+
+bool NullFramebuffer::copy ( const Gre::RenderFramebuffer & source , const Gre::RenderFramebufferAttachement & attachment ) const
+{
+    iRenderer -> trace ( "copyFramebuffer" , source.getName() , getName() , (int) attachment ) ;
+    return true ;
+}
+
+bool NullFramebuffer::bindAttachment ( const Gre::FramebufferAttachment & attachment ) const
+{
+    iRenderer -> trace ( "bindAttachment" , getName() , (int) attachment.layer , (int) attachment.type ) ;
+    return true ;
+}
+
+void NullFramebuffer::unbindAttachment ( const Gre::FramebufferAttachment & attachment ) const
+{
+    iRenderer -> trace ( "unbindAttachment" , getName() , (int) attachment.layer ) ;
+}
+
+// ---------------------------------------------------------------------------------------------------
+
+NullFramebufferCreator::NullFramebufferCreator ( const NullRenderer* parent )
+: Gre::RenderFramebufferInternalCreator() , iRenderer(parent)
+{
+
+}
+
+NullFramebufferCreator::~NullFramebufferCreator()
+{
+
+}
+
+Gre::RenderFramebuffer* NullFramebufferCreator::load(const std::string &name, const Gre::ResourceLoaderOptions &) const
+{
+    if ( !iRenderer )
+    return nullptr ;
+
+    return new NullFramebuffer ( iRenderer , name ) ;
+}
+
+Gre::RenderFramebuffer* NullFramebufferCreator::loadNull () const
+{
+    if ( !iRenderer )
+    return nullptr ;
+
+    return new NullFramebuffer ( iRenderer , std::string() ) ;
+}
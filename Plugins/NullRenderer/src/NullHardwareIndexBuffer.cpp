@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  NullHardwareIndexBuffer.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "NullRenderer.h"
+
+NullHardwareIndexBuffer::NullHardwareIndexBuffer ( const NullRenderer * renderer , size_t sz , const Gre::IndexDescriptor& desc )
+: Gre::HardwareIndexBuffer("") , iRenderer(renderer) , iSize(sz)
+{
+    setIndexDescriptor(desc) ;
+    setDirty(true) ;
+
+    Gre::RenderStatistics::CountUpload ( sz ) ;
+    iRenderer -> trace ( "createIndexBuffer" , sz ) ;
+}
+
+NullHardwareIndexBuffer::~NullHardwareIndexBuffer() noexcept ( false )
+{
+
+}
+
+void NullHardwareIndexBuffer::bind() const
+{
+    iRenderer -> trace ( "bindIndexBuffer" , iSize ) ;
+}
+
+void NullHardwareIndexBuffer::unbind() const
+{
+    iRenderer -> trace ( "unbindIndexBuffer" ) ;
+}
+
+void NullHardwareIndexBuffer::addData(const char *, size_t sz)
+{
+    GreAutolock ;
+
+    iSize = iSize + sz ;
+    setDirty(true) ;
+
+    Gre::RenderStatistics::CountUpload ( sz ) ;
+    iRenderer -> trace ( "addIndexData" , sz ) ;
+}
+
+const char* NullHardwareIndexBuffer::getData() const
+{
+    return nullptr ;
+}
+
+void NullHardwareIndexBuffer::clearData()
+{
+    GreAutolock ; iSize = 0 ;
+}
+
+size_t NullHardwareIndexBuffer::getSize() const
+{
+    return iSize ;
+}
+
+size_t NullHardwareIndexBuffer::count() const
+{
+    return iSize / Gre::IndexTypeGetSize(getIndexDescriptor().getType()) ;
+}
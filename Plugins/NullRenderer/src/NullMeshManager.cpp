@@ -0,0 +1,119 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  NullMeshManager.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "NullRenderer.h"
+
+// -----------------------------------------------------------------------------
+
+class NullMesh : public Gre::Mesh
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    NullMesh ( const NullRenderer* renderer , const std::string & name )
+    : Gre::Mesh ( name ) , iRenderer ( renderer )
+    {
+
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~NullMesh ()
+    {
+
+    }
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    void iBind ( const Gre::TechniqueHolder & technique ) const
+    {
+        if ( technique.isInvalid() )
+        return ;
+
+        iRenderer -> trace ( "bindMesh" , getName() ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    void iUnbind ( const Gre::TechniqueHolder & technique ) const
+    {
+        if ( technique.isInvalid() )
+        return ;
+
+        iRenderer -> trace ( "unbindMesh" , getName() ) ;
+    }
+
+protected:
+
+    /// @brief Renderer recording the calls.
+    const NullRenderer * iRenderer ;
+};
+
+// -----------------------------------------------------------------------------
+
+NullMeshManager::NullMeshManager ( const NullRenderer* renderer )
+: Gre::MeshManager() , iRenderer(renderer)
+{
+
+}
+
+NullMeshManager::~NullMeshManager() noexcept ( false )
+{
+
+}
+
+Gre::HardwareVertexBufferHolder NullMeshManager::createVertexBuffer(const void *, size_t sz, const Gre::VertexDescriptor &desc) const
+{
+    if ( !iRenderer )
+    return Gre::HardwareVertexBufferHolder ( nullptr ) ;
+
+    return Gre::HardwareVertexBufferHolder ( new NullHardwareVertexBuffer ( iRenderer , sz , desc ) ) ;
+}
+
+Gre::HardwareIndexBufferHolder NullMeshManager::createIndexBuffer(const void *, size_t sz, const Gre::IndexDescriptor &desc) const
+{
+    if ( !iRenderer )
+    return Gre::HardwareIndexBufferHolder ( nullptr ) ;
+
+    return Gre::HardwareIndexBufferHolder ( new NullHardwareIndexBuffer ( iRenderer , sz , desc ) ) ;
+}
+
+Gre::Mesh* NullMeshManager::create ( const std::string & name ) const
+{
+    if ( !iRenderer )
+    return nullptr ;
+
+    return new NullMesh ( iRenderer , name ) ;
+}
@@ -0,0 +1,193 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  NullProgram.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "NullRenderer.h"
+
+#include <GlslReflection.h>
+
+NullProgram::NullProgram ( const NullRenderer * renderer , const std::string & name )
+: Gre::HardwareProgram ( name ) , iRenderer ( renderer )
+{
+
+}
+
+NullProgram::~NullProgram() noexcept ( false )
+{
+    _deleteProgram() ;
+}
+
+void NullProgram::_bind() const
+{
+    GreAutolock ;
+
+    if ( !iBinded )
+    {
+        iRenderer -> trace ( "useProgram" , getName() ) ;
+        iBinded = true ;
+    }
+}
+
+void NullProgram::_unbind() const
+{
+    GreAutolock ;
+
+    if ( iBinded )
+    {
+        iRenderer -> trace ( "useProgram" , "" ) ;
+        iBinded = false ;
+    }
+}
+
+bool NullProgram::_attachShader(const Gre::HardwareShaderHolder & hwdShader)
+{
+    GreAutolock ;
+
+    if ( iLinked || hwdShader.isInvalid() )
+    return false ;
+
+    iRenderer -> trace ( "attachShader" , getName() , hwdShader->getName() ) ;
+    return true ;
+}
+
+bool NullProgram::_finalize()
+{
+    GreAutolock ;
+
+    if ( iLinked )
+    return false ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Uniforms and attributes are read from the global scope of each shaders.
+    // Locations are given in declaration order , as a driver could do.
+
+    Gre::GlslReflection reflection ;
+
+    for ( auto & attached : iAttachedShaders )
+    {
+        if ( attached.second.isInvalid() )
+        continue ;
+
+        const NullShader * shader = reinterpret_cast < const NullShader * > ( attached.second.getObject() ) ;
+        reflection.reflect ( attached.first , shader -> getRealSource () ) ;
+    }
+
+    iUniforms = reflection.uniforms ;
+    iUniformBlocks = reflection.blocks ;
+    iAttribsLocation = reflection.attributes ;
+
+    iRenderer -> trace ( "linkProgram" , getName() , iUniforms.size() , iUniformBlocks.size() , iAttribsLocation.size() ) ;
+
+    iLinked = true ;
+    return iLinked ;
+}
+
+void NullProgram::_deleteProgram()
+{
+    GreAutolock ;
+
+    iLinked = false ;
+    iBinded = false ;
+}
+
+bool NullProgram::binded () const
+{
+    return iBinded ;
+}
+
+void NullProgram::setVertexAttrib(const std::string &attrib, size_t elements, Gre::VertexAttribType type, bool normalize, size_t stride, void *pointer) const
+{
+    auto it = iAttribsLocation.find(attrib) ;
+
+    if ( it != iAttribsLocation.end() )
+    setVertexAttrib ( it->second , elements , type , normalize , stride , pointer ) ;
+}
+
+void NullProgram::setVertexAttrib(int loc, size_t elements, Gre::VertexAttribType type, bool normalize, size_t stride, void *pointer) const
+{
+    if ( loc < 0 )
+    return ;
+
+    iRenderer -> trace ( "setVertexAttrib" , loc , elements , (int) type , normalize , stride , (size_t) pointer ) ;
+}
+
+void NullProgram::disableVertexAttribs () const
+{
+    GreAutolock ;
+
+    if ( !binded() )
+    return ;
+
+    iRenderer -> trace ( "disableVertexAttribs" , getName() ) ;
+}
+
+void NullProgram::bindTextureUnit(int unit) const
+{
+    iRenderer -> trace ( "bindTextureUnit" , unit ) ;
+}
+
+bool NullProgram::_setUniform(int location, const Gre::HdwProgVarType &type, const Gre::RealProgramVariable &value) const
+{
+    if ( location < 0 )
+    return false ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Only the first component is traced , which is enough to tell two
+    // values apart in most cases.
+
+    if ( iRenderer -> isTracing () )
+    {
+        if ( type == Gre::HdwProgVarType::Float1 || type == Gre::HdwProgVarType::Float2 ||
+             type == Gre::HdwProgVarType::Float3 || type == Gre::HdwProgVarType::Float4 ||
+             type == Gre::HdwProgVarType::Matrix2 || type == Gre::HdwProgVarType::Matrix3 ||
+             type == Gre::HdwProgVarType::Matrix4 )
+        iRenderer -> trace ( "setUniform" , location , (int) type , value.f1 ) ;
+        else
+        iRenderer -> trace ( "setUniform" , location , (int) type , value.i1 ) ;
+    }
+
+    return true ;
+}
+
+bool NullProgram::_setUniformBlock ( int index , const Gre::UniformBlockBinding & binding ,
+                                     const Gre::UniformArena & , size_t offset , size_t size ) const
+{
+    if ( index < 0 )
+    return false ;
+
+    iRenderer -> trace ( "setUniformBlock" , index , (int) binding , offset , size ) ;
+    return true ;
+}
+
+unsigned int NullProgram::getMaximumLights() const
+{
+    return 10 ;
+}
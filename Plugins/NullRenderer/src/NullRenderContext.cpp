@@ -0,0 +1,74 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  NullRenderContext.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "NullRenderer.h"
+
+NullRenderContext::NullRenderContext ( const std::string & name , const Gre::Surface & surface )
+: Gre::RenderContext ( name ) , iSurface ( surface ) , iFrames ( 0 )
+{
+
+}
+
+NullRenderContext::~NullRenderContext () noexcept ( false )
+{
+
+}
+
+void NullRenderContext::bind () const
+{
+    iIsBinded = true ;
+}
+
+void NullRenderContext::unbind () const
+{
+    iIsBinded = false ;
+}
+
+void NullRenderContext::flush () const
+{
+    GreAutolock ; iFrames++ ;
+}
+
+Gre::Surface NullRenderContext::getSurface () const
+{
+    GreAutolock ; return iSurface ;
+}
+
+void NullRenderContext::setSurface ( const Gre::Surface & surface )
+{
+    GreAutolock ; iSurface = surface ;
+}
+
+size_t NullRenderContext::getFramesCount () const
+{
+    GreAutolock ; return iFrames ;
+}
@@ -0,0 +1,171 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  NullRenderer.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "NullRenderer.h"
+
+NullRenderer::NullRenderer ( const std::string& name , const Gre::RendererOptions& options )
+: Gre::Renderer(name, options) , iTracing(false)
+{
+
+}
+
+NullRenderer::~NullRenderer() noexcept ( false )
+{
+
+}
+
+void NullRenderer::setClearRegion(const Gre::Surface &box) const
+{
+    trace ( "setClearRegion" , box.left , box.top , box.width , box.height ) ;
+}
+
+void NullRenderer::setViewport(const Gre::Viewport &viewport) const
+{
+    if ( iContext.isInvalid() )
+    return ;
+
+    Gre::Surface viewsurf = viewport.getSurface () ;
+    trace ( "setViewport" , viewsurf.left , viewsurf.top , viewsurf.width , viewsurf.height ) ;
+
+    if ( viewport.regioned() )
+    setClearRegion ( viewport.region() ) ;
+
+    setClearColor ( viewport.clearcolor() ) ;
+    setClearDepth ( viewport.cleardepth() ) ;
+    clearBuffers ( viewport.clearbuffers() ) ;
+}
+
+void NullRenderer::setClearColor(const Gre::Color &color) const
+{
+    trace ( "setClearColor" , color.getRed() , color.getGreen() , color.getBlue() , color.getAlpha() ) ;
+}
+
+void NullRenderer::setClearDepth(float value) const
+{
+    trace ( "setClearDepth" , value ) ;
+}
+
+void NullRenderer::clearBuffers ( const Gre::ClearBuffers & buffers ) const
+{
+    trace ( "clearBuffers" , buffers.to_string() ) ;
+}
+
+void NullRenderer::drawSubMesh(const Gre::SubMeshHolder & submesh) const
+{
+    if ( submesh.isInvalid() )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Binds the index buffer as the OpenGlRenderer does , so the calls made
+    // by the backends are the same.
+
+    const Gre::HardwareIndexBufferHolder& index = submesh->getIndexBuffer();
+
+    if ( index.isInvalid() )
+    return ;
+
+    index->bind() ;
+    Gre::RenderStatistics::CountDraw ( *index.getObject() ) ;
+
+    trace ( "drawSubMesh" , (int) index->getIndexDescriptor().getMode() , index->count() ,
+            (int) index->getIndexDescriptor().getType() ) ;
+}
+
+void NullRenderer::setRasterState ( const Gre::RasterState & state ) const
+{
+    trace ( "setRasterState" , state.depthtest , state.depthwrite , (int) state.culling , state.blending ) ;
+}
+
+void NullRenderer::draw ( const Gre::TechniqueHolder & technique ) const
+{
+    Gre::RenderStatistics::CountDraw ( 4 , 2 ) ;
+    trace ( "draw" , technique.isInvalid() ? std::string() : technique->getName() ) ;
+}
+
+void NullRenderer::setTracing ( bool value )
+{
+    iTracing = value ;
+}
+
+bool NullRenderer::isTracing () const
+{
+    return iTracing ;
+}
+
+std::vector < NullRendererCall > NullRenderer::getTrace () const
+{
+    std::lock_guard < std::mutex > lock ( iTraceMutex ) ;
+    return iTrace ;
+}
+
+size_t NullRenderer::getCallsCount ( const std::string & function ) const
+{
+    std::lock_guard < std::mutex > lock ( iTraceMutex ) ;
+    size_t result = 0 ;
+
+    for ( const NullRendererCall & call : iTrace )
+    if ( call.function == function ) result++ ;
+
+    return result ;
+}
+
+void NullRenderer::clearTrace ()
+{
+    std::lock_guard < std::mutex > lock ( iTraceMutex ) ;
+    iTrace.clear () ;
+}
+
+void NullRenderer::iRecord ( const char * function , const std::string & arguments ) const
+{
+    std::lock_guard < std::mutex > lock ( iTraceMutex ) ;
+    iTrace.push_back ( NullRendererCall { function , arguments } ) ;
+}
+
+Gre::MeshManagerHolder NullRenderer::iCreateMeshManager() const
+{
+    return Gre::MeshManagerHolder ( new NullMeshManager(this) ) ;
+}
+
+Gre::HardwareProgramManagerInternalCreator* NullRenderer::iCreateProgramManagerCreator() const
+{
+    return new NullProgramManagerCreator(this) ;
+}
+
+Gre::TextureInternalCreator* NullRenderer::iCreateTextureCreator() const
+{
+    return new NullTextureCreator(this) ;
+}
+
+Gre::RenderFramebufferInternalCreator* NullRenderer::iCreateFramebufferCreator() const
+{
+    return new NullFramebufferCreator(this) ;
+}
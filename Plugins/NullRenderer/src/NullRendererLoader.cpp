@@ -0,0 +1,107 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  NullRendererLoader.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "NullRenderer.h"
+
+NullRendererLoader::NullRendererLoader ()
+{
+
+}
+
+NullRendererLoader::~NullRendererLoader() noexcept ( false )
+{
+
+}
+
+Gre::ResourceLoader* NullRendererLoader::clone () const
+{
+    return new NullRendererLoader () ;
+}
+
+bool NullRendererLoader::isLoadable ( const std::string& ) const
+{
+    return false ;
+}
+
+bool NullRendererLoader::isCompatible ( const Gre::RendererOptions& options ) const
+{
+    //////////////////////////////////////////////////////////////////////
+    // The null renderer is never chosen by default : it must be asked for.
+
+    auto it = options.find ( "Renderer.Backend" ) ;
+
+    if ( it == options.end() || !it->second.is(typeid(std::string)) )
+    return false ;
+
+    return it->second.to<std::string>() == "Null" ;
+}
+
+Gre::RendererHolder NullRendererLoader::load ( const std::string& name , const Gre::RendererOptions& options ) const
+{
+    NullRenderer* renderer = new NullRenderer ( name , options ) ;
+    if ( !renderer ) {
+        GreDebug("[WARN] Can't create NullRenderer '") << name << "'." << Gre::gendl ;
+        return Gre::RendererHolder ( nullptr ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Reads the tracing option and the size of the context. Windowless
+    // contexts are sized as '1024x768'.
+
+    auto trace = options.find ( "Renderer.Trace" ) ;
+
+    if ( trace != options.end() && trace->second.is(typeid(bool)) )
+    renderer -> setTracing ( trace->second.to<bool>() ) ;
+
+    Gre::Surface surface = { 0 , 0 , 1024 , 768 } ;
+    auto size = options.find ( "Renderer.Size" ) ;
+
+    if ( size != options.end() && size->second.is(typeid(std::string)) )
+    {
+        int width = 0 , height = 0 ;
+        const std::string value = size->second.to<std::string>() ;
+
+        if ( sscanf ( value.c_str() , "%dx%d" , &width , &height ) == 2 && width > 0 && height > 0 )
+        {
+            surface.width = width ;
+            surface.height = height ;
+        }
+
+        else
+        GreDebug("[WARN] Invalid 'Renderer.Size' value '") << value << "'." << Gre::gendl ;
+    }
+
+    renderer -> setRenderContext ( Gre::RenderContextHolder ( new NullRenderContext ( name + ".context" , surface ) ) ) ;
+
+    GreDebug("[INFO] Created and installed NullRenderer '") << name << "'." << Gre::gendl ;
+    return Gre::RendererHolder ( renderer ) ;
+}
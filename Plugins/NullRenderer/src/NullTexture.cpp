@@ -0,0 +1,96 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  NullTexture.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "NullRenderer.h"
+
+NullTexture::NullTexture (const NullRenderer * renderer ,
+                          const std::string & name , const Gre::TextureType & type ,
+                          const Gre::SoftwarePixelBufferHolderList& buffers)
+: Gre::Texture(name, type, buffers) , iRenderer(renderer)
+{
+    if ( !iPixelBuffers.empty() ) {
+        _setBuffer () ;
+    }
+}
+
+NullTexture::~NullTexture () noexcept ( false )
+{
+
+}
+
+void NullTexture::_bind () const
+{
+    iRenderer -> trace ( "bindTexture" , getName() , (int) getType() ) ;
+}
+
+void NullTexture::_unbind () const
+{
+    iRenderer -> trace ( "unbindTexture" , getName() ) ;
+}
+
+void NullTexture::_setBuffer () const
+{
+    GreAutolock ;
+
+    for ( const Gre::SoftwarePixelBufferHolder & buffer : iPixelBuffers )
+    {
+        if ( buffer.isInvalid() )
+        continue ;
+
+        const Gre::Surface & surface = buffer -> getSurface () ;
+        iRenderer -> trace ( "uploadTexture" , getName() , surface.width , surface.height , buffer -> getDepth () ) ;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+NullTextureCreator::NullTextureCreator ( const NullRenderer* renderer )
+: iRenderer(renderer)
+{
+
+}
+
+NullTextureCreator::~NullTextureCreator()
+{
+
+}
+
+Gre::Texture* NullTextureCreator::load(const std::string & name ,
+                                       const Gre::SoftwarePixelBufferHolderList & buffers ,
+                                       const Gre::TextureType & type ,
+                                       const Gre::ResourceLoaderOptions & ) const
+{
+    if ( !iRenderer )
+    return nullptr ;
+
+    return new NullTexture ( iRenderer , name , type , buffers ) ;
+}
@@ -0,0 +1,73 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  PluginMain.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include <ResourceManager.h>
+#include "NullRenderer.h"
+
+Gre::PluginInfo info ;
+
+extern "C" Gre::PluginInfo * GetPluginInfo ( void )
+{
+    info.name = "NullRenderer Plugin" ;
+    info.author = "Luk2010" ;
+    info.version = GRE_PLUGIN_VERSION ;
+
+    uuid_parse("634dfe97-239c-49cd-9529-1bac5d7d5aec", info.uuid);
+
+    return & info ;
+}
+
+extern "C" void StartPlugin ( void )
+{
+    //////////////////////////////////////////////////////////////////////
+    // The loader only accepts options with 'Renderer.Backend' set to "Null" ,
+    // so the plugin can stay loaded next to the OpenGlRenderer.
+
+    NullRendererLoader* loader = new NullRendererLoader () ;
+    if ( !loader ) {
+        GreDebug("[WARN]") << "Can't create 'NullRendererLoader' instance." << Gre::gendl ;
+        return ;
+    }
+
+    auto & factory = Gre::ResourceManager::Get () ->getRendererManager()->getFactory() ;
+    factory.registers("NullRendererLoader", loader);
+
+    GreDebug("[INFO] NullRenderer Plugin started.") << Gre::gendl ;
+}
+
+extern "C" void StopPlugin ( void )
+{
+    auto & factory = Gre::ResourceManager::Get() ->getRendererManager()->getFactory() ;
+    factory.unregister("NullRendererLoader");
+
+    GreDebug("[INFO] NullRenderer Plugin stopped.") << Gre::gendl ;
+}
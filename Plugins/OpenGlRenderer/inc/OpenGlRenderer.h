@@ -106,6 +106,12 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual bool isComplete () const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Copies the attachment from the source framebuffer with
+    /// 'glBlitFramebuffer()'. The source must be an OpenGl framebuffer.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool copy ( const Gre::RenderFramebuffer & source , const Gre::RenderFramebufferAttachement & attachment ) const ;
+
 protected:
 
     //////////////////////////////////////////////////////////////////////
@@ -361,6 +367,16 @@ public:
                                   size_t stride ,
                                   void * pointer) const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Binds the attribute at given location , enabling it.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setVertexAttrib (int location ,
+                                  size_t elements ,
+                                  Gre::VertexAttribType type ,
+                                  bool normalize ,
+                                  size_t stride ,
+                                  void * pointer) const ;
+
     //////////////////////////////////////////////////////////////////////
     /// @brief Should bind the texture unit with given number .
     //////////////////////////////////////////////////////////////////////
@@ -371,6 +387,13 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual bool _setUniform ( int location , const Gre::HdwProgVarType & type , const Gre::RealProgramVariable & value ) const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Uploads the bytes staged in the arena since the last call ,
+    /// and binds the given range to the binding point.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool _setUniformBlock ( int index , const Gre::UniformBlockBinding & binding ,
+                                    const Gre::UniformArena & arena , size_t offset , size_t size ) const ;
+
     //////////////////////////////////////////////////////////////////////
     /// @brief Returns the maximum number of lights supported by the
     /// program driver.
@@ -669,6 +692,11 @@ public:
     //////////////////////////////////////////////////////////////////////
     virtual void drawSubMesh ( const Gre::SubMeshHolder & submesh ) const ;
 
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Applies depth , culling and blending states.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setRasterState ( const Gre::RasterState & state ) const ;
+
 public:
 
     //////////////////////////////////////////////////////////////////////
@@ -103,6 +103,8 @@ void OpenGlFramebuffer::bind() const
     GreAutolock ;
 
     glBindFramebuffer ( GL_FRAMEBUFFER , iGlFramebuffer ) ;
+    Gre::RenderStatistics::CountFramebufferBind () ;
+
     GLenum status = glCheckFramebufferStatus ( GL_FRAMEBUFFER ) ;
 
     if ( status != GL_FRAMEBUFFER_COMPLETE )
@@ -181,6 +183,53 @@ bool OpenGlFramebuffer::isComplete () const
     return glCheckFramebufferStatus ( GL_FRAMEBUFFER ) ;
 }
 
+bool OpenGlFramebuffer::copy ( const Gre::RenderFramebuffer & source , const Gre::RenderFramebufferAttachement & attachment ) const
+{
+    GreAutolock ;
+
+    const OpenGlFramebuffer * glsource = dynamic_cast < const OpenGlFramebuffer * > ( &source ) ;
+
+    if ( !glsource || !glsource -> iGlFramebuffer || !iGlFramebuffer )
+    return false ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The copied size is the size of the attachment's texture , or the
+    // source viewport for renderbuffers.
+
+    const Gre::FramebufferAttachment & srcattachment = source.getAttachment ( attachment ) ;
+    Gre::Surface surface = source.getViewport () .getSurface () ;
+
+    if ( !srcattachment.texture.isInvalid() )
+    surface = srcattachment.texture -> getSurface () ;
+
+    GLbitfield mask = GL_COLOR_BUFFER_BIT ;
+
+    if ( attachment == Gre::RenderFramebufferAttachement::Depth ) mask = GL_DEPTH_BUFFER_BIT ;
+    else if ( attachment == Gre::RenderFramebufferAttachement::Stencil ) mask = GL_STENCIL_BUFFER_BIT ;
+    else if ( attachment == Gre::RenderFramebufferAttachement::DepthStencil ) mask = GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT ;
+
+    GLint previous = 0 ;
+    glGetIntegerv ( GL_FRAMEBUFFER_BINDING , &previous ) ;
+
+    glBindFramebuffer ( GL_READ_FRAMEBUFFER , glsource -> iGlFramebuffer ) ;
+    glBindFramebuffer ( GL_DRAW_FRAMEBUFFER , iGlFramebuffer ) ;
+
+    if ( mask == GL_COLOR_BUFFER_BIT )
+    {
+        glReadBuffer ( translateGlAttachement ( attachment ) ) ;
+        glDrawBuffer ( translateGlAttachement ( attachment ) ) ;
+    }
+
+    glBlitFramebuffer ( 0 , 0 , surface.width , surface.height ,
+                        0 , 0 , surface.width , surface.height ,
+                        mask , GL_NEAREST ) ;
+
+    GLenum error = glGetError () ;
+    glBindFramebuffer ( GL_FRAMEBUFFER , (GLuint) previous ) ;
+
+    return error == GL_NO_ERROR ;
+}
+
 bool OpenGlFramebuffer::bindAttachment ( const Gre::FramebufferAttachment & attachment ) const
 {
     if ( !iGlFramebuffer )
@@ -44,6 +44,7 @@ OpenGlHardwareIndexBuffer::OpenGlHardwareIndexBuffer ( const void* data , size_t
     {
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, iGlBuffer);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, sz, data, GL_STATIC_DRAW);
+        Gre::RenderStatistics::CountUpload ( sz ) ;
         iSize = sz ; setIndexDescriptor(desc);
     }
     
@@ -89,6 +90,7 @@ void OpenGlHardwareIndexBuffer::addData(const char *vdata, size_t sz)
             
             glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, size);
             glBufferSubData(GL_COPY_WRITE_BUFFER, size, sz, vdata);
+            Gre::RenderStatistics::CountUpload ( sz ) ;
             
             glBindBuffer(GL_COPY_READ_BUFFER, 0);
             glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
@@ -105,6 +107,7 @@ void OpenGlHardwareIndexBuffer::addData(const char *vdata, size_t sz)
         {
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, iGlBuffer);
             glBufferData(GL_ELEMENT_ARRAY_BUFFER, sz, vdata, GL_STATIC_DRAW);
+            Gre::RenderStatistics::CountUpload ( sz ) ;
         }
     }
     
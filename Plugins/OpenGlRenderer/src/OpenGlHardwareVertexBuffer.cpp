@@ -44,6 +44,7 @@ OpenGlHardwareVertexBuffer::OpenGlHardwareVertexBuffer ( const void* data , size
     {
         glBindBuffer(GL_ARRAY_BUFFER, iGlBuffer);
         glBufferData(GL_ARRAY_BUFFER, sz, data, GL_STATIC_DRAW);
+        Gre::RenderStatistics::CountUpload ( sz ) ;
         iSize = sz ; setVertexDescriptor(desc);
     }
     
@@ -89,6 +90,7 @@ void OpenGlHardwareVertexBuffer::addData(const char *vdata, size_t sz)
             
             glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, size);
             glBufferSubData(GL_COPY_WRITE_BUFFER, size, sz, vdata);
+            Gre::RenderStatistics::CountUpload ( sz ) ;
             
             glBindBuffer(GL_COPY_READ_BUFFER, 0);
             glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
@@ -105,6 +107,7 @@ void OpenGlHardwareVertexBuffer::addData(const char *vdata, size_t sz)
         {
             glBindBuffer(GL_ARRAY_BUFFER, iGlBuffer);
             glBufferData(GL_ARRAY_BUFFER, sz, vdata, GL_STATIC_DRAW);
+            Gre::RenderStatistics::CountUpload ( sz ) ;
         }
     }
     
@@ -32,6 +32,15 @@
 
 #include "OpenGlRenderer.h"
 
+//////////////////////////////////////////////////////////////////////
+// Uniform buffer holding the arena for every programs , with the arena's
+// generation and the number of bytes already uploaded in it.
+
+static GLuint UniformArenaBuffer = 0 ;
+static size_t UniformArenaGeneration = 0 ;
+static size_t UniformArenaCapacity = 0 ;
+static size_t UniformArenaUploaded = 0 ;
+
 GLenum translateGlAttribType ( const Gre::VertexAttribType & type )
 {
     if ( type == Gre::VertexAttribType::Byte )
@@ -256,6 +265,42 @@ bool OpenGlProgram::_finalize()
         }
     }
 
+    //////////////////////////////////////////////////////////////////////
+    // Tries to iterate through uniform blocks. Blocks filled by the engine
+    // are bound to their binding point here , once.
+
+    GLint blockcount = 0 ;
+    glGetProgramiv(iGlProgram, GL_ACTIVE_UNIFORM_BLOCKS, &blockcount) ;
+
+    for ( int i = 0 ; i < blockcount ; ++i )
+    {
+        GLchar buf [256] ; GLsizei lenght = 0 ;
+        glGetActiveUniformBlockName(iGlProgram, i, sizeof(buf), &lenght, buf) ;
+
+        std::string name ( buf , lenght ) ;
+        iUniformBlocks [name] = i ;
+
+        for ( size_t binding = 0 ; binding < Gre::UniformBlockBindingCount ; ++binding )
+        {
+            if ( name == Gre::UniformBlockName ( (Gre::UniformBlockBinding) binding ) )
+            glUniformBlockBinding(iGlProgram, i, (GLuint) binding) ;
+        }
+    }
+
+    if ( blockcount )
+    {
+        //////////////////////////////////////////////////////////////////////
+        // Ranges bound must start at a multiple of the driver's alignment.
+
+        GLint alignment = 0 ;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment) ;
+
+        Gre::UniformArena & arena = Gre::UniformArena::Get () ;
+
+        if ( alignment > 0 && arena.getAlignment() % alignment )
+        arena.setAlignment ( alignment ) ;
+    }
+
     //////////////////////////////////////////////////////////////////////
     // Tries to iterate through Attributes.
 
@@ -318,32 +363,33 @@ void OpenGlProgram::setVertexAttrib(const std::string &attrib, size_t elements,
     auto it = iAttribsLocation.find(attrib) ;
 
     if ( it != iAttribsLocation.end() )
-    {
-        int loc = it->second ;
+    setVertexAttrib ( it->second , elements , type , normalize , stride , pointer ) ;
+}
 
-        if ( loc >= 0 )
-        {
-            //////////////////////////////////////////////////////////////////////
-            // Enables Vertex Attribute and points the correct elements. Notes that
-            // a Vertex Array Object should be binded when using this function.
+void OpenGlProgram::setVertexAttrib(int loc, size_t elements, Gre::VertexAttribType type, bool normalize, size_t stride, void *pointer) const
+{
+    if ( loc < 0 )
+    return ;
 
-            glEnableVertexAttribArray(loc) ;
+    //////////////////////////////////////////////////////////////////////
+    // Enables Vertex Attribute and points the correct elements. Notes that
+    // a Vertex Array Object should be binded when using this function.
 
-            if ( type == Gre::VertexAttribType::Int )
-            {
-                glVertexAttribIPointer(loc, elements,
-                                       translateGlAttribType(type),
-                                       stride, pointer);
-            }
+    glEnableVertexAttribArray(loc) ;
 
-            else
-            {
-                glVertexAttribPointer(loc, elements,
-                                      translateGlAttribType(type),
-                                      normalize,
-                                      stride, pointer);
-            }
-        }
+    if ( type == Gre::VertexAttribType::Int )
+    {
+        glVertexAttribIPointer(loc, elements,
+                               translateGlAttribType(type),
+                               stride, pointer);
+    }
+
+    else
+    {
+        glVertexAttribPointer(loc, elements,
+                              translateGlAttribType(type),
+                              normalize,
+                              stride, pointer);
     }
 }
 
@@ -455,6 +501,49 @@ bool OpenGlProgram::_setUniform(int location, const Gre::HdwProgVarType &type, c
     return false ;
 }
 
+bool OpenGlProgram::_setUniformBlock ( int index , const Gre::UniformBlockBinding & binding ,
+                                       const Gre::UniformArena & arena , size_t offset , size_t size ) const
+{
+    GreAutolock ;
+
+    if ( !iGlProgram || index < 0 )
+    return false ;
+
+    if ( !UniformArenaBuffer )
+    glGenBuffers(1, &UniformArenaBuffer) ;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, UniformArenaBuffer) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // When the arena starts again at zero , the buffer is orphaned : the
+    // driver does not wait for the draws still reading the old one.
+
+    if ( UniformArenaGeneration != arena.getGeneration() || UniformArenaCapacity != arena.getCapacity() )
+    {
+        glBufferData(GL_UNIFORM_BUFFER, arena.getCapacity(), NULL, GL_STREAM_DRAW) ;
+
+        UniformArenaGeneration = arena.getGeneration () ;
+        UniformArenaCapacity = arena.getCapacity () ;
+        UniformArenaUploaded = 0 ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Every blocks staged since the last call are sent with one update.
+
+    if ( arena.getSize() > UniformArenaUploaded )
+    {
+        glBufferSubData(GL_UNIFORM_BUFFER, UniformArenaUploaded, arena.getSize() - UniformArenaUploaded,
+                        arena.getData() + UniformArenaUploaded) ;
+
+        Gre::RenderStatistics::CountUpload ( arena.getSize() - UniformArenaUploaded ) ;
+
+        UniformArenaUploaded = arena.getSize () ;
+    }
+
+    glBindBufferRange(GL_UNIFORM_BUFFER, (GLuint) binding, UniformArenaBuffer, offset, size) ;
+    return true ;
+}
+
 unsigned int OpenGlProgram::getMaximumLights() const
 {
     return 10 ;
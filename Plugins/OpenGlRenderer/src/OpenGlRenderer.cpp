@@ -145,8 +145,7 @@ void OpenGlRenderer::setViewport(const Gre::Viewport &viewport) const
     glClearColor ( viewport.clearcolor().getRed() , viewport.clearcolor().getGreen() ,
                    viewport.clearcolor().getBlue() , viewport.clearcolor().getAlpha() ) ;
 
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
+    // Depth test is part of the raster states bound with the pipeline state.
 
     glClearDepth ( viewport.cleardepth() ) ;
 
@@ -178,7 +177,21 @@ void OpenGlRenderer::clearBuffers ( const Gre::ClearBuffers & buffers ) const
     if ( buffers.test((int)Gre::ClearBuffer::Stencil) )
         buffs = buffs | GL_STENCIL_BUFFER_BIT ;
 
-    if ( buffs ) glClear(buffs) ;
+    //////////////////////////////////////////////////////////////////////
+    // The depth buffer is cleared even if the bound raster state doesn't
+    // write depth.
+
+    if ( buffers.test((int)Gre::ClearBuffer::Depth) )
+    {
+        GLboolean depthmask = GL_TRUE ;
+        glGetBooleanv(GL_DEPTH_WRITEMASK, &depthmask) ;
+        glDepthMask(GL_TRUE) ;
+
+        glClear(buffs) ;
+        glDepthMask(depthmask) ;
+    }
+
+    else if ( buffs ) glClear(buffs) ;
 
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 }
@@ -200,6 +213,40 @@ void OpenGlRenderer::drawSubMesh(const Gre::SubMeshHolder & submesh) const
                    index->count(),
                    translateGlType(index->getIndexDescriptor().getType()),
                    index->getData());
+
+    Gre::RenderStatistics::CountDraw ( *index.getObject() ) ;
+}
+
+void OpenGlRenderer::setRasterState ( const Gre::RasterState & state ) const
+{
+    if ( state.depthtest )
+    {
+        glEnable ( GL_DEPTH_TEST ) ;
+        glDepthFunc ( GL_LESS ) ;
+    }
+
+    else
+    glDisable ( GL_DEPTH_TEST ) ;
+
+    glDepthMask ( state.depthwrite ? GL_TRUE : GL_FALSE ) ;
+
+    if ( state.culling == Gre::CullMode::None )
+    glDisable ( GL_CULL_FACE ) ;
+
+    else
+    {
+        glEnable ( GL_CULL_FACE ) ;
+        glCullFace ( state.culling == Gre::CullMode::Back ? GL_BACK : GL_FRONT ) ;
+    }
+
+    if ( state.blending )
+    {
+        glEnable ( GL_BLEND ) ;
+        glBlendFunc ( GL_SRC_ALPHA , GL_ONE_MINUS_SRC_ALPHA ) ;
+    }
+
+    else
+    glDisable ( GL_BLEND ) ;
 }
 
 void OpenGlRenderer::draw ( const Gre::TechniqueHolder & technique ) const
@@ -220,6 +267,7 @@ void OpenGlRenderer::draw ( const Gre::TechniqueHolder & technique ) const
 
     glBindVertexArray ( iDefaultQuadVAO ) ;
     glDrawArrays ( GL_TRIANGLE_STRIP , 0 , 4 ) ;
+    Gre::RenderStatistics::CountDraw ( 4 , 2 ) ;
 
     glBindVertexArray ( 0 ) ;
 }
@@ -54,7 +54,16 @@ bool OpenGlRendererLoader::isLoadable ( const std::string& filepath ) const
 
 bool OpenGlRendererLoader::isCompatible ( const Gre::RendererOptions& options ) const
 {
+    //////////////////////////////////////////////////////////////////////
+    // The OpenGlRenderer is the default backend : it only refuses options
+    // asking for another one.
+
+    auto it = options.find ( "Renderer.Backend" ) ;
+
+    if ( it == options.end() || !it->second.is(typeid(std::string)) )
     return true ;
+
+    return it->second.to<std::string>() == "OpenGl" ;
 }
 
 Gre::RendererHolder OpenGlRendererLoader::load ( const std::string& name , const Gre::RendererOptions& options ) const
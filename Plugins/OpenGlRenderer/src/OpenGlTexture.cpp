@@ -257,6 +257,17 @@ GLenum translateGlPixelType ( PixelType format )
     return GL_INVALID_ENUM ;
 }
 
+/// @brief Returns the number of bytes glTexImage reads from the given buffer.
+size_t getGlUploadSize ( const Gre::SoftwarePixelBufferHolder & buffer )
+{
+    if ( buffer.isInvalid() || !buffer->getData() )
+        return 0 ;
+    
+    return (size_t) buffer->getSurface().width * (size_t) std::max ( buffer->getSurface().height , 1 )
+         * (size_t) std::max ( buffer->getDepth() , 1 )
+         * PixelFormatGetCount ( buffer->getPixelFormat() ) * PixelTypeGetSize ( buffer->getPixelType() ) ;
+}
+
 // ---------------------------------------------------------------------------------------------------------
 // OpenGlTexture
 
@@ -400,6 +411,7 @@ void OpenGlTexture::_setBuffer () const
                      translateGlPixelType(buffer->getPixelType()),
                      buffer->getData());
         
+        Gre::RenderStatistics::CountUpload ( getGlUploadSize(buffer) ) ;
         glGenerateMipmap(GL_TEXTURE_1D);
         glBindTexture(GL_TEXTURE_1D, 0);
     }
@@ -426,6 +438,7 @@ void OpenGlTexture::_setBuffer () const
                      translateGlPixelType(buffer->getPixelType()),
                      buffer->getData());
         
+        Gre::RenderStatistics::CountUpload ( getGlUploadSize(buffer) ) ;
         glGenerateMipmap(GL_TEXTURE_2D);
         glBindTexture(GL_TEXTURE_2D, 0);
     }
@@ -452,6 +465,7 @@ void OpenGlTexture::_setBuffer () const
                      translateGlPixelType(buffer->getPixelType()),
                      buffer->getData());
         
+        Gre::RenderStatistics::CountUpload ( getGlUploadSize(buffer) ) ;
         glGenerateMipmap(GL_TEXTURE_3D);
         glBindTexture(GL_TEXTURE_3D, 0);
     }
@@ -480,6 +494,8 @@ void OpenGlTexture::_setBuffer () const
                          translateGlPixelFormat(buffer->getPixelFormat()),
                          translateGlPixelType(buffer->getPixelType()),
                          buffer->getData());
+            
+            Gre::RenderStatistics::CountUpload ( getGlUploadSize(buffer) ) ;
             layer ++ ;
         }
         
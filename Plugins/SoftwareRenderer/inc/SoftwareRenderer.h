@@ -0,0 +1,1118 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SoftwareRenderer.h
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#ifndef SoftwareRenderer_h
+#define SoftwareRenderer_h
+
+#include <Renderer.h>
+
+class SoftwareRenderer ;
+class SoftwareProgram ;
+class SoftwareTexture ;
+class SoftwareFramebuffer ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Buffers a SoftwareRasterizer draws in. Rows start from the bottom
+/// of the image , as in OpenGl.
+//////////////////////////////////////////////////////////////////////
+struct SoftwareTarget
+{
+    /// @brief Color pixels , or null if the target has no color.
+    unsigned char * color ;
+
+    /// @brief Number of bytes per color pixel ( 1 , 3 or 4 ).
+    int channels ;
+
+    /// @brief Depth values , or null if the target has no depth.
+    float * depth ;
+
+    /// @brief Width of the buffers , in pixels.
+    int width ;
+
+    /// @brief Height of the buffers , in pixels.
+    int height ;
+
+    SoftwareTarget () : color ( nullptr ) , channels ( 0 ) , depth ( nullptr ) , width ( 0 ) , height ( 0 ) { }
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Attributes of a vertex , given to 'SoftwareShader::vertex()'.
+/// Missing attributes are ( 0 , 0 , 0 , 1 ) , except the color which is
+/// white.
+//////////////////////////////////////////////////////////////////////
+struct SoftwareVertex
+{
+    /// @brief Attributes by Gre::VertexAttribAlias.
+    Gre::Vector4 attributes [Gre::VertexAttribAliasCount] ;
+};
+
+/// @brief Maximum number of floats interpolated between a vertex and its
+/// fragments.
+static const size_t SoftwareVaryingsMax = 16 ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Output of 'SoftwareShader::vertex()' , and input of its
+/// 'SoftwareShader::fragment()' once interpolated.
+//////////////////////////////////////////////////////////////////////
+struct SoftwareVarying
+{
+    /// @brief Position in clip space.
+    Gre::Vector4 position ;
+
+    /// @brief Values interpolated with perspective correction.
+    float values [SoftwareVaryingsMax] ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Gives the values of the bound Technique to a SoftwareShader.
+///
+/// Values are read from the program's uniforms , using the technique's
+/// aliases , so a shader does not depend on the names used by the GLSL
+/// programs.
+//////////////////////////////////////////////////////////////////////
+class SoftwareShaderContext
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareShaderContext (const SoftwareRenderer * renderer ,
+                           const Gre::Technique * technique ,
+                           const SoftwareProgram * program) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the technique , which may be null.
+    //////////////////////////////////////////////////////////////////////
+    const Gre::Technique * getTechnique () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Reads the uniform named 'name' in the program.
+    //////////////////////////////////////////////////////////////////////
+    bool getValue ( const std::string & name , Gre::HdwProgVarType & type , Gre::RealProgramVariable & value ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Reads the uniform aliased by 'param' in the technique.
+    //////////////////////////////////////////////////////////////////////
+    bool getValue ( const Gre::TechniqueParam & param , Gre::HdwProgVarType & type , Gre::RealProgramVariable & value ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Reads a light's member , named 'LightAlias.MemberAlias' as
+    /// explained in Gre::Technique.
+    //////////////////////////////////////////////////////////////////////
+    bool getLightValue (const Gre::TechniqueParam & light , const Gre::TechniqueParam & member ,
+                        Gre::HdwProgVarType & type , Gre::RealProgramVariable & value) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the matrix aliased by 'param' , or 'fallback'.
+    //////////////////////////////////////////////////////////////////////
+    Gre::Matrix4 getMatrix ( const Gre::TechniqueParam & param , const Gre::Matrix4 & fallback ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the vector aliased by 'param' , or 'fallback'. Missing
+    /// components are taken from 'fallback'.
+    //////////////////////////////////////////////////////////////////////
+    Gre::Vector4 getVector ( const Gre::TechniqueParam & param , const Gre::Vector4 & fallback ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the texture bound to the sampler aliased by 'param' ,
+    /// or null.
+    //////////////////////////////////////////////////////////////////////
+    const SoftwareTexture * getTexture ( const Gre::TechniqueParam & param ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Converts a value to a vector , keeping 'fallback' components
+    /// the value doesn't have.
+    //////////////////////////////////////////////////////////////////////
+    static Gre::Vector4 ToVector ( const Gre::HdwProgVarType & type , const Gre::RealProgramVariable & value , const Gre::Vector4 & fallback ) ;
+
+protected:
+
+    /// @brief Renderer holding the texture units.
+    const SoftwareRenderer * iRenderer ;
+
+    /// @brief Technique drawn.
+    const Gre::Technique * iTechnique ;
+
+    /// @brief Program holding the values.
+    const SoftwareProgram * iProgram ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Programmable shading of the SoftwareRenderer.
+///
+/// 'prepare()' is called once per draw to read the technique's values.
+/// 'vertex()' and 'fragment()' are then called from every threads of the
+/// Gre::JobPool , and must not change the shader.
+//////////////////////////////////////////////////////////////////////
+class SoftwareShader
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SoftwareShader () { }
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Reads the values used by the next draw.
+    //////////////////////////////////////////////////////////////////////
+    virtual void prepare ( const SoftwareShaderContext & context ) = 0 ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the number of floats written in 'SoftwareVarying::values'.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getVaryingsCount () const = 0 ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Computes the clip space position and the varyings of a vertex.
+    //////////////////////////////////////////////////////////////////////
+    virtual void vertex ( const SoftwareVertex & input , SoftwareVarying & output ) const = 0 ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Computes the color of a fragment. Returns false to discard it.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool fragment ( const SoftwareVarying & input , Gre::Vector4 & color ) const = 0 ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Shader used when no shader is set for a technique.
+///
+/// Vertices are transformed by the technique's matrices ( identity when
+/// missing ). Fragments use the material's diffuse color and texture , lit
+/// by the first light with a Lambert term when the technique has one.
+//////////////////////////////////////////////////////////////////////
+class SoftwareDefaultShader : public SoftwareShader
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareDefaultShader () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void prepare ( const SoftwareShaderContext & context ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Normal , world position , texture coordinates and color.
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getVaryingsCount () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void vertex ( const SoftwareVertex & input , SoftwareVarying & output ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool fragment ( const SoftwareVarying & input , Gre::Vector4 & color ) const ;
+
+protected:
+
+    /// @brief Model matrix.
+    Gre::Matrix4 iModel ;
+
+    /// @brief Projection * View * Model.
+    Gre::Matrix4 iMvp ;
+
+    /// @brief Matrix for the normals.
+    Gre::Matrix3 iNormal ;
+
+    /// @brief Diffuse color.
+    Gre::Vector4 iDiffuse ;
+
+    /// @brief Diffuse texture , or null.
+    const SoftwareTexture * iTexture ;
+
+    /// @brief True if the first light is used.
+    bool iLit ;
+
+    /// @brief Position of the first light , in world space , or its
+    /// direction if 'w' is 0.
+    Gre::Vector4 iLightPosition ;
+
+    /// @brief Ambient intensity.
+    Gre::Vector3 iLightAmbient ;
+
+    /// @brief Diffuse intensity.
+    Gre::Vector3 iLightDiffuse ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Tiled rasterizer.
+///
+/// Triangles are transformed on the Gre::JobPool , clipped against the near
+/// plane , and binned in tiles of 'TileSize' pixels. Tiles are then
+/// rasterized in parallel : a tile is only written by one job , and its
+/// triangles are drawn in submission order. Edge functions are evaluated
+/// four pixels at a time , and varyings are interpolated with perspective
+/// correction.
+//////////////////////////////////////////////////////////////////////
+class SoftwareRasterizer
+{
+public:
+
+    /// @brief Width and height of a tile , in pixels.
+    static const int TileSize = 32 ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Draws indexed triangles. 'vertices' gives the attributes of
+    /// each vertex , 'viewport' maps the normalized coordinates to the
+    /// target , and only pixels in 'scissor' are written.
+    //////////////////////////////////////////////////////////////////////
+    static void drawTriangles (const SoftwareTarget & target ,
+                               const Gre::Surface & viewport ,
+                               const Gre::Surface & scissor ,
+                               const Gre::RasterState & state ,
+                               const SoftwareShader & shader ,
+                               const std::vector < SoftwareVertex > & vertices ,
+                               const std::vector < uint32_t > & indices) ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Writes an 8 bits RGB , RGBA or Red pixel buffer to a PNG file. The
+/// first row of the buffer is the bottom of the image.
+//////////////////////////////////////////////////////////////////////
+bool SoftwarePixelBufferSavePng ( const Gre::SoftwarePixelBuffer & buffer , const std::string & path ) ;
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A render context without any window.
+//////////////////////////////////////////////////////////////////////
+class SoftwareRenderContext : public Gre::RenderContext
+{
+public:
+
+    POOLED ( Gre::Pools::Resource )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareRenderContext ( const std::string & name , const Gre::Surface & surface ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SoftwareRenderContext () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void bind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void unbind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void flush () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::Surface getSurface () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the surface. The renderer's buffers are resized at
+    /// next frame.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setSurface ( const Gre::Surface & surface ) ;
+
+protected:
+
+    /// @brief Surface of the context.
+    Gre::Surface iSurface ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A framebuffer drawing in the pixel buffers of its attached
+/// textures.
+///
+/// The Color0 attachment must be an 8 bits texture , and the Depth
+/// attachment a float one. Renderbuffers , or a missing depth attachment ,
+/// use buffers owned by the framebuffer. The framebuffer returned by
+/// 'loadNull()' draws in the renderer's default target.
+//////////////////////////////////////////////////////////////////////
+class SoftwareFramebuffer : public Gre::RenderFramebuffer
+{
+public:
+
+    POOLED ( Gre::Pools::Render )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareFramebuffer ( const SoftwareRenderer * renderer , const std::string & name , bool isdefault = false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SoftwareFramebuffer () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void bind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void unbind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool binded () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isComplete () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Copies the color or the depth of the source.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool copy ( const Gre::RenderFramebuffer & source , const Gre::RenderFramebufferAttachement & attachment ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the buffers to draw in.
+    //////////////////////////////////////////////////////////////////////
+    virtual SoftwareTarget getTarget () const ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool bindAttachment ( const Gre::FramebufferAttachment & attachment ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void unbindAttachment ( const Gre::FramebufferAttachment & attachment ) const ;
+
+protected:
+
+    /// @brief Renderer owning the default target.
+    const SoftwareRenderer * iRenderer ;
+
+    /// @brief Property to hold the bind state of the framebuffer.
+    mutable bool iBinded ;
+
+    /// @brief True if the framebuffer draws in the default target.
+    bool iDefault ;
+
+    /// @brief Color buffer used without Color0 texture.
+    mutable std::vector < unsigned char > iColor ;
+
+    /// @brief Depth buffer used without Depth texture.
+    mutable std::vector < float > iDepth ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Software Framebuffer Creator.
+//////////////////////////////////////////////////////////////////////
+class SoftwareFramebufferCreator : public Gre::RenderFramebufferInternalCreator
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareFramebufferCreator ( const SoftwareRenderer * renderer ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SoftwareFramebufferCreator () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::RenderFramebuffer* load ( const std::string & name , const Gre::ResourceLoaderOptions& options ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::RenderFramebuffer* loadNull () const ;
+
+protected:
+
+    /// @brief Parent's renderer.
+    const SoftwareRenderer * iRenderer ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A texture sampled from its first pixel buffer.
+//////////////////////////////////////////////////////////////////////
+class SoftwareTexture : public Gre::Texture
+{
+public:
+
+    POOLED ( Gre::Pools::Render )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareTexture (const SoftwareRenderer * renderer ,
+                     const std::string & name , const Gre::TextureType & type ,
+                     const Gre::SoftwarePixelBufferHolderList & buffers) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SoftwareTexture () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the bilinear filtered color at given coordinates ,
+    /// repeated outside [0 , 1]. Depth and red textures return ( v , v , v , 1 ).
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::Vector4 sample ( const Gre::Vector2 & coordinates ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Fills 'target' with the pixel buffer , if its format can be
+    /// drawn in.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool getTarget ( SoftwareTarget & target , bool depth ) const ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Puts the texture in the renderer's active unit.
+    //////////////////////////////////////////////////////////////////////
+    virtual void _bind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void _unbind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Caches the first pixel buffer.
+    //////////////////////////////////////////////////////////////////////
+    virtual void _setBuffer ( ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the texel at given integer coordinates.
+    //////////////////////////////////////////////////////////////////////
+    Gre::Vector4 iTexel ( int x , int y ) const ;
+
+protected:
+
+    /// @brief Renderer holding the texture units.
+    const SoftwareRenderer * iRenderer ;
+
+    /// @brief Pixel buffer sampled.
+    mutable Gre::SoftwarePixelBufferHolder iPixels ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Software Texture Creator.
+//////////////////////////////////////////////////////////////////////
+class SoftwareTextureCreator : public Gre::TextureInternalCreator
+{
+public:
+
+    POOLED ( Gre::Pools::Manager )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareTextureCreator ( const SoftwareRenderer * renderer ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SoftwareTextureCreator () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::Texture* load (const std::string & name ,
+                                const Gre::SoftwarePixelBufferHolderList & buffers ,
+                                const Gre::TextureType & type ,
+                                const Gre::ResourceLoaderOptions & ops ) const ;
+
+protected:
+
+    /// @brief
+    const SoftwareRenderer * iRenderer ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A GLSL shader , kept to find the program's uniforms. It is never
+/// executed : the SoftwareShader of the technique is used instead.
+//////////////////////////////////////////////////////////////////////
+class SoftwareGlslShader : public Gre::HardwareShader
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareGlslShader ( const std::string & name , const Gre::ShaderType & type , const std::string & src ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SoftwareGlslShader () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual const std::string& getErrorLog () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the source with its '#include' directives expanded.
+    //////////////////////////////////////////////////////////////////////
+    virtual const std::string& getRealSource () const ;
+
+protected:
+
+    /// @brief
+    std::string iErrorLog ;
+
+    /// @brief Source with included files.
+    std::string iRealSource ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Vertex attribute set with 'setVertexAttrib()'.
+//////////////////////////////////////////////////////////////////////
+struct SoftwareAttribute
+{
+    /// @brief Data of the first element.
+    const char * pointer ;
+
+    /// @brief Number of components.
+    size_t elements ;
+
+    /// @brief Type of the components.
+    Gre::VertexAttribType type ;
+
+    /// @brief True if integers are normalized.
+    bool normalize ;
+
+    /// @brief Bytes between two elements.
+    size_t stride ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A program storing the values of its uniforms and the attributes
+/// pointed by the meshes , for the SoftwareShader to read them.
+//////////////////////////////////////////////////////////////////////
+class SoftwareProgram : public Gre::HardwareProgram
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareProgram ( const SoftwareRenderer * renderer , const std::string & name ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SoftwareProgram () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void _bind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void _unbind () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool _attachShader ( const Gre::HardwareShaderHolder & hwdShader ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Finds the uniforms and the attributes in the GLSL sources.
+    /// Uniform blocks are not listed : the technique sets their values as
+    /// plain uniforms.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool _finalize () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void _deleteProgram () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool binded () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void disableVertexAttribs () const ;
+
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void setVertexAttrib (const std::string & attrib ,
+                                  size_t elements ,
+                                  Gre::VertexAttribType type ,
+                                  bool normalize ,
+                                  size_t stride ,
+                                  void * pointer) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records the attribute. 'pointer' is the address of the data
+    /// in the vertex buffer.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setVertexAttrib (int location ,
+                                  size_t elements ,
+                                  Gre::VertexAttribType type ,
+                                  bool normalize ,
+                                  size_t stride ,
+                                  void * pointer) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the renderer's active texture unit.
+    //////////////////////////////////////////////////////////////////////
+    virtual void bindTextureUnit ( int unit ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual bool _setUniform ( int location , const Gre::HdwProgVarType & type , const Gre::RealProgramVariable & value ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual unsigned int getMaximumLights () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the value set for the uniform at 'location'.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool getUniformValue ( int location , Gre::HdwProgVarType & type , Gre::RealProgramVariable & value ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the attribute set at 'location' , or null.
+    //////////////////////////////////////////////////////////////////////
+    virtual const SoftwareAttribute * getAttribute ( int location ) const ;
+
+protected:
+
+    /// @brief Renderer drawing with this program.
+    const SoftwareRenderer * iRenderer ;
+
+    /// @brief Values set , by location.
+    mutable std::vector < std::pair < Gre::HdwProgVarType , Gre::RealProgramVariable > > iValues ;
+
+    /// @brief Attributes set , by location.
+    mutable std::map < int , SoftwareAttribute > iAttributes ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Software HardwareProgramManagerCreator.
+//////////////////////////////////////////////////////////////////////
+class SoftwareProgramManagerCreator : public Gre::HardwareProgramManagerInternalCreator
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareProgramManagerCreator ( const SoftwareRenderer * renderer ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SoftwareProgramManagerCreator () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::HardwareShaderHolder loadShader (const Gre::ShaderType & type ,
+                                                  const std::string & name ,
+                                                  const std::string & source) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::HardwareProgramHolder loadProgram (const std::string & name ,
+                                                    const Gre::HardwareShaderHolderList & shaders) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns "GLSL" : GLSL sources give the uniforms' names.
+    //////////////////////////////////////////////////////////////////////
+    virtual const std::string getCompiler () const ;
+
+protected:
+
+    /// @brief
+    const SoftwareRenderer * iRenderer ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Index Buffer keeping its data in memory.
+//////////////////////////////////////////////////////////////////////
+class SoftwareHardwareIndexBuffer : public Gre::HardwareIndexBuffer
+{
+public:
+
+    POOLED ( Gre::Pools::HdwBuffer )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareHardwareIndexBuffer ( const void* data , size_t sz , const Gre::IndexDescriptor& desc ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~SoftwareHardwareIndexBuffer () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void bind() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void unbind() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void addData(const char* vdata, size_t sz);
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual const char* getData() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void clearData();
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getSize() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t count() const;
+
+protected:
+
+    /// @brief
+    std::vector < char > iData ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Vertex Buffer keeping its data in memory.
+//////////////////////////////////////////////////////////////////////
+class SoftwareHardwareVertexBuffer : public Gre::HardwareVertexBuffer
+{
+public:
+
+    POOLED ( Gre::Pools::HdwBuffer )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareHardwareVertexBuffer ( const void* data , size_t sz , const Gre::VertexDescriptor& desc ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SoftwareHardwareVertexBuffer () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void bind() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void unbind() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void addData(const char* vdata, size_t sz);
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the data. Attributes point in it.
+    //////////////////////////////////////////////////////////////////////
+    virtual const char* getData() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void clearData();
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t getSize() const;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual size_t count() const;
+
+protected:
+
+    /// @brief
+    std::vector < char > iData ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Software Gre::MeshManager.
+//////////////////////////////////////////////////////////////////////
+class SoftwareMeshManager : public Gre::MeshManager
+{
+public:
+
+    POOLED ( Gre::Pools::Manager )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareMeshManager ( const SoftwareRenderer * renderer ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SoftwareMeshManager () noexcept ( false ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::HardwareVertexBufferHolder createVertexBuffer ( const void* data , size_t sz , const Gre::VertexDescriptor& desc ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::HardwareIndexBufferHolder createIndexBuffer ( const void* data , size_t sz , const Gre::IndexDescriptor& desc ) const  ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::Mesh* create ( const std::string & name ) const ;
+
+protected:
+
+    /// @brief
+    const SoftwareRenderer * iRenderer ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A Gre::Renderer rasterizing on the CPU.
+///
+/// The default target is a RGBA pixel buffer of the context's size , which
+/// can be saved to PNG with 'saveColorBuffer()'. Each technique is drawn
+/// with the SoftwareShader set with 'setShader()' , or a
+/// SoftwareDefaultShader.
+///
+/// The renderer is loaded when the RendererOptions holds 'Renderer.Backend'
+/// set to "Software". 'Renderer.Size' ( string , as "1024x768" ) gives the
+/// size of the SoftwareRenderContext created by the loader.
+///
+//////////////////////////////////////////////////////////////////////
+class SoftwareRenderer : public Gre::Renderer
+{
+public:
+
+    POOLED ( Gre::Pools::Render )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareRenderer ( const std::string& name , const Gre::RendererOptions& options ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SoftwareRenderer () noexcept ( false ) ;
+
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void setClearRegion ( const Gre::Surface & box ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void setViewport ( const Gre::Viewport & viewport ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void setClearColor ( const Gre::Color & color ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void setClearDepth ( float value ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void clearBuffers ( const Gre::ClearBuffers & buffers ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Draws a quad covering the viewport.
+    //////////////////////////////////////////////////////////////////////
+    virtual void draw ( const Gre::TechniqueHolder & technique ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void drawSubMesh ( const Gre::SubMeshHolder & submesh ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual void setRasterState ( const Gre::RasterState & state ) const ;
+
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Sets the shader used to draw with the technique named
+    /// 'technique'. A null shader uses the default one again.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setShader ( const std::string & technique , const std::shared_ptr < SoftwareShader > & shader ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the default target's color buffer.
+    //////////////////////////////////////////////////////////////////////
+    virtual const Gre::SoftwarePixelBufferHolder & getColorBuffer () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Writes the default target's color buffer to a PNG file.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool saveColorBuffer ( const std::string & path ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the default target , resized to the context's surface.
+    //////////////////////////////////////////////////////////////////////
+    virtual SoftwareTarget getDefaultTarget () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Makes 'framebuffer' the target of the next draws.
+    //////////////////////////////////////////////////////////////////////
+    void bindFramebuffer ( const SoftwareFramebuffer * framebuffer ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Draws in the default target again , if 'framebuffer' is the
+    /// one bound.
+    //////////////////////////////////////////////////////////////////////
+    void unbindFramebuffer ( const SoftwareFramebuffer * framebuffer ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Sets the technique drawing the next submeshes. Called by the
+    /// meshes when binding a submesh.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setCurrentTechnique ( const Gre::Technique * technique ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Changes the active texture unit.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setActiveUnit ( int unit ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Puts a texture in the active unit.
+    //////////////////////////////////////////////////////////////////////
+    virtual void setUnitTexture ( const SoftwareTexture * texture ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the texture in given unit , or null.
+    //////////////////////////////////////////////////////////////////////
+    virtual const SoftwareTexture * getUnitTexture ( int unit ) const ;
+
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::MeshManagerHolder iCreateMeshManager ( ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::HardwareProgramManagerInternalCreator * iCreateProgramManagerCreator ( ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::TextureInternalCreator* iCreateTextureCreator ( ) const ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::RenderFramebufferInternalCreator* iCreateFramebufferCreator ( ) const ;
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns the target of the bound framebuffer.
+    //////////////////////////////////////////////////////////////////////
+    SoftwareTarget iCurrentTarget () const ;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Prepares the shader of 'technique' and draws the triangles.
+    //////////////////////////////////////////////////////////////////////
+    void iDraw (const Gre::Technique * technique ,
+                const std::vector < SoftwareVertex > & vertices ,
+                const std::vector < uint32_t > & indices) const ;
+
+protected:
+
+    /// @brief Number of texture units.
+    static const int UnitsCount = 32 ;
+
+    /// @brief Default target's colors.
+    mutable Gre::SoftwarePixelBufferHolder iColorBuffer ;
+
+    /// @brief Default target's depths.
+    mutable std::vector < float > iDepthBuffer ;
+
+    /// @brief Surface drawn , set by 'setViewport()'.
+    mutable Gre::Surface iViewport ;
+
+    /// @brief Region cleared and drawn , if 'iScissor' is true.
+    mutable Gre::Surface iClearRegion ;
+
+    /// @brief True if 'iClearRegion' is used.
+    mutable bool iScissor ;
+
+    /// @brief Clear color , as red , green , blue and alpha.
+    mutable Gre::Vector4 iClearColor ;
+
+    /// @brief Clear depth.
+    mutable float iClearDepth ;
+
+    /// @brief Raster states applied.
+    mutable Gre::RasterState iRasterState ;
+
+    /// @brief Framebuffer bound , or null for the default target.
+    mutable const SoftwareFramebuffer * iFramebuffer ;
+
+    /// @brief Technique of the submesh bound.
+    mutable const Gre::Technique * iTechnique ;
+
+    /// @brief Active texture unit.
+    mutable int iActiveUnit ;
+
+    /// @brief Textures bound to each unit.
+    mutable const SoftwareTexture * iUnits [UnitsCount] ;
+
+    /// @brief Shaders set by technique's name.
+    std::map < std::string , std::shared_ptr < SoftwareShader > > iShaders ;
+
+    /// @brief Shader used for other techniques.
+    std::shared_ptr < SoftwareShader > iDefaultShader ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A SoftwareRenderer Loader.
+//////////////////////////////////////////////////////////////////////
+class SoftwareRendererLoader : public Gre::RendererLoader
+{
+public:
+
+    POOLED ( Gre::Pools::Loader )
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareRendererLoader () ;
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    virtual ~SoftwareRendererLoader () noexcept ( false ) ;
+
+    ////////////////////////////////////////////////////////////////////////
+    /// @brief Returns a clone of this object.
+    ////////////////////////////////////////////////////////////////////////
+    virtual Gre::ResourceLoader* clone() const;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns false.
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isLoadable( const std::string& filepath ) const;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Returns true if 'Renderer.Backend' is "Software".
+    //////////////////////////////////////////////////////////////////////
+    virtual bool isCompatible ( const Gre::RendererOptions& options ) const;
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Creates a SoftwareRenderer with its SoftwareRenderContext.
+    //////////////////////////////////////////////////////////////////////
+    virtual Gre::RendererHolder load ( const std::string& name , const Gre::RendererOptions& options ) const;
+};
+
+#endif /* SoftwareRenderer_h */
@@ -0,0 +1,215 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SoftwareFramebufferCreator.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "SoftwareRenderer.h"
+
+SoftwareFramebuffer::SoftwareFramebuffer ( const SoftwareRenderer * renderer , const std::string & name , bool isdefault )
+: Gre::RenderFramebuffer ( name ) , iRenderer ( renderer ) , iBinded ( false ) , iDefault ( isdefault )
+{
+
+}
+
+SoftwareFramebuffer::~SoftwareFramebuffer() noexcept ( false )
+{
+    if ( iBinded )
+    iRenderer -> unbindFramebuffer ( this ) ;
+}
+
+void SoftwareFramebuffer::bind() const
+{
+    GreAutolock ; iBinded = true ;
+    Gre::RenderStatistics::CountFramebufferBind () ;
+    iRenderer -> bindFramebuffer ( this ) ;
+}
+
+void SoftwareFramebuffer::unbind() const
+{
+    GreAutolock ; iBinded = false ;
+    iRenderer -> unbindFramebuffer ( this ) ;
+}
+
+bool SoftwareFramebuffer::binded () const
+{
+    GreAutolock ; return iBinded ;
+}
+
+bool SoftwareFramebuffer::isComplete () const
+{
+    return true ;
+}
+
+bool SoftwareFramebuffer::copy ( const Gre::RenderFramebuffer & source , const Gre::RenderFramebufferAttachement & attachment ) const
+{
+    const SoftwareTarget from = reinterpret_cast < const SoftwareFramebuffer & > ( source ) .getTarget () ;
+    const SoftwareTarget to = getTarget () ;
+
+    if ( from.width != to.width || from.height != to.height )
+    return false ;
+
+    const size_t pixels = (size_t) to.width * (size_t) to.height ;
+
+    if ( attachment == Gre::RenderFramebufferAttachement::Depth )
+    {
+        if ( !from.depth || !to.depth )
+        return false ;
+
+        std::copy ( from.depth , from.depth + pixels , to.depth ) ;
+        return true ;
+    }
+
+    if ( attachment == Gre::RenderFramebufferAttachement::Color0 )
+    {
+        if ( !from.color || !to.color || from.channels != to.channels )
+        return false ;
+
+        std::copy ( from.color , from.color + pixels * to.channels , to.color ) ;
+        return true ;
+    }
+
+    return false ;
+}
+
+SoftwareTarget SoftwareFramebuffer::getTarget () const
+{
+    if ( iDefault )
+    return iRenderer -> getDefaultTarget () ;
+
+    GreAutolock ;
+
+    SoftwareTarget target ;
+    const Gre::FramebufferAttachment & color = getAttachment ( Gre::RenderFramebufferAttachement::Color0 ) ;
+    const Gre::FramebufferAttachment & depth = getAttachment ( Gre::RenderFramebufferAttachement::Depth ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Color : drawn in the texture , or in our own buffer for renderbuffers.
+
+    if ( color.layer == Gre::RenderFramebufferAttachement::Color0 )
+    {
+        if ( color.type == Gre::RenderFramebufferAttachementType::Texture && !color.texture.isInvalid() )
+        {
+            const SoftwareTexture * texture = reinterpret_cast < const SoftwareTexture * > ( color.texture.getObject() ) ;
+
+            if ( !texture -> getTarget ( target , false ) )
+            GreDebug ( "[WARN] Framebuffer '" ) << getName() << "' can't draw in texture '" << texture -> getName() << "'." << Gre::gendl ;
+        }
+
+        else if ( color.type == Gre::RenderFramebufferAttachementType::Renderbuffer )
+        {
+            target.width = color.renderbuffer.size.first ;
+            target.height = color.renderbuffer.size.second ;
+            target.channels = 4 ;
+
+            iColor.resize ( (size_t) target.width * (size_t) target.height * 4 ) ;
+            target.color = iColor.data () ;
+        }
+    }
+
+    if ( !target.color )
+    {
+        target.width = getDefaultSize () .first ;
+        target.height = getDefaultSize () .second ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Depth : drawn in the texture if it has the color's size. Else , the
+    // framebuffer uses its own buffer.
+
+    if ( depth.layer == Gre::RenderFramebufferAttachement::Depth &&
+         depth.type == Gre::RenderFramebufferAttachementType::Texture && !depth.texture.isInvalid() )
+    {
+        const SoftwareTexture * texture = reinterpret_cast < const SoftwareTexture * > ( depth.texture.getObject() ) ;
+        SoftwareTarget depthtarget ;
+
+        if ( texture -> getTarget ( depthtarget , true ) )
+        {
+            if ( !target.color )
+            {
+                target.width = depthtarget.width ;
+                target.height = depthtarget.height ;
+            }
+
+            if ( depthtarget.width == target.width && depthtarget.height == target.height )
+            target.depth = depthtarget.depth ;
+        }
+    }
+
+    if ( !target.depth && target.width > 0 && target.height > 0 )
+    {
+        const size_t pixels = (size_t) target.width * (size_t) target.height ;
+
+        if ( iDepth.size () != pixels )
+        iDepth.assign ( pixels , 1.0f ) ;
+
+        target.depth = iDepth.data () ;
+    }
+
+    return target ;
+}
+
+bool SoftwareFramebuffer::bindAttachment ( const Gre::FramebufferAttachment & ) const
+{
+    return true ;
+}
+
+void SoftwareFramebuffer::unbindAttachment ( const Gre::FramebufferAttachment & ) const
+{
+
+}
+
+// ---------------------------------------------------------------------------
+
+SoftwareFramebufferCreator::SoftwareFramebufferCreator ( const SoftwareRenderer* parent )
+: Gre::RenderFramebufferInternalCreator() , iRenderer(parent)
+{
+
+}
+
+SoftwareFramebufferCreator::~SoftwareFramebufferCreator()
+{
+
+}
+
+Gre::RenderFramebuffer* SoftwareFramebufferCreator::load(const std::string &name, const Gre::ResourceLoaderOptions &) const
+{
+    if ( !iRenderer )
+    return nullptr ;
+
+    return new SoftwareFramebuffer ( iRenderer , name ) ;
+}
+
+Gre::RenderFramebuffer* SoftwareFramebufferCreator::loadNull () const
+{
+    if ( !iRenderer )
+    return nullptr ;
+
+    return new SoftwareFramebuffer ( iRenderer , std::string() , true ) ;
+}
@@ -0,0 +1,95 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SoftwareHardwareIndexBuffer.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "SoftwareRenderer.h"
+
+SoftwareHardwareIndexBuffer::SoftwareHardwareIndexBuffer ( const void* data , size_t sz , const Gre::IndexDescriptor& desc )
+: Gre::HardwareIndexBuffer("")
+{
+    if ( data && sz )
+    iData.assign ( (const char*) data , (const char*) data + sz ) ;
+    else
+    iData.resize ( sz ) ;
+
+    Gre::RenderStatistics::CountUpload ( sz ) ;
+
+    setIndexDescriptor(desc) ;
+    setDirty(true) ;
+}
+
+SoftwareHardwareIndexBuffer::~SoftwareHardwareIndexBuffer() noexcept ( false )
+{
+
+}
+
+void SoftwareHardwareIndexBuffer::bind() const
+{
+
+}
+
+void SoftwareHardwareIndexBuffer::unbind() const
+{
+
+}
+
+void SoftwareHardwareIndexBuffer::addData(const char *vdata, size_t sz)
+{
+    GreAutolock ;
+
+    if ( vdata && sz )
+    iData.insert ( iData.end() , vdata , vdata + sz ) ;
+
+    Gre::RenderStatistics::CountUpload ( sz ) ;
+
+    setDirty(true) ;
+}
+
+const char* SoftwareHardwareIndexBuffer::getData() const
+{
+    return iData.empty() ? nullptr : iData.data() ;
+}
+
+void SoftwareHardwareIndexBuffer::clearData()
+{
+    GreAutolock ; iData.clear() ;
+    setDirty(true) ;
+}
+
+size_t SoftwareHardwareIndexBuffer::getSize() const
+{
+    return iData.size() ;
+}
+
+size_t SoftwareHardwareIndexBuffer::count() const
+{
+    return iData.size() / Gre::IndexTypeGetSize(getIndexDescriptor().getType()) ;
+}
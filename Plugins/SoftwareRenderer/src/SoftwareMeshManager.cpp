@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SoftwareMeshManager.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "SoftwareRenderer.h"
+
+// -----------------------------------------------------------------------------
+
+class SoftwareMesh : public Gre::Mesh
+{
+public:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    SoftwareMesh ( const SoftwareRenderer* renderer , const std::string & name )
+    : Gre::Mesh ( name ) , iRenderer ( renderer )
+    {
+
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    ~SoftwareMesh ()
+    {
+
+    }
+
+protected:
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    void iBind ( const Gre::TechniqueHolder & ) const
+    {
+
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    void iUnbind ( const Gre::TechniqueHolder & ) const
+    {
+
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    /// @brief Records the attributes in the program , and tells the
+    /// renderer which technique draws the submesh.
+    //////////////////////////////////////////////////////////////////////
+    void iBindSubMesh ( const Gre::SubMeshHolder & submesh , const Gre::TechniqueHolder & technique ) const
+    {
+        Gre::Mesh::iBindSubMesh ( submesh , technique ) ;
+        iRenderer -> setCurrentTechnique ( technique.isInvalid() ? nullptr : technique.getObject() ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////
+    void iUnbindSubMesh ( const Gre::SubMeshHolder & submesh , const Gre::TechniqueHolder & technique ) const
+    {
+        Gre::Mesh::iUnbindSubMesh ( submesh , technique ) ;
+        iRenderer -> setCurrentTechnique ( nullptr ) ;
+    }
+
+protected:
+
+    /// @brief Renderer drawing the submeshes.
+    const SoftwareRenderer * iRenderer ;
+};
+
+// -----------------------------------------------------------------------------
+
+SoftwareMeshManager::SoftwareMeshManager ( const SoftwareRenderer* renderer )
+: Gre::MeshManager() , iRenderer(renderer)
+{
+
+}
+
+SoftwareMeshManager::~SoftwareMeshManager() noexcept ( false )
+{
+
+}
+
+Gre::HardwareVertexBufferHolder SoftwareMeshManager::createVertexBuffer(const void *data, size_t sz, const Gre::VertexDescriptor &desc) const
+{
+    return Gre::HardwareVertexBufferHolder ( new SoftwareHardwareVertexBuffer ( data , sz , desc ) ) ;
+}
+
+Gre::HardwareIndexBufferHolder SoftwareMeshManager::createIndexBuffer(const void *data, size_t sz, const Gre::IndexDescriptor &desc) const
+{
+    return Gre::HardwareIndexBufferHolder ( new SoftwareHardwareIndexBuffer ( data , sz , desc ) ) ;
+}
+
+Gre::Mesh* SoftwareMeshManager::create ( const std::string & name ) const
+{
+    if ( !iRenderer )
+    return nullptr ;
+
+    return new SoftwareMesh ( iRenderer , name ) ;
+}
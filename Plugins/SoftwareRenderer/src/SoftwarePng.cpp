@@ -0,0 +1,182 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SoftwarePng.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "SoftwareRenderer.h"
+
+#include <fstream>
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Returns the table used to compute CRC-32.
+//////////////////////////////////////////////////////////////////////
+static std::vector < uint32_t > SoftwarePngCrcTable ()
+{
+    std::vector < uint32_t > table ( 256 ) ;
+
+    for ( uint32_t n = 0 ; n < 256 ; ++n )
+    {
+        uint32_t c = n ;
+
+        for ( int k = 0 ; k < 8 ; ++k )
+        c = ( c & 1 ) ? 0xEDB88320u ^ ( c >> 1 ) : c >> 1 ;
+
+        table [n] = c ;
+    }
+
+    return table ;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Updates a CRC-32 , as used by PNG chunks.
+//////////////////////////////////////////////////////////////////////
+static uint32_t SoftwarePngCrc ( uint32_t crc , const unsigned char * data , size_t size )
+{
+    static const std::vector < uint32_t > table = SoftwarePngCrcTable () ;
+
+    crc = crc ^ 0xFFFFFFFFu ;
+
+    for ( size_t i = 0 ; i < size ; ++i )
+    crc = table [( crc ^ data [i] ) & 0xFF] ^ ( crc >> 8 ) ;
+
+    return crc ^ 0xFFFFFFFFu ;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Appends a big endian integer.
+//////////////////////////////////////////////////////////////////////
+static void SoftwarePngPush ( std::vector < unsigned char > & data , uint32_t value )
+{
+    data.push_back ( (unsigned char) ( value >> 24 ) ) ;
+    data.push_back ( (unsigned char) ( value >> 16 ) ) ;
+    data.push_back ( (unsigned char) ( value >> 8 ) ) ;
+    data.push_back ( (unsigned char) value ) ;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Writes a chunk with its length and CRC.
+//////////////////////////////////////////////////////////////////////
+static void SoftwarePngChunk ( std::ofstream & stream , const char * type , const std::vector < unsigned char > & content )
+{
+    std::vector < unsigned char > chunk ;
+    SoftwarePngPush ( chunk , (uint32_t) content.size () ) ;
+
+    chunk.insert ( chunk.end () , type , type + 4 ) ;
+    chunk.insert ( chunk.end () , content.begin () , content.end () ) ;
+
+    SoftwarePngPush ( chunk , SoftwarePngCrc ( 0 , chunk.data () + 4 , chunk.size () - 4 ) ) ;
+    stream.write ( (const char*) chunk.data () , chunk.size () ) ;
+}
+
+bool SoftwarePixelBufferSavePng ( const Gre::SoftwarePixelBuffer & buffer , const std::string & path )
+{
+    const Gre::Surface & surface = buffer.getSurface () ;
+    const unsigned char * pixels = reinterpret_cast < const unsigned char * > ( buffer.getData () ) ;
+
+    if ( !pixels || surface.width <= 0 || surface.height <= 0 || buffer.getPixelType () != Gre::PixelType::UnsignedByte )
+    return false ;
+
+    int channels = 0 ; unsigned char colortype = 0 ;
+
+    switch ( buffer.getPixelFormat () )
+    {
+        case Gre::PixelFormat::Red:  channels = 1 ; colortype = 0 ; break ;
+        case Gre::PixelFormat::RGB:  channels = 3 ; colortype = 2 ; break ;
+        case Gre::PixelFormat::RGBA: channels = 4 ; colortype = 6 ; break ;
+        default: return false ;
+    }
+
+    std::ofstream stream ( path , std::ios::binary ) ;
+
+    if ( !stream )
+    {
+        GreDebug ( "[WARN] Can't open file '" ) << path << "'." << Gre::gendl ;
+        return false ;
+    }
+
+    static const unsigned char signature [8] = { 0x89 , 'P' , 'N' , 'G' , '\r' , '\n' , 0x1A , '\n' } ;
+    stream.write ( (const char*) signature , 8 ) ;
+
+    std::vector < unsigned char > header ;
+    SoftwarePngPush ( header , (uint32_t) surface.width ) ;
+    SoftwarePngPush ( header , (uint32_t) surface.height ) ;
+    header.push_back ( 8 ) ; header.push_back ( colortype ) ;
+    header.push_back ( 0 ) ; header.push_back ( 0 ) ; header.push_back ( 0 ) ;
+    SoftwarePngChunk ( stream , "IHDR" , header ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Scanlines , from the top of the image , each with filter 0. They are
+    // stored in uncompressed deflate blocks , so no library is needed.
+
+    const size_t rowsize = (size_t) surface.width * channels ;
+    std::vector < unsigned char > raw ;
+    raw.reserve ( ( rowsize + 1 ) * surface.height ) ;
+
+    for ( int y = surface.height - 1 ; y >= 0 ; --y )
+    {
+        raw.push_back ( 0 ) ;
+        raw.insert ( raw.end () , pixels + y * rowsize , pixels + ( y + 1 ) * rowsize ) ;
+    }
+
+    std::vector < unsigned char > compressed ;
+    compressed.push_back ( 0x78 ) ; compressed.push_back ( 0x01 ) ;
+
+    uint32_t a = 1 , b = 0 ;
+
+    for ( size_t offset = 0 ; offset < raw.size () || offset == 0 ; )
+    {
+        const size_t size = std::min ( raw.size () - offset , (size_t) 65535 ) ;
+        const bool last = offset + size >= raw.size () ;
+
+        compressed.push_back ( last ? 1 : 0 ) ;
+        compressed.push_back ( (unsigned char) ( size & 0xFF ) ) ;
+        compressed.push_back ( (unsigned char) ( size >> 8 ) ) ;
+        compressed.push_back ( (unsigned char) ( ~size & 0xFF ) ) ;
+        compressed.push_back ( (unsigned char) ( ( ~size >> 8 ) & 0xFF ) ) ;
+        compressed.insert ( compressed.end () , raw.begin () + offset , raw.begin () + offset + size ) ;
+
+        for ( size_t i = offset ; i < offset + size ; ++i )
+        {
+            a = ( a + raw [i] ) % 65521 ;
+            b = ( b + a ) % 65521 ;
+        }
+
+        offset = offset + size ;
+
+        if ( last )
+        break ;
+    }
+
+    SoftwarePngPush ( compressed , ( b << 16 ) | a ) ;
+    SoftwarePngChunk ( stream , "IDAT" , compressed ) ;
+    SoftwarePngChunk ( stream , "IEND" , std::vector < unsigned char > () ) ;
+
+    return stream.good () ;
+}
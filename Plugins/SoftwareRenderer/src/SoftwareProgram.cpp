@@ -0,0 +1,177 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SoftwareProgram.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "SoftwareRenderer.h"
+
+#include <GlslReflection.h>
+
+SoftwareProgram::SoftwareProgram ( const SoftwareRenderer * renderer , const std::string & name )
+: Gre::HardwareProgram ( name ) , iRenderer ( renderer )
+{
+
+}
+
+SoftwareProgram::~SoftwareProgram() noexcept ( false )
+{
+    _deleteProgram() ;
+}
+
+void SoftwareProgram::_bind() const
+{
+    GreAutolock ; iBinded = true ;
+}
+
+void SoftwareProgram::_unbind() const
+{
+    GreAutolock ; iBinded = false ;
+}
+
+bool SoftwareProgram::_attachShader(const Gre::HardwareShaderHolder & hwdShader)
+{
+    GreAutolock ;
+    return !iLinked && !hwdShader.isInvalid() ;
+}
+
+bool SoftwareProgram::_finalize()
+{
+    GreAutolock ;
+
+    if ( iLinked )
+    return false ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Uniform blocks are not listed : the technique then sends every values
+    // as plain uniforms , which the SoftwareShaderContext can read.
+
+    Gre::GlslReflection reflection ;
+
+    for ( auto & attached : iAttachedShaders )
+    {
+        if ( attached.second.isInvalid() )
+        continue ;
+
+        const SoftwareGlslShader * shader = reinterpret_cast < const SoftwareGlslShader * > ( attached.second.getObject() ) ;
+        reflection.reflect ( attached.first , shader -> getRealSource () ) ;
+    }
+
+    iUniforms = reflection.uniforms ;
+    iAttribsLocation = reflection.attributes ;
+    iValues.resize ( (size_t) reflection.nextUniform ) ;
+
+    iLinked = true ;
+    return iLinked ;
+}
+
+void SoftwareProgram::_deleteProgram()
+{
+    GreAutolock ;
+
+    iValues.clear() ;
+    iAttributes.clear() ;
+
+    iLinked = false ;
+    iBinded = false ;
+}
+
+bool SoftwareProgram::binded () const
+{
+    return iBinded ;
+}
+
+void SoftwareProgram::setVertexAttrib(const std::string &attrib, size_t elements, Gre::VertexAttribType type, bool normalize, size_t stride, void *pointer) const
+{
+    auto it = iAttribsLocation.find(attrib) ;
+
+    if ( it != iAttribsLocation.end() )
+    setVertexAttrib ( it->second , elements , type , normalize , stride , pointer ) ;
+}
+
+void SoftwareProgram::setVertexAttrib(int loc, size_t elements, Gre::VertexAttribType type, bool normalize, size_t stride, void *pointer) const
+{
+    if ( loc < 0 || !pointer )
+    return ;
+
+    GreAutolock ;
+    iAttributes [loc] = SoftwareAttribute { (const char*) pointer , elements , type , normalize , stride } ;
+}
+
+void SoftwareProgram::disableVertexAttribs () const
+{
+    GreAutolock ; iAttributes.clear () ;
+}
+
+void SoftwareProgram::bindTextureUnit(int unit) const
+{
+    iRenderer -> setActiveUnit ( unit ) ;
+}
+
+bool SoftwareProgram::_setUniform(int location, const Gre::HdwProgVarType &type, const Gre::RealProgramVariable &value) const
+{
+    if ( location < 0 )
+    return false ;
+
+    GreAutolock ;
+
+    if ( (size_t) location >= iValues.size() )
+    iValues.resize ( (size_t) location + 1 ) ;
+
+    iValues [location] = std::make_pair ( type , value ) ;
+    return true ;
+}
+
+unsigned int SoftwareProgram::getMaximumLights() const
+{
+    return 10 ;
+}
+
+bool SoftwareProgram::getUniformValue ( int location , Gre::HdwProgVarType & type , Gre::RealProgramVariable & value ) const
+{
+    GreAutolock ;
+
+    if ( location < 0 || (size_t) location >= iValues.size() )
+    return false ;
+
+    if ( iValues [location] .first == Gre::HdwProgVarType::None )
+    return false ;
+
+    type = iValues [location] .first ;
+    value = iValues [location] .second ;
+    return true ;
+}
+
+const SoftwareAttribute * SoftwareProgram::getAttribute ( int location ) const
+{
+    GreAutolock ;
+
+    auto it = iAttributes.find ( location ) ;
+    return it == iAttributes.end() ? nullptr : &it->second ;
+}
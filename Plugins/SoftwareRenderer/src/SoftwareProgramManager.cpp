@@ -0,0 +1,84 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SoftwareProgramManager.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "SoftwareRenderer.h"
+
+SoftwareProgramManagerCreator::SoftwareProgramManagerCreator ( const SoftwareRenderer* renderer )
+: Gre::HardwareProgramManagerInternalCreator()
+, iRenderer(renderer)
+{
+
+}
+
+SoftwareProgramManagerCreator::~SoftwareProgramManagerCreator()
+{
+
+}
+
+Gre::HardwareShaderHolder SoftwareProgramManagerCreator::loadShader (const Gre::ShaderType & type ,
+                                                                     const std::string & name ,
+                                                                     const std::string & source) const
+{
+    if ( !iRenderer )
+    return Gre::HardwareShaderHolder ( nullptr ) ;
+
+    return Gre::HardwareShaderHolder ( new SoftwareGlslShader(name, type, source) ) ;
+}
+
+Gre::HardwareProgramHolder SoftwareProgramManagerCreator::loadProgram (const std::string & name ,
+                                                                       const Gre::HardwareShaderHolderList & shaders) const
+{
+    if ( !iRenderer )
+    return Gre::HardwareProgramHolder ( nullptr ) ;
+
+    Gre::HardwareProgramHolder program ( new SoftwareProgram(iRenderer, name) ) ;
+
+    if ( shaders.empty() )
+    return program ;
+
+    program -> attachShaders ( shaders ) ;
+    program -> finalize () ;
+
+    if ( program -> isFinalized() )
+    return program ;
+
+#ifdef GreIsDebugMode
+    GreDebug ( "[WARN] SoftwareProgram '" ) << name << "' not loaded." << Gre::gendl ;
+#endif
+
+    return Gre::HardwareProgramHolder ( nullptr ) ;
+}
+
+const std::string SoftwareProgramManagerCreator::getCompiler () const
+{
+    return "GLSL" ;
+}
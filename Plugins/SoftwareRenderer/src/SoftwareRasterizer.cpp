@@ -0,0 +1,483 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SoftwareRasterizer.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "SoftwareRenderer.h"
+#include <JobPool.h>
+#include <Profiler.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////
+/// @brief A triangle in window coordinates , ready to be rasterized.
+//////////////////////////////////////////////////////////////////////
+struct SoftwareTriangle
+{
+    /// @brief Window coordinates of the vertices.
+    float x [3] , y [3] ;
+
+    /// @brief Depth of the vertices , in [0 , 1].
+    float z [3] ;
+
+    /// @brief Inverse of the clip space 'w' of the vertices.
+    float invw [3] ;
+
+    /// @brief Varyings divided by 'w'.
+    float values [3] [SoftwareVaryingsMax] ;
+
+    /// @brief Pixels covered , clipped to the scissor.
+    int minx , miny , maxx , maxy ;
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Returns the vertex between 'a' and 'b' at 't'.
+//////////////////////////////////////////////////////////////////////
+static SoftwareVarying SoftwareVaryingLerp ( const SoftwareVarying & a , const SoftwareVarying & b , float t , size_t count )
+{
+    SoftwareVarying result ;
+    result.position = a.position + ( b.position - a.position ) * t ;
+
+    for ( size_t i = 0 ; i < count ; ++i )
+    result.values [i] = a.values [i] + ( b.values [i] - a.values [i] ) * t ;
+
+    return result ;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Clips a triangle against the near plane ( z > -w ). Returns the
+/// number of vertices of the resulting polygon ( 0 , 3 or 4 ).
+//////////////////////////////////////////////////////////////////////
+static size_t SoftwareClipNear ( const SoftwareVarying * input [3] , SoftwareVarying output [4] , size_t count )
+{
+    size_t result = 0 ;
+
+    for ( size_t i = 0 ; i < 3 ; ++i )
+    {
+        const SoftwareVarying & a = * input [i] ;
+        const SoftwareVarying & b = * input [(i + 1) % 3] ;
+
+        const float da = a.position.z + a.position.w ;
+        const float db = b.position.z + b.position.w ;
+
+        if ( da >= 0.0f )
+        output [result++] = a ;
+
+        if ( ( da >= 0.0f ) != ( db >= 0.0f ) )
+        output [result++] = SoftwareVaryingLerp ( a , b , da / ( da - db ) , count ) ;
+    }
+
+    return result ;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Returns true if the triangle is outside one of the clip planes.
+//////////////////////////////////////////////////////////////////////
+static bool SoftwareIsOutside ( const SoftwareVarying * v [3] )
+{
+    for ( int axis = 0 ; axis < 3 ; ++axis )
+    {
+        bool below = true , above = true ;
+
+        for ( int i = 0 ; i < 3 ; ++i )
+        {
+            const float c = v[i] -> position [axis] ;
+            const float w = v[i] -> position.w ;
+
+            below = below && c < -w ;
+            above = above && c > w ;
+        }
+
+        if ( below || above )
+        return true ;
+    }
+
+    return false ;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Converts a clipped triangle to window coordinates. Returns false
+/// if it is culled or covers no pixel.
+//////////////////////////////////////////////////////////////////////
+static bool SoftwareSetupTriangle (const SoftwareVarying & a , const SoftwareVarying & b , const SoftwareVarying & c ,
+                                   const Gre::Surface & viewport , const Gre::Surface & scissor ,
+                                   const Gre::RasterState & state , size_t count ,
+                                   SoftwareTriangle & triangle)
+{
+    const SoftwareVarying * v [3] = { &a , &b , &c } ;
+
+    for ( int i = 0 ; i < 3 ; ++i )
+    {
+        const float invw = 1.0f / v[i] -> position.w ;
+
+        triangle.x [i] = (float) viewport.left + ( v[i]->position.x * invw * 0.5f + 0.5f ) * (float) viewport.width ;
+        triangle.y [i] = (float) viewport.top + ( v[i]->position.y * invw * 0.5f + 0.5f ) * (float) viewport.height ;
+        triangle.z [i] = v[i]->position.z * invw * 0.5f + 0.5f ;
+        triangle.invw [i] = invw ;
+
+        for ( size_t j = 0 ; j < count ; ++j )
+        triangle.values [i] [j] = v[i]->values [j] * invw ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Front faces are counter-clockwise , as in OpenGl. Triangles are then
+    // stored counter-clockwise so every edge function is positive inside.
+
+    const float area = ( triangle.x[1] - triangle.x[0] ) * ( triangle.y[2] - triangle.y[0] )
+                     - ( triangle.y[1] - triangle.y[0] ) * ( triangle.x[2] - triangle.x[0] ) ;
+
+    if ( area == 0.0f )
+    return false ;
+
+    if ( state.culling == Gre::CullMode::Back && area < 0.0f )
+    return false ;
+
+    if ( state.culling == Gre::CullMode::Front && area > 0.0f )
+    return false ;
+
+    if ( area < 0.0f )
+    {
+        std::swap ( triangle.x [1] , triangle.x [2] ) ;
+        std::swap ( triangle.y [1] , triangle.y [2] ) ;
+        std::swap ( triangle.z [1] , triangle.z [2] ) ;
+        std::swap ( triangle.invw [1] , triangle.invw [2] ) ;
+
+        for ( size_t j = 0 ; j < count ; ++j )
+        std::swap ( triangle.values [1] [j] , triangle.values [2] [j] ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Pixels whose center is in the bounding box.
+
+    const float minx = std::min ( triangle.x[0] , std::min ( triangle.x[1] , triangle.x[2] ) ) ;
+    const float maxx = std::max ( triangle.x[0] , std::max ( triangle.x[1] , triangle.x[2] ) ) ;
+    const float miny = std::min ( triangle.y[0] , std::min ( triangle.y[1] , triangle.y[2] ) ) ;
+    const float maxy = std::max ( triangle.y[0] , std::max ( triangle.y[1] , triangle.y[2] ) ) ;
+
+    triangle.minx = std::max ( scissor.left , (int) std::ceil ( minx - 0.5f ) ) ;
+    triangle.miny = std::max ( scissor.top , (int) std::ceil ( miny - 0.5f ) ) ;
+    triangle.maxx = std::min ( scissor.left + scissor.width - 1 , (int) std::floor ( maxx - 0.5f ) ) ;
+    triangle.maxy = std::min ( scissor.top + scissor.height - 1 , (int) std::floor ( maxy - 0.5f ) ) ;
+
+    return triangle.minx <= triangle.maxx && triangle.miny <= triangle.maxy ;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Writes a fragment's color in the target.
+//////////////////////////////////////////////////////////////////////
+static void SoftwareWriteColor ( const SoftwareTarget & target , size_t pixel , const Gre::Vector4 & color , bool blending )
+{
+    unsigned char * dest = target.color + pixel * target.channels ;
+    const float alpha = std::min ( 1.0f , std::max ( 0.0f , color.w ) ) ;
+
+    for ( int i = 0 ; i < target.channels ; ++i )
+    {
+        float value = std::min ( 1.0f , std::max ( 0.0f , color [i] ) ) ;
+
+        if ( blending )
+        value = value * alpha + ( (float) dest [i] / 255.0f ) * ( 1.0f - alpha ) ;
+
+        dest [i] = (unsigned char) ( value * 255.0f + 0.5f ) ;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Edge function of a triangle : 'a * x + b * y + c' is positive on
+/// the inner side of the edge.
+//////////////////////////////////////////////////////////////////////
+struct SoftwareEdge
+{
+    float a , b , c ;
+
+    /// @brief True if pixels exactly on the edge are drawn ( top-left rule ).
+    bool inclusive ;
+
+    SoftwareEdge ( float x0 , float y0 , float x1 , float y1 )
+    {
+        a = y0 - y1 ;
+        b = x1 - x0 ;
+        c = x0 * y1 - x1 * y0 ;
+
+        //////////////////////////////////////////////////////////////////////
+        // With counter-clockwise triangles and y going up , left edges go
+        // down and top edges go left.
+
+        inclusive = ( y1 < y0 ) || ( y1 == y0 && x1 < x0 ) ;
+    }
+
+    float at ( float x , float y ) const { return a * x + b * y + c ; }
+};
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Rasterizes the part of a triangle inside a tile.
+//////////////////////////////////////////////////////////////////////
+static void SoftwareRasterizeTriangle (const SoftwareTarget & target ,
+                                       const Gre::RasterState & state ,
+                                       const SoftwareShader & shader ,
+                                       const SoftwareTriangle & triangle ,
+                                       size_t count ,
+                                       int tx0 , int ty0 , int tx1 , int ty1)
+{
+    const int minx = std::max ( tx0 , triangle.minx ) ;
+    const int miny = std::max ( ty0 , triangle.miny ) ;
+    const int maxx = std::min ( tx1 - 1 , triangle.maxx ) ;
+    const int maxy = std::min ( ty1 - 1 , triangle.maxy ) ;
+
+    if ( minx > maxx || miny > maxy )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Edge 'i' is opposite to vertex 'i' , so its value divided by the area
+    // is the barycentric weight of this vertex.
+
+    const SoftwareEdge edges [3] =
+    {
+        SoftwareEdge ( triangle.x[1] , triangle.y[1] , triangle.x[2] , triangle.y[2] ) ,
+        SoftwareEdge ( triangle.x[2] , triangle.y[2] , triangle.x[0] , triangle.y[0] ) ,
+        SoftwareEdge ( triangle.x[0] , triangle.y[0] , triangle.x[1] , triangle.y[1] )
+    };
+
+    const float invarea = 1.0f / ( edges[0].at ( triangle.x[0] , triangle.y[0] ) ) ;
+
+    const bool depthtest = state.depthtest && target.depth ;
+    const bool depthwrite = depthtest && state.depthwrite ;
+
+#if defined(__SSE2__)
+    const __m128 steps = _mm_set_ps ( 3.0f , 2.0f , 1.0f , 0.0f ) ;
+    const __m128 zero = _mm_setzero_ps () ;
+#endif
+
+    for ( int y = miny ; y <= maxy ; ++y )
+    {
+        const float py = (float) y + 0.5f ;
+
+        for ( int x = minx ; x <= maxx ; x += 4 )
+        {
+            const float px = (float) x + 0.5f ;
+            float e [3] [4] ;
+            int mask = 0 ;
+
+            //////////////////////////////////////////////////////////////////////
+            // Evaluates the three edges for four pixels at once.
+
+#if defined(__SSE2__)
+            __m128 inside = _mm_castsi128_ps ( _mm_set1_epi32 ( -1 ) ) ;
+
+            for ( int i = 0 ; i < 3 ; ++i )
+            {
+                const __m128 value = _mm_add_ps ( _mm_set1_ps ( edges[i].at ( px , py ) ) ,
+                                                  _mm_mul_ps ( _mm_set1_ps ( edges[i].a ) , steps ) ) ;
+
+                _mm_storeu_ps ( e [i] , value ) ;
+                inside = _mm_and_ps ( inside , edges[i].inclusive ? _mm_cmpge_ps ( value , zero ) : _mm_cmpgt_ps ( value , zero ) ) ;
+            }
+
+            mask = _mm_movemask_ps ( inside ) ;
+#else
+            mask = 0xF ;
+
+            for ( int i = 0 ; i < 3 ; ++i )
+            {
+                const float value = edges[i].at ( px , py ) ;
+
+                for ( int j = 0 ; j < 4 ; ++j )
+                {
+                    e [i] [j] = value + edges[i].a * (float) j ;
+
+                    if ( edges[i].inclusive ? e [i] [j] < 0.0f : e [i] [j] <= 0.0f )
+                    mask = mask & ~( 1 << j ) ;
+                }
+            }
+#endif
+
+            if ( x + 3 > maxx )
+            mask = mask & ( ( 1 << ( maxx - x + 1 ) ) - 1 ) ;
+
+            for ( int j = 0 ; mask ; ++j , mask >>= 1 )
+            {
+                if ( !( mask & 1 ) )
+                continue ;
+
+                const float b0 = e [0] [j] * invarea ;
+                const float b1 = e [1] [j] * invarea ;
+                const float b2 = e [2] [j] * invarea ;
+
+                const float z = b0 * triangle.z[0] + b1 * triangle.z[1] + b2 * triangle.z[2] ;
+
+                if ( z < 0.0f || z > 1.0f )
+                continue ;
+
+                const size_t pixel = (size_t) y * (size_t) target.width + (size_t) ( x + j ) ;
+
+                if ( depthtest && !( z < target.depth [pixel] ) )
+                continue ;
+
+                //////////////////////////////////////////////////////////////////////
+                // Perspective correct varyings : 'values / w' and '1 / w' are
+                // linear in window space.
+
+                const float invw = b0 * triangle.invw[0] + b1 * triangle.invw[1] + b2 * triangle.invw[2] ;
+                const float w = 1.0f / invw ;
+
+                SoftwareVarying fragment ;
+                fragment.position = Gre::Vector4 ( (float) ( x + j ) + 0.5f , py , z , invw ) ;
+
+                for ( size_t k = 0 ; k < count ; ++k )
+                fragment.values [k] = ( b0 * triangle.values[0][k] + b1 * triangle.values[1][k] + b2 * triangle.values[2][k] ) * w ;
+
+                Gre::Vector4 color ;
+
+                if ( !shader.fragment ( fragment , color ) )
+                continue ;
+
+                if ( depthwrite )
+                target.depth [pixel] = z ;
+
+                if ( target.color )
+                SoftwareWriteColor ( target , pixel , color , state.blending ) ;
+            }
+        }
+    }
+}
+
+void SoftwareRasterizer::drawTriangles (const SoftwareTarget & target ,
+                                        const Gre::Surface & viewport ,
+                                        const Gre::Surface & scissor ,
+                                        const Gre::RasterState & state ,
+                                        const SoftwareShader & shader ,
+                                        const std::vector < SoftwareVertex > & vertices ,
+                                        const std::vector < uint32_t > & indices)
+{
+    GreProfile( "SoftwareRasterizer::drawTriangles" ) ;
+
+    if ( vertices.empty() || indices.size() < 3 || target.width <= 0 || target.height <= 0 )
+    return ;
+
+    if ( !target.color && !target.depth )
+    return ;
+
+    const size_t count = std::min ( shader.getVaryingsCount () , SoftwareVaryingsMax ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Vertex stage : every vertex is shaded once , whatever the number of
+    // triangles using it.
+
+    std::vector < SoftwareVarying > varyings ( vertices.size () ) ;
+
+    Gre::JobPool::Get().parallelFor ( vertices.size() , 256 , [&] ( size_t begin , size_t end )
+    {
+        for ( size_t i = begin ; i < end ; ++i )
+        shader.vertex ( vertices [i] , varyings [i] ) ;
+    });
+
+    //////////////////////////////////////////////////////////////////////
+    // Pixels drawn are the ones in the target and in the scissor.
+
+    Gre::Surface clip ;
+    clip.left = std::max ( 0 , scissor.left ) ;
+    clip.top = std::max ( 0 , scissor.top ) ;
+    clip.width = std::min ( target.width , scissor.left + scissor.width ) - clip.left ;
+    clip.height = std::min ( target.height , scissor.top + scissor.height ) - clip.top ;
+
+    if ( clip.width <= 0 || clip.height <= 0 )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Setup : triangles are clipped against the near plane , culled , and
+    // converted to window coordinates in submission order.
+
+    std::vector < SoftwareTriangle > triangles ;
+    triangles.reserve ( indices.size () / 3 ) ;
+
+    for ( size_t i = 0 ; i + 2 < indices.size () ; i += 3 )
+    {
+        if ( indices[i] >= varyings.size() || indices[i+1] >= varyings.size() || indices[i+2] >= varyings.size() )
+        continue ;
+
+        const SoftwareVarying * input [3] = { &varyings[indices[i]] , &varyings[indices[i+1]] , &varyings[indices[i+2]] } ;
+
+        if ( SoftwareIsOutside ( input ) )
+        continue ;
+
+        SoftwareVarying polygon [4] ;
+        const size_t corners = SoftwareClipNear ( input , polygon , count ) ;
+
+        for ( size_t j = 1 ; j + 1 < corners ; ++j )
+        {
+            SoftwareTriangle triangle ;
+
+            if ( SoftwareSetupTriangle ( polygon[0] , polygon[j] , polygon[j+1] , viewport , clip , state , count , triangle ) )
+            triangles.push_back ( triangle ) ;
+        }
+    }
+
+    if ( triangles.empty() )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Binning : each tile gets the triangles overlapping it , in order.
+
+    const int tilesx = ( target.width + TileSize - 1 ) / TileSize ;
+    const int tilesy = ( target.height + TileSize - 1 ) / TileSize ;
+
+    std::vector < std::vector < uint32_t > > bins ( (size_t) tilesx * (size_t) tilesy ) ;
+
+    for ( size_t i = 0 ; i < triangles.size () ; ++i )
+    {
+        const SoftwareTriangle & triangle = triangles [i] ;
+
+        for ( int ty = triangle.miny / TileSize ; ty <= triangle.maxy / TileSize ; ++ty )
+        for ( int tx = triangle.minx / TileSize ; tx <= triangle.maxx / TileSize ; ++tx )
+        bins [(size_t) ty * tilesx + tx] .push_back ( (uint32_t) i ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Tiles are rasterized in parallel. A tile is only touched by one job ,
+    // so no pixel is written twice at the same time.
+
+    Gre::JobPool::Get().parallelFor ( bins.size() , 1 , [&] ( size_t begin , size_t end )
+    {
+        for ( size_t tile = begin ; tile < end ; ++tile )
+        {
+            if ( bins [tile] .empty() )
+            continue ;
+
+            const int tx0 = (int) ( tile % tilesx ) * TileSize ;
+            const int ty0 = (int) ( tile / tilesx ) * TileSize ;
+            const int tx1 = std::min ( tx0 + TileSize , target.width ) ;
+            const int ty1 = std::min ( ty0 + TileSize , target.height ) ;
+
+            for ( uint32_t index : bins [tile] )
+            SoftwareRasterizeTriangle ( target , state , shader , triangles [index] , count , tx0 , ty0 , tx1 , ty1 ) ;
+        }
+    });
+}
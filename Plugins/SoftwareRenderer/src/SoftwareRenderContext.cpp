@@ -0,0 +1,69 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SoftwareRenderContext.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "SoftwareRenderer.h"
+
+SoftwareRenderContext::SoftwareRenderContext ( const std::string & name , const Gre::Surface & surface )
+: Gre::RenderContext ( name ) , iSurface ( surface )
+{
+
+}
+
+SoftwareRenderContext::~SoftwareRenderContext () noexcept ( false )
+{
+
+}
+
+void SoftwareRenderContext::bind () const
+{
+    iIsBinded = true ;
+}
+
+void SoftwareRenderContext::unbind () const
+{
+    iIsBinded = false ;
+}
+
+void SoftwareRenderContext::flush () const
+{
+
+}
+
+Gre::Surface SoftwareRenderContext::getSurface () const
+{
+    GreAutolock ; return iSurface ;
+}
+
+void SoftwareRenderContext::setSurface ( const Gre::Surface & surface )
+{
+    GreAutolock ; iSurface = surface ;
+}
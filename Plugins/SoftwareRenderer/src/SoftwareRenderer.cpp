@@ -0,0 +1,495 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SoftwareRenderer.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "SoftwareRenderer.h"
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Reads one component of a vertex attribute.
+//////////////////////////////////////////////////////////////////////
+static float SoftwareReadComponent ( const char * data , const Gre::VertexAttribType & type , bool normalize , size_t index )
+{
+    switch ( type )
+    {
+        case Gre::VertexAttribType::Byte:
+        {
+            const float value = (float) reinterpret_cast < const int8_t * > ( data ) [index] ;
+            return normalize ? std::max ( -1.0f , value / 127.0f ) : value ;
+        }
+
+        case Gre::VertexAttribType::UnsignedByte:
+        {
+            const float value = (float) reinterpret_cast < const uint8_t * > ( data ) [index] ;
+            return normalize ? value / 255.0f : value ;
+        }
+
+        case Gre::VertexAttribType::Short:
+        {
+            const float value = (float) reinterpret_cast < const int16_t * > ( data ) [index] ;
+            return normalize ? std::max ( -1.0f , value / 32767.0f ) : value ;
+        }
+
+        case Gre::VertexAttribType::UnsignedShort:
+        {
+            const float value = (float) reinterpret_cast < const uint16_t * > ( data ) [index] ;
+            return normalize ? value / 65535.0f : value ;
+        }
+
+        case Gre::VertexAttribType::Int:
+        {
+            const double value = (double) reinterpret_cast < const int32_t * > ( data ) [index] ;
+            return (float) ( normalize ? std::max ( -1.0 , value / 2147483647.0 ) : value ) ;
+        }
+
+        case Gre::VertexAttribType::UnsignedInt:
+        {
+            const double value = (double) reinterpret_cast < const uint32_t * > ( data ) [index] ;
+            return (float) ( normalize ? value / 4294967295.0 : value ) ;
+        }
+
+        case Gre::VertexAttribType::Float:
+        return reinterpret_cast < const float * > ( data ) [index] ;
+
+        case Gre::VertexAttribType::Double:
+        return (float) reinterpret_cast < const double * > ( data ) [index] ;
+    }
+
+    return 0.0f ;
+}
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Returns the size of a component , in bytes.
+//////////////////////////////////////////////////////////////////////
+static size_t SoftwareComponentSize ( const Gre::VertexAttribType & type )
+{
+    switch ( type )
+    {
+        case Gre::VertexAttribType::Byte:
+        case Gre::VertexAttribType::UnsignedByte:
+        return 1 ;
+
+        case Gre::VertexAttribType::Short:
+        case Gre::VertexAttribType::UnsignedShort:
+        return 2 ;
+
+        case Gre::VertexAttribType::Double:
+        return 8 ;
+
+        default:
+        return 4 ;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Returns a vertex with every attributes missing.
+//////////////////////////////////////////////////////////////////////
+static SoftwareVertex SoftwareEmptyVertex ()
+{
+    SoftwareVertex vertex ;
+
+    for ( size_t i = 0 ; i < Gre::VertexAttribAliasCount ; ++i )
+    vertex.attributes [i] = Gre::Vector4 ( 0.0f , 0.0f , 0.0f , 1.0f ) ;
+
+    vertex.attributes [(int) Gre::VertexAttribAlias::Color] = Gre::Vector4 ( 1.0f ) ;
+    return vertex ;
+}
+
+SoftwareRenderer::SoftwareRenderer ( const std::string& name , const Gre::RendererOptions& options )
+: Gre::Renderer(name, options)
+, iColorBuffer ( new Gre::SoftwarePixelBuffer () )
+, iScissor ( false ) , iClearColor ( 0.0f ) , iClearDepth ( 1.0f )
+, iFramebuffer ( nullptr ) , iTechnique ( nullptr ) , iActiveUnit ( 0 )
+, iDefaultShader ( new SoftwareDefaultShader () )
+{
+    iViewport = { 0 , 0 , 0 , 0 } ;
+    iClearRegion = { 0 , 0 , 0 , 0 } ;
+
+    for ( int i = 0 ; i < UnitsCount ; ++i )
+    iUnits [i] = nullptr ;
+}
+
+SoftwareRenderer::~SoftwareRenderer() noexcept ( false )
+{
+
+}
+
+void SoftwareRenderer::setClearRegion(const Gre::Surface &box) const
+{
+    GreAutolock ;
+
+    iClearRegion = box ;
+    iScissor = true ;
+}
+
+void SoftwareRenderer::setViewport(const Gre::Viewport &viewport) const
+{
+    if ( iContext.isInvalid() )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // As the OpenGlRenderer , a region acts as a scissor until the next
+    // viewport.
+
+    {
+        GreAutolock ;
+        iViewport = viewport.getSurface () ;
+        iScissor = false ;
+    }
+
+    if ( viewport.regioned() )
+    setClearRegion ( viewport.region() ) ;
+
+    setClearColor ( viewport.clearcolor() ) ;
+    setClearDepth ( viewport.cleardepth() ) ;
+    clearBuffers ( viewport.clearbuffers() ) ;
+}
+
+void SoftwareRenderer::setClearColor(const Gre::Color &color) const
+{
+    GreAutolock ; iClearColor = Gre::Vector4 ( color.getRed() , color.getGreen() , color.getBlue() , color.getAlpha() ) ;
+}
+
+void SoftwareRenderer::setClearDepth(float value) const
+{
+    GreAutolock ; iClearDepth = value ;
+}
+
+void SoftwareRenderer::clearBuffers ( const Gre::ClearBuffers & buffers ) const
+{
+    GreAutolock ;
+
+    const SoftwareTarget target = iCurrentTarget () ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Clears the whole target , or the region only.
+
+    int left = 0 , top = 0 , right = target.width , bottom = target.height ;
+
+    if ( iScissor )
+    {
+        left = std::max ( left , iClearRegion.left ) ;
+        top = std::max ( top , iClearRegion.top ) ;
+        right = std::min ( right , iClearRegion.left + iClearRegion.width ) ;
+        bottom = std::min ( bottom , iClearRegion.top + iClearRegion.height ) ;
+    }
+
+    if ( left >= right || top >= bottom )
+    return ;
+
+    if ( target.color && buffers.test((int)Gre::ClearBuffer::Color) )
+    {
+        const float values [4] = { iClearColor.x , iClearColor.y , iClearColor.z , iClearColor.w } ;
+        unsigned char pixel [4] ;
+
+        for ( int i = 0 ; i < 4 ; ++i )
+        pixel [i] = (unsigned char) ( std::min ( 1.0f , std::max ( 0.0f , values [i] ) ) * 255.0f + 0.5f ) ;
+
+        for ( int y = top ; y < bottom ; ++y )
+        {
+            unsigned char * row = target.color + ( (size_t) y * target.width + left ) * target.channels ;
+
+            for ( int x = left ; x < right ; ++x , row += target.channels )
+            std::copy ( pixel , pixel + target.channels , row ) ;
+        }
+    }
+
+    if ( target.depth && buffers.test((int)Gre::ClearBuffer::Depth) )
+    {
+        for ( int y = top ; y < bottom ; ++y )
+        std::fill ( target.depth + (size_t) y * target.width + left , target.depth + (size_t) y * target.width + right , iClearDepth ) ;
+    }
+}
+
+void SoftwareRenderer::draw ( const Gre::TechniqueHolder & technique ) const
+{
+    if ( technique.isInvalid() )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The same quad as the OpenGlRenderer. Texture coordinates are also
+    // given , so the default shader can copy a texture on the viewport.
+
+    static const float corners [4] [2] = { { -1.0f , -1.0f } , { 1.0f , -1.0f } , { -1.0f , 1.0f } , { 1.0f , 1.0f } } ;
+
+    std::vector < SoftwareVertex > vertices ( 4 , SoftwareEmptyVertex () ) ;
+
+    for ( int i = 0 ; i < 4 ; ++i )
+    {
+        vertices [i] .attributes [(int) Gre::VertexAttribAlias::Position] = Gre::Vector4 ( corners[i][0] , corners[i][1] , 0.0f , 1.0f ) ;
+        vertices [i] .attributes [(int) Gre::VertexAttribAlias::Texture] = Gre::Vector4 ( corners[i][0] * 0.5f + 0.5f , corners[i][1] * 0.5f + 0.5f , 0.0f , 1.0f ) ;
+    }
+
+    const std::vector < uint32_t > indices = { 0 , 1 , 2 , 2 , 1 , 3 } ;
+    iDraw ( technique.getObject() , vertices , indices ) ;
+    Gre::RenderStatistics::CountDraw ( 4 , 2 ) ;
+}
+
+void SoftwareRenderer::drawSubMesh(const Gre::SubMeshHolder & submesh) const
+{
+    if ( submesh.isInvalid() || !iTechnique )
+    return ;
+
+    const Gre::HardwareIndexBufferHolder & index = submesh -> getIndexBuffer () ;
+
+    if ( index.isInvalid() || !index -> getData() )
+    return ;
+
+    if ( index -> getIndexDescriptor().getMode() != Gre::IndexDrawmode::Triangles )
+    return ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Reads the indices.
+
+    const size_t count = index -> count () ;
+    std::vector < uint32_t > indices ( count ) ;
+    uint32_t maximum = 0 ;
+
+    for ( size_t i = 0 ; i < count ; ++i )
+    {
+        switch ( index -> getIndexDescriptor().getType() )
+        {
+            case Gre::IndexType::UnsignedByte:
+            indices [i] = reinterpret_cast < const uint8_t * > ( index -> getData() ) [i] ; break ;
+
+            case Gre::IndexType::UnsignedShort:
+            indices [i] = reinterpret_cast < const uint16_t * > ( index -> getData() ) [i] ; break ;
+
+            case Gre::IndexType::UnsignedInteger:
+            indices [i] = reinterpret_cast < const uint32_t * > ( index -> getData() ) [i] ; break ;
+
+            default:
+            return ;
+        }
+
+        maximum = std::max ( maximum , indices [i] ) ;
+    }
+
+    //////////////////////////////////////////////////////////////////////
+    // Reads the vertices from the attributes the mesh gave to the program.
+
+    const Gre::PipelineStateHolder & state = iTechnique -> getPipelineState () ;
+    const Gre::HardwareProgramHolder & program = iTechnique -> getHardwareProgram () ;
+
+    if ( state.isInvalid() || program.isInvalid() )
+    return ;
+
+    const SoftwareProgram * softprogram = reinterpret_cast < const SoftwareProgram * > ( program.getObject() ) ;
+    std::vector < SoftwareVertex > vertices ( (size_t) maximum + 1 , SoftwareEmptyVertex () ) ;
+
+    for ( size_t alias = 0 ; alias < Gre::VertexAttribAliasCount ; ++alias )
+    {
+        const SoftwareAttribute * attribute = softprogram -> getAttribute ( state -> getAttribLocation ( (Gre::VertexAttribAlias) alias ) ) ;
+
+        if ( !attribute )
+        continue ;
+
+        const size_t elements = std::min ( attribute -> elements , (size_t) 4 ) ;
+        const size_t stride = attribute -> stride ? attribute -> stride : attribute -> elements * SoftwareComponentSize ( attribute -> type ) ;
+
+        for ( size_t i = 0 ; i < vertices.size () ; ++i )
+        {
+            const char * data = attribute -> pointer + i * stride ;
+
+            for ( size_t j = 0 ; j < elements ; ++j )
+            vertices [i] .attributes [alias] [j] = SoftwareReadComponent ( data , attribute -> type , attribute -> normalize , j ) ;
+        }
+    }
+
+    iDraw ( iTechnique , vertices , indices ) ;
+    Gre::RenderStatistics::CountDraw ( *index.getObject() ) ;
+}
+
+void SoftwareRenderer::setRasterState ( const Gre::RasterState & state ) const
+{
+    GreAutolock ; iRasterState = state ;
+}
+
+void SoftwareRenderer::setShader ( const std::string & technique , const std::shared_ptr < SoftwareShader > & shader )
+{
+    GreAutolock ;
+
+    if ( shader )
+    iShaders [technique] = shader ;
+    else
+    iShaders.erase ( technique ) ;
+}
+
+const Gre::SoftwarePixelBufferHolder & SoftwareRenderer::getColorBuffer () const
+{
+    getDefaultTarget () ;
+    return iColorBuffer ;
+}
+
+bool SoftwareRenderer::saveColorBuffer ( const std::string & path ) const
+{
+    const Gre::SoftwarePixelBufferHolder & buffer = getColorBuffer () ;
+
+    if ( buffer.isInvalid() )
+    return false ;
+
+    return SoftwarePixelBufferSavePng ( *buffer.getObject() , path ) ;
+}
+
+SoftwareTarget SoftwareRenderer::getDefaultTarget () const
+{
+    GreAutolock ;
+
+    SoftwareTarget target ;
+
+    if ( iContext.isInvalid() || iColorBuffer.isInvalid() )
+    return target ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Buffers follow the context's size. They are cleared when resized.
+
+    const Gre::Surface surface = iContext -> getSurface () ;
+    const Gre::Surface & current = iColorBuffer -> getSurface () ;
+
+    if ( current.width != surface.width || current.height != surface.height || !iColorBuffer -> getData () )
+    {
+        const size_t pixels = (size_t) std::max ( 0 , surface.width ) * (size_t) std::max ( 0 , surface.height ) ;
+
+        iColorBuffer -> setSurface ( { 0 , 0 , surface.width , surface.height } ) ;
+        iColorBuffer -> setPixelFormat ( Gre::PixelFormat::RGBA ) ;
+        iColorBuffer -> setPixelType ( Gre::PixelType::UnsignedByte ) ;
+        iColorBuffer -> setData ( nullptr , pixels * 4 ) ;
+        iDepthBuffer.assign ( pixels , 1.0f ) ;
+    }
+
+    target.color = reinterpret_cast < unsigned char * > ( iColorBuffer -> getData () ) ;
+    target.channels = 4 ;
+    target.depth = iDepthBuffer.empty () ? nullptr : iDepthBuffer.data () ;
+    target.width = surface.width ;
+    target.height = surface.height ;
+    return target ;
+}
+
+void SoftwareRenderer::bindFramebuffer ( const SoftwareFramebuffer * framebuffer ) const
+{
+    GreAutolock ; iFramebuffer = framebuffer ;
+}
+
+void SoftwareRenderer::unbindFramebuffer ( const SoftwareFramebuffer * framebuffer ) const
+{
+    GreAutolock ;
+
+    if ( iFramebuffer == framebuffer )
+    iFramebuffer = nullptr ;
+}
+
+void SoftwareRenderer::setCurrentTechnique ( const Gre::Technique * technique ) const
+{
+    GreAutolock ; iTechnique = technique ;
+}
+
+void SoftwareRenderer::setActiveUnit ( int unit ) const
+{
+    GreAutolock ; iActiveUnit = unit ;
+}
+
+void SoftwareRenderer::setUnitTexture ( const SoftwareTexture * texture ) const
+{
+    GreAutolock ;
+
+    if ( iActiveUnit >= 0 && iActiveUnit < UnitsCount )
+    iUnits [iActiveUnit] = texture ;
+}
+
+const SoftwareTexture * SoftwareRenderer::getUnitTexture ( int unit ) const
+{
+    GreAutolock ;
+
+    if ( unit < 0 || unit >= UnitsCount )
+    return nullptr ;
+
+    return iUnits [unit] ;
+}
+
+Gre::MeshManagerHolder SoftwareRenderer::iCreateMeshManager() const
+{
+    return Gre::MeshManagerHolder ( new SoftwareMeshManager(this) ) ;
+}
+
+Gre::HardwareProgramManagerInternalCreator* SoftwareRenderer::iCreateProgramManagerCreator() const
+{
+    return new SoftwareProgramManagerCreator(this) ;
+}
+
+Gre::TextureInternalCreator* SoftwareRenderer::iCreateTextureCreator() const
+{
+    return new SoftwareTextureCreator(this) ;
+}
+
+Gre::RenderFramebufferInternalCreator* SoftwareRenderer::iCreateFramebufferCreator() const
+{
+    return new SoftwareFramebufferCreator(this) ;
+}
+
+SoftwareTarget SoftwareRenderer::iCurrentTarget () const
+{
+    GreAutolock ;
+
+    if ( iFramebuffer )
+    return iFramebuffer -> getTarget () ;
+
+    return getDefaultTarget () ;
+}
+
+void SoftwareRenderer::iDraw (const Gre::Technique * technique ,
+                              const std::vector < SoftwareVertex > & vertices ,
+                              const std::vector < uint32_t > & indices) const
+{
+    GreAutolock ;
+
+    //////////////////////////////////////////////////////////////////////
+    // The shader reads the values the technique sent to its program.
+
+    auto it = iShaders.find ( technique -> getName () ) ;
+    SoftwareShader * shader = it == iShaders.end () ? iDefaultShader.get () : it -> second.get () ;
+
+    const Gre::HardwareProgramHolder & program = technique -> getHardwareProgram () ;
+    const SoftwareProgram * softprogram = program.isInvalid() ? nullptr : reinterpret_cast < const SoftwareProgram * > ( program.getObject() ) ;
+
+    shader -> prepare ( SoftwareShaderContext ( this , technique , softprogram ) ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Without viewport , the whole target is used.
+
+    const SoftwareTarget target = iCurrentTarget () ;
+    Gre::Surface viewport = iViewport ;
+
+    if ( viewport.width <= 0 || viewport.height <= 0 )
+    viewport = { 0 , 0 , target.width , target.height } ;
+
+    const Gre::Surface scissor = iScissor ? iClearRegion : viewport ;
+
+    SoftwareRasterizer::drawTriangles ( target , viewport , scissor , iRasterState , *shader , vertices , indices ) ;
+}
@@ -0,0 +1,281 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SoftwareShader.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "SoftwareRenderer.h"
+
+SoftwareShaderContext::SoftwareShaderContext (const SoftwareRenderer * renderer ,
+                                              const Gre::Technique * technique ,
+                                              const SoftwareProgram * program)
+: iRenderer ( renderer ) , iTechnique ( technique ) , iProgram ( program )
+{
+
+}
+
+const Gre::Technique * SoftwareShaderContext::getTechnique () const
+{
+    return iTechnique ;
+}
+
+bool SoftwareShaderContext::getValue ( const std::string & name , Gre::HdwProgVarType & type , Gre::RealProgramVariable & value ) const
+{
+    if ( !iProgram || name.empty() )
+    return false ;
+
+    int location = -1 ;
+
+    if ( !iProgram -> findUniform ( name , location , type ) )
+    return false ;
+
+    return iProgram -> getUniformValue ( location , type , value ) ;
+}
+
+bool SoftwareShaderContext::getValue ( const Gre::TechniqueParam & param , Gre::HdwProgVarType & type , Gre::RealProgramVariable & value ) const
+{
+    if ( !iTechnique )
+    return false ;
+
+    return getValue ( iTechnique -> getAlias ( param ) , type , value ) ;
+}
+
+bool SoftwareShaderContext::getLightValue (const Gre::TechniqueParam & light , const Gre::TechniqueParam & member ,
+                                           Gre::HdwProgVarType & type , Gre::RealProgramVariable & value) const
+{
+    if ( !iTechnique )
+    return false ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Named as in 'Technique::setAliasedParameterStructValue()'.
+
+    const std::string name1 = iTechnique -> getAlias ( light ) ;
+    const std::string name2 = iTechnique -> getAlias ( member ) ;
+
+    if ( name2.empty() )
+    return false ;
+
+    return getValue ( name1.empty() ? name2 : name1 + "." + name2 , type , value ) ;
+}
+
+Gre::Matrix4 SoftwareShaderContext::getMatrix ( const Gre::TechniqueParam & param , const Gre::Matrix4 & fallback ) const
+{
+    Gre::HdwProgVarType type ;
+    Gre::RealProgramVariable value ;
+
+    if ( !getValue ( param , type , value ) )
+    return fallback ;
+
+    if ( type == Gre::HdwProgVarType::Matrix4 )
+    return value.m4 ;
+
+    if ( type == Gre::HdwProgVarType::Matrix3 )
+    return Gre::Matrix4 ( value.m3 ) ;
+
+    return fallback ;
+}
+
+Gre::Vector4 SoftwareShaderContext::getVector ( const Gre::TechniqueParam & param , const Gre::Vector4 & fallback ) const
+{
+    Gre::HdwProgVarType type ;
+    Gre::RealProgramVariable value ;
+
+    if ( !getValue ( param , type , value ) )
+    return fallback ;
+
+    return ToVector ( type , value , fallback ) ;
+}
+
+const SoftwareTexture * SoftwareShaderContext::getTexture ( const Gre::TechniqueParam & param ) const
+{
+    Gre::HdwProgVarType type ;
+    Gre::RealProgramVariable value ;
+
+    if ( !iRenderer || !getValue ( param , type , value ) )
+    return nullptr ;
+
+    //////////////////////////////////////////////////////////////////////
+    // A sampler holds the unit its texture was bound to.
+
+    if ( type < Gre::HdwProgVarType::Sampler1D && type != Gre::HdwProgVarType::Int1 )
+    return nullptr ;
+
+    return iRenderer -> getUnitTexture ( value.i1 ) ;
+}
+
+Gre::Vector4 SoftwareShaderContext::ToVector ( const Gre::HdwProgVarType & type , const Gre::RealProgramVariable & value , const Gre::Vector4 & fallback )
+{
+    Gre::Vector4 result = fallback ;
+
+    switch ( type )
+    {
+        case Gre::HdwProgVarType::Float4:
+        result = Gre::Vector4 ( value.f4.x , value.f4.y , value.f4.z , value.f4.w ) ;
+        break ;
+
+        case Gre::HdwProgVarType::Float3:
+        result.x = value.f4.x ; result.y = value.f4.y ; result.z = value.f4.z ;
+        break ;
+
+        case Gre::HdwProgVarType::Float2:
+        result.x = value.f4.x ; result.y = value.f4.y ;
+        break ;
+
+        case Gre::HdwProgVarType::Float1: result.x = value.f4.x ;
+        break ;
+
+        case Gre::HdwProgVarType::Int1: result.x = (float) value.i1 ;
+        break ;
+
+        default:
+        break ;
+    }
+
+    return result ;
+}
+
+// ---------------------------------------------------------------------------
+
+SoftwareDefaultShader::SoftwareDefaultShader ()
+: iTexture ( nullptr ) , iLit ( false )
+{
+
+}
+
+void SoftwareDefaultShader::prepare ( const SoftwareShaderContext & context )
+{
+    const Gre::Matrix4 identity ( 1.0f ) ;
+
+    Gre::HdwProgVarType type ;
+    Gre::RealProgramVariable value ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Matrices : the combined one if the technique gives it , else the
+    // product of the separate ones.
+
+    iModel = context.getMatrix ( Gre::TechniqueParam::ModelMatrix , identity ) ;
+
+    if ( context.getValue ( Gre::TechniqueParam::ProjectionViewModelMatrix , type , value ) && type == Gre::HdwProgVarType::Matrix4 )
+    iMvp = value.m4 ;
+
+    else
+    {
+        const Gre::Matrix4 view = context.getMatrix ( Gre::TechniqueParam::ViewMatrix , identity ) ;
+        const Gre::Matrix4 projection = context.getMatrix ( Gre::TechniqueParam::ProjectionMatrix , identity ) ;
+        iMvp = context.getMatrix ( Gre::TechniqueParam::ProjectionViewMatrix , projection * view ) * iModel ;
+    }
+
+    if ( context.getValue ( Gre::TechniqueParam::NormalMatrix3 , type , value ) && type == Gre::HdwProgVarType::Matrix3 )
+    iNormal = value.m3 ;
+
+    else
+    iNormal = Gre::Matrix3 ( context.getMatrix ( Gre::TechniqueParam::NormalMatrix , iModel ) ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Material.
+
+    iDiffuse = context.getVector ( Gre::TechniqueParam::MaterialDiffuse , Gre::Vector4 ( 1.0f ) ) ;
+    iTexture = context.getTexture ( Gre::TechniqueParam::MaterialTexDiffuse ) ;
+
+    if ( !iTexture )
+    iTexture = context.getTexture ( Gre::TechniqueParam::Texture0 ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // First light , only if its position was given.
+
+    iLit = context.getLightValue ( Gre::TechniqueParam::Light0 , Gre::TechniqueParam::LightPosition , type , value ) ;
+
+    if ( iLit )
+    {
+        const Gre::Vector4 position = SoftwareShaderContext::ToVector ( type , value , Gre::Vector4 ( 0.0f , 0.0f , 0.0f , 1.0f ) ) ;
+        iLightPosition = position ;
+
+        Gre::Vector4 ambient ( 0.0f ) , diffuse ( 1.0f ) ;
+
+        if ( context.getLightValue ( Gre::TechniqueParam::Light0 , Gre::TechniqueParam::LightAmbient , type , value ) )
+        ambient = SoftwareShaderContext::ToVector ( type , value , ambient ) ;
+
+        if ( context.getLightValue ( Gre::TechniqueParam::Light0 , Gre::TechniqueParam::LightDiffuse , type , value ) )
+        diffuse = SoftwareShaderContext::ToVector ( type , value , diffuse ) ;
+
+        iLightAmbient = Gre::Vector3 ( ambient ) ;
+        iLightDiffuse = Gre::Vector3 ( diffuse ) ;
+    }
+}
+
+size_t SoftwareDefaultShader::getVaryingsCount () const
+{
+    return 12 ;
+}
+
+void SoftwareDefaultShader::vertex ( const SoftwareVertex & input , SoftwareVarying & output ) const
+{
+    const Gre::Vector4 & position = input.attributes [(int) Gre::VertexAttribAlias::Position] ;
+    const Gre::Vector4 & normal = input.attributes [(int) Gre::VertexAttribAlias::Normal] ;
+    const Gre::Vector4 & texture = input.attributes [(int) Gre::VertexAttribAlias::Texture] ;
+    const Gre::Vector4 & color = input.attributes [(int) Gre::VertexAttribAlias::Color] ;
+
+    output.position = iMvp * position ;
+
+    const Gre::Vector3 n = iNormal * Gre::Vector3 ( normal ) ;
+    const Gre::Vector4 world = iModel * position ;
+
+    output.values [0] = n.x ; output.values [1] = n.y ; output.values [2] = n.z ;
+    output.values [3] = world.x ; output.values [4] = world.y ; output.values [5] = world.z ;
+    output.values [6] = texture.x ; output.values [7] = texture.y ;
+    output.values [8] = color.x ; output.values [9] = color.y ; output.values [10] = color.z ; output.values [11] = color.w ;
+}
+
+bool SoftwareDefaultShader::fragment ( const SoftwareVarying & input , Gre::Vector4 & color ) const
+{
+    color = iDiffuse * Gre::Vector4 ( input.values[8] , input.values[9] , input.values[10] , input.values[11] ) ;
+
+    if ( iTexture )
+    color = color * iTexture -> sample ( Gre::Vector2 ( input.values[6] , input.values[7] ) ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Lambert term. A position with 'w' = 0 is a direction.
+
+    const Gre::Vector3 normal ( input.values[0] , input.values[1] , input.values[2] ) ;
+
+    if ( !iLit || glm::dot ( normal , normal ) == 0.0f )
+    return true ;
+
+    const Gre::Vector3 world ( input.values[3] , input.values[4] , input.values[5] ) ;
+    const Gre::Vector3 direction = iLightPosition.w == 0.0f ? Gre::Vector3 ( iLightPosition ) : Gre::Vector3 ( iLightPosition ) - world ;
+
+    if ( glm::dot ( direction , direction ) == 0.0f )
+    return true ;
+
+    const float lambert = std::max ( 0.0f , glm::dot ( glm::normalize ( normal ) , glm::normalize ( direction ) ) ) ;
+    const Gre::Vector3 light = iLightAmbient + iLightDiffuse * lambert ;
+
+    color = Gre::Vector4 ( color.x * light.x , color.y * light.y , color.z * light.z , color.w ) ;
+    return true ;
+}
@@ -0,0 +1,234 @@
+//////////////////////////////////////////////////////////////////////
+//
+//  SoftwareTexture.cpp
+//  This source file is part of Gre
+//		(Gang's Resource Engine)
+//
+//  Copyright (c) 2015 - 2017 Luk2010
+//  Created on 28/06/2017.
+//
+//////////////////////////////////////////////////////////////////////
+/*
+ -----------------------------------------------------------------------------
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "SoftwareRenderer.h"
+
+//////////////////////////////////////////////////////////////////////
+/// @brief Returns the number of components for a PixelFormat the
+/// SoftwareTexture can read , or 0.
+//////////////////////////////////////////////////////////////////////
+static int SoftwarePixelFormatComponents ( const Gre::PixelFormat & format )
+{
+    switch ( format )
+    {
+        case Gre::PixelFormat::Red:
+        case Gre::PixelFormat::DepthComponent:
+        case Gre::PixelFormat::Luminance:
+        return 1 ;
+
+        case Gre::PixelFormat::RG:
+        case Gre::PixelFormat::LuminanceAlpha:
+        return 2 ;
+
+        case Gre::PixelFormat::RGB:
+        case Gre::PixelFormat::BGR:
+        return 3 ;
+
+        case Gre::PixelFormat::RGBA:
+        case Gre::PixelFormat::BGRA:
+        return 4 ;
+
+        default:
+        return 0 ;
+    }
+}
+
+SoftwareTexture::SoftwareTexture (const SoftwareRenderer * renderer ,
+                                  const std::string & name , const Gre::TextureType & type ,
+                                  const Gre::SoftwarePixelBufferHolderList& buffers)
+: Gre::Texture(name, type, buffers) , iRenderer(renderer)
+{
+    if ( !iPixelBuffers.empty() ) {
+        _setBuffer () ;
+    }
+}
+
+SoftwareTexture::~SoftwareTexture () noexcept ( false )
+{
+
+}
+
+Gre::Vector4 SoftwareTexture::sample ( const Gre::Vector2 & coordinates ) const
+{
+    //////////////////////////////////////////////////////////////////////
+    // Called by every rasterizer threads : the texture is not locked , and
+    // must not change while a frame is drawn.
+
+    if ( iPixels.isInvalid() )
+    return Gre::Vector4 ( 1.0f ) ;
+
+    const Gre::Surface & surface = iPixels -> getSurface () ;
+
+    if ( surface.width <= 0 || surface.height <= 0 )
+    return Gre::Vector4 ( 1.0f ) ;
+
+    const float u = coordinates.x * (float) surface.width - 0.5f ;
+    const float v = coordinates.y * (float) surface.height - 0.5f ;
+
+    const int x = (int) std::floor ( u ) ;
+    const int y = (int) std::floor ( v ) ;
+    const float fx = u - (float) x ;
+    const float fy = v - (float) y ;
+
+    const Gre::Vector4 bottom = iTexel ( x , y ) * ( 1.0f - fx ) + iTexel ( x + 1 , y ) * fx ;
+    const Gre::Vector4 top = iTexel ( x , y + 1 ) * ( 1.0f - fx ) + iTexel ( x + 1 , y + 1 ) * fx ;
+
+    return bottom * ( 1.0f - fy ) + top * fy ;
+}
+
+bool SoftwareTexture::getTarget ( SoftwareTarget & target , bool depth ) const
+{
+    GreAutolock ;
+
+    if ( iPixels.isInvalid() || !iPixels -> getData () )
+    return false ;
+
+    const Gre::Surface & surface = iPixels -> getSurface () ;
+    const int components = SoftwarePixelFormatComponents ( iPixels -> getPixelFormat () ) ;
+
+    if ( depth )
+    {
+        if ( iPixels -> getPixelType () != Gre::PixelType::Float || components != 1 )
+        return false ;
+
+        target.depth = reinterpret_cast < float * > ( iPixels -> getData () ) ;
+    }
+
+    else
+    {
+        if ( iPixels -> getPixelType () != Gre::PixelType::UnsignedByte || components == 0 || components == 2 )
+        return false ;
+
+        target.color = reinterpret_cast < unsigned char * > ( iPixels -> getData () ) ;
+        target.channels = components ;
+    }
+
+    target.width = surface.width ;
+    target.height = surface.height ;
+    return true ;
+}
+
+void SoftwareTexture::_bind () const
+{
+    iRenderer -> setUnitTexture ( this ) ;
+}
+
+void SoftwareTexture::_unbind () const
+{
+
+}
+
+void SoftwareTexture::_setBuffer () const
+{
+    GreAutolock ;
+
+    for ( const Gre::SoftwarePixelBufferHolder & buffer : iPixelBuffers )
+    {
+        if ( buffer.isInvalid() )
+        continue ;
+
+        iPixels = buffer ;
+        return ;
+    }
+
+    iPixels.clear () ;
+}
+
+Gre::Vector4 SoftwareTexture::iTexel ( int x , int y ) const
+{
+    const Gre::Surface & surface = iPixels -> getSurface () ;
+
+    x = x % surface.width ; if ( x < 0 ) x += surface.width ;
+    y = y % surface.height ; if ( y < 0 ) y += surface.height ;
+
+    const Gre::PixelFormat format = iPixels -> getPixelFormat () ;
+    const int components = SoftwarePixelFormatComponents ( format ) ;
+    const size_t index = ( (size_t) y * (size_t) surface.width + (size_t) x ) * (size_t) components ;
+
+    float values [4] = { 0.0f , 0.0f , 0.0f , 1.0f } ;
+
+    if ( iPixels -> getPixelType () == Gre::PixelType::UnsignedByte )
+    {
+        const unsigned char * data = reinterpret_cast < const unsigned char * > ( iPixels -> getData () ) ;
+
+        for ( int i = 0 ; i < components ; ++i )
+        values [i] = (float) data [index + i] / 255.0f ;
+    }
+
+    else if ( iPixels -> getPixelType () == Gre::PixelType::Float )
+    {
+        const float * data = reinterpret_cast < const float * > ( iPixels -> getData () ) ;
+
+        for ( int i = 0 ; i < components ; ++i )
+        values [i] = data [index + i] ;
+    }
+
+    else return Gre::Vector4 ( 1.0f ) ;
+
+    //////////////////////////////////////////////////////////////////////
+    // Single components are read as a gray level , and BGR is swizzled.
+
+    if ( components == 1 )
+    return Gre::Vector4 ( values[0] , values[0] , values[0] , 1.0f ) ;
+
+    if ( components == 2 )
+    return Gre::Vector4 ( values[0] , values[0] , values[0] , values[1] ) ;
+
+    if ( format == Gre::PixelFormat::BGR || format == Gre::PixelFormat::BGRA )
+    std::swap ( values[0] , values[2] ) ;
+
+    return Gre::Vector4 ( values[0] , values[1] , values[2] , values[3] ) ;
+}
+
+// ---------------------------------------------------------------------------
+
+SoftwareTextureCreator::SoftwareTextureCreator ( const SoftwareRenderer* renderer )
+: iRenderer(renderer)
+{
+
+}
+
+SoftwareTextureCreator::~SoftwareTextureCreator()
+{
+
+}
+
+Gre::Texture* SoftwareTextureCreator::load(const std::string & name ,
+                                           const Gre::SoftwarePixelBufferHolderList & buffers ,
+                                           const Gre::TextureType & type ,
+                                           const Gre::ResourceLoaderOptions & ) const
+{
+    if ( !iRenderer )
+    return nullptr ;
+
+    return new SoftwareTexture ( iRenderer , name , type , buffers ) ;
+}